@@ -17,15 +17,342 @@ public static partial class NativeWindowsCapture
     public static class ErrorCodes
     {
         public const int Success = 0;
+        public const int Unchanged = 1;  // 前回読み出したフレームから変化なし
+        public const int Pending = 2;    // 非同期処理を開始した（完了はコールバック・イベントで通知）
         public const int InvalidWindow = -1;
         public const int Unsupported = -2;
         public const int AlreadyExists = -3;
         public const int NotFound = -4;
         public const int Memory = -5;
         public const int Device = -6;
+        public const int BufferTooSmall = -7;  // 呼び出し側バッファの容量不足
         public const int SehException = -100;  // [Issue #324] SEH例外（AccessViolation等）
     }
 
+    /// <summary>
+    /// エラー発生段階（BaketaCapture_GetLastErrorInfo）
+    /// </summary>
+    public static class ErrorStages
+    {
+        public const int None = 0;          // エラーなし
+        public const int Api = 1;           // 引数検証・セッション検索
+        public const int Capture = 2;       // セッション内部のその他の処理
+        public const int Device = 3;        // D3D11 デバイス作成・デバイス削除
+        public const int CaptureItem = 4;   // GraphicsCaptureItem 作成
+        public const int FramePool = 5;     // フレームプール・キャプチャ開始
+        public const int FrameWait = 6;     // フレーム到着待ち
+        public const int Readback = 7;      // ステージングテクスチャの作成・コピー・マップ
+        public const int GpuProcess = 8;    // GPU リサイズ・変換・差分検出
+        public const int Allocation = 9;    // 出力バッファ確保
+        public const int Encode = 10;       // ハードウェアエンコーダーの作成・エンコード
+    }
+
+    /// <summary>
+    /// 段階別タイミングの種別（BaketaCaptureStats.stages の添字）
+    /// </summary>
+    public static class TimingStages
+    {
+        public const int FrameWait = 0;     // フレーム到着待ち
+        public const int Copy = 1;          // ステージングへのコピー発行
+        public const int Map = 2;           // コピー完了待ち・マップ
+        public const int GpuResize = 3;     // GPU リサイズ（CPU 側の発行時間）
+        public const int GpuResizeGpu = 4;  // GPU リサイズ（タイムスタンプクエリによる GPU 実行時間）
+        public const int RowCopy = 5;       // マップ済みメモリから出力バッファへの行コピー
+        public const int Allocation = 6;    // 出力バッファ確保
+        public const int Total = 7;         // キャプチャ呼び出し全体
+        public const int Count = 8;
+    }
+
+    /// <summary>
+    /// 診断ログレベル定義
+    /// </summary>
+    public static class DiagnosticsLevels
+    {
+        public const int Off = 0;      // 診断ログなし（既定）
+        public const int Basic = 1;    // フォールバック等の低頻度イベントのみ
+        public const int Verbose = 2;  // 毎フレームのテクスチャ・ピクセル詳細
+    }
+
+    /// <summary>
+    /// リサイズフィルター（BaketaCapture_CaptureFrameScaled）
+    /// </summary>
+    public static class ResizeFilters
+    {
+        public const int Bilinear = 0;  // バイリニア（最速）
+        public const int Area = 1;      // 面積平均（縮小時の文字認識向け）
+        public const int Lanczos2 = 2;  // Lanczos-2（輪郭を保つ、最も重い）
+        public const int MaxScaledOutputs = 4;
+    }
+
+    /// <summary>
+    /// 出力ピクセルフォーマット（BaketaCapture_CaptureFrameEx）
+    /// </summary>
+    public static class PixelFormats
+    {
+        public const int Bgra32 = 0;  // 4 バイト BGRA
+        public const int Gray8 = 1;   // 1 バイト輝度（BT.601 係数）
+        public const int Bgr24 = 2;   // 3 バイト BGR（パック）
+        public const int Nv12 = 3;    // Y プレーン + UV インターリーブプレーン（BT.709 リミテッドレンジ）
+    }
+
+    /// <summary>
+    /// ハードウェアエンコーダーのコーデック（BaketaCapture_StartEncoder）
+    /// </summary>
+    public static class VideoCodecs
+    {
+        public const int H264 = 0;  // H.264 Main（Annex B）
+        public const int Hevc = 1;  // HEVC Main（Annex B）
+    }
+
+    /// <summary>
+    /// 記録ファイルのリプレイ（BaketaCapture_CreateReplaySession、組み合わせ可）
+    /// </summary>
+    public static class ReplayFlags
+    {
+        public const int RecordedTiming = 0x0;  // 記録時の提示間隔どおり（遅れた分は読み飛ばす）
+        public const int MaxSpeed = 0x1;        // 呼び出しごとに次のフレームを待たずに出す
+        public const int Loop = 0x2;            // 最後のフレームの後は先頭へ戻る
+    }
+
+    /// <summary>
+    /// 最後のエラーの詳細（呼び出しスレッドごと）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureErrorInfo
+    {
+        public int stage;           // ErrorStages
+        public int hresult;         // 失敗した API の HRESULT（無い場合は 0）
+        public int sessionId;       // エラーを記録したセッション（エクスポート層のエラーは 0）
+        public int messageLength;   // BaketaCapture_GetLastError で取得できるメッセージ長
+    }
+
+    /// <summary>
+    /// 段階別タイミング統計（マイクロ秒）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureStageTiming
+    {
+        public long count;          // サンプル数
+        public int p50Us;           // 中央値
+        public int p95Us;           // 95 パーセンタイル
+        public int p99Us;           // 99 パーセンタイル
+        public int maxUs;           // 最大値
+        public long totalUs;        // 合計（平均 = totalUs / count）
+    }
+
+    /// <summary>
+    /// セッション統計
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureStats
+    {
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = TimingStages.Count)]
+        public BaketaCaptureStageTiming[] stages;  // TimingStages 別
+        public long framesArrived;          // WGC から到着したフレーム数
+        public long framesDelivered;        // 読み出しに成功したキャプチャ呼び出し数
+        public long framesDropped;          // 読み出される前に置き換えられた・間引かれたフレーム数
+        public long cpuFallbackCount;       // GPU 処理が使えず CPU 処理に切り替えた回数
+        public long captureFailures;        // 失敗したキャプチャ呼び出し数
+        public long bufferReuseCount;       // 出力バッファプールの再利用数（プロセス共通）
+        public long bufferAllocationCount;  // 出力バッファプールの新規確保数（プロセス共通）
+    }
+
+    /// <summary>
+    /// 矩形（ピクセル座標）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureRect
+    {
+        public int x;
+        public int y;
+        public int width;
+        public int height;
+    }
+
+    /// <summary>
+    /// ROI キャプチャの要求と結果
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureRegion
+    {
+        public BaketaCaptureRect source;    // [入力] ウィンドウ内の領域（元のキャプチャ解像度）
+        public int targetWidth;             // [入力] 出力幅（0 で等倍）
+        public int targetHeight;            // [入力] 出力高さ（0 で等倍）
+        public int offset;                  // [出力] 出力バッファ先頭からのバイトオフセット（フレーム外は -1）
+        public int width;                   // [出力] 出力幅
+        public int height;                  // [出力] 出力高さ
+        public int stride;                  // [出力] 行バイト数
+    }
+
+    /// <summary>
+    /// 複数スケール出力の要求と結果
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureScaledOutput
+    {
+        public int targetWidth;             // [入力] 出力幅（0 で targetHeight からアスペクト比維持）
+        public int targetHeight;            // [入力] 出力高さ（0 で targetWidth からアスペクト比維持）
+        public int offset;                  // [出力] 出力バッファ先頭からのバイトオフセット
+        public int width;                   // [出力] 出力幅
+        public int height;                  // [出力] 出力高さ
+        public int stride;                  // [出力] 行バイト数
+    }
+
+    /// <summary>
+    /// タイル変化検出結果
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureTileInfo
+    {
+        public int tileSize;            // タイル一辺のピクセル数（元のキャプチャ解像度基準）
+        public int tileColumns;         // タイル列数
+        public int tileRows;            // タイル行数
+        public int dirtyTileCount;      // 変化したタイル数
+    }
+
+    /// <summary>
+    /// エッジ密度マップの情報
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureEdgeMapInfo
+    {
+        public int cellSize;            // セル一辺のピクセル数（元のキャプチャ解像度基準）
+        public int columns;             // セル列数
+        public int rows;                // セル行数
+        public int dataSize;            // マップのバイト数（容量不足時も設定）
+        public long timestamp;          // マップを作成したフレームの提示時刻
+        public ulong sequence;          // マップを作成したフレームの通し番号
+    }
+
+    /// <summary>
+    /// 共有メモリフレームリングのヘッダー（マッピング先頭）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureRingHeader
+    {
+        public uint magic;              // 0x474E5242 ("BRNG")
+        public uint version;            // レイアウトのバージョン
+        public uint slotCount;          // スロット数
+        public uint slotStride;         // スロット間隔（バイト）
+        public uint headerSize;         // 最初のスロットのオフセット
+        public uint slotHeaderSize;     // スロット先頭からピクセルデータまでのバイト数
+        public uint maxFrameBytes;      // 1 フレームの最大バイト数
+        public uint reserved;
+        public long latestFrameId;      // 最後に書き込んだフレームID（0 はフレームなし）
+    }
+
+    /// <summary>
+    /// 共有メモリフレームリングのスロットヘッダー（seq が奇数の間は書き込み中）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureRingSlot
+    {
+        public long seq;                // seqlock カウンタ
+        public ulong frameId;           // このスロットのフレームID（0 は無効）
+        public ulong sequence;          // セッション内のフレーム通し番号
+        public long timestamp;          // 提示時刻 (QPC 基準の 100ns 単位)
+        public int width;               // 幅 (リサイズ後)
+        public int height;              // 高さ (リサイズ後)
+        public int stride;              // 行バイト数
+        public int format;              // PixelFormats の値
+        public int dataSize;            // ピクセルデータのバイト数
+        public int originalWidth;       // 元のキャプチャ幅
+        public int originalHeight;      // 元のキャプチャ高さ
+        public int reserved;
+    }
+
+    /// <summary>
+    /// フレーム到着コールバック（WGC のフレーム到着スレッドから呼ばれる）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="timestamp">フレームのタイムスタンプ（100ns 単位）</param>
+    /// <param name="userData">登録時のユーザーデータ</param>
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate void FrameArrivedCallback(int sessionId, long timestamp, IntPtr userData);
+
+    /// <summary>
+    /// 非同期セッション作成の完了コールバック（作成ワーカースレッドから呼ばれる）
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウハンドル</param>
+    /// <param name="result">結果コード（BaketaCapture_CreateSession と同じ）</param>
+    /// <param name="sessionId">作成されたセッションID（成功時のみ）</param>
+    /// <param name="userData">登録時のユーザーデータ</param>
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate void SessionCreatedCallback(IntPtr hwnd, int result, int sessionId, IntPtr userData);
+
+    /// <summary>
+    /// フォーマット指定付きフレームデータ構造体
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureFrameEx
+    {
+        public IntPtr data;           // ピクセルデータ（format に応じたレイアウト）
+        public int width;             // 幅 (リサイズ後)
+        public int height;            // 高さ (リサイズ後)
+        public int stride;            // 行バイト数（NV12 は Y プレーン）
+        public long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
+        public int originalWidth;     // 元のキャプチャ幅 (リサイズ前)
+        public int originalHeight;    // 元のキャプチャ高さ (リサイズ前)
+        public int format;            // PixelFormats の値
+        public int dataSize;          // data 全体のバイト数
+        public int uvOffset;          // NV12: UV プレーン先頭のバイトオフセット
+        public int uvStride;          // NV12: UV プレーンの行バイト数
+        public ulong sequence;        // セッション内のフレーム通し番号
+    }
+
+    /// <summary>
+    /// GPU 共有フレーム（BaketaCapture_ExportSharedFrame）
+    /// 消費側は同じアダプターのデバイスで sharedHandle を開き、キー付きミューテックスを acquireKey で取得・releaseKey で返却する
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureSharedFrame
+    {
+        public IntPtr sharedHandle;   // テクスチャの NT 共有ハンドル（ライブラリ所有、閉じないこと）
+        public int slot;              // プール内のスロット番号
+        public int width;             // 幅 (リサイズ後)
+        public int height;            // 高さ (リサイズ後)
+        public int dxgiFormat;        // DXGI_FORMAT（B8G8R8A8_UNORM）
+        public ulong acquireKey;      // 消費側が AcquireSync に渡すキー
+        public ulong releaseKey;      // 消費側が ReleaseSync に渡すキー
+        public long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
+        public int originalWidth;     // 元のキャプチャ幅 (リサイズ前)
+        public int originalHeight;    // 元のキャプチャ高さ (リサイズ前)
+        public ulong sequence;        // セッション内のフレーム通し番号
+        public ulong generation;      // プールの世代（変化時はハンドルを開き直す）
+        public uint adapterLuidLow;   // アダプター LUID（LowPart）
+        public int adapterLuidHigh;   // アダプター LUID（HighPart）
+    }
+
+    /// <summary>
+    /// ハードウェアエンコーダーの設定
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureEncoderConfig
+    {
+        public int codec;             // VideoCodecs.*
+        public int targetWidth;       // 出力幅の上限（0 でリサイズなし）
+        public int targetHeight;      // 出力高さの上限（0 でリサイズなし）
+        public int bitrateKbps;       // 目標ビットレート（CBR、kbps）
+        public int frameRate;         // 想定フレームレート
+        public int keyframeInterval;  // キーフレーム間隔（フレーム数、0 でエンコーダー既定）
+    }
+
+    /// <summary>
+    /// エンコード済みパケットの情報（データは Annex B 形式）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BaketaCaptureEncodedPacket
+    {
+        public int dataSize;          // パケットのバイト数（バッファ不足時も設定される）
+        public int codec;             // VideoCodecs.*
+        public int width;             // 符号化サイズ（幅）
+        public int height;            // 符号化サイズ（高さ）
+        public int isKeyframe;        // 1 でキーフレーム
+        public int discontinuity;     // 1 の場合は直前までのパケットが破棄された
+        public long timestamp;        // 対応するキャプチャフレームの提示時刻 (100ns 単位)
+        public ulong sequence;        // 対応するキャプチャフレームの通し番号
+    }
+
     /// <summary>
     /// フレームデータ構造体
     /// </summary>
@@ -37,9 +364,10 @@ public static partial class NativeWindowsCapture
         public int height;              // 高さ (リサイズ後)
         public int stride;              // 行バイト数
         [MarshalAs(UnmanagedType.I8)]
-        public long timestamp;          // キャプチャ時刻 (100ns 単位)
+        public long timestamp;          // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
         public int originalWidth;       // 🚀 [Issue #193] 元のキャプチャ幅 (リサイズ前)
         public int originalHeight;      // 🚀 [Issue #193] 元のキャプチャ高さ (リサイズ前)
+        public ulong sequence;          // セッション内のフレーム通し番号（同じ値は同じフレーム）
     }
 
     /// <summary>
@@ -70,6 +398,70 @@ public static partial class NativeWindowsCapture
     [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
     public static extern int BaketaCapture_CreateSession([In] IntPtr hwnd, [Out] out int sessionId);
 
+    /// <summary>
+    /// ウィンドウキャプチャセッションをバックグラウンドで作成（呼び出し側をブロックしない）
+    /// 既存セッションがあれば即座に ErrorCodes.Success、作成を開始・実行中なら ErrorCodes.Pending を返す
+    /// コールバックのデリゲートは完了通知まで GC されないよう呼び出し側で保持すること
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウハンドル</param>
+    /// <param name="callback">完了コールバック（省略可）</param>
+    /// <param name="userData">コールバックに渡すユーザーデータ</param>
+    /// <param name="completionEvent">完了時にシグナルするイベントハンドル（省略可）</param>
+    /// <param name="sessionId">既存セッションのID（出力、ErrorCodes.Success の場合のみ）</param>
+    /// <returns>ErrorCodes.Success / ErrorCodes.Pending / エラーコード</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CreateSessionAsync([In] IntPtr hwnd, SessionCreatedCallback? callback, IntPtr userData, IntPtr completionEvent, [Out] out int sessionId);
+
+    /// <summary>
+    /// ウィンドウのキャプチャセッションをバックグラウンドで事前作成（初回キャプチャまでの待ち時間短縮）
+    /// 後の BaketaCapture_CreateSession は事前作成したセッションを再利用する
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウハンドル</param>
+    /// <returns>事前作成を開始した場合は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_Prewarm([In] IntPtr hwnd);
+
+    /// <summary>
+    /// モニターの一部の矩形をキャプチャするセッションを作成（同じモニターのセッション間で WGC フレームプールを共有）
+    /// </summary>
+    /// <param name="monitor">対象モニターの HMONITOR（IntPtr.Zero の場合は screenRect を含むモニター）</param>
+    /// <param name="screenRect">切り出すスクリーン矩形（物理ピクセル）</param>
+    /// <param name="sessionId">作成されたセッションID（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CreateMonitorSession([In] IntPtr monitor, in BaketaCaptureRect screenRect, [Out] out int sessionId);
+
+    /// <summary>
+    /// モニター全体をキャプチャするセッションを作成
+    /// </summary>
+    /// <param name="monitor">対象モニターの HMONITOR</param>
+    /// <param name="screenRect">IntPtr.Zero を指定（モニター全体）</param>
+    /// <param name="sessionId">作成されたセッションID（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CreateMonitorSession([In] IntPtr monitor, [In] IntPtr screenRect, [Out] out int sessionId);
+
+    /// <summary>
+    /// 記録ファイル（BaketaCapture_StartRecording で作成）を再生するリプレイセッションを作成
+    /// 以降のキャプチャ API はウィンドウセッションと同じ経路で記録したフレームを返す（ストリーミング・フレームイベントは非対応）
+    /// </summary>
+    /// <param name="path">記録ファイルのパス</param>
+    /// <param name="flags">ReplayFlags.* の組み合わせ</param>
+    /// <param name="sessionId">作成されたセッションID（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success、ファイルが無い場合は ErrorCodes.NotFound、形式が不正な場合は ErrorCodes.Unsupported</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CreateReplaySession([MarshalAs(UnmanagedType.LPWStr)] string path, int flags, [Out] out int sessionId);
+
     /// <summary>
     /// フレームをキャプチャ
     /// </summary>
@@ -96,6 +488,23 @@ public static partial class NativeWindowsCapture
     [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
     public static extern int BaketaCapture_CaptureFrameResized(int sessionId, [Out] out BaketaCaptureFrame frame, int targetWidth, int targetHeight, int timeoutMs);
 
+    /// <summary>
+    /// 複数セッションのフレームをまとめてキャプチャ（GPU 処理を全セッション分発行してから順にマップ）
+    /// 成功したフレーム（statusCodes が ErrorCodes.Success）はそれぞれ BaketaCapture_ReleaseFrame で解放すること
+    /// </summary>
+    /// <param name="sessionIds">セッションID配列</param>
+    /// <param name="count">セッション数</param>
+    /// <param name="frames">キャプチャフレーム配列（出力、count 要素）</param>
+    /// <param name="statusCodes">セッションごとの結果コード配列（出力、count 要素）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">バッチ全体のタイムアウト時間（ミリ秒）</param>
+    /// <returns>全セッション成功時は ErrorCodes.Success、それ以外は最初に失敗したセッションの結果コード</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureBatch([In] int[] sessionIds, int count, [Out] BaketaCaptureFrame[] frames, [Out] int[] statusCodes, int targetWidth, int targetHeight, int timeoutMs);
+
     /// <summary>
     /// フレームデータを解放
     /// </summary>
@@ -150,6 +559,427 @@ public static partial class NativeWindowsCapture
     [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
     public static extern int BaketaCapture_GetWindowDebugInfo(int sessionId, [Out] IntPtr windowInfoBuffer, int windowInfoSize, [Out] IntPtr screenRectBuffer, int screenRectSize);
 
+    /// <summary>
+    /// 呼び出し側が用意したバッファへフレームをキャプチャ（必要に応じてGPU側でリサイズ）
+    /// 出力は stride = 幅 * 4 で詰めて書き込まれ、BaketaCapture_ReleaseFrame は不要
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">キャプチャフレーム（出力）</param>
+    /// <param name="buffer">出力先バッファ（ピン留め済みであること）</param>
+    /// <param name="bufferSize">バッファ容量（バイト）</param>
+    /// <param name="requiredSize">必要バイト数（容量不足時に設定）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <returns>成功時は ErrorCodes.Success、容量不足時は ErrorCodes.BufferTooSmall</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureFrameInto(int sessionId, [Out] out BaketaCaptureFrame frame, IntPtr buffer, int bufferSize, [Out] out int requiredSize, int targetWidth, int targetHeight, int timeoutMs);
+
+    /// <summary>
+    /// フレームバッファプールの保持上限（ハイウォーターマーク）を設定
+    /// </summary>
+    /// <param name="maxPooledBytes">保持する未使用バッファの合計バイト数上限</param>
+    /// <param name="maxPooledBuffers">保持する未使用バッファ数上限（0でプール無効）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern void BaketaCapture_SetFramePoolLimits(long maxPooledBytes, int maxPooledBuffers);
+
+    /// <summary>
+    /// フレームバッファプールの未使用バッファをすべて解放
+    /// </summary>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern void BaketaCapture_TrimFramePool();
+
+    /// <summary>
+    /// 診断ログレベルを設定
+    /// </summary>
+    /// <param name="level">DiagnosticsLevels の値</param>
+    /// <returns>実際に設定されたレベル（ビルド時上限でクランプ）</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetDiagnosticsLevel(int level);
+
+    /// <summary>
+    /// 現在の診断ログレベルを取得
+    /// </summary>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_GetDiagnosticsLevel();
+
+    /// <summary>
+    /// ストリーミングモードを開始（以降の CaptureFrame 系は到着待ちをせず最新フレームを返す）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="maxFps">最大フレームレート（0 以下で無制限）</param>
+    /// <param name="poolDepth">フレームプールのバッファ数（0 以下で既定値）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StartStreaming(int sessionId, int maxFps, int poolDepth);
+
+    /// <summary>
+    /// ストリーミングモードを停止
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StopStreaming(int sessionId);
+
+    /// <summary>
+    /// 最小フレーム間隔を設定（間隔未満で届いたフレームはネイティブ側で即座に破棄）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="intervalMs">最小フレーム間隔（ミリ秒、0 以下で無制限）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetMinFrameInterval(int sessionId, int intervalMs);
+
+    /// <summary>
+    /// フレーム到着通知用の自動リセットイベントを取得（呼び出し側で CloseHandle が必要）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="eventHandle">複製されたイベントハンドル</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_GetFrameEvent(int sessionId, out IntPtr eventHandle);
+
+    /// <summary>
+    /// フレーム到着コールバックを設定（null で解除）
+    /// デリゲートは解除するまで呼び出し側で参照を保持すること
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="callback">コールバック</param>
+    /// <param name="userData">ユーザーデータ</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetFrameCallback(int sessionId, FrameArrivedCallback? callback, IntPtr userData);
+
+    /// <summary>
+    /// 前回このAPIで読み出したフレームから変化がある場合のみフレームをキャプチャ（GPU タイル差分検出）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">フレームデータ（変化なしの場合は空）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="threshold">ピクセル変化とみなす B+G+R 差分絶対値の合計（0〜765）</param>
+    /// <param name="tileInfo">タイル検出結果</param>
+    /// <param name="dirtyBitmap">変化タイルのビットマップ（32 タイル / ワード、LSB 先頭、省略可）</param>
+    /// <param name="dirtyBitmapWords">ビットマップのワード数</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <returns>変化ありは ErrorCodes.Success、変化なしは ErrorCodes.Unchanged</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureFrameIfChanged(int sessionId, [Out] out BaketaCaptureFrame frame, int targetWidth, int targetHeight, int threshold, out BaketaCaptureTileInfo tileInfo, [Out] uint[]? dirtyBitmap, int dirtyBitmapWords, int timeoutMs);
+
+    /// <summary>
+    /// 変化矩形のみを読み出して永続フレームを更新しキャプチャ
+    /// frame.bgraData はセッション所有で、次の呼び出しかセッション解放まで有効（ReleaseFrame 不要）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">フレームデータ</param>
+    /// <param name="dirtyRects">今回更新された矩形</param>
+    /// <param name="maxRects">dirtyRects の容量（超過時は外接矩形1つ）</param>
+    /// <param name="rectCount">更新された矩形数（0 は変化なし）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureFrameDirty(int sessionId, [Out] out BaketaCaptureFrame frame, [Out] BaketaCaptureRect[]? dirtyRects, int maxRects, out int rectCount, int timeoutMs);
+
+    /// <summary>
+    /// WGC の DirtyRegions 収集を有効化・無効化
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="enabled">1 で有効、0 で無効</param>
+    /// <returns>OS 非対応時は ErrorCodes.Unsupported</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetDirtyRegionMode(int sessionId, int enabled);
+
+    /// <summary>
+    /// 計測レイテンシに基づく解像度の自動調整を設定（CaptureFrameResized / CaptureToSharedRing が対象）
+    /// 有効時は targetWidth / targetHeight を上限として扱い、選択したスケールは width / originalWidth で分かる
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="latencyBudgetUs">1 回の読み出し（フレーム待ちを除く）に許容する時間（マイクロ秒、0 以下で無効化）</param>
+    /// <param name="minScale">文字の可読性を保つ最小スケール（0.0 より大きく 1.0 以下）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetAdaptiveResolution(int sessionId, int latencyBudgetUs, float minScale);
+
+    /// <summary>
+    /// ウィンドウ状態によるキャプチャの自動停止を設定（ウィンドウセッションは既定で有効）
+    /// 最小化・クローク・非表示の間はキャプチャ呼び出しが待機せずに失敗し（ErrorStages.FrameWait / ERROR_NOT_READY）、
+    /// 前面ウィンドウに完全に覆われている間は 1fps に間引かれる。復帰時は自動で再開する
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="enabled">1 で有効、0 で無効</param>
+    /// <returns>成功時は ErrorCodes.Success、モニター・領域セッションは ErrorCodes.Unsupported</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetAutoSuspend(int sessionId, int enabled);
+
+    /// <summary>
+    /// パイプライン読み出しを設定（既定は無効、CaptureFrame / CaptureFrameResized が対象）
+    /// 有効時はフレーム到着時にステージングへのコピーを発行しておき、読み出しはコピー完了を待たずにマップする。
+    /// 最新フレームのコピーが未完了の場合は 1 つ前のフレームを返す（timestamp / sequence はそのフレームの値）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="enabled">1 で有効、0 で無効</param>
+    /// <returns>成功時は ErrorCodes.Success、領域・リプレイセッションは ErrorCodes.Unsupported</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_SetPipelinedReadback(int sessionId, int enabled);
+
+    /// <summary>
+    /// セッションで読み出したフレームの記録を開始（提示時刻・通し番号・変化矩形とともに圧縮して追記）
+    /// 記録中のキャプチャには等倍のステージングコピー・圧縮・書き込みの時間が加わる
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="path">記録ファイルのパス（既存のファイルは上書き）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StartRecording(int sessionId, [MarshalAs(UnmanagedType.LPWStr)] string path);
+
+    /// <summary>
+    /// フレームの記録を終了してファイルを閉じる
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frameCount">記録したフレーム数（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success、記録中でない場合は ErrorCodes.NotFound</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StopRecording(int sessionId, [Out] out int frameCount);
+
+    /// <summary>
+    /// 複数の ROI のみをキャプチャ（GPU アトラス経由で1回の Map）
+    /// frame.bgraData に ROI ごとのデータが連続して格納される（各 ROI は regions[i].offset / stride、frame.stride は全体バイト数）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="regions">ROI の要求と結果</param>
+    /// <param name="count">ROI 数</param>
+    /// <param name="frame">フレームデータ（BaketaCapture_ReleaseFrame で解放）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureRegions(int sessionId, [In, Out] BaketaCaptureRegion[] regions, int count, [Out] out BaketaCaptureFrame frame, int timeoutMs);
+
+    /// <summary>
+    /// 文字領域候補のエッジ密度マップ（16x16 セルごとに 0〜255）と同じフレームをキャプチャ
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">フレームデータ（出力、BaketaCapture_ReleaseFrame で解放）</param>
+    /// <param name="targetWidth">フレームのターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">フレームのターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="densityMap">マップの出力先（セル番号 = 行 * 列数 + 列）</param>
+    /// <param name="densityMapSize">densityMap の容量（バイト）</param>
+    /// <param name="mapInfo">マップの情報</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <returns>成功時は ErrorCodes.Success、容量不足時は ErrorCodes.BufferTooSmall</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureEdgeMap(int sessionId, [Out] out BaketaCaptureFrame frame, int targetWidth, int targetHeight, [Out] byte[] densityMap, int densityMapSize, out BaketaCaptureEdgeMapInfo mapInfo, int timeoutMs);
+
+    /// <summary>
+    /// 文字領域候補のエッジ密度マップのみを作成（frame には IntPtr.Zero を渡す、フレーム本体は読み出さない）
+    /// </summary>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureEdgeMap(int sessionId, IntPtr frame, int targetWidth, int targetHeight, [Out] byte[] densityMap, int densityMapSize, out BaketaCaptureEdgeMapInfo mapInfo, int timeoutMs);
+
+    /// <summary>
+    /// フィルターを指定して1〜4個のサイズへ同時にリサイズしキャプチャ
+    /// frame.bgraData に出力ごとのデータが連続して格納される（各出力は outputs[i].offset / stride、frame.stride は全体バイト数）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="filter">ResizeFilters の値</param>
+    /// <param name="outputs">出力サイズの要求と結果</param>
+    /// <param name="count">出力数</param>
+    /// <param name="frame">フレームデータ（BaketaCapture_ReleaseFrame で解放）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureFrameScaled(int sessionId, int filter, [In, Out] BaketaCaptureScaledOutput[] outputs, int count, [Out] out BaketaCaptureFrame frame, int timeoutMs);
+
+    /// <summary>
+    /// 出力フォーマットを指定してキャプチャ（GPU 上で変換してから読み出し）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">フレームデータ（BaketaCapture_ReleaseFrameEx で解放）</param>
+    /// <param name="format">PixelFormats の値</param>
+    /// <param name="targetWidth">ターゲット幅（0 で等倍）</param>
+    /// <param name="targetHeight">ターゲット高さ（0 で等倍）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureFrameEx(int sessionId, [Out] out BaketaCaptureFrameEx frame, int format, int targetWidth, int targetHeight, int timeoutMs);
+
+    /// <summary>
+    /// BaketaCapture_CaptureFrameEx で取得したフレームデータを解放
+    /// </summary>
+    /// <param name="frame">解放するフレーム</param>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern void BaketaCapture_ReleaseFrameEx([In, Out] ref BaketaCaptureFrameEx frame);
+
+    /// <summary>
+    /// 最新フレームを GPU 共有テクスチャへコピーして NT ハンドルで取得（CPU への読み出しなし）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">共有フレーム（出力、解放不要）</param>
+    /// <param name="targetWidth">ターゲット幅（0 で等倍）</param>
+    /// <param name="targetHeight">ターゲット高さ（0 で等倍）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_ExportSharedFrame(int sessionId, [Out] out BaketaCaptureSharedFrame frame, int targetWidth, int targetHeight, int timeoutMs);
+
+    /// <summary>
+    /// セッションの共有メモリフレームリングを作成（プロセス外の消費側へフレームIDのみを渡す）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="name">マッピング名（例: Local\BaketaFrames）</param>
+    /// <param name="slotCount">スロット数（2〜64）</param>
+    /// <param name="maxFrameBytes">1 フレームの最大バイト数</param>
+    /// <returns>成功時は ErrorCodes.Success、同名のマッピングが存在する場合は ErrorCodes.AlreadyExists</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_EnableSharedRing(int sessionId, [MarshalAs(UnmanagedType.LPWStr)] string name, int slotCount, int maxFrameBytes);
+
+    /// <summary>
+    /// セッションの共有メモリフレームリングを閉じる
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_DisableSharedRing(int sessionId);
+
+    /// <summary>
+    /// フレームをキャプチャして共有メモリリングのスロットへ直接書き込む（frame.bgraData はスロットを指し、解放不要）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frame">書き込んだフレームの情報（出力）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <param name="frameId">消費側へ渡すフレームID（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success、リング未作成は ErrorCodes.NotFound</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_CaptureToSharedRing(int sessionId, [Out] out BaketaCaptureFrame frame, int targetWidth, int targetHeight, int timeoutMs, out ulong frameId);
+
+    /// <summary>
+    /// ハードウェアエンコーダー（Media Foundation）を開始（出力サイズは最初の EncodeFrame で決まる）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="config">エンコード設定</param>
+    /// <returns>成功時は ErrorCodes.Success、ハードウェアエンコーダーが無い場合は ErrorCodes.Unsupported</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StartEncoder(int sessionId, in BaketaCaptureEncoderConfig config);
+
+    /// <summary>
+    /// ハードウェアエンコーダーを停止（未読パケットも破棄する）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_StopEncoder(int sessionId);
+
+    /// <summary>
+    /// フレームを GPU 上で NV12 へ変換してハードウェアエンコーダーへ入力（パケットは ReadEncodedPacket で読み出す）
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="forceKeyframe">1 でこのフレームをキーフレームにする</param>
+    /// <param name="timeoutMs">待機上限（ミリ秒）</param>
+    /// <param name="queuedPackets">呼び出し後の未読パケット数（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success、エンコーダー未開始は ErrorCodes.NotFound</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_EncodeFrame(int sessionId, int forceKeyframe, int timeoutMs, out int queuedPackets);
+
+    /// <summary>
+    /// 最も古い未読のエンコード済みパケットを読み出す
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="buffer">パケットの書き込み先</param>
+    /// <param name="bufferSize">buffer のバイト数</param>
+    /// <param name="packet">パケット情報（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success、未読パケットが無い場合は ErrorCodes.Pending、
+    /// バッファ不足時は ErrorCodes.BufferTooSmall（packet.dataSize に必要サイズ、パケットは残る）</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_ReadEncodedPacket(int sessionId, [Out] byte[]? buffer, int bufferSize, out BaketaCaptureEncodedPacket packet);
+
+    /// <summary>
+    /// 呼び出しスレッドの最後のエラーの段階・HRESULT を取得
+    /// </summary>
+    /// <param name="info">エラー詳細（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_GetLastErrorInfo(out BaketaCaptureErrorInfo info);
+
+    /// <summary>
+    /// セッションの段階別タイミング・フレーム統計を取得
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="stats">統計（出力）</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_GetSessionStats(int sessionId, out BaketaCaptureStats stats);
+
+    /// <summary>
+    /// セッションの統計をリセット
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <returns>成功時は ErrorCodes.Success</returns>
+    [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Design", "CA1707:Identifiers should not contain underscores", Justification = "Native API naming convention")]
+    [System.Diagnostics.CodeAnalysis.SuppressMessage("Interoperability", "CA1401:P/Invokes should not be visible", Justification = "Public API for platform integration")]
+    public static extern int BaketaCapture_ResetSessionStats(int sessionId);
+
     /// <summary>
     /// 最後のエラーメッセージを取得（文字列版）
     /// </summary>
@@ -8,6 +8,7 @@ using Baketa.Core.Abstractions.Platform.Windows;
 using Baketa.Core.Settings;
 using Baketa.Infrastructure.Platform.Adapters;
 using Microsoft.Extensions.Logging;
+using Microsoft.Win32.SafeHandles;
 
 namespace Baketa.Infrastructure.Platform.Windows.Capture;
 
@@ -40,6 +41,10 @@ public class NativeWindowsCaptureWrapper : IDisposable
     // [Issue #324] セッションごとのセマフォ（同時アクセス防止）
     private static readonly ConcurrentDictionary<int, SemaphoreSlim> _sessionSemaphores = new();
 
+    // フレーム到着通知イベント（ネイティブ側で複製されたハンドルを所有）
+    private WaitHandle? _frameEvent;
+    private readonly object _frameEventLock = new();
+
     /// <summary>
     /// ライブラリが初期化済みかどうか
     /// </summary>
@@ -471,6 +476,96 @@ public class NativeWindowsCaptureWrapper : IDisposable
         }).ConfigureAwait(false);
     }
 
+    /// <summary>
+    /// 次のフレームが到着するまで非同期に待機
+    /// ネイティブの自動リセットイベントを ThreadPool.RegisterWaitForSingleObject で待つため、待機中にスレッドを占有しない
+    /// </summary>
+    /// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+    /// <param name="cancellationToken">キャンセルトークン</param>
+    /// <returns>フレームが到着した場合は true、タイムアウト・セッション無効時は false</returns>
+    public async Task<bool> WaitForNextFrameAsync(int timeoutMs = 5000, CancellationToken cancellationToken = default)
+    {
+        var frameEvent = GetOrCreateFrameEvent();
+        if (frameEvent == null)
+        {
+            return false;
+        }
+
+        var completion = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+        var registration = ThreadPool.RegisterWaitForSingleObject(
+            frameEvent,
+            static (state, timedOut) => ((TaskCompletionSource<bool>)state!).TrySetResult(!timedOut),
+            completion,
+            timeoutMs,
+            executeOnlyOnce: true);
+
+        try
+        {
+            using (cancellationToken.Register(static state => ((TaskCompletionSource<bool>)state!).TrySetCanceled(), completion))
+            {
+                return await completion.Task.ConfigureAwait(false);
+            }
+        }
+        finally
+        {
+            registration.Unregister(null);
+        }
+    }
+
+    /// <summary>
+    /// フレーム到着通知イベントを取得（初回はネイティブから複製ハンドルを取得）
+    /// </summary>
+    private WaitHandle? GetOrCreateFrameEvent()
+    {
+        lock (_frameEventLock)
+        {
+            if (_frameEvent != null)
+            {
+                return _frameEvent;
+            }
+
+            if (_sessionId < 0)
+            {
+                _logger?.LogError("キャプチャセッションが作成されていません");
+                return null;
+            }
+
+            int result = NativeWindowsCapture.BaketaCapture_GetFrameEvent(_sessionId, out var handle);
+            if (result != NativeWindowsCapture.ErrorCodes.Success || handle == IntPtr.Zero)
+            {
+                string errorMsg = NativeWindowsCapture.GetLastErrorMessage();
+                _logger?.LogError("フレーム到着イベントの取得に失敗: {ErrorCode}, {ErrorMessage}", result, errorMsg);
+                return null;
+            }
+
+            _frameEvent = new NativeFrameEvent(handle);
+            return _frameEvent;
+        }
+    }
+
+    /// <summary>
+    /// フレーム到着通知イベントを解放
+    /// </summary>
+    private void ReleaseFrameEvent()
+    {
+        lock (_frameEventLock)
+        {
+            _frameEvent?.Dispose();
+            _frameEvent = null;
+        }
+    }
+
+    /// <summary>
+    /// ネイティブから受け取ったイベントハンドルを所有する WaitHandle
+    /// </summary>
+    private sealed class NativeFrameEvent : WaitHandle
+    {
+        public NativeFrameEvent(IntPtr handle)
+        {
+            SafeWaitHandle = new SafeWaitHandle(handle, ownsHandle: true);
+        }
+    }
+
     /// <summary>
     /// 現在のキャプチャセッションを停止
     /// [Issue #324] セマフォのクリーンアップ追加
@@ -489,6 +584,8 @@ public class NativeWindowsCaptureWrapper : IDisposable
                     semaphore.Dispose();
                 }
 
+                ReleaseFrameEvent();
+
                 NativeWindowsCapture.BaketaCapture_ReleaseSession(_sessionId);
                 _sessionId = -1;
                 _windowHandle = IntPtr.Zero;
@@ -510,6 +607,8 @@ public class NativeWindowsCaptureWrapper : IDisposable
 
         try
         {
+            ReleaseFrameEvent();
+
             // セッションを削除
             if (_sessionId >= 0)
             {
@@ -0,0 +1,754 @@
+﻿// BaketaCaptureBench - ネイティブキャプチャのマイクロベンチマーク
+//
+// 合成ウィンドウ（または --hwnd で指定したウィンドウ）に対して CaptureFrame / CaptureFrameResized /
+// CaptureRegions / ストリーミングを解像度・出力サイズ・プール深さの組み合わせで実行し、
+// fps・呼び出しレイテンシのパーセンタイル・読み出しバイト数・フレームあたりのバッファ確保数を CSV / JSON で出力する。
+// --record で対象のフレーム列をファイルへ記録し、--replay でそのファイルを再生するリプレイセッションを対象にすると、
+// 同じフレーム列（解像度・変化矩形・提示間隔）でコード変更前後の結果を比較できる。
+//
+// 使用例:
+//   BaketaCaptureBench --resolutions 1280x720,1920x1080 --targets 0x0,960x540 --modes frame,resized,streaming
+//   BaketaCaptureBench --hwnd 0x1A2B3C --frames 600 --format json --output result.json
+//   BaketaCaptureBench --monitor --modes frame,resized,regions
+//   BaketaCaptureBench --hwnd 0x1A2B3C --record game.bkrec --frames 600
+//   BaketaCaptureBench --replay game.bkrec --replay-speed max --modes frame,resized,regions
+
+#define NOMINMAX
+#include <windows.h>
+#include <dwmapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BaketaCaptureNative.h"
+
+namespace
+{
+    struct Size
+    {
+        int width = 0;
+        int height = 0;
+    };
+
+    enum class Mode
+    {
+        Frame,       // BaketaCapture_CaptureFrame（到着待ち）
+        Resized,     // BaketaCapture_CaptureFrameResized
+        Regions,     // BaketaCapture_CaptureRegions（4 分割した ROI）
+        Streaming,   // StartStreaming 後の BaketaCapture_CaptureFrameResized
+    };
+
+    struct Options
+    {
+        HWND targetWindow = nullptr;  // 指定時は合成ウィンドウを使わない
+        bool primaryMonitor = false;  // プライマリモニター全体のモニターセッションを使う
+        std::vector<Size> resolutions{ { 1280, 720 }, { 1920, 1080 } };
+        std::vector<Size> targets{ { 0, 0 }, { 960, 540 } };
+        std::vector<int> poolDepths{ 3, 5 };
+        std::vector<Mode> modes{ Mode::Frame, Mode::Resized, Mode::Regions, Mode::Streaming };
+        int frames = 300;
+        int warmupFrames = 30;
+        int timeoutMs = 1000;
+        bool json = false;
+        std::string outputPath;
+        std::wstring recordPath;      // 指定時はベンチマークを行わず対象のフレームを記録する
+        std::wstring replayPath;      // 指定時は記録ファイルのリプレイセッションを対象にする
+        bool replayMaxSpeed = false;  // 記録時の提示間隔を無視して最大速度で再生する
+    };
+
+    struct CaseResult
+    {
+        const char* mode = "";
+        Size source;
+        Size target;
+        int poolDepth = 0;
+        int frames = 0;
+        int failures = 0;
+        double fps = 0.0;
+        long long p50Us = 0;
+        long long p95Us = 0;
+        long long p99Us = 0;
+        long long maxUs = 0;
+        double bytesPerFrame = 0.0;
+        double allocationsPerFrame = 0.0;
+        long long framesDropped = 0;
+        long long cpuFallbacks = 0;
+    };
+
+    const char* ModeName(Mode mode)
+    {
+        switch (mode)
+        {
+        case Mode::Frame: return "frame";
+        case Mode::Resized: return "resized";
+        case Mode::Regions: return "regions";
+        case Mode::Streaming: return "streaming";
+        }
+        return "unknown";
+    }
+
+    bool ParseMode(const std::string& text, Mode* mode)
+    {
+        for (Mode candidate : { Mode::Frame, Mode::Resized, Mode::Regions, Mode::Streaming })
+        {
+            if (text == ModeName(candidate))
+            {
+                *mode = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::string> SplitList(const std::string& text)
+    {
+        std::vector<std::string> items;
+        size_t start = 0;
+        while (start <= text.size())
+        {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = text.size();
+            }
+            if (end > start)
+            {
+                items.push_back(text.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return items;
+    }
+
+    std::wstring Widen(const std::string& text)
+    {
+        int length = MultiByteToWideChar(CP_ACP, 0, text.c_str(), -1, nullptr, 0);
+        if (length <= 0)
+        {
+            return std::wstring();
+        }
+        std::wstring wide(static_cast<size_t>(length), L'\0');
+        MultiByteToWideChar(CP_ACP, 0, text.c_str(), -1, wide.data(), length);
+        wide.resize(static_cast<size_t>(length - 1));
+        return wide;
+    }
+
+    bool ParseSize(const std::string& text, Size* size)
+    {
+        return std::sscanf(text.c_str(), "%dx%d", &size->width, &size->height) == 2 &&
+            size->width >= 0 && size->height >= 0;
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: BaketaCaptureBench [options]\n"
+            "  --hwnd <hex>             capture an existing window instead of the synthetic one\n"
+            "  --monitor                capture the primary monitor (monitor session)\n"
+            "  --resolutions WxH,...    synthetic window client sizes (default 1280x720,1920x1080)\n"
+            "  --targets WxH,...        resize targets, 0x0 = native (default 0x0,960x540)\n"
+            "  --pool-depths N,...      streaming frame pool depths (default 3,5)\n"
+            "  --modes m,...            frame,resized,regions,streaming (default all)\n"
+            "  --frames N               measured frames per case (default 300)\n"
+            "  --warmup N               warmup frames per case (default 30)\n"
+            "  --timeout MS             capture timeout (default 1000)\n"
+            "  --format csv|json        output format (default csv)\n"
+            "  --output PATH            write results to PATH instead of stdout\n"
+            "  --record PATH            record --frames frames of the target to PATH instead of benchmarking\n"
+            "  --replay PATH            benchmark a replay session of a recording made with --record\n"
+            "  --replay-speed S         recorded|max (default recorded)\n");
+    }
+
+    bool ParseOptions(int argc, char** argv, Options* options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                return false;
+            }
+            if (arg == "--monitor")
+            {
+                options->primaryMonitor = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                return false;
+            }
+
+            std::string value = argv[++i];
+            if (arg == "--hwnd")
+            {
+                options->targetWindow = reinterpret_cast<HWND>(static_cast<uintptr_t>(std::strtoull(value.c_str(), nullptr, 16)));
+            }
+            else if (arg == "--resolutions" || arg == "--targets")
+            {
+                std::vector<Size> sizes;
+                for (const std::string& item : SplitList(value))
+                {
+                    Size size;
+                    if (!ParseSize(item, &size))
+                    {
+                        std::fprintf(stderr, "Invalid size: %s\n", item.c_str());
+                        return false;
+                    }
+                    sizes.push_back(size);
+                }
+                (arg == "--resolutions" ? options->resolutions : options->targets) = sizes;
+            }
+            else if (arg == "--pool-depths")
+            {
+                options->poolDepths.clear();
+                for (const std::string& item : SplitList(value))
+                {
+                    options->poolDepths.push_back(std::atoi(item.c_str()));
+                }
+            }
+            else if (arg == "--modes")
+            {
+                options->modes.clear();
+                for (const std::string& item : SplitList(value))
+                {
+                    Mode mode;
+                    if (!ParseMode(item, &mode))
+                    {
+                        std::fprintf(stderr, "Unknown mode: %s\n", item.c_str());
+                        return false;
+                    }
+                    options->modes.push_back(mode);
+                }
+            }
+            else if (arg == "--frames")
+            {
+                options->frames = (std::max)(1, std::atoi(value.c_str()));
+            }
+            else if (arg == "--warmup")
+            {
+                options->warmupFrames = (std::max)(0, std::atoi(value.c_str()));
+            }
+            else if (arg == "--timeout")
+            {
+                options->timeoutMs = (std::max)(1, std::atoi(value.c_str()));
+            }
+            else if (arg == "--format")
+            {
+                options->json = (value == "json");
+            }
+            else if (arg == "--output")
+            {
+                options->outputPath = value;
+            }
+            else if (arg == "--record" || arg == "--replay")
+            {
+                (arg == "--record" ? options->recordPath : options->replayPath) = Widen(value);
+            }
+            else if (arg == "--replay-speed")
+            {
+                if (value != "recorded" && value != "max")
+                {
+                    std::fprintf(stderr, "Unknown replay speed: %s\n", value.c_str());
+                    return false;
+                }
+                options->replayMaxSpeed = (value == "max");
+            }
+            else
+            {
+                std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 毎 vsync 内容が変わる合成ウィンドウ（WGC は内容が変化したときのみフレームを届けるため）
+    /// 専用スレッドでメッセージループと描画を回す
+    /// </summary>
+    class SyntheticWindow
+    {
+    public:
+        ~SyntheticWindow() { Stop(); }
+
+        bool Start(Size clientSize)
+        {
+            m_thread = std::thread([this, clientSize]() { Run(clientSize); });
+            while (!m_ready.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return m_hwnd.load() != nullptr;
+        }
+
+        void Stop()
+        {
+            m_running.store(false);
+            if (m_thread.joinable())
+            {
+                m_thread.join();
+            }
+        }
+
+        HWND Handle() const { return m_hwnd.load(); }
+
+    private:
+        static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
+        {
+            if (message == WM_ERASEBKGND)
+            {
+                return 1;
+            }
+            return DefWindowProcW(hwnd, message, wParam, lParam);
+        }
+
+        void Run(Size clientSize)
+        {
+            WNDCLASSW windowClass = {};
+            windowClass.lpfnWndProc = WindowProc;
+            windowClass.hInstance = GetModuleHandleW(nullptr);
+            windowClass.lpszClassName = L"BaketaCaptureBenchWindow";
+            windowClass.hCursor = LoadCursorW(nullptr, IDC_ARROW);
+            RegisterClassW(&windowClass);
+
+            RECT rect = { 0, 0, clientSize.width, clientSize.height };
+            AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
+            HWND hwnd = CreateWindowExW(0, windowClass.lpszClassName, L"BaketaCaptureBench", WS_OVERLAPPEDWINDOW | WS_VISIBLE,
+                0, 0, rect.right - rect.left, rect.bottom - rect.top, nullptr, nullptr, windowClass.hInstance, nullptr);
+            m_hwnd.store(hwnd);
+            m_ready.store(true);
+            if (!hwnd)
+            {
+                return;
+            }
+
+            int frame = 0;
+            while (m_running.load())
+            {
+                MSG message;
+                while (PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE))
+                {
+                    TranslateMessage(&message);
+                    DispatchMessageW(&message);
+                }
+
+                Paint(hwnd, frame++);
+                DwmFlush();  // コンポジターの次の合成まで待つ（約 1 vsync に 1 回の更新）
+            }
+
+            DestroyWindow(hwnd);
+            m_hwnd.store(nullptr);
+        }
+
+        static void Paint(HWND hwnd, int frame)
+        {
+            RECT client;
+            GetClientRect(hwnd, &client);
+            HDC dc = GetDC(hwnd);
+
+            // 背景色の変化と横に流れる帯（テキスト領域のような高周波成分を含む）
+            HBRUSH background = CreateSolidBrush(RGB(frame % 256, 64, 255 - frame % 256));
+            FillRect(dc, &client, background);
+            DeleteObject(background);
+
+            int bandWidth = (std::max)(16L, client.right / 8);
+            int bandX = client.right > 0 ? (frame * 8) % client.right : 0;
+            RECT band = { bandX, 0, bandX + bandWidth, client.bottom };
+            FillRect(dc, &band, static_cast<HBRUSH>(GetStockObject(WHITE_BRUSH)));
+
+            wchar_t text[32];
+            int length = swprintf_s(text, L"frame %d", frame);
+            TextOutW(dc, 16, 16, text, length);
+
+            ReleaseDC(hwnd, dc);
+        }
+
+        std::thread m_thread;
+        std::atomic<HWND> m_hwnd{ nullptr };
+        std::atomic<bool> m_ready{ false };
+        std::atomic<bool> m_running{ true };
+    };
+
+    long long QpcNow()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    double QpcFrequency()
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(frequency.QuadPart);
+    }
+
+    long long Percentile(const std::vector<long long>& sorted, double percentile)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(percentile * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[(std::min)(index, sorted.size() - 1)];
+    }
+
+    /// <summary>
+    /// 1 回のキャプチャを実行し、成功時は読み出したバイト数を返す（失敗時は -1）
+    /// </summary>
+    long long CaptureOnce(int sessionId, Mode mode, Size source, Size target, int timeoutMs)
+    {
+        BaketaCaptureFrame frame = {};
+        long long bytes = -1;
+
+        if (mode == Mode::Regions)
+        {
+            // フレームを 2x2 に分割した ROI（target 指定時は各 ROI をその 1/2 サイズへ縮小）
+            BaketaCaptureRegion regions[4] = {};
+            int halfWidth = (std::max)(1, source.width / 2);
+            int halfHeight = (std::max)(1, source.height / 2);
+            for (int i = 0; i < 4; ++i)
+            {
+                regions[i].source = { (i % 2) * halfWidth, (i / 2) * halfHeight, halfWidth, halfHeight };
+                regions[i].targetWidth = target.width / 2;
+                regions[i].targetHeight = target.height / 2;
+            }
+            if (BaketaCapture_CaptureRegions(sessionId, regions, 4, &frame, timeoutMs) == BAKETA_CAPTURE_SUCCESS)
+            {
+                bytes = frame.stride;  // ROI の場合は stride がバッファ全体のバイト数
+            }
+        }
+        else
+        {
+            int result = (mode == Mode::Frame)
+                ? BaketaCapture_CaptureFrame(sessionId, &frame, timeoutMs)
+                : BaketaCapture_CaptureFrameResized(sessionId, &frame, target.width, target.height, timeoutMs);
+            if (result == BAKETA_CAPTURE_SUCCESS)
+            {
+                bytes = static_cast<long long>(frame.height) * frame.stride;
+            }
+        }
+
+        if (frame.bgraData)
+        {
+            BaketaCapture_ReleaseFrame(&frame);
+        }
+        return bytes;
+    }
+
+    /// <summary>
+    /// 対象（リプレイ・モニター・ウィンドウ）のセッションを作成する
+    /// リプレイはケースごとに先頭から再生し、--frames が記録より多い場合は先頭へ戻る
+    /// </summary>
+    bool CreateBenchSession(HWND hwnd, const Options& options, int* sessionId)
+    {
+        int created = BAKETA_CAPTURE_SUCCESS;
+        if (!options.replayPath.empty())
+        {
+            int flags = BAKETA_CAPTURE_REPLAY_LOOP | (options.replayMaxSpeed ? BAKETA_CAPTURE_REPLAY_MAX_SPEED : BAKETA_CAPTURE_REPLAY_RECORDED_TIMING);
+            created = BaketaCapture_CreateReplaySession(options.replayPath.c_str(), flags, sessionId);
+        }
+        else
+        {
+            created = options.primaryMonitor
+                ? BaketaCapture_CreateMonitorSession(MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY), nullptr, sessionId)
+                : BaketaCapture_CreateSession(hwnd, sessionId);
+        }
+
+        if (created != BAKETA_CAPTURE_SUCCESS)
+        {
+            char message[512] = {};
+            BaketaCapture_GetLastError(message, sizeof(message));
+            std::fprintf(stderr, "CreateSession failed: %s\n", message);
+            return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 対象のフレームを --frames 枚記録する（DirtyRegions に対応していれば変化矩形も記録する）
+    /// </summary>
+    bool RecordTarget(HWND hwnd, const Options& options)
+    {
+        int sessionId = 0;
+        if (!CreateBenchSession(hwnd, options, &sessionId))
+        {
+            return false;
+        }
+
+        BaketaCapture_SetDirtyRegionMode(sessionId, 1);
+        if (BaketaCapture_StartRecording(sessionId, options.recordPath.c_str()) != BAKETA_CAPTURE_SUCCESS)
+        {
+            char message[512] = {};
+            BaketaCapture_GetLastError(message, sizeof(message));
+            std::fprintf(stderr, "StartRecording failed: %s\n", message);
+            BaketaCapture_ReleaseSession(sessionId);
+            return false;
+        }
+
+        int failures = 0;
+        for (int i = 0; i < options.frames; ++i)
+        {
+            BaketaCaptureFrame frame = {};
+            if (BaketaCapture_CaptureFrame(sessionId, &frame, options.timeoutMs) != BAKETA_CAPTURE_SUCCESS)
+            {
+                ++failures;
+                continue;
+            }
+            BaketaCapture_ReleaseFrame(&frame);
+        }
+
+        int recorded = 0;
+        int stopped = BaketaCapture_StopRecording(sessionId, &recorded);
+        BaketaCapture_ReleaseSession(sessionId);
+        std::fprintf(stderr, "recorded %d frames (%d capture failures)\n", recorded, failures);
+        return stopped == BAKETA_CAPTURE_SUCCESS && recorded > 0;
+    }
+
+    bool RunCase(HWND hwnd, Mode mode, Size target, int poolDepth, const Options& options, CaseResult* result)
+    {
+        int sessionId = 0;
+        if (!CreateBenchSession(hwnd, options, &sessionId))
+        {
+            return false;
+        }
+
+        if (mode == Mode::Streaming &&
+            BaketaCapture_StartStreaming(sessionId, 0, poolDepth) != BAKETA_CAPTURE_SUCCESS)
+        {
+            std::fprintf(stderr, "StartStreaming failed (poolDepth=%d)\n", poolDepth);
+            BaketaCapture_ReleaseSession(sessionId);
+            return false;
+        }
+
+        // 実際のキャプチャサイズ（合成ウィンドウが画面に収まらない場合は指定より小さくなる）
+        BaketaCaptureFrame probe = {};
+        Size source;
+        if (BaketaCapture_CaptureFrame(sessionId, &probe, options.timeoutMs) == BAKETA_CAPTURE_SUCCESS)
+        {
+            source = { probe.originalWidth, probe.originalHeight };
+            BaketaCapture_ReleaseFrame(&probe);
+        }
+
+        for (int i = 0; i < options.warmupFrames; ++i)
+        {
+            CaptureOnce(sessionId, mode, source, target, options.timeoutMs);
+        }
+
+        BaketaCapture_ResetSessionStats(sessionId);
+        BaketaCaptureStats before = {};
+        BaketaCapture_GetSessionStats(sessionId, &before);
+
+        std::vector<long long> latencies;
+        latencies.reserve(options.frames);
+        long long totalBytes = 0;
+        int failures = 0;
+        double frequency = QpcFrequency();
+
+        long long caseStart = QpcNow();
+        for (int i = 0; i < options.frames; ++i)
+        {
+            long long start = QpcNow();
+            long long bytes = CaptureOnce(sessionId, mode, source, target, options.timeoutMs);
+            long long elapsed = QpcNow() - start;
+
+            if (bytes < 0)
+            {
+                ++failures;
+                continue;
+            }
+            latencies.push_back(static_cast<long long>(static_cast<double>(elapsed) * 1000000.0 / frequency));
+            totalBytes += bytes;
+        }
+        double caseSeconds = static_cast<double>(QpcNow() - caseStart) / frequency;
+
+        BaketaCaptureStats after = {};
+        BaketaCapture_GetSessionStats(sessionId, &after);
+        if (mode == Mode::Streaming)
+        {
+            BaketaCapture_StopStreaming(sessionId);
+        }
+        BaketaCapture_ReleaseSession(sessionId);
+
+        std::sort(latencies.begin(), latencies.end());
+        int succeeded = static_cast<int>(latencies.size());
+
+        result->mode = ModeName(mode);
+        result->source = source;
+        result->target = target;
+        result->poolDepth = (mode == Mode::Streaming) ? poolDepth : 0;
+        result->frames = succeeded;
+        result->failures = failures;
+        result->fps = caseSeconds > 0.0 ? succeeded / caseSeconds : 0.0;
+        result->p50Us = Percentile(latencies, 0.50);
+        result->p95Us = Percentile(latencies, 0.95);
+        result->p99Us = Percentile(latencies, 0.99);
+        result->maxUs = latencies.empty() ? 0 : latencies.back();
+        result->bytesPerFrame = succeeded > 0 ? static_cast<double>(totalBytes) / succeeded : 0.0;
+        // バッファプールはプロセス共通だが、ベンチマークは 1 セッションずつ実行するため差分で測れる
+        result->allocationsPerFrame = succeeded > 0
+            ? static_cast<double>(after.bufferAllocationCount - before.bufferAllocationCount) / succeeded : 0.0;
+        result->framesDropped = after.framesDropped;
+        result->cpuFallbacks = after.cpuFallbackCount;
+        return true;
+    }
+
+    void WriteCsv(FILE* out, const std::vector<CaseResult>& results)
+    {
+        std::fprintf(out, "mode,sourceWidth,sourceHeight,targetWidth,targetHeight,poolDepth,frames,failures,"
+            "fps,p50Us,p95Us,p99Us,maxUs,bytesPerFrame,allocationsPerFrame,framesDropped,cpuFallbacks\n");
+        for (const CaseResult& r : results)
+        {
+            std::fprintf(out, "%s,%d,%d,%d,%d,%d,%d,%d,%.2f,%lld,%lld,%lld,%lld,%.0f,%.4f,%lld,%lld\n",
+                r.mode, r.source.width, r.source.height, r.target.width, r.target.height, r.poolDepth,
+                r.frames, r.failures, r.fps, r.p50Us, r.p95Us, r.p99Us, r.maxUs,
+                r.bytesPerFrame, r.allocationsPerFrame, r.framesDropped, r.cpuFallbacks);
+        }
+    }
+
+    void WriteJson(FILE* out, const std::vector<CaseResult>& results)
+    {
+        std::fprintf(out, "[\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const CaseResult& r = results[i];
+            std::fprintf(out,
+                "  {\"mode\":\"%s\",\"sourceWidth\":%d,\"sourceHeight\":%d,\"targetWidth\":%d,\"targetHeight\":%d,"
+                "\"poolDepth\":%d,\"frames\":%d,\"failures\":%d,\"fps\":%.2f,\"p50Us\":%lld,\"p95Us\":%lld,"
+                "\"p99Us\":%lld,\"maxUs\":%lld,\"bytesPerFrame\":%.0f,\"allocationsPerFrame\":%.4f,"
+                "\"framesDropped\":%lld,\"cpuFallbacks\":%lld}%s\n",
+                r.mode, r.source.width, r.source.height, r.target.width, r.target.height, r.poolDepth,
+                r.frames, r.failures, r.fps, r.p50Us, r.p95Us, r.p99Us, r.maxUs,
+                r.bytesPerFrame, r.allocationsPerFrame, r.framesDropped, r.cpuFallbacks,
+                i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "]\n");
+    }
+
+    void RunMatrix(HWND hwnd, const Options& options, std::vector<CaseResult>* results)
+    {
+        for (Mode mode : options.modes)
+        {
+            if (mode == Mode::Streaming && !options.replayPath.empty())
+            {
+                std::fprintf(stderr, "streaming is not supported for replay sessions, skipped\n");
+                continue;
+            }
+
+            // 等倍キャプチャは出力サイズ・プール深さに依存しない
+            std::vector<Size> targets = (mode == Mode::Frame) ? std::vector<Size>{ { 0, 0 } } : options.targets;
+            std::vector<int> depths = (mode == Mode::Streaming) ? options.poolDepths : std::vector<int>{ 0 };
+
+            for (const Size& target : targets)
+            {
+                for (int depth : depths)
+                {
+                    CaseResult result;
+                    if (RunCase(hwnd, mode, target, depth, options, &result))
+                    {
+                        std::fprintf(stderr, "%-9s %4dx%-4d -> %4dx%-4d depth=%d  %.1f fps  p50=%lldus p99=%lldus\n",
+                            result.mode, result.source.width, result.source.height, target.width, target.height,
+                            result.poolDepth, result.fps, result.p50Us, result.p99Us);
+                        results->push_back(result);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+
+    if (!BaketaCapture_IsSupported())
+    {
+        std::fprintf(stderr, "Windows Graphics Capture is not supported on this system\n");
+        return 1;
+    }
+    if (BaketaCapture_Initialize() != BAKETA_CAPTURE_SUCCESS)
+    {
+        std::fprintf(stderr, "BaketaCapture_Initialize failed\n");
+        return 1;
+    }
+
+    if (!options.recordPath.empty())
+    {
+        bool recorded = false;
+        if (options.targetWindow || options.primaryMonitor)
+        {
+            recorded = RecordTarget(options.targetWindow, options);
+        }
+        else if (!options.resolutions.empty())
+        {
+            SyntheticWindow window;
+            if (window.Start(options.resolutions.front()))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));  // 初回表示・合成を待つ
+                recorded = RecordTarget(window.Handle(), options);
+            }
+        }
+        BaketaCapture_Shutdown();
+        return recorded ? 0 : 1;
+    }
+
+    std::vector<CaseResult> results;
+    if (options.targetWindow || options.primaryMonitor || !options.replayPath.empty())
+    {
+        RunMatrix(options.targetWindow, options, &results);
+    }
+    else
+    {
+        for (const Size& resolution : options.resolutions)
+        {
+            SyntheticWindow window;
+            if (!window.Start(resolution))
+            {
+                std::fprintf(stderr, "Failed to create synthetic window %dx%d\n", resolution.width, resolution.height);
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));  // 初回表示・合成を待つ
+            RunMatrix(window.Handle(), options, &results);
+        }
+    }
+
+    BaketaCapture_Shutdown();
+
+    FILE* out = stdout;
+    if (!options.outputPath.empty() && fopen_s(&out, options.outputPath.c_str(), "w") != 0)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    if (options.json)
+    {
+        WriteJson(out, results);
+    }
+    else
+    {
+        WriteCsv(out, results);
+    }
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return results.empty() ? 1 : 0;
+}
@@ -6,25 +6,257 @@ extern "C" {
 
 // エラーコード定義
 #define BAKETA_CAPTURE_SUCCESS 0
+#define BAKETA_CAPTURE_UNCHANGED 1  // 前回読み出したフレームから変化なし（フレームデータは返さない）
+#define BAKETA_CAPTURE_PENDING 2    // 非同期処理を開始した（完了はコールバック・イベントで通知）
 #define BAKETA_CAPTURE_ERROR_INVALID_WINDOW -1
 #define BAKETA_CAPTURE_ERROR_UNSUPPORTED -2
 #define BAKETA_CAPTURE_ERROR_ALREADY_EXISTS -3
 #define BAKETA_CAPTURE_ERROR_NOT_FOUND -4
 #define BAKETA_CAPTURE_ERROR_MEMORY -5
 #define BAKETA_CAPTURE_ERROR_DEVICE -6
+#define BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL -7  // 呼び出し側バッファの容量不足
 #define BAKETA_CAPTURE_ERROR_SEH_EXCEPTION -100  // [Issue #324] SEH例外（AccessViolation等）
 
+// エラー発生段階（BaketaCapture_GetLastErrorInfo）
+#define BAKETA_CAPTURE_STAGE_NONE 0          // エラーなし
+#define BAKETA_CAPTURE_STAGE_API 1           // 引数検証・セッション検索
+#define BAKETA_CAPTURE_STAGE_CAPTURE 2       // セッション内部のその他の処理
+#define BAKETA_CAPTURE_STAGE_DEVICE 3        // D3D11 デバイス作成・デバイス削除
+#define BAKETA_CAPTURE_STAGE_CAPTURE_ITEM 4  // GraphicsCaptureItem 作成
+#define BAKETA_CAPTURE_STAGE_FRAME_POOL 5    // フレームプール・キャプチャ開始
+#define BAKETA_CAPTURE_STAGE_FRAME_WAIT 6    // フレーム到着待ち
+#define BAKETA_CAPTURE_STAGE_READBACK 7      // ステージングテクスチャの作成・コピー・マップ
+#define BAKETA_CAPTURE_STAGE_GPU_PROCESS 8   // GPU リサイズ・変換・差分検出
+#define BAKETA_CAPTURE_STAGE_ALLOCATION 9    // 出力バッファ確保
+#define BAKETA_CAPTURE_STAGE_ENCODE 10       // ハードウェアエンコーダーの作成・エンコード
+
+// 段階別タイミング（BaketaCaptureStats.stages の添字）
+#define BAKETA_CAPTURE_TIMING_FRAME_WAIT 0      // フレーム到着待ち（ストリーミングは最新フレームの取得）
+#define BAKETA_CAPTURE_TIMING_COPY 1            // ステージングテクスチャへのコピー発行
+#define BAKETA_CAPTURE_TIMING_MAP 2             // Map 待ち（GPU コピー完了待ち）
+#define BAKETA_CAPTURE_TIMING_GPU_RESIZE 3      // GPU リサイズの発行（CPU 側）
+#define BAKETA_CAPTURE_TIMING_GPU_RESIZE_GPU 4  // GPU リサイズの GPU 実行時間（タイムスタンプクエリ）
+#define BAKETA_CAPTURE_TIMING_ROW_COPY 5        // マップしたメモリから出力バッファへのコピー
+#define BAKETA_CAPTURE_TIMING_ALLOCATION 6      // 出力バッファ確保
+#define BAKETA_CAPTURE_TIMING_TOTAL 7           // キャプチャ呼び出し全体
+#define BAKETA_CAPTURE_TIMING_STAGE_COUNT 8
+
+// 診断ログレベル
+#define BAKETA_CAPTURE_DIAG_OFF 0      // 診断ログなし（既定）
+#define BAKETA_CAPTURE_DIAG_BASIC 1    // フォールバック等の低頻度イベントのみ
+#define BAKETA_CAPTURE_DIAG_VERBOSE 2  // 毎フレームのテクスチャ・ピクセル詳細
+
+// リサイズフィルター（BaketaCapture_CaptureFrameScaled）
+#define BAKETA_CAPTURE_FILTER_BILINEAR 0  // バイリニア（最速、大きな縮小では細かな文字がエイリアスする）
+#define BAKETA_CAPTURE_FILTER_AREA 1      // 面積平均（ボックス、縮小時の文字認識向け）
+#define BAKETA_CAPTURE_FILTER_LANCZOS2 2  // Lanczos-2（輪郭を保つ、最も重い）
+#define BAKETA_CAPTURE_MAX_SCALED_OUTPUTS 4
+
+// 出力ピクセルフォーマット（BaketaCapture_CaptureFrameEx）
+#define BAKETA_CAPTURE_FORMAT_BGRA32 0  // 4 バイト BGRA（BaketaCaptureFrame と同じ）
+#define BAKETA_CAPTURE_FORMAT_GRAY8 1   // 1 バイト輝度（BT.601 係数）
+#define BAKETA_CAPTURE_FORMAT_BGR24 2   // 3 バイト BGR（パック、アルファなし）
+#define BAKETA_CAPTURE_FORMAT_NV12 3    // Y プレーン + UV インターリーブプレーン（BT.709 リミテッドレンジ、幅・高さは偶数）
+
+// ハードウェアエンコーダーのコーデック（BaketaCapture_StartEncoder）
+#define BAKETA_CAPTURE_CODEC_H264 0  // H.264 Main（Annex B）
+#define BAKETA_CAPTURE_CODEC_HEVC 1  // HEVC Main（Annex B）
+
+// 記録ファイルのリプレイ（BaketaCapture_CreateReplaySession、組み合わせ可）
+#define BAKETA_CAPTURE_REPLAY_RECORDED_TIMING 0x0  // 記録時の提示間隔どおりにフレームを出す（遅れた分は読み飛ばす）
+#define BAKETA_CAPTURE_REPLAY_MAX_SPEED 0x1        // 呼び出しごとに次のフレームを待たずに出す（読み飛ばしなし）
+#define BAKETA_CAPTURE_REPLAY_LOOP 0x2             // 最後のフレームの後は先頭へ戻る（無い場合は以降のキャプチャが失敗する）
+
+// 最後のエラーの詳細（BaketaCapture_GetLastErrorInfo、呼び出しスレッドごと）
+typedef struct {
+    int stage;                  // BAKETA_CAPTURE_STAGE_*
+    int hresult;                // 失敗した API の HRESULT（無い場合は 0）
+    int sessionId;              // エラーを記録したセッション（エクスポート層のエラーは 0）
+    int messageLength;          // BaketaCapture_GetLastError で取得できるメッセージ長
+} BaketaCaptureErrorInfo;
+
+// 段階別タイミング統計（マイクロ秒）
+typedef struct {
+    long long count;            // サンプル数
+    int p50Us;                  // 中央値
+    int p95Us;                  // 95 パーセンタイル
+    int p99Us;                  // 99 パーセンタイル
+    int maxUs;                  // 最大値
+    long long totalUs;          // 合計（平均 = totalUs / count）
+} BaketaCaptureStageTiming;
+
+// セッション統計（BaketaCapture_GetSessionStats）
+typedef struct {
+    BaketaCaptureStageTiming stages[BAKETA_CAPTURE_TIMING_STAGE_COUNT];  // BAKETA_CAPTURE_TIMING_* 別
+    long long framesArrived;    // WGC から到着したフレーム数
+    long long framesDelivered;  // 読み出しに成功したキャプチャ呼び出し数
+    long long framesDropped;    // 読み出される前に置き換えられた・間引かれたフレーム数
+    long long cpuFallbackCount; // GPU 処理が使えず CPU 処理に切り替えた回数
+    long long captureFailures;  // 失敗したキャプチャ呼び出し数
+    long long bufferReuseCount; // 出力バッファプールの再利用数（プロセス共通）
+    long long bufferAllocationCount; // 出力バッファプールの新規確保数（プロセス共通）
+} BaketaCaptureStats;
+
 // フレームデータ構造体
 typedef struct {
     unsigned char* bgraData;    // BGRA ピクセルデータ
     int width;                  // 幅 (リサイズ後)
     int height;                 // 高さ (リサイズ後)
     int stride;                 // 行バイト数
-    long long timestamp;        // キャプチャ時刻 (100ns 単位)
+    long long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
     int originalWidth;          // 🚀 [Issue #193] 元のキャプチャ幅 (リサイズ前)
     int originalHeight;         // 🚀 [Issue #193] 元のキャプチャ高さ (リサイズ前)
+    unsigned long long sequence; // セッション内のフレーム通し番号（同じ値は同じフレーム、間引かれたフレームも番号を消費する）
 } BaketaCaptureFrame;
 
+// フォーマット指定付きフレームデータ構造体（BaketaCapture_CaptureFrameEx / BaketaCapture_ReleaseFrameEx）
+typedef struct {
+    unsigned char* data;        // ピクセルデータ（format に応じたレイアウト）
+    int width;                  // 幅 (リサイズ後)
+    int height;                 // 高さ (リサイズ後)
+    int stride;                 // 行バイト数（NV12 は Y プレーン）
+    long long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
+    int originalWidth;          // 元のキャプチャ幅 (リサイズ前)
+    int originalHeight;         // 元のキャプチャ高さ (リサイズ前)
+    int format;                 // BAKETA_CAPTURE_FORMAT_*
+    int dataSize;               // data 全体のバイト数
+    int uvOffset;               // NV12: UV プレーン先頭のバイトオフセット（他フォーマットは 0）
+    int uvStride;               // NV12: UV プレーンの行バイト数（他フォーマットは 0）
+    unsigned long long sequence; // セッション内のフレーム通し番号
+} BaketaCaptureFrameEx;
+
+// 矩形（ピクセル座標）
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} BaketaCaptureRect;
+
+// ROI キャプチャの要求と結果（BaketaCapture_CaptureRegions）
+typedef struct {
+    BaketaCaptureRect source;   // [入力] ウィンドウ内の領域（元のキャプチャ解像度）
+    int targetWidth;            // [入力] 出力幅（0 で等倍）
+    int targetHeight;           // [入力] 出力高さ（0 で等倍）
+    int offset;                 // [出力] 出力バッファ先頭からのバイトオフセット（領域がフレーム外の場合は -1）
+    int width;                  // [出力] 出力幅
+    int height;                 // [出力] 出力高さ
+    int stride;                 // [出力] 行バイト数（幅 * 4）
+} BaketaCaptureRegion;
+
+// 複数スケール出力の要求と結果（BaketaCapture_CaptureFrameScaled）
+typedef struct {
+    int targetWidth;            // [入力] 出力幅（0 で targetHeight からアスペクト比維持）
+    int targetHeight;           // [入力] 出力高さ（0 で targetWidth からアスペクト比維持）
+    int offset;                 // [出力] 出力バッファ先頭からのバイトオフセット
+    int width;                  // [出力] 出力幅
+    int height;                 // [出力] 出力高さ
+    int stride;                 // [出力] 行バイト数（幅 * 4）
+} BaketaCaptureScaledOutput;
+
+// タイル変化検出結果
+typedef struct {
+    int tileSize;               // タイル一辺のピクセル数（元のキャプチャ解像度基準）
+    int tileColumns;            // タイル列数
+    int tileRows;               // タイル行数
+    int dirtyTileCount;         // 変化したタイル数
+} BaketaCaptureTileInfo;
+
+// エッジ密度マップの情報（BaketaCapture_CaptureEdgeMap）
+typedef struct {
+    int cellSize;               // セル一辺のピクセル数（元のキャプチャ解像度基準）
+    int columns;                // セル列数
+    int rows;                   // セル行数
+    int dataSize;               // マップのバイト数（columns * rows、容量不足時も設定）
+    long long timestamp;        // マップを作成したフレームの提示時刻
+    unsigned long long sequence; // マップを作成したフレームの通し番号
+} BaketaCaptureEdgeMapInfo;
+
+// 共有メモリフレームリング（BaketaCapture_EnableSharedRing）
+// マッピング先頭に BaketaCaptureRingHeader（headerSize バイト）、続いて slotCount 個のスロット（slotStride バイト間隔）を置く
+// スロットは BaketaCaptureRingSlot（slotHeaderSize バイト）の後にピクセルデータが続く。フレームIDのスロット番号は frameId % slotCount
+// 消費側の読み出し手順: seq を読む（奇数なら書き込み中）→ frameId が一致するか確認 → データを参照 → seq を再度読み、変わっていなければ有効
+#define BAKETA_CAPTURE_RING_MAGIC 0x474E5242  // "BRNG"（リトルエンディアン）
+#define BAKETA_CAPTURE_RING_VERSION 1
+
+typedef struct {
+    unsigned int magic;         // BAKETA_CAPTURE_RING_MAGIC（レイアウト初期化後に設定される）
+    unsigned int version;       // BAKETA_CAPTURE_RING_VERSION
+    unsigned int slotCount;     // スロット数
+    unsigned int slotStride;    // スロット間隔（バイト、64 の倍数）
+    unsigned int headerSize;    // このヘッダーのバイト数（最初のスロットのオフセット）
+    unsigned int slotHeaderSize; // スロットヘッダーのバイト数（スロット先頭からピクセルデータまで）
+    unsigned int maxFrameBytes; // 1 フレームの最大バイト数
+    unsigned int reserved;
+    long long latestFrameId;    // 最後に書き込んだフレームID（0 はフレームなし、アトミックに更新）
+} BaketaCaptureRingHeader;
+
+typedef struct {
+    long long seq;              // seqlock カウンタ（奇数は書き込み中、アトミックに更新）
+    unsigned long long frameId; // このスロットのフレームID（0 は無効）
+    unsigned long long sequence; // セッション内のフレーム通し番号
+    long long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
+    int width;                  // 幅 (リサイズ後)
+    int height;                 // 高さ (リサイズ後)
+    int stride;                 // 行バイト数
+    int format;                 // BAKETA_CAPTURE_FORMAT_*（現在は BGRA32 のみ）
+    int dataSize;               // ピクセルデータのバイト数
+    int originalWidth;          // 元のキャプチャ幅 (リサイズ前)
+    int originalHeight;         // 元のキャプチャ高さ (リサイズ前)
+    int reserved;
+} BaketaCaptureRingSlot;
+
+// GPU 共有フレーム（BaketaCapture_ExportSharedFrame）
+// 消費側は同じアダプターのデバイスで sharedHandle を開き（ID3D12Device::OpenSharedHandle / ID3D11Device1::OpenSharedResource1）、
+// IDXGIKeyedMutex::AcquireSync(acquireKey) で取得して読み出した後、ReleaseSync(releaseKey) で返却する
+typedef struct {
+    void* sharedHandle;         // テクスチャの NT 共有ハンドル（ライブラリ所有、閉じないこと。別プロセスへは DuplicateHandle で渡す）
+    int slot;                   // プール内のスロット番号（0〜2、開いたテクスチャのキャッシュキー）
+    int width;                  // 幅 (リサイズ後)
+    int height;                 // 高さ (リサイズ後)
+    int dxgiFormat;             // DXGI_FORMAT（DXGI_FORMAT_B8G8R8A8_UNORM）
+    unsigned long long acquireKey;  // 消費側が AcquireSync に渡すキー
+    unsigned long long releaseKey;  // 消費側が ReleaseSync に渡すキー
+    long long timestamp;        // 提示時刻 (WGC SystemRelativeTime、QPC 基準の 100ns 単位)
+    int originalWidth;          // 元のキャプチャ幅 (リサイズ前)
+    int originalHeight;         // 元のキャプチャ高さ (リサイズ前)
+    unsigned long long sequence; // セッション内のフレーム通し番号
+    unsigned long long generation; // プールの世代（変化した場合はテクスチャが作り直されており、開き直しが必要）
+    unsigned int adapterLuidLow;    // テクスチャを作成したアダプターの LUID（LowPart）
+    int adapterLuidHigh;            // テクスチャを作成したアダプターの LUID（HighPart）
+} BaketaCaptureSharedFrame;
+
+// ハードウェアエンコーダーの設定（BaketaCapture_StartEncoder）
+typedef struct {
+    int codec;                  // BAKETA_CAPTURE_CODEC_*
+    int targetWidth;            // 出力幅の上限（0 でリサイズなし、アスペクト比を維持して縮小のみ、偶数に切り下げ）
+    int targetHeight;           // 出力高さの上限（0 でリサイズなし）
+    int bitrateKbps;            // 目標ビットレート（CBR、kbps）
+    int frameRate;              // 想定フレームレート（レート制御用）
+    int keyframeInterval;       // キーフレーム間隔（フレーム数、0 でエンコーダー既定）
+} BaketaCaptureEncoderConfig;
+
+// エンコード済みパケット（BaketaCapture_ReadEncodedPacket）
+// データは Annex B 形式で、キーフレームにはパラメーターセット（SPS / PPS、HEVC は VPS も）が含まれる
+typedef struct {
+    int dataSize;               // パケットのバイト数（バッファ不足時も設定される）
+    int codec;                  // BAKETA_CAPTURE_CODEC_*
+    int width;                  // 符号化サイズ（幅）
+    int height;                 // 符号化サイズ（高さ）
+    int isKeyframe;             // 1 でキーフレーム（IDR）
+    int discontinuity;          // 1 の場合、読み出し遅れで直前までのパケットを破棄した（このパケットはキーフレーム）
+    long long timestamp;        // 対応するキャプチャフレームの提示時刻 (100ns 単位)
+    unsigned long long sequence; // 対応するキャプチャフレームの通し番号
+} BaketaCaptureEncodedPacket;
+
+// フレーム到着コールバック（WGC のフレーム到着スレッドから呼ばれる）
+// コールバック内で SetFrameCallback / ReleaseSession を呼ばないこと
+typedef void (*BaketaCaptureFrameCallback)(int sessionId, long long timestamp, void* userData);
+
+// 非同期セッション作成の完了コールバック（作成ワーカースレッドから呼ばれる）
+// result は BaketaCapture_CreateSession と同じ結果コード、失敗時はこのスレッドで BaketaCapture_GetLastError が詳細を返す
+typedef void (*BaketaCaptureSessionCallback)(void* hwnd, int result, int sessionId, void* userData);
+
 /// <summary>
 /// ライブラリの初期化
 /// </summary>
@@ -44,6 +276,58 @@ __declspec(dllexport) void BaketaCapture_Shutdown();
 /// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
 __declspec(dllexport) int BaketaCapture_CreateSession(void* hwnd, int* sessionId);
 
+/// <summary>
+/// ウィンドウキャプチャセッションをバックグラウンドで作成（呼び出し側をブロックしない）
+/// D3D デバイス作成・GraphicsCaptureItem 作成（バックオフ付きリトライ）・フレームプール作成をワーカースレッドで行い、
+/// 完了時に callback を呼び、completionEvent をシグナルする。既存セッションがあれば即座に BAKETA_CAPTURE_SUCCESS を返す（通知なし）
+/// 同じウィンドウの作成が実行中の場合は新たに作成せず、その完了時に一緒に通知する
+/// イベントで完了を受け取った場合は、同じ引数で再度呼び出すと結果（セッションID または失敗コード）を即座に返す
+/// </summary>
+/// <param name="hwnd">対象ウィンドウハンドル</param>
+/// <param name="callback">完了コールバック（省略可）</param>
+/// <param name="userData">コールバックに渡すユーザーデータ</param>
+/// <param name="completionEvent">完了時にシグナルするイベント（省略可、内部で複製するため呼び出し後に閉じてよい）</param>
+/// <param name="sessionId">既存セッションのID（出力、BAKETA_CAPTURE_SUCCESS の場合のみ設定）</param>
+/// <returns>既存セッションがあれば BAKETA_CAPTURE_SUCCESS、作成を開始・実行中なら BAKETA_CAPTURE_PENDING</returns>
+__declspec(dllexport) int BaketaCapture_CreateSessionAsync(void* hwnd, BaketaCaptureSessionCallback callback, void* userData, void* completionEvent, int* sessionId);
+
+/// <summary>
+/// ウィンドウのキャプチャセッションをバックグラウンドで事前作成（初回キャプチャまでの待ち時間短縮）
+/// D3D デバイス・フレームプール・GPU リサイズリソースを作成して登録し、後の BaketaCapture_CreateSession はそれを再利用する
+/// キャプチャ自体は開始しない。事前作成の失敗は報告せず、BaketaCapture_CreateSession が通常どおり作成してエラーを返す
+/// </summary>
+/// <param name="hwnd">対象ウィンドウハンドル</param>
+/// <returns>事前作成を開始した（または実行中の）場合は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_Prewarm(void* hwnd);
+
+/// <summary>
+/// モニター（またはその一部の矩形）のキャプチャセッションを作成
+/// 排他フルスクリーン相当のゲームや複数ウィンドウのアプリ向け。同じモニターのセッションは1つの WGC フレームプールを共有し、
+/// 矩形はセッションごとに GPU 上で切り出すため、以降の CaptureFrame / CaptureFrameResized / CaptureRegions 等は切り出した画像を対象とする
+/// 矩形は物理ピクセルのスクリーン座標（Per-Monitor DPI Aware のプロセスで取得した値）
+/// ストリーミングモード・DirtyRegions・フレームイベント／コールバックは非対応
+/// </summary>
+/// <param name="monitor">対象モニターの HMONITOR（nullptr の場合は screenRect を含むモニター）</param>
+/// <param name="screenRect">切り出すスクリーン矩形（nullptr でモニター全体、モニター外の部分は切り捨て）</param>
+/// <param name="sessionId">セッションID（出力、BaketaCapture_ReleaseSession で解放）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_CreateMonitorSession(void* monitor, const BaketaCaptureRect* screenRect, int* sessionId);
+
+/// <summary>
+/// 記録ファイル（BaketaCapture_StartRecording で作成）を再生するリプレイセッションを作成
+/// ベンチマーク・回帰テスト向けに同じフレーム列を決定的に再現する。記録ファイルはメモリマップして必要なフレームのみ展開し、
+/// GPU テクスチャへアップロードした後は CaptureFrame / CaptureFrameResized / CaptureRegions / CaptureFrameDirty 等が
+/// ウィンドウセッションと同じ経路で処理する（変化矩形は記録時のものを返し、DirtyRegions の有効化は不要）
+/// 最後のフレームの後は BAKETA_CAPTURE_REPLAY_LOOP が無ければキャプチャが失敗する
+/// （BaketaCapture_GetLastErrorInfo の stage が BAKETA_CAPTURE_STAGE_FRAME_WAIT、hresult が HRESULT_FROM_WIN32(ERROR_HANDLE_EOF)）
+/// ストリーミングモード・フレームイベント／コールバックは非対応
+/// </summary>
+/// <param name="path">記録ファイルのパス</param>
+/// <param name="flags">BAKETA_CAPTURE_REPLAY_* の組み合わせ</param>
+/// <param name="sessionId">セッションID（出力、BaketaCapture_ReleaseSession で解放）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、ファイルが無い場合は BAKETA_CAPTURE_ERROR_NOT_FOUND、形式が不正な場合は BAKETA_CAPTURE_ERROR_UNSUPPORTED</returns>
+__declspec(dllexport) int BaketaCapture_CreateReplaySession(const wchar_t* path, int flags, int* sessionId);
+
 /// <summary>
 /// フレームをキャプチャ
 /// </summary>
@@ -64,12 +348,352 @@ __declspec(dllexport) int BaketaCapture_CaptureFrame(int sessionId, BaketaCaptur
 /// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
 __declspec(dllexport) int BaketaCapture_CaptureFrameResized(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs);
 
+/// <summary>
+/// 複数セッションのフレームをまとめてキャプチャ（必要に応じてGPU側でリサイズ）
+/// 全セッションの GPU 処理を発行してから順にマップするため、CaptureFrameResized を個別に呼ぶより GPU 待ちが重なる
+/// 各セッションの結果は statusCodes に格納され、成功したフレームはそれぞれ BaketaCapture_ReleaseFrame で解放する
+/// </summary>
+/// <param name="sessionIds">セッションID配列（同じIDの重複指定は BAKETA_CAPTURE_ERROR_ALREADY_EXISTS）</param>
+/// <param name="count">セッション数</param>
+/// <param name="outFrames">キャプチャフレーム配列（出力、count 要素）</param>
+/// <param name="statusCodes">セッションごとの結果コード配列（出力、count 要素）</param>
+/// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+/// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+/// <param name="timeoutMs">バッチ全体のフレーム到着待ちタイムアウト（ミリ秒）</param>
+/// <returns>全セッション成功時は BAKETA_CAPTURE_SUCCESS、それ以外は最初に失敗したセッションの結果コード</returns>
+__declspec(dllexport) int BaketaCapture_CaptureBatch(const int* sessionIds, int count, BaketaCaptureFrame* outFrames, int* statusCodes, int targetWidth, int targetHeight, int timeoutMs);
+
+/// <summary>
+/// 呼び出し側が用意したバッファへフレームをキャプチャ（必要に応じてGPU側でリサイズ）
+/// 出力は stride = 幅 * 4 で詰めて書き込まれる。frame->bgraData は buffer を指し、ReleaseFrame は不要
+/// 容量は前回読み出したフレームサイズで事前に確認し、不足する場合はフレームを取得せずに BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL を返す
+/// （初回・フレームサイズが変わった直後・解像度自動調整中は読み出し後に判明するため、そのフレームは失われる）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">キャプチャフレーム（出力）</param>
+/// <param name="buffer">出力先バッファ（ピン留め済みであること）</param>
+/// <param name="bufferSize">バッファ容量（バイト）</param>
+/// <param name="requiredSize">必要バイト数（出力・省略可）。容量不足時に設定される</param>
+/// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+/// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、容量不足時は BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL</returns>
+__declspec(dllexport) int BaketaCapture_CaptureFrameInto(int sessionId, BaketaCaptureFrame* frame, unsigned char* buffer, int bufferSize, int* requiredSize, int targetWidth, int targetHeight, int timeoutMs);
+
+/// <summary>
+/// 前回このAPIで読み出したフレームから変化がある場合のみフレームをキャプチャ
+/// GPU 上で 32x32 タイル単位に比較し、変化がなければステージングコピー・Map を行わない
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">フレームデータ（出力）。変化なしの場合はクリアされたまま</param>
+/// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+/// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+/// <param name="threshold">ピクセル変化とみなす B+G+R 差分絶対値の合計（0〜765、0 で任意の変化）</param>
+/// <param name="tileInfo">タイル検出結果（出力・省略可）</param>
+/// <param name="dirtyBitmap">変化タイルのビットマップ（出力・省略可）。タイル番号 = 行 * 列数 + 列、32 タイル / ワード、LSB 先頭</param>
+/// <param name="dirtyBitmapWords">ビットマップのワード数（不足分は切り捨て）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>変化ありは BAKETA_CAPTURE_SUCCESS、変化なしは BAKETA_CAPTURE_UNCHANGED、失敗時は負のエラーコード</returns>
+__declspec(dllexport) int BaketaCapture_CaptureFrameIfChanged(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int threshold, BaketaCaptureTileInfo* tileInfo, unsigned int* dirtyBitmap, int dirtyBitmapWords, int timeoutMs);
+
+/// <summary>
+/// 複数の ROI のみをキャプチャ
+/// GPU 上で各 ROI を1枚のアトラスへ切り出し（targetWidth/Height 指定時はシェーダーでリサイズ）、1回の Map で読み出す
+/// frame->bgraData に ROI ごとの BGRA データが連続して格納され、各 ROI の位置は regions[i].offset / stride で示す
+/// frame->width / height は元のキャプチャサイズ、frame->stride はバッファ全体のバイト数
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="regions">ROI の要求と結果</param>
+/// <param name="count">ROI 数</param>
+/// <param name="frame">フレームデータ（出力、BaketaCapture_ReleaseFrame で解放）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_CaptureRegions(int sessionId, BaketaCaptureRegion* regions, int count, BaketaCaptureFrame* frame, int timeoutMs);
+
+/// <summary>
+/// 文字領域候補のエッジ密度マップを作成（frame 指定時は同じフレームも併せてキャプチャ）
+/// GPU 上で 16x16 セルごとに輝度 Sobel 勾配の平均と輝度の標準偏差を求め、1 セル 1 バイト（0〜255）に量子化したマップのみを読み戻す
+/// 値が大きいセルほど文字・細かな輪郭が密集しており、テキスト検出の対象領域の絞り込みに使える
+/// フィーチャーレベル 11_0 未満のデバイスでは失敗する
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">フレームデータ（出力・省略可、BaketaCapture_ReleaseFrame で解放）。nullptr の場合はマップのみ作成する</param>
+/// <param name="targetWidth">フレームのターゲット幅（0の場合はリサイズなし、マップは常に元のキャプチャ解像度基準）</param>
+/// <param name="targetHeight">フレームのターゲット高さ（0の場合はリサイズなし）</param>
+/// <param name="densityMap">マップの出力先（セル番号 = 行 * 列数 + 列）</param>
+/// <param name="densityMapSize">densityMap の容量（バイト）</param>
+/// <param name="mapInfo">マップの情報（出力・省略可）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、容量不足時は BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL（mapInfo->dataSize に必要サイズ）</returns>
+__declspec(dllexport) int BaketaCapture_CaptureEdgeMap(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, unsigned char* densityMap, int densityMapSize, BaketaCaptureEdgeMapInfo* mapInfo, int timeoutMs);
+
+/// <summary>
+/// フィルターを指定して1〜4個のサイズへ同時にリサイズしキャプチャ（コンピュートシェーダー1回の Dispatch・1回の Map）
+/// 例: 検出用 1/4 と認識用 1/2 を同時に得る
+/// frame->bgraData に出力ごとの BGRA データが連続して格納され、各出力の位置は outputs[i].offset / stride で示す
+/// frame->width / height は元のキャプチャサイズ、frame->stride はバッファ全体のバイト数
+/// フィーチャーレベル 11_0 未満のデバイスでは失敗する
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="filter">BAKETA_CAPTURE_FILTER_*</param>
+/// <param name="outputs">出力サイズの要求と結果</param>
+/// <param name="count">出力数（1〜BAKETA_CAPTURE_MAX_SCALED_OUTPUTS）</param>
+/// <param name="frame">フレームデータ（出力、BaketaCapture_ReleaseFrame で解放）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_CaptureFrameScaled(int sessionId, int filter, BaketaCaptureScaledOutput* outputs, int count, BaketaCaptureFrame* frame, int timeoutMs);
+
+/// <summary>
+/// 出力フォーマットを指定してキャプチャ（読み出し前に GPU 上で変換し、転送量を削減する）
+/// GRAY8 / BGR24 / NV12 はフィーチャーレベル 11_0 以上が必要。NV12 は出力サイズを偶数に切り下げる
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">フレームデータ（出力、BaketaCapture_ReleaseFrameEx で解放）</param>
+/// <param name="format">BAKETA_CAPTURE_FORMAT_*</param>
+/// <param name="targetWidth">ターゲット幅（0 で等倍、アスペクト比を維持して縮小のみ）</param>
+/// <param name="targetHeight">ターゲット高さ（0 で等倍）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_CaptureFrameEx(int sessionId, BaketaCaptureFrameEx* frame, int format, int targetWidth, int targetHeight, int timeoutMs);
+
+/// <summary>
+/// 最新フレームを GPU 共有テクスチャへコピーして NT ハンドルで渡す（CPU への読み出し・消費側での再アップロードを省く）
+/// 3 枚のキー付きミューテックス付き共有テクスチャを循環させる。消費側が返却済みのスロットを優先し、
+/// 全スロットが消費側待ちの場合は消費側がまだ取得していない最も古いフレームを上書きするため、受け取ったフレームは速やかに取得すること
+/// 消費側が全スロットを保持している場合は失敗する。ハンドルはプールの世代が変わるかセッション解放まで有効
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">共有フレーム（出力、解放不要）</param>
+/// <param name="targetWidth">ターゲット幅（0 で等倍、アスペクト比を維持して縮小のみ）</param>
+/// <param name="targetHeight">ターゲット高さ（0 で等倍）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_ExportSharedFrame(int sessionId, BaketaCaptureSharedFrame* frame, int targetWidth, int targetHeight, int timeoutMs);
+
+/// <summary>
+/// セッションの共有メモリフレームリングを作成（プロセス外の消費側へフレームIDだけを渡すため）
+/// 以降の BaketaCapture_CaptureToSharedRing はキャプチャ結果をリングのスロットへ直接書き込む
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="name">マッピング名（例: L"Local\BaketaFrames"、同名のマッピングが既にあれば BAKETA_CAPTURE_ERROR_ALREADY_EXISTS）</param>
+/// <param name="slotCount">スロット数（2〜64）</param>
+/// <param name="maxFrameBytes">1 フレームの最大バイト数（幅 * 4 * 高さ、超えるフレームは BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS（既存のリングは置き換える）</returns>
+__declspec(dllexport) int BaketaCapture_EnableSharedRing(int sessionId, const wchar_t* name, int slotCount, int maxFrameBytes);
+
+/// <summary>
+/// セッションの共有メモリフレームリングを閉じる（消費側が開いている間はマッピング自体は残る）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_DisableSharedRing(int sessionId);
+
+/// <summary>
+/// フレームをキャプチャして共有メモリリングの次のスロットへ直接書き込む（必要に応じてGPU側でリサイズ）
+/// 出力は stride = 幅 * 4 の BGRA。frame->bgraData はこのプロセス内のスロットを指し、ReleaseFrame は不要
+/// スロットは slotCount 回後のキャプチャで上書きされる
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">書き込んだフレームの情報（出力）</param>
+/// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+/// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <param name="frameId">消費側へ渡すフレームID（出力）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、リング未作成は BAKETA_CAPTURE_ERROR_NOT_FOUND</returns>
+__declspec(dllexport) int BaketaCapture_CaptureToSharedRing(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs, unsigned long long* frameId);
+
+/// <summary>
+/// ハードウェアエンコーダー（Media Foundation）を開始（既存のエンコーダーは置き換える）
+/// エンコーダーは最初の BaketaCapture_EncodeFrame で出力サイズが決まった時点で作成し、ウィンドウサイズの変化で出力サイズが
+/// 変わった場合は作り直す（新しいサイズの最初のパケットはキーフレーム）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="config">エンコード設定</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、ハードウェアエンコーダーが無い場合は BAKETA_CAPTURE_ERROR_UNSUPPORTED</returns>
+__declspec(dllexport) int BaketaCapture_StartEncoder(int sessionId, const BaketaCaptureEncoderConfig* config);
+
+/// <summary>
+/// ハードウェアエンコーダーを停止（未読パケットも破棄する）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_StopEncoder(int sessionId);
+
+/// <summary>
+/// フレームを取得して GPU 上で出力サイズの NV12 へ変換し、ハードウェアエンコーダーへ入力する（CPU への読み出しは行わない）
+/// 出力パケットは BaketaCapture_ReadEncodedPacket で読み出す。timeoutMs 内に出力されなかったパケットは後で読み出せる
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="forceKeyframe">1 でこのフレームをキーフレームにする（受信側の途中参加・パケット欠落からの復帰用）</param>
+/// <param name="timeoutMs">フレーム到着・エンコーダー入力・出力の待機上限（ミリ秒）</param>
+/// <param name="queuedPackets">呼び出し後の未読パケット数（出力・省略可）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_EncodeFrame(int sessionId, int forceKeyframe, int timeoutMs, int* queuedPackets);
+
+/// <summary>
+/// 最も古い未読のエンコード済みパケットを読み出す
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="buffer">パケットの書き込み先</param>
+/// <param name="bufferSize">buffer のバイト数</param>
+/// <param name="packet">パケット情報（出力）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、未読パケットが無い場合は BAKETA_CAPTURE_PENDING、
+/// バッファ不足時は BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL（packet->dataSize に必要サイズ、パケットは残る）</returns>
+__declspec(dllexport) int BaketaCapture_ReadEncodedPacket(int sessionId, unsigned char* buffer, int bufferSize, BaketaCaptureEncodedPacket* packet);
+
+/// <summary>
+/// 変化矩形のみを読み出して永続フレームを更新しキャプチャ
+/// frame->bgraData はセッション所有の永続フレームを指し、次の CaptureFrameDirty 呼び出しか
+/// セッション解放まで有効（ReleaseFrame は不要・呼んでも解放されない）
+/// 初回・サイズ変更時・OS が DirtyRegions 非対応の場合はフレーム全体を1矩形として返す
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frame">フレームデータ（出力）</param>
+/// <param name="dirtyRects">今回更新された矩形（出力）</param>
+/// <param name="maxRects">dirtyRects の容量（超過時は外接矩形1つにまとめる）</param>
+/// <param name="rectCount">更新された矩形数（出力、0 は前回から変化なし）</param>
+/// <param name="timeoutMs">タイムアウト時間（ミリ秒）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_CaptureFrameDirty(int sessionId, BaketaCaptureFrame* frame, BaketaCaptureRect* dirtyRects, int maxRects, int* rectCount, int timeoutMs);
+
+/// <summary>
+/// WGC の DirtyRegions 収集を有効化・無効化（無効時の CaptureFrameDirty は常に全体読み出し）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="enabled">1 で有効、0 で無効</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、OS 非対応時は BAKETA_CAPTURE_ERROR_UNSUPPORTED</returns>
+__declspec(dllexport) int BaketaCapture_SetDirtyRegionMode(int sessionId, int enabled);
+
+/// <summary>
+/// 計測レイテンシに基づく解像度の自動調整を設定（BaketaCapture_CaptureFrameResized / CaptureToSharedRing が対象）
+/// 有効時は targetWidth / targetHeight を上限（0 は元サイズ）として扱い、フレーム待ちを除く読み出し時間が
+/// 予算に収まるよう縮小率を調整する。初期スケールはキャプチャデバイスのアダプタ（統合 GPU・専用 VRAM 量）から決める
+/// 選択したスケールは frame->width / frame->originalWidth（高さも同様）で分かる
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="latencyBudgetUs">1 回の読み出しに許容する時間（マイクロ秒、0 以下で無効化）</param>
+/// <param name="minScale">文字の可読性を保つ最小スケール（0.0 より大きく 1.0 以下）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、minScale が範囲外の場合は BAKETA_CAPTURE_ERROR_INVALID_WINDOW</returns>
+__declspec(dllexport) int BaketaCapture_SetAdaptiveResolution(int sessionId, int latencyBudgetUs, float minScale);
+
+/// <summary>
+/// ウィンドウ状態によるキャプチャの自動停止を設定（ウィンドウセッションは既定で有効）
+/// 最小化・DWM クローク（別の仮想デスクトップ等）・非表示の間は WGC セッションを閉じて保持中のフレームを解放し、
+/// キャプチャ呼び出しは待機せずに失敗する（BaketaCapture_GetLastErrorInfo の stage が BAKETA_CAPTURE_STAGE_FRAME_WAIT、
+/// hresult が HRESULT_FROM_WIN32(ERROR_NOT_READY)）。前面ウィンドウに完全に覆われている間は受け取るフレームを 1fps に間引く
+/// 復帰時は呼び出しを待たずにキャプチャを再開する。ウィンドウのサイズ変更時はフレームプールを新しいサイズで作り直す（常に有効）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="enabled">1 で有効、0 で無効</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、モニター・領域セッションは BAKETA_CAPTURE_ERROR_UNSUPPORTED</returns>
+__declspec(dllexport) int BaketaCapture_SetAutoSuspend(int sessionId, int enabled);
+
+/// <summary>
+/// パイプライン読み出しを設定（既定は無効、BaketaCapture_CaptureFrame / CaptureFrameResized / CaptureFrameInto が対象）
+/// 有効時はフレーム到着時に直近の呼び出しと同じ目標サイズでステージングテクスチャへのコピー（必要なら GPU リサイズも）を
+/// 発行しておき、キャプチャ呼び出しはコピー済みのテクスチャを待たずにマップする（ステージングテクスチャは最大 3 枚）
+/// 最新フレームのコピーが未完了の場合は完了済みの 1 つ前のフレームを返す（frame->timestamp / sequence はそのフレームの値）
+/// 読まれないフレームもコピーされるため、読み出し頻度がフレームレートより大幅に低い場合は SetMinFrameInterval と併用する
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="enabled">1 で有効、0 で無効</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、領域・リプレイセッションは BAKETA_CAPTURE_ERROR_UNSUPPORTED</returns>
+__declspec(dllexport) int BaketaCapture_SetPipelinedReadback(int sessionId, int enabled);
+
+/// <summary>
+/// セッションで読み出したフレームの記録を開始（BaketaCapture_CreateReplaySession で再生できる）
+/// 以降のキャプチャ呼び出しごとに等倍の BGRA フレーム（HDR は SDR へトーンマップ済み）を提示時刻・通し番号・
+/// 前回記録したフレームからの変化矩形（DirtyRegions 有効時）とともに圧縮して追記する。同じフレームは1回のみ記録する
+/// 記録中のキャプチャに加わるのは等倍のステージングコピーのみで、圧縮・書き込みは書き込みスレッドで行う
+/// 書き込みが追いつかない間のフレームは記録しない（次に記録するフレームの変化矩形は前回記録したフレームからのものになる）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="path">記録ファイルのパス（既存のファイルは上書き、記録中の場合は前のファイルを閉じて切り替える）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_StartRecording(int sessionId, const wchar_t* path);
+
+/// <summary>
+/// フレームの記録を終了してファイルを閉じる
+/// 記録中に書き込みが失敗した場合はそれまでのフレームを残して BAKETA_CAPTURE_ERROR_DEVICE を返す
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="frameCount">記録したフレーム数（出力・省略可）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS、記録中でない場合は BAKETA_CAPTURE_ERROR_NOT_FOUND</returns>
+__declspec(dllexport) int BaketaCapture_StopRecording(int sessionId, int* frameCount);
+
+/// <summary>
+/// ストリーミングモードを開始
+/// WGC キャプチャを一度だけ開始し、以降の CaptureFrame 系呼び出しは到着待ちをせず最新フレームを返す
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="maxFps">最大フレームレート（0 以下で無制限）</param>
+/// <param name="poolDepth">フレームプールのバッファ数（0 以下で既定値 3、範囲 3〜8）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_StartStreaming(int sessionId, int maxFps, int poolDepth);
+
+/// <summary>
+/// ストリーミングモードを停止（通常の到着待ちキャプチャに戻る）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_StopStreaming(int sessionId);
+
+/// <summary>
+/// 最小フレーム間隔を設定（フレームペーシング、通常モード・ストリーミングモード共通）
+/// 間隔未満で届いたフレームはテクスチャを保持せずに即座にフレームプールへ返却する
+/// 高リフレッシュレートのディスプレイで 2〜5 fps しか必要ない場合に WGC コールバックと GPU メモリの負荷を抑える
+/// ストリーミングの maxFps と併用した場合は長い方の間隔が適用される
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="intervalMs">最小フレーム間隔（ミリ秒、0 以下で無制限）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_SetMinFrameInterval(int sessionId, int intervalMs);
+
+/// <summary>
+/// フレーム到着通知用の自動リセットイベントを取得
+/// 返されるハンドルは呼び出し側プロセス用に複製されたもので、不要になったら CloseHandle すること
+/// 取得時に WGC キャプチャを開始する（セッションのクローズ時にもシグナルされる）
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="eventHandle">イベントハンドル（出力）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_GetFrameEvent(int sessionId, void** eventHandle);
+
+/// <summary>
+/// フレーム到着コールバックを設定
+/// 取得時に WGC キャプチャを開始する。解除時は進行中のコールバック完了を待ってから戻る
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="callback">コールバック（nullptr で解除）</param>
+/// <param name="userData">コールバックに渡すユーザーデータ</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_SetFrameCallback(int sessionId, BaketaCaptureFrameCallback callback, void* userData);
+
 /// <summary>
 /// フレームデータを解放
+/// ネイティブで確保したバッファはフレームバッファプールへ返却される
 /// </summary>
 /// <param name="frame">解放するフレーム</param>
 __declspec(dllexport) void BaketaCapture_ReleaseFrame(BaketaCaptureFrame* frame);
 
+/// <summary>
+/// BaketaCapture_CaptureFrameEx で取得したフレームデータを解放
+/// </summary>
+/// <param name="frame">解放するフレーム</param>
+__declspec(dllexport) void BaketaCapture_ReleaseFrameEx(BaketaCaptureFrameEx* frame);
+
+/// <summary>
+/// フレームバッファプールの保持上限（ハイウォーターマーク）を設定
+/// </summary>
+/// <param name="maxPooledBytes">保持する未使用バッファの合計バイト数上限</param>
+/// <param name="maxPooledBuffers">保持する未使用バッファ数上限（0でプール無効）</param>
+__declspec(dllexport) void BaketaCapture_SetFramePoolLimits(long long maxPooledBytes, int maxPooledBuffers);
+
+/// <summary>
+/// フレームバッファプールの未使用バッファをすべて解放
+/// </summary>
+__declspec(dllexport) void BaketaCapture_TrimFramePool();
+
 /// <summary>
 /// キャプチャセッションを削除
 /// </summary>
@@ -83,13 +707,49 @@ __declspec(dllexport) void BaketaCapture_ReleaseSession(int sessionId);
 __declspec(dllexport) int BaketaCapture_IsSupported();
 
 /// <summary>
-/// 最後のエラーメッセージを取得
+/// 呼び出しスレッドの最後のエラーメッセージを取得
 /// </summary>
 /// <param name="buffer">メッセージバッファ</param>
 /// <param name="bufferSize">バッファサイズ</param>
 /// <returns>実際のメッセージ長</returns>
 __declspec(dllexport) int BaketaCapture_GetLastError(char* buffer, int bufferSize);
 
+/// <summary>
+/// 呼び出しスレッドの最後のエラーの段階・HRESULT を取得（文字列の整形・コピーなし）
+/// </summary>
+/// <param name="info">エラー詳細（出力）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_GetLastErrorInfo(BaketaCaptureErrorInfo* info);
+
+/// <summary>
+/// セッションの段階別タイミング・フレーム統計を取得
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <param name="stats">統計（出力）</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_GetSessionStats(int sessionId, BaketaCaptureStats* stats);
+
+/// <summary>
+/// セッションの統計をリセット
+/// </summary>
+/// <param name="sessionId">セッションID</param>
+/// <returns>成功時は BAKETA_CAPTURE_SUCCESS</returns>
+__declspec(dllexport) int BaketaCapture_ResetSessionStats(int sessionId);
+
+/// <summary>
+/// 診断ログレベルを設定
+/// VERBOSE 以外では毎フレームのデバッグ文字列整形を行わない
+/// </summary>
+/// <param name="level">BAKETA_CAPTURE_DIAG_OFF / BASIC / VERBOSE</param>
+/// <returns>実際に設定されたレベル（ビルド時上限でクランプ）</returns>
+__declspec(dllexport) int BaketaCapture_SetDiagnosticsLevel(int level);
+
+/// <summary>
+/// 現在の診断ログレベルを取得
+/// </summary>
+/// <returns>BAKETA_CAPTURE_DIAG_OFF / BASIC / VERBOSE</returns>
+__declspec(dllexport) int BaketaCapture_GetDiagnosticsLevel();
+
 /// <summary>
 /// セッションのウィンドウデバッグ情報を取得
 /// </summary>
@@ -0,0 +1,144 @@
+﻿#include "pch.h"
+#include "DxgiGpuDetector.h"
+#include <cmath>
+
+namespace
+{
+    // 指数移動平均の重み（新しいサンプルの比率）
+    constexpr double kAverageWeight = 0.25;
+
+    // 予算に対してこの比率を超えたら縮小、下回る状態が続いたら拡大（間を空けて振動を防ぐ）
+    constexpr double kShrinkRatio = 1.1;
+    constexpr double kGrowRatio = 0.6;
+    constexpr int kGrowStreak = 8;
+
+    // スケール変更直後に無視するサンプル数
+    constexpr int kSettleSamples = 2;
+
+    // 専用 VRAM がこれ未満の GPU は控えめなスケールから開始する
+    constexpr unsigned long long kLowVideoMemoryBytes = 2ull * 1024 * 1024 * 1024;
+
+    // アダプタの種類ごとの初期スケール
+    constexpr float kIntegratedInitialScale = 0.5f;
+    constexpr float kLowMemoryInitialScale = 0.75f;
+}
+
+float AdaptiveResolutionController::Quantize(float scale)
+{
+    return std::floor(scale / kScaleStep + 0.5f) * kScaleStep;
+}
+
+void AdaptiveResolutionController::Configure(int latencyBudgetUs, float minScale, LUID adapterLuid)
+{
+    // 初期スケールはアダプタの種類から決める（判定できない場合は等倍から計測で下げる）
+    float initialScale = 1.0f;
+    DxgiGpuInfo gpuInfo = {};
+    if (GetGpuInfoByLuid(adapterLuid.LowPart, adapterLuid.HighPart, &gpuInfo))
+    {
+        if (gpuInfo.IsIntegrated)
+        {
+            initialScale = kIntegratedInitialScale;
+        }
+        else if (gpuInfo.DedicatedVideoMemory < kLowVideoMemoryBytes)
+        {
+            initialScale = kLowMemoryInitialScale;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = true;
+    m_budgetUs = static_cast<double>((std::max)(1, latencyBudgetUs));
+    m_minScale = Quantize((std::clamp)(minScale, kMinAllowedScale, 1.0f));
+    m_maxScale = 1.0f;
+    m_scale = (std::clamp)(initialScale, m_minScale, m_maxScale);
+    m_averageUs = 0.0;
+    m_settleSamples = 0;
+    m_underBudgetStreak = 0;
+}
+
+void AdaptiveResolutionController::Disable()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = false;
+    m_scale = 1.0f;
+    m_averageUs = 0.0;
+}
+
+bool AdaptiveResolutionController::IsEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled;
+}
+
+float AdaptiveResolutionController::GetScale() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled ? m_scale : 1.0f;
+}
+
+void AdaptiveResolutionController::ApplyScale(int sourceWidth, int sourceHeight, int* targetWidth, int* targetHeight) const
+{
+    float scale = GetScale();
+
+    // 呼び出し側の目標サイズを上限とし、元サイズに対するスケールで更に縮小する
+    // （アスペクト比の維持は ResizeAndConvertTextureToBGRA 側で行う）
+    int limitWidth = *targetWidth > 0 ? (std::min)(*targetWidth, sourceWidth) : sourceWidth;
+    int limitHeight = *targetHeight > 0 ? (std::min)(*targetHeight, sourceHeight) : sourceHeight;
+    int scaledWidth = (std::max)(1, static_cast<int>(sourceWidth * scale + 0.5f));
+    int scaledHeight = (std::max)(1, static_cast<int>(sourceHeight * scale + 0.5f));
+
+    *targetWidth = (std::min)(limitWidth, scaledWidth);
+    *targetHeight = (std::min)(limitHeight, scaledHeight);
+}
+
+void AdaptiveResolutionController::Observe(unsigned long long elapsedUs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    // スケール変更直後はリサイズ用リソース・ステージングテクスチャの再作成を含むため除外
+    if (m_settleSamples > 0)
+    {
+        --m_settleSamples;
+        return;
+    }
+
+    double sample = static_cast<double>(elapsedUs);
+    m_averageUs = m_averageUs <= 0.0 ? sample : m_averageUs + (sample - m_averageUs) * kAverageWeight;
+
+    float newScale = m_scale;
+    if (m_averageUs > m_budgetUs * kShrinkRatio)
+    {
+        // 所要時間は画素数（スケールの2乗）にほぼ比例するため、予算に収まる比率の平方根で縮小する
+        // 量子化で変化が消えないよう最低1段は下げる
+        float target = m_scale * static_cast<float>(std::sqrt(m_budgetUs / m_averageUs));
+        newScale = (std::min)(Quantize(target), m_scale - kScaleStep);
+        m_underBudgetStreak = 0;
+    }
+    else if (m_averageUs < m_budgetUs * kGrowRatio)
+    {
+        // 余裕が続いた場合のみ1段ずつ戻す
+        if (++m_underBudgetStreak >= kGrowStreak)
+        {
+            newScale = m_scale + kScaleStep;
+            m_underBudgetStreak = 0;
+        }
+    }
+    else
+    {
+        m_underBudgetStreak = 0;
+    }
+
+    newScale = (std::clamp)(newScale, m_minScale, m_maxScale);
+    if (newScale != m_scale)
+    {
+        // 新しいスケールでの所要時間を画素数比で見積もって平均を引き継ぐ
+        double ratio = static_cast<double>(newScale) / static_cast<double>(m_scale);
+        m_averageUs *= ratio * ratio;
+        m_scale = newScale;
+        m_settleSamples = kSettleSamples;
+    }
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+/// <summary>
+/// 計測したレイテンシに基づいてキャプチャ解像度を調整するコントローラー
+/// GPU リサイズ・コピー・マップ・行コピーの所要時間（フレーム待ちを除く）を指数移動平均で追跡し、
+/// 予算を超えればスケールを下げ、余裕が続けば段階的に戻す。初期スケールはアダプタの種類
+/// （統合 GPU / 専用 VRAM 量）から決め、文字の可読性を保つ最小スケールより下げない。
+/// スケールは kScaleStep 刻みに量子化し、リサイズ用リソースの作り直しを抑える。
+/// </summary>
+class AdaptiveResolutionController
+{
+public:
+    /// <summary>
+    /// スケールの量子化単位
+    /// </summary>
+    static constexpr float kScaleStep = 1.0f / 16.0f;
+
+    /// <summary>
+    /// 指定可能な最小スケールの下限
+    /// </summary>
+    static constexpr float kMinAllowedScale = kScaleStep;
+
+    AdaptiveResolutionController() = default;
+    AdaptiveResolutionController(const AdaptiveResolutionController&) = delete;
+    AdaptiveResolutionController& operator=(const AdaptiveResolutionController&) = delete;
+
+    /// <summary>
+    /// 適応モードを有効化し、アダプタの種類から初期スケールを決める
+    /// </summary>
+    /// <param name="latencyBudgetUs">1 回の読み出し（フレーム待ちを除く）に許容する時間（マイクロ秒、1 以上）</param>
+    /// <param name="minScale">文字の可読性を保つ最小スケール（kMinAllowedScale 〜 1.0 にクランプ）</param>
+    /// <param name="adapterLuid">キャプチャデバイスのアダプタ LUID</param>
+    void Configure(int latencyBudgetUs, float minScale, LUID adapterLuid);
+
+    /// <summary>
+    /// 適応モードを無効化する
+    /// </summary>
+    void Disable();
+
+    /// <summary>
+    /// 適応モードが有効か
+    /// </summary>
+    bool IsEnabled() const;
+
+    /// <summary>
+    /// 現在のスケールからリサイズ目標サイズを求める
+    /// 呼び出し側の目標サイズ（0 以下は元サイズ）を上限として扱う
+    /// </summary>
+    /// <param name="sourceWidth">元フレーム幅</param>
+    /// <param name="sourceHeight">元フレーム高さ</param>
+    /// <param name="targetWidth">呼び出し側の目標幅（入力）、適用する目標幅（出力）</param>
+    /// <param name="targetHeight">呼び出し側の目標高さ（入力）、適用する目標高さ（出力）</param>
+    void ApplyScale(int sourceWidth, int sourceHeight, int* targetWidth, int* targetHeight) const;
+
+    /// <summary>
+    /// 1 回の読み出しの所要時間を記録し、必要に応じてスケールを更新する
+    /// </summary>
+    /// <param name="elapsedUs">リサイズ・コピー・マップ・行コピーの合計時間（マイクロ秒）</param>
+    void Observe(unsigned long long elapsedUs);
+
+    /// <summary>
+    /// 現在のスケール（無効時は 1.0）
+    /// </summary>
+    float GetScale() const;
+
+private:
+    static float Quantize(float scale);
+
+    mutable std::mutex m_mutex;
+    bool m_enabled = false;
+    double m_budgetUs = 0.0;
+    float m_minScale = 1.0f;
+    float m_maxScale = 1.0f;
+    float m_scale = 1.0f;
+    double m_averageUs = 0.0;   // 指数移動平均（0 は未計測）
+    int m_settleSamples = 0;    // スケール変更直後に無視するサンプル数（リソース再作成の影響を除く）
+    int m_underBudgetStreak = 0;
+};
@@ -0,0 +1,254 @@
+﻿#include "pch.h"
+
+AsyncSessionCreator& AsyncSessionCreator::Instance()
+{
+    static AsyncSessionCreator instance;
+    return instance;
+}
+
+int AsyncSessionCreator::CreateAndRegister(HWND hwnd, int* sessionId)
+{
+    // [Issue #324] 既存セッションの再利用チェック（共有ロックのみ）
+    int cachedSessionId = 0;
+    if (SessionRegistry::Instance().FindByWindow(hwnd, &cachedSessionId))
+    {
+        *sessionId = cachedSessionId;
+        CaptureLastError::SetMessage("[Issue #324] Session reused");
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+
+    // 新規セッション作成（D3D デバイス作成・リトライを含むため、レジストリのロック外で初期化する）
+    int newSessionId = SessionRegistry::Instance().NextSessionId();
+    auto session = std::make_shared<WindowsCaptureSession>(newSessionId, hwnd);
+
+    if (!session->Initialize())
+    {
+        // Gemini推奨: HRESULTを直接取得して返却（詳細メッセージはセッションが設定済み）
+        HRESULT hr = session->GetLastHResult();
+        if (hr != S_OK)
+        {
+            return hr;
+        }
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    // [Issue #324] セッションを登録（初期化中に同じウィンドウのセッションが登録されていればそちらを再利用）
+    int registeredSessionId = SessionRegistry::Instance().Add(session);
+    if (registeredSessionId != newSessionId)
+    {
+        session->Close();
+        *sessionId = registeredSessionId;
+        CaptureLastError::SetMessage("[Issue #324] Session reused");
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+
+    *sessionId = newSessionId;
+    CaptureLastError::Clear();
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+int AsyncSessionCreator::Start(HWND hwnd, bool prewarmGpu, const Waiter& waiter, int* sessionId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // 完了済みのワーカーを片付ける（完了済みの future の破棄は待機しない）
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(),
+        [](const std::shared_future<void>& task) { return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }),
+        m_tasks.end());
+
+    auto it = m_pending.find(hwnd);
+    if (it != m_pending.end() && it->second->completed &&
+        std::chrono::steady_clock::now() - it->second->completedAt > kFailedResultRetention)
+    {
+        // 回収されないまま古くなった失敗結果は返さず、作成し直す
+        m_pending.erase(it);
+        it = m_pending.end();
+    }
+
+    if (it != m_pending.end())
+    {
+        Pending& pending = *it->second;
+        if (!pending.completed)
+        {
+            // 実行中: 完了時に一緒に通知する
+            Waiter stored = waiter;
+            if (waiter.event && !DuplicateHandle(GetCurrentProcess(), waiter.event, GetCurrentProcess(), &stored.event, 0, FALSE, DUPLICATE_SAME_ACCESS))
+            {
+                stored.event = nullptr;
+            }
+            pending.waiters.push_back(stored);
+            return BAKETA_CAPTURE_PENDING;
+        }
+
+        // 完了済みの失敗: 結果とワーカーのエラー情報を渡して回収する
+        int result = pending.result;
+        CaptureLastError::Set(pending.error.stage, pending.error.hresult, pending.error.sessionId, pending.error.message);
+        m_pending.erase(it);
+        return result;
+    }
+
+    // キャッシュヒットは待たずに返す
+    if (SessionRegistry::Instance().FindByWindow(hwnd, sessionId))
+    {
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+
+    auto pending = std::make_shared<Pending>();
+    Waiter stored = waiter;
+    if (waiter.event && !DuplicateHandle(GetCurrentProcess(), waiter.event, GetCurrentProcess(), &stored.event, 0, FALSE, DUPLICATE_SAME_ACCESS))
+    {
+        stored.event = nullptr;
+    }
+    if (stored.callback || stored.event)
+    {
+        pending->waiters.push_back(stored);
+    }
+    m_pending.emplace(hwnd, pending);
+    m_tasks.push_back(std::async(std::launch::async, [this, hwnd, prewarmGpu] { Run(hwnd, prewarmGpu); }).share());
+    return BAKETA_CAPTURE_PENDING;
+}
+
+void AsyncSessionCreator::Run(HWND hwnd, bool prewarmGpu)
+{
+    winrt::init_apartment(winrt::apartment_type::multi_threaded);
+    CaptureLastError::Clear();
+
+    int sessionId = 0;
+    int result = BAKETA_CAPTURE_ERROR_DEVICE;
+    try
+    {
+        result = IsWindow(hwnd) ? CreateAndRegister(hwnd, &sessionId) : BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+        if (result == BAKETA_CAPTURE_ERROR_INVALID_WINDOW)
+        {
+            CaptureLastError::Set(BAKETA_CAPTURE_STAGE_API, S_OK, 0, "Invalid window handle");
+        }
+
+        if (result == BAKETA_CAPTURE_SUCCESS && prewarmGpu)
+        {
+            if (auto session = SessionRegistry::Instance().Find(sessionId))
+            {
+                session->PrewarmGpuResources();
+                CaptureLastError::Clear();
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        CaptureLastError::Set(BAKETA_CAPTURE_STAGE_CAPTURE, E_FAIL, 0, e.what());
+        result = BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        CaptureLastError::Set(BAKETA_CAPTURE_STAGE_CAPTURE, E_FAIL, 0, "Failed to create session: Unknown error");
+        result = BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(hwnd);
+        if (it != m_pending.end())
+        {
+            Pending& pending = *it->second;
+            waiters.swap(pending.waiters);
+
+            // イベントで待つ呼び出し側が結果を回収できるよう、失敗結果のみ残す（成功はレジストリから引ける）
+            bool hasEventWaiter = std::any_of(waiters.begin(), waiters.end(), [](const Waiter& w) { return w.event != nullptr; });
+            if (result != BAKETA_CAPTURE_SUCCESS && hasEventWaiter)
+            {
+                pending.completed = true;
+                pending.result = result;
+                pending.sessionId = sessionId;
+                pending.error = CaptureLastError::Current();
+                pending.completedAt = std::chrono::steady_clock::now();
+            }
+            else
+            {
+                m_pending.erase(it);
+            }
+        }
+    }
+    m_completed.notify_all();
+
+    // コールバック内で BaketaCapture_GetLastError を呼ぶとこのスレッドのエラー情報が返る
+    for (const Waiter& waiter : waiters)
+    {
+        Notify(waiter, hwnd, result, sessionId);
+    }
+
+    CaptureLastError::Clear();
+    winrt::uninit_apartment();
+}
+
+void AsyncSessionCreator::Notify(const Waiter& waiter, HWND hwnd, int result, int sessionId)
+{
+    if (waiter.callback)
+    {
+        try
+        {
+            waiter.callback(hwnd, result, sessionId, waiter.userData);
+        }
+        catch (...) { /* コールバックの例外はワーカー外へ伝播させない */ }
+    }
+
+    if (waiter.event)
+    {
+        SetEvent(waiter.event);
+        CloseHandle(waiter.event);
+    }
+}
+
+void AsyncSessionCreator::Wait(HWND hwnd)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_completed.wait(lock, [this, hwnd]
+    {
+        auto it = m_pending.find(hwnd);
+        return it == m_pending.end() || it->second->completed;
+    });
+
+    // 同期作成は失敗後も作成し直すため、保持中の失敗結果は以降の Start へ残さない
+    m_pending.erase(hwnd);
+}
+
+void AsyncSessionCreator::Shutdown()
+{
+    std::vector<std::shared_future<void>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        tasks.swap(m_tasks);
+    }
+
+    // ロック外で待つ（ワーカーは完了時に m_mutex を取得する）
+    for (auto& task : tasks)
+    {
+        task.wait();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+}
+
+void AsyncSessionCreator::Abandon()
+{
+    std::vector<std::shared_future<void>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        tasks.swap(m_tasks);
+
+        // 実行中の作成は完了時に m_pending を参照するため、完了済みの結果のみ破棄する
+        for (auto it = m_pending.begin(); it != m_pending.end();)
+        {
+            it = it->second->completed ? m_pending.erase(it) : std::next(it);
+        }
+    }
+
+    // 未完了の future を破棄すると完了まで待つため、意図的にリークさせる
+    auto it = std::partition(tasks.begin(), tasks.end(),
+        [](const std::shared_future<void>& task) { return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+    if (it != tasks.end())
+    {
+        new std::vector<std::shared_future<void>>(std::make_move_iterator(it), std::make_move_iterator(tasks.end()));
+        tasks.erase(it, tasks.end());
+    }
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+/// <summary>
+/// ウィンドウセッションのバックグラウンド作成（BaketaCapture_CreateSessionAsync / BaketaCapture_Prewarm）
+/// D3D デバイス作成・GraphicsCaptureItem 作成（バックオフ付きリトライ）・フレームプール作成をワーカースレッドで行い、
+/// 完了時に待機中の全呼び出し側へコールバック・イベントで通知する。同じウィンドウの作成は 1 つにまとめる。
+/// </summary>
+class AsyncSessionCreator
+{
+public:
+    /// <summary>
+    /// 完了通知の受け取り先
+    /// </summary>
+    struct Waiter
+    {
+        BaketaCaptureSessionCallback callback = nullptr;
+        void* userData = nullptr;
+        HANDLE event = nullptr;  // シグナルするイベント（Start で複製し、通知後に閉じる）
+    };
+
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static AsyncSessionCreator& Instance();
+
+    /// <summary>
+    /// ウィンドウのセッションを同期的に作成して登録する（既存の有効なセッションがあれば再利用）
+    /// BaketaCapture_CreateSession とワーカーの共通処理。失敗時は呼び出しスレッドの最後のエラーを設定する
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウ</param>
+    /// <param name="sessionId">セッション ID（出力）</param>
+    /// <returns>BAKETA_CAPTURE_SUCCESS、または失敗時の結果コード（初期化失敗の HRESULT を含む）</returns>
+    static int CreateAndRegister(HWND hwnd, int* sessionId);
+
+    /// <summary>
+    /// バックグラウンド作成を開始する（同じウィンドウの作成が実行中ならその完了を待つ側に加わる）
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウ</param>
+    /// <param name="prewarmGpu">作成後に GPU リサイズリソースも作成するか</param>
+    /// <param name="waiter">完了通知の受け取り先（コールバック・イベントとも省略可）</param>
+    /// <param name="sessionId">既存セッションまたは完了済みの結果のセッション ID（出力）</param>
+    /// <returns>既存・完了済みなら結果コード、作成を開始・実行中なら BAKETA_CAPTURE_PENDING</returns>
+    int Start(HWND hwnd, bool prewarmGpu, const Waiter& waiter, int* sessionId);
+
+    /// <summary>
+    /// ウィンドウの作成が実行中であれば完了まで待つ
+    /// 保持中の失敗結果は呼び出し側が作成し直すため破棄する
+    /// </summary>
+    void Wait(HWND hwnd);
+
+    /// <summary>
+    /// 実行中の作成を全て待ってから状態を破棄する（BaketaCapture_Shutdown 用）
+    /// </summary>
+    void Shutdown();
+
+    /// <summary>
+    /// 実行中の作成を待たずに切り離す（DllMain の DLL_PROCESS_DETACH 用）
+    /// std::async の future は破棄時に完了を待つため、ローダーロック中は破棄せずに残す
+    /// </summary>
+    void Abandon();
+
+private:
+    /// <summary>
+    /// 失敗結果を回収されるまで保持する上限（これより古い結果は次の Start で破棄して作成し直す）
+    /// </summary>
+    static constexpr std::chrono::milliseconds kFailedResultRetention{ 5000 };
+
+    AsyncSessionCreator() = default;
+    AsyncSessionCreator(const AsyncSessionCreator&) = delete;
+    AsyncSessionCreator& operator=(const AsyncSessionCreator&) = delete;
+
+    struct Pending
+    {
+        bool completed = false;
+        int result = BAKETA_CAPTURE_SUCCESS;
+        int sessionId = 0;
+        CaptureLastError::Record error = {};  // 失敗時のワーカーのエラー（イベントで待つ呼び出し側へ引き継ぐ）
+        std::chrono::steady_clock::time_point completedAt;
+        std::vector<Waiter> waiters;
+    };
+
+    void Run(HWND hwnd, bool prewarmGpu);
+    static void Notify(const Waiter& waiter, HWND hwnd, int result, int sessionId);
+
+    std::mutex m_mutex;
+    std::condition_variable m_completed;
+    std::unordered_map<HWND, std::shared_ptr<Pending>> m_pending;  // 実行中・結果未回収の作成
+    std::vector<std::shared_future<void>> m_tasks;                  // 完了待ち用（完了済みは Start で片付ける）
+};
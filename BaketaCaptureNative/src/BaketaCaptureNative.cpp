@@ -3,20 +3,24 @@
 
 // グローバル状態
 static bool g_initialized = false;
-static std::mutex g_sessionMutex;
-static std::unordered_map<int, std::unique_ptr<WindowsCaptureSession>> g_sessions;
-static std::atomic<int> g_nextSessionId(1);
-static std::string g_lastError;
-
-// [Issue #324] HWND → SessionID のキャッシュ（セッション再利用）
-static std::unordered_map<HWND, int> g_hwndToSessionCache;
 
 /// <summary>
-/// エラーメッセージを設定
+/// エラーメッセージを設定（呼び出しスレッドのレコードへ、ヒープ確保なし）
+/// 段階が未設定の場合はエクスポート層のエラー（引数検証・セッション検索）として記録する
 /// </summary>
+static void SetLastError(const char* message)
+{
+    CaptureLastError::Record& record = CaptureLastError::Current();
+    if (record.stage == BAKETA_CAPTURE_STAGE_NONE)
+    {
+        record.stage = BAKETA_CAPTURE_STAGE_API;
+    }
+    CaptureLastError::SetMessage(message);
+}
+
 static void SetLastError(const std::string& message)
 {
-    g_lastError = message;
+    SetLastError(message.c_str());
 }
 
 /// <summary>
@@ -42,7 +46,7 @@ int BaketaCapture_Initialize()
         }
 
         g_initialized = true;
-        SetLastError("");
+        CaptureLastError::Clear();
         return BAKETA_CAPTURE_SUCCESS;
     }
     catch (const std::exception& e)
@@ -58,24 +62,71 @@ int BaketaCapture_Initialize()
 }
 
 /// <summary>
-/// ライブラリの終了処理
-/// [Issue #324] HWNDキャッシュもクリア
+/// ライブラリの終了処理（BaketaCapture_Shutdown と DllMain の共通処理）
 /// </summary>
-void BaketaCapture_Shutdown()
+/// <param name="processDetach">DLL_PROCESS_DETACH から呼ばれた場合は true（ローダーロック中のためスレッドの終了を待たない）</param>
+/// <param name="processTerminating">プロセス終了による DLL_PROCESS_DETACH の場合は true（セッションをクローズしない）</param>
+static void ShutdownLibrary(bool processDetach, bool processTerminating)
 {
     if (!g_initialized)
     {
         return;
     }
 
+    // 実行中のバックグラウンド作成を待つ（完了後に登録されたセッションも以下でクローズする）
+    // ローダーロック中はワーカーが完了できない可能性があるため待たずに切り離す
+    if (processDetach)
+    {
+        AsyncSessionCreator::Instance().Abandon();
+    }
+    else
+    {
+        AsyncSessionCreator::Instance().Shutdown();
+    }
+
+    if (processTerminating)
+    {
+        // プロセス終了中はフレームコールバックのスレッドが途中で終了させられているため、
+        // クローズ（コールバックの完了待ち）を行わずにセッションを手放す。メモリ・ハンドルは OS が回収する
+        SessionRegistry::Instance().Abandon();
+        CpuWorkerPool::Instance().Abandon();
+        g_initialized = false;
+        return;
+    }
+
+    // [Issue #324] HWNDキャッシュごと一覧から外してからクローズ（参照中のキャプチャがあれば完了後に破棄される）
+    for (auto& session : SessionRegistry::Instance().RemoveAll())
+    {
+        session->Close();
+    }
+
+    // 共有 D3D デバイスを解放（各セッションが参照を手放した時点で破棄される）
+    D3DDeviceManager::Instance().Reset();
+
+    // 未使用のフレームバッファを解放（貸出中のものは ReleaseFrame で返却される）
+    FrameBufferPool::Instance().Trim();
+
+    // CPU フォールバック用ワーカーを停止（ローダーロック中は join せず切り離す）
+    if (processDetach)
+    {
+        CpuWorkerPool::Instance().Abandon();
+    }
+    else
     {
-        std::lock_guard<std::mutex> lock(g_sessionMutex);
-        g_hwndToSessionCache.clear();  // [Issue #324]
-        g_sessions.clear();
+        CpuWorkerPool::Instance().Shutdown();
     }
 
     g_initialized = false;
-    SetLastError("");
+    CaptureLastError::Clear();
+}
+
+/// <summary>
+/// ライブラリの終了処理
+/// [Issue #324] HWNDキャッシュもクリア
+/// </summary>
+void BaketaCapture_Shutdown()
+{
+    ShutdownLibrary(false, false);
 }
 
 /// <summary>
@@ -84,6 +135,8 @@ void BaketaCapture_Shutdown()
 /// </summary>
 int BaketaCapture_CreateSession(void* hwnd, int* sessionId)
 {
+    CaptureLastError::Clear();
+
     if (!g_initialized)
     {
         SetLastError("Library not initialized");
@@ -107,67 +160,277 @@ int BaketaCapture_CreateSession(void* hwnd, int* sessionId)
 
     try
     {
-        std::lock_guard<std::mutex> lock(g_sessionMutex);
+        // CreateSessionAsync / Prewarm で作成中であれば完了を待って再利用する
+        AsyncSessionCreator::Instance().Wait(windowHandle);
+
+        int result = AsyncSessionCreator::CreateAndRegister(windowHandle, sessionId);
+        if (result != BAKETA_CAPTURE_SUCCESS && CaptureLastError::Current().message[0] == '\0')
+        {
+            SetLastError("Failed to initialize capture session");
+        }
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Failed to create session: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Failed to create session: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// ウィンドウキャプチャセッションをバックグラウンドで作成
+/// 既存セッションがあれば即座に返し、無ければワーカーで作成して完了をコールバック・イベントで通知する
+/// </summary>
+int BaketaCapture_CreateSessionAsync(void* hwnd, BaketaCaptureSessionCallback callback, void* userData, void* completionEvent, int* sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!hwnd || !sessionId)
+    {
+        SetLastError("Invalid parameters");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    HWND windowHandle = static_cast<HWND>(hwnd);
+    if (!IsWindow(windowHandle))
+    {
+        SetLastError("Invalid window handle");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    try
+    {
+        AsyncSessionCreator::Waiter waiter;
+        waiter.callback = callback;
+        waiter.userData = userData;
+        waiter.event = static_cast<HANDLE>(completionEvent);
+
+        int result = AsyncSessionCreator::Instance().Start(windowHandle, false, waiter, sessionId);
+        if (result == BAKETA_CAPTURE_SUCCESS || result == BAKETA_CAPTURE_PENDING)
+        {
+            CaptureLastError::Clear();
+        }
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Failed to start session creation: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Failed to start session creation: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// ウィンドウのセッションをバックグラウンドで事前作成（D3D デバイス・フレームプール・GPU リサイズリソース）
+/// 後の CreateSession は事前作成の完了を待ち、作成済みのセッションを再利用する
+/// </summary>
+int BaketaCapture_Prewarm(void* hwnd)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!hwnd)
+    {
+        SetLastError("Invalid parameters");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    HWND windowHandle = static_cast<HWND>(hwnd);
+    if (!IsWindow(windowHandle))
+    {
+        SetLastError("Invalid window handle");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    try
+    {
+        // 既存セッションがあれば GPU リソースのみ作成、無ければバックグラウンドで作成を開始（結果は通知しない）
+        int sessionId = 0;
+        int result = AsyncSessionCreator::Instance().Start(windowHandle, true, AsyncSessionCreator::Waiter{}, &sessionId);
+        if (result == BAKETA_CAPTURE_SUCCESS)
+        {
+            if (auto session = SessionRegistry::Instance().Find(sessionId))
+            {
+                session->PrewarmGpuResources();
+            }
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Failed to start prewarm: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Failed to start prewarm: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// モニター（またはその一部の矩形）のキャプチャセッションを作成
+/// 同じモニターのセッションは1つの WGC フレームプールを共有し、矩形はセッションごとに GPU 上で切り出す
+/// </summary>
+int BaketaCapture_CreateMonitorSession(void* monitor, const BaketaCaptureRect* screenRect, int* sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!sessionId || (!monitor && !screenRect) || (screenRect && (screenRect->width <= 0 || screenRect->height <= 0)))
+    {
+        SetLastError("Invalid parameters");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // モニター未指定の場合は矩形の大部分が含まれるモニターを使う
+    RECT requested = {};
+    if (screenRect)
+    {
+        requested = { screenRect->x, screenRect->y, screenRect->x + screenRect->width, screenRect->y + screenRect->height };
+    }
+    HMONITOR monitorHandle = monitor ? static_cast<HMONITOR>(monitor) : MonitorFromRect(&requested, MONITOR_DEFAULTTONULL);
+
+    MONITORINFO monitorInfo = {};
+    monitorInfo.cbSize = sizeof(monitorInfo);
+    if (!monitorHandle || !GetMonitorInfoW(monitorHandle, &monitorInfo))
+    {
+        SetLastError("Invalid monitor handle");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
 
-        // [Issue #324] 既存セッションの再利用チェック
-        auto cacheIt = g_hwndToSessionCache.find(windowHandle);
-        if (cacheIt != g_hwndToSessionCache.end())
+    // スクリーン座標の矩形をモニター左上基準に変換（モニター外の部分は切り捨てる）
+    RECT cropRect = {};
+    if (screenRect)
+    {
+        RECT clipped = {};
+        if (!IntersectRect(&clipped, &requested, &monitorInfo.rcMonitor))
         {
-            int cachedSessionId = cacheIt->second;
-            auto sessionIt = g_sessions.find(cachedSessionId);
+            SetLastError("Screen rectangle does not intersect the monitor");
+            return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+        }
+        OffsetRect(&clipped, -monitorInfo.rcMonitor.left, -monitorInfo.rcMonitor.top);
+        cropRect = clipped;
+    }
 
-            if (sessionIt != g_sessions.end() && sessionIt->second && sessionIt->second->IsValid())
+    try
+    {
+        // モニターのフレームソースを共有（無ければレジストリのロック外で初期化して登録）
+        auto source = SessionRegistry::Instance().FindMonitorSource(monitorHandle);
+        if (!source)
+        {
+            auto created = std::make_shared<WindowsCaptureSession>(0, monitorHandle);
+            if (!created->Initialize())
             {
-                // 有効な既存セッションを再利用
-                *sessionId = cachedSessionId;
-                SetLastError("[Issue #324] Session reused");
-                return BAKETA_CAPTURE_SUCCESS;
+                SetLastError(created->GetLastError());
+                HRESULT hr = created->GetLastHResult();
+                return hr != S_OK ? hr : BAKETA_CAPTURE_ERROR_DEVICE;
             }
-            else
+
+            source = SessionRegistry::Instance().AddMonitorSource(created);
+            if (source != created)
             {
-                // 無効なセッション - キャッシュから削除
-                if (sessionIt != g_sessions.end())
-                {
-                    g_sessions.erase(sessionIt);
-                }
-                g_hwndToSessionCache.erase(cacheIt);
+                created->Close();
             }
         }
 
-        // 新規セッション作成
-        int newSessionId = g_nextSessionId.fetch_add(1);
-        auto session = std::make_unique<WindowsCaptureSession>(newSessionId, windowHandle);
-
+        int newSessionId = SessionRegistry::Instance().NextSessionId();
+        auto session = std::make_shared<WindowsCaptureSession>(newSessionId, source, screenRect ? &cropRect : nullptr);
         if (!session->Initialize())
         {
-            // WindowsCaptureSessionの詳細エラーメッセージを取得して伝播
             SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        *sessionId = SessionRegistry::Instance().Add(session);
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Failed to create monitor session: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Failed to create monitor session: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 記録ファイルを再生するリプレイセッションを作成
+/// </summary>
+int BaketaCapture_CreateReplaySession(const wchar_t* path, int flags, int* sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!path || !path[0] || !sessionId)
+    {
+        SetLastError("Invalid parameters");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
 
-            // Gemini推奨: HRESULTを直接取得して返却
+    try
+    {
+        int newSessionId = SessionRegistry::Instance().NextSessionId();
+        auto session = std::make_shared<WindowsCaptureSession>(newSessionId, path, flags);
+        if (!session->Initialize())
+        {
+            SetLastError(session->GetLastError());
             HRESULT hr = session->GetLastHResult();
-            if (hr != S_OK) {
-                return hr; // 実際のHRESULTを直接返却
+            if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || hr == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND))
+            {
+                return BAKETA_CAPTURE_ERROR_NOT_FOUND;
             }
-
-            return BAKETA_CAPTURE_ERROR_DEVICE;
+            return hr == HRESULT_FROM_WIN32(ERROR_BAD_FORMAT) ? BAKETA_CAPTURE_ERROR_UNSUPPORTED : BAKETA_CAPTURE_ERROR_DEVICE;
         }
 
-        // [Issue #324] セッションをキャッシュに登録
-        g_hwndToSessionCache[windowHandle] = newSessionId;
-        g_sessions[newSessionId] = std::move(session);
-
-        *sessionId = newSessionId;
-        SetLastError("");
+        *sessionId = SessionRegistry::Instance().Add(session);
+        CaptureLastError::Clear();
         return BAKETA_CAPTURE_SUCCESS;
     }
     catch (const std::exception& e)
     {
-        SetLastError(std::string("Failed to create session: ") + e.what());
+        SetLastError(std::string("Failed to create replay session: ") + e.what());
         return BAKETA_CAPTURE_ERROR_DEVICE;
     }
     catch (...)
     {
-        SetLastError("Failed to create session: Unknown error");
+        SetLastError("Failed to create replay session: Unknown error");
         return BAKETA_CAPTURE_ERROR_DEVICE;
     }
 }
@@ -178,6 +441,8 @@ int BaketaCapture_CreateSession(void* hwnd, int* sessionId)
 /// </summary>
 int BaketaCapture_CaptureFrame(int sessionId, BaketaCaptureFrame* frame, int timeoutMs)
 {
+    CaptureLastError::Clear();
+
     if (!g_initialized)
     {
         SetLastError("Library not initialized");
@@ -196,23 +461,13 @@ int BaketaCapture_CaptureFrame(int sessionId, BaketaCaptureFrame* frame, int tim
     frame->height = 0;
     frame->stride = 0;
     frame->timestamp = 0;
+    frame->sequence = 0;
 
-    WindowsCaptureSession* session = nullptr;
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
     {
-        std::lock_guard<std::mutex> lock(g_sessionMutex);
-        auto it = g_sessions.find(sessionId);
-        if (it == g_sessions.end())
-        {
-            SetLastError("Session not found");
-            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
-        }
-        session = it->second.get();
-
-        if (!session || session->IsClosing())
-        {
-            SetLastError("Session is closing");
-            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
-        }
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
     }
 
     try
@@ -224,13 +479,13 @@ int BaketaCapture_CaptureFrame(int sessionId, BaketaCaptureFrame* frame, int tim
             return BAKETA_CAPTURE_ERROR_DEVICE;
         }
 
-        if (!session->CaptureFrame(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, timeoutMs))
+        if (!session->CaptureFrame(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence, timeoutMs))
         {
-            SetLastError("Failed to capture frame");
+            SetLastError(session->GetLastError());
             return BAKETA_CAPTURE_ERROR_DEVICE;
         }
 
-        SetLastError("");
+        CaptureLastError::Clear();
         return BAKETA_CAPTURE_SUCCESS;
     }
     catch (const std::exception& e)
@@ -251,6 +506,8 @@ int BaketaCapture_CaptureFrame(int sessionId, BaketaCaptureFrame* frame, int tim
 /// </summary>
 int BaketaCapture_CaptureFrameResized(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs)
 {
+    CaptureLastError::Clear();
+
     if (!g_initialized)
     {
         SetLastError("Library not initialized");
@@ -269,26 +526,15 @@ int BaketaCapture_CaptureFrameResized(int sessionId, BaketaCaptureFrame* frame,
     frame->height = 0;
     frame->stride = 0;
     frame->timestamp = 0;
+    frame->sequence = 0;
     frame->originalWidth = 0;      // 🚀 [Issue #193]
     frame->originalHeight = 0;     // 🚀 [Issue #193]
 
-    WindowsCaptureSession* session = nullptr;
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
     {
-        std::lock_guard<std::mutex> lock(g_sessionMutex);
-        auto it = g_sessions.find(sessionId);
-        if (it == g_sessions.end())
-        {
-            SetLastError("Session not found");
-            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
-        }
-        session = it->second.get();
-
-        // [Issue #324] セッションがクローズ中かチェック
-        if (!session || session->IsClosing())
-        {
-            SetLastError("Session is closing");
-            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
-        }
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
     }
 
     try
@@ -301,13 +547,13 @@ int BaketaCapture_CaptureFrameResized(int sessionId, BaketaCaptureFrame* frame,
         }
 
         // 🚀 [Issue #193] 元のキャプチャサイズも取得
-        if (!session->CaptureFrameResized(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, timeoutMs))
+        if (!session->CaptureFrameResized(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence, &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, timeoutMs))
         {
-            SetLastError("Failed to capture resized frame");
+            SetLastError(session->GetLastError());
             return BAKETA_CAPTURE_ERROR_DEVICE;
         }
 
-        SetLastError("");
+        CaptureLastError::Clear();
         return BAKETA_CAPTURE_SUCCESS;
     }
     catch (const std::exception& e)
@@ -323,50 +569,1659 @@ int BaketaCapture_CaptureFrameResized(int sessionId, BaketaCaptureFrame* frame,
 }
 
 /// <summary>
-/// フレームデータを解放 - 🚀 P2最適化: アライメント済みメモリ対応
+/// 複数セッションのフレームをまとめてキャプチャ
+/// 全セッションの GPU リサイズ・ステージングコピーを発行してから共有デバイスごとに 1 回だけ Flush し、
+/// その後で指定順にマップすることで、セッションごとの GPU 待ちを直列化せずに重ねる
 /// </summary>
-void BaketaCapture_ReleaseFrame(BaketaCaptureFrame* frame)
+int BaketaCapture_CaptureBatch(const int* sessionIds, int count, BaketaCaptureFrame* outFrames, int* statusCodes, int targetWidth, int targetHeight, int timeoutMs)
 {
-    if (frame && frame->bgraData)
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
     {
-        // 🚀 P2最適化: _aligned_mallocに対応する_aligned_freeを使用
-        _aligned_free(frame->bgraData);
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!sessionIds || !outFrames || !statusCodes || count <= 0)
+    {
+        SetLastError("Invalid batch parameters");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体と結果コードを初期化
+    for (int i = 0; i < count; ++i)
+    {
+        BaketaCaptureFrame* frame = &outFrames[i];
         frame->bgraData = nullptr;
         frame->width = 0;
         frame->height = 0;
         frame->stride = 0;
         frame->timestamp = 0;
-        frame->originalWidth = 0;    // 🚀 [Issue #193]
-        frame->originalHeight = 0;   // 🚀 [Issue #193]
+        frame->sequence = 0;
+        frame->originalWidth = 0;
+        frame->originalHeight = 0;
+        statusCodes[i] = BAKETA_CAPTURE_ERROR_NOT_FOUND;
     }
-}
-
-/// <summary>
-/// キャプチャセッションを削除
-/// [Issue #324] HWNDキャッシュもクリーンアップ
-/// </summary>
-void BaketaCapture_ReleaseSession(int sessionId)
-{
-    std::lock_guard<std::mutex> lock(g_sessionMutex);
 
-    // [Issue #324] セッションのHWNDを取得してキャッシュから削除
-    auto sessionIt = g_sessions.find(sessionId);
-    if (sessionIt != g_sessions.end() && sessionIt->second)
+    try
     {
-        HWND hwnd = sessionIt->second->GetWindowHandle();
-        auto cacheIt = g_hwndToSessionCache.find(hwnd);
-        if (cacheIt != g_hwndToSessionCache.end() && cacheIt->second == sessionId)
+        std::vector<std::shared_ptr<WindowsCaptureSession>> sessions(static_cast<size_t>(count));
+        std::vector<BatchReadback> readbacks(static_cast<size_t>(count));
+        std::vector<ID3D11DeviceContext*> contexts;
+
+        std::vector<std::shared_ptr<WindowsCaptureSession>> candidates(static_cast<size_t>(count));
+        std::vector<int> lockOrder;
+        lockOrder.reserve(static_cast<size_t>(count));
+
+        // 1. セッションを解決（不正なものはここで結果コードを確定）
+        for (int i = 0; i < count; ++i)
         {
-            g_hwndToSessionCache.erase(cacheIt);
-        }
-    }
+            auto session = SessionRegistry::Instance().Find(sessionIds[i]);
+            if (!session)
+            {
+                SetLastError("Session not found");
+                continue;
+            }
 
-    g_sessions.erase(sessionId);
-}
+            // 同じセッションの重複指定は読み出しロックの二重取得になるため拒否
+            if (std::find(candidates.begin(), candidates.begin() + i, session) != candidates.begin() + i)
+            {
+                SetLastError("Session specified more than once in batch");
+                statusCodes[i] = BAKETA_CAPTURE_ERROR_ALREADY_EXISTS;
+                continue;
+            }
 
-/// <summary>
-/// Windows Graphics Capture API がサポートされているかチェック
-/// </summary>
+            if (!session->IsValid())
+            {
+                SetLastError("Session is invalid or closing");
+                statusCodes[i] = BAKETA_CAPTURE_ERROR_DEVICE;
+                continue;
+            }
+
+            candidates[i] = session;
+            lockOrder.push_back(i);
+        }
+
+        // 読み出しロックはマップ完了まで保持するため、指定順ではなくセッションID順に取得する
+        // （[A,B] と [B,A] のバッチが同時に走ってもロック順が逆転しない）
+        std::sort(lockOrder.begin(), lockOrder.end(), [sessionIds](int a, int b) { return sessionIds[a] < sessionIds[b]; });
+
+        // 2. 全セッションのフレーム取得と GPU 処理の発行（到着待ちの上限はバッチ全体で timeoutMs を共有）
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((std::max)(0, timeoutMs));
+        for (int i : lockOrder)
+        {
+            const auto& session = candidates[i];
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (!session->BeginBatchReadback(targetWidth, targetHeight, static_cast<int>((std::max)(0LL, static_cast<long long>(remaining.count()))), &readbacks[i]))
+            {
+                statusCodes[i] = BAKETA_CAPTURE_ERROR_DEVICE;
+                continue;
+            }
+
+            sessions[i] = session;
+            ID3D11DeviceContext* context = session->GetDeviceContext();
+            if (std::find(contexts.begin(), contexts.end(), context) == contexts.end())
+            {
+                contexts.push_back(context);
+            }
+        }
+
+        // 3. 共有デバイスごとに 1 回だけコマンドを送出
+        for (ID3D11DeviceContext* context : contexts)
+        {
+            context->Flush();
+        }
+
+        // 4. 指定順にマップして出力（失敗したセッションも他のセッションの結果には影響しない）
+        int firstError = BAKETA_CAPTURE_SUCCESS;
+        for (int i = 0; i < count; ++i)
+        {
+            if (sessions[i])
+            {
+                BaketaCaptureFrame* frame = &outFrames[i];
+                BatchReadback& readback = readbacks[i];
+                if (sessions[i]->EndBatchReadback(&readback, &frame->bgraData, &frame->stride))
+                {
+                    frame->width = readback.width;
+                    frame->height = readback.height;
+                    frame->timestamp = readback.timestamp;
+                    frame->sequence = readback.sequence;
+                    frame->originalWidth = readback.originalWidth;
+                    frame->originalHeight = readback.originalHeight;
+                    statusCodes[i] = BAKETA_CAPTURE_SUCCESS;
+                }
+                else
+                {
+                    statusCodes[i] = BAKETA_CAPTURE_ERROR_DEVICE;
+                }
+            }
+
+            if (firstError == BAKETA_CAPTURE_SUCCESS && statusCodes[i] != BAKETA_CAPTURE_SUCCESS)
+            {
+                firstError = statusCodes[i];
+            }
+        }
+
+        if (firstError == BAKETA_CAPTURE_SUCCESS)
+        {
+            CaptureLastError::Clear();
+        }
+        return firstError;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Batch capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Batch capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 変化がある場合のみフレームをキャプチャ（GPU タイル差分検出）
+/// </summary>
+int BaketaCapture_CaptureFrameIfChanged(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int threshold, BaketaCaptureTileInfo* tileInfo, unsigned int* dirtyBitmap, int dirtyBitmapWords, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame)
+    {
+        SetLastError("Invalid frame parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    frame->bgraData = nullptr;
+    frame->width = 0;
+    frame->height = 0;
+    frame->stride = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->originalWidth = 0;
+    frame->originalHeight = 0;
+
+    if (tileInfo)
+    {
+        *tileInfo = {};
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        bool changed = false;
+        if (!session->CaptureFrameIfChanged(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence, &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, threshold, tileInfo, dirtyBitmap, dirtyBitmapWords, timeoutMs, &changed))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return changed ? BAKETA_CAPTURE_SUCCESS : BAKETA_CAPTURE_UNCHANGED;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Frame capture if changed failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Frame capture if changed failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 複数の ROI のみをキャプチャ（GPU アトラス経由で1回の Map）
+/// </summary>
+int BaketaCapture_CaptureRegions(int sessionId, BaketaCaptureRegion* regions, int count, BaketaCaptureFrame* frame, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame || !regions || count <= 0)
+    {
+        SetLastError("Invalid frame or region parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    frame->bgraData = nullptr;
+    frame->width = 0;
+    frame->height = 0;
+    frame->stride = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->originalWidth = 0;
+    frame->originalHeight = 0;
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        int dataSize = 0;
+        if (!session->CaptureRegions(regions, count, &frame->bgraData, &dataSize, &frame->width, &frame->height, &frame->timestamp, &frame->sequence, timeoutMs))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        frame->stride = dataSize;
+        frame->originalWidth = frame->width;
+        frame->originalHeight = frame->height;
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Region capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Region capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 文字領域候補のエッジ密度マップを作成（フレームの併用は任意）
+/// </summary>
+int BaketaCapture_CaptureEdgeMap(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, unsigned char* densityMap, int densityMapSize, BaketaCaptureEdgeMapInfo* mapInfo, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!densityMap || densityMapSize <= 0)
+    {
+        SetLastError("Invalid density map buffer");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // 出力構造体を初期化
+    if (frame)
+    {
+        memset(frame, 0, sizeof(*frame));
+    }
+    BaketaCaptureEdgeMapInfo info = {};
+    if (mapInfo)
+    {
+        *mapInfo = info;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        bool captured = session->CaptureEdgeMap(frame, targetWidth, targetHeight, densityMap, densityMapSize, &info, timeoutMs);
+        if (mapInfo)
+        {
+            *mapInfo = info;
+        }
+
+        if (!captured)
+        {
+            if (frame)
+            {
+                frame->bgraData = nullptr;
+            }
+            SetLastError(session->GetLastError());
+            return info.dataSize > densityMapSize ? BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL : BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Edge map capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Edge map capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// フィルターを指定して複数サイズへ同時にリサイズしキャプチャ
+/// </summary>
+int BaketaCapture_CaptureFrameScaled(int sessionId, int filter, BaketaCaptureScaledOutput* outputs, int count, BaketaCaptureFrame* frame, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame || !outputs || count <= 0 || count > BAKETA_CAPTURE_MAX_SCALED_OUTPUTS)
+    {
+        SetLastError("Invalid frame or scaled output parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    frame->bgraData = nullptr;
+    frame->width = 0;
+    frame->height = 0;
+    frame->stride = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->originalWidth = 0;
+    frame->originalHeight = 0;
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        int dataSize = 0;
+        if (!session->CaptureFrameScaled(filter, outputs, count, &frame->bgraData, &dataSize, &frame->width, &frame->height, &frame->timestamp, &frame->sequence, timeoutMs))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        frame->stride = dataSize;
+        frame->originalWidth = frame->width;
+        frame->originalHeight = frame->height;
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Scaled capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Scaled capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 出力フォーマットを指定してキャプチャ（GPU 上で変換してから読み出し）
+/// </summary>
+int BaketaCapture_CaptureFrameEx(int sessionId, BaketaCaptureFrameEx* frame, int format, int targetWidth, int targetHeight, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame)
+    {
+        SetLastError("Invalid frame parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    memset(frame, 0, sizeof(*frame));
+
+    if (format < BAKETA_CAPTURE_FORMAT_BGRA32 || format > BAKETA_CAPTURE_FORMAT_NV12)
+    {
+        SetLastError("Invalid output format");
+        return BAKETA_CAPTURE_ERROR_UNSUPPORTED;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        bool captured = false;
+        if (format == BAKETA_CAPTURE_FORMAT_BGRA32)
+        {
+            // BGRA は既存の読み出し経路をそのまま使う
+            captured = session->CaptureFrameResized(&frame->data, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence,
+                &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, timeoutMs);
+            frame->dataSize = captured ? frame->stride * frame->height : 0;
+        }
+        else
+        {
+            captured = session->CaptureFrameConverted(format, targetWidth, targetHeight, &frame->data, &frame->width, &frame->height,
+                &frame->stride, &frame->dataSize, &frame->timestamp, &frame->sequence, &frame->originalWidth, &frame->originalHeight, timeoutMs);
+        }
+
+        if (!captured)
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        frame->format = format;
+        if (format == BAKETA_CAPTURE_FORMAT_NV12)
+        {
+            frame->uvOffset = frame->stride * frame->height;
+            frame->uvStride = frame->stride;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Format capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Format capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 最新フレームを GPU 共有テクスチャへコピーして NT ハンドルで渡す
+/// </summary>
+int BaketaCapture_ExportSharedFrame(int sessionId, BaketaCaptureSharedFrame* frame, int targetWidth, int targetHeight, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame)
+    {
+        SetLastError("Invalid frame parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    memset(frame, 0, sizeof(*frame));
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        if (!session->ExportSharedFrame(targetWidth, targetHeight, timeoutMs, frame))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Shared frame export failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Shared frame export failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// セッションの共有メモリフレームリングを作成
+/// </summary>
+int BaketaCapture_EnableSharedRing(int sessionId, const wchar_t* name, int slotCount, int maxFrameBytes)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!name || !name[0] || slotCount < 2 || slotCount > SharedFrameRing::kMaxSlotCount || maxFrameBytes <= 0)
+    {
+        SetLastError("Invalid shared ring parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        HRESULT hr = S_OK;
+        if (!session->EnableSharedRing(name, slotCount, maxFrameBytes, &hr))
+        {
+            SetLastError(session->GetLastError());
+            if (hr == HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS))
+            {
+                return BAKETA_CAPTURE_ERROR_ALREADY_EXISTS;
+            }
+            return BAKETA_CAPTURE_ERROR_MEMORY;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Shared ring creation failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        SetLastError("Shared ring creation failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_MEMORY;
+    }
+}
+
+/// <summary>
+/// セッションの共有メモリフレームリングを閉じる
+/// </summary>
+int BaketaCapture_DisableSharedRing(int sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    session->DisableSharedRing();
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+/// <summary>
+/// フレームをキャプチャして共有メモリリングのスロットへ直接書き込む
+/// </summary>
+int BaketaCapture_CaptureToSharedRing(int sessionId, BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs, unsigned long long* frameId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame || !frameId)
+    {
+        SetLastError("Invalid frame or frameId parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    memset(frame, 0, sizeof(*frame));
+    *frameId = 0;
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        if (!session->HasSharedRing())
+        {
+            SetLastError("Shared frame ring not enabled");
+            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+        }
+
+        size_t requiredSize = 0;
+        if (!session->CaptureToSharedRing(frame, targetWidth, targetHeight, timeoutMs, frameId, &requiredSize))
+        {
+            frame->bgraData = nullptr;
+            SetLastError(session->GetLastError());
+            return requiredSize > 0 ? BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL : BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Shared ring capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Shared ring capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// セッションのハードウェアエンコーダーを開始
+/// </summary>
+int BaketaCapture_StartEncoder(int sessionId, const BaketaCaptureEncoderConfig* config)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!config || (config->codec != BAKETA_CAPTURE_CODEC_H264 && config->codec != BAKETA_CAPTURE_CODEC_HEVC) ||
+        config->targetWidth < 0 || config->targetHeight < 0 || config->bitrateKbps <= 0 || config->frameRate <= 0 || config->keyframeInterval < 0)
+    {
+        SetLastError("Invalid encoder configuration");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        HRESULT hr = S_OK;
+        if (!session->StartEncoder(*config, &hr))
+        {
+            SetLastError(session->GetLastError());
+            if (hr == DXGI_ERROR_UNSUPPORTED || hr == MF_E_TOPO_CODEC_NOT_FOUND)
+            {
+                return BAKETA_CAPTURE_ERROR_UNSUPPORTED;
+            }
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("StartEncoder failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("StartEncoder failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// セッションのハードウェアエンコーダーを停止
+/// </summary>
+int BaketaCapture_StopEncoder(int sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    session->StopEncoder();
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+/// <summary>
+/// フレームをハードウェアエンコーダーへ入力
+/// </summary>
+int BaketaCapture_EncodeFrame(int sessionId, int forceKeyframe, int timeoutMs, int* queuedPackets)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    int queued = 0;
+    if (queuedPackets)
+    {
+        *queuedPackets = 0;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        if (!session->HasEncoder())
+        {
+            SetLastError("Encoder not started");
+            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+        }
+
+        bool encoded = session->EncodeFrame(forceKeyframe != 0, timeoutMs, &queued);
+        if (queuedPackets)
+        {
+            *queuedPackets = queued;
+        }
+        if (!encoded)
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("EncodeFrame failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("EncodeFrame failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 最も古い未読のエンコード済みパケットを読み出す
+/// </summary>
+int BaketaCapture_ReadEncodedPacket(int sessionId, unsigned char* buffer, int bufferSize, BaketaCaptureEncodedPacket* packet)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!packet || bufferSize < 0)
+    {
+        SetLastError("Invalid packet or buffer parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    memset(packet, 0, sizeof(*packet));
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        bool available = false;
+        if (!session->ReadEncodedPacket(buffer, bufferSize, packet, &available))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+        }
+
+        if (!available)
+        {
+            return BAKETA_CAPTURE_PENDING;
+        }
+
+        if (!buffer || packet->dataSize > bufferSize)
+        {
+            SetLastError("Packet buffer too small: required " + std::to_string(packet->dataSize) + " bytes");
+            return BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("ReadEncodedPacket failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("ReadEncodedPacket failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 変化矩形のみを読み出して永続フレームを更新しキャプチャ
+/// </summary>
+int BaketaCapture_CaptureFrameDirty(int sessionId, BaketaCaptureFrame* frame, BaketaCaptureRect* dirtyRects, int maxRects, int* rectCount, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame || !rectCount)
+    {
+        SetLastError("Invalid frame parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    frame->bgraData = nullptr;
+    frame->width = 0;
+    frame->height = 0;
+    frame->stride = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->originalWidth = 0;
+    frame->originalHeight = 0;
+    *rectCount = 0;
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        if (!session->CaptureFrameDirty(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence, dirtyRects, maxRects, rectCount, timeoutMs))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        frame->originalWidth = frame->width;
+        frame->originalHeight = frame->height;
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Dirty frame capture failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Dirty frame capture failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// WGC の DirtyRegions 収集を有効化・無効化
+/// </summary>
+int BaketaCapture_SetDirtyRegionMode(int sessionId, int enabled)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (enabled && !WindowsCaptureSession::IsDirtyRegionSupported())
+        {
+            SetLastError("WGC DirtyRegions is not supported on this system");
+            return BAKETA_CAPTURE_ERROR_UNSUPPORTED;
+        }
+
+        if (!session->SetDirtyRegionMode(enabled != 0) && enabled)
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (...)
+    {
+        SetLastError("SetDirtyRegionMode failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 計測レイテンシに基づく解像度の自動調整を設定
+/// </summary>
+int BaketaCapture_SetAdaptiveResolution(int sessionId, int latencyBudgetUs, float minScale)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (latencyBudgetUs > 0 && !(minScale > 0.0f && minScale <= 1.0f))
+    {
+        SetLastError("Minimum scale must be in (0, 1]");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->SetAdaptiveResolution(latencyBudgetUs, minScale))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("SetAdaptiveResolution failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("SetAdaptiveResolution failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+int BaketaCapture_SetAutoSuspend(int sessionId, int enabled)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->GetWindowHandle())
+        {
+            SetLastError("Auto suspend is only supported for window sessions");
+            return BAKETA_CAPTURE_ERROR_UNSUPPORTED;
+        }
+
+        if (!session->SetAutoSuspend(enabled != 0))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("SetAutoSuspend failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("SetAutoSuspend failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+int BaketaCapture_SetPipelinedReadback(int sessionId, int enabled)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->HasOwnFramePool())
+        {
+            SetLastError("Pipelined readback is only supported for window and monitor sessions");
+            return BAKETA_CAPTURE_ERROR_UNSUPPORTED;
+        }
+
+        if (!session->SetPipelinedReadback(enabled != 0))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("SetPipelinedReadback failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("SetPipelinedReadback failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 読み出したフレームの記録を開始
+/// </summary>
+int BaketaCapture_StartRecording(int sessionId, const wchar_t* path)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!path || !path[0])
+    {
+        SetLastError("Invalid recording path");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        HRESULT hr = S_OK;
+        if (!session->StartRecording(path, &hr))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("StartRecording failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("StartRecording failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// フレームの記録を終了
+/// </summary>
+int BaketaCapture_StopRecording(int sessionId, int* frameCount)
+{
+    CaptureLastError::Clear();
+
+    if (frameCount)
+    {
+        *frameCount = 0;
+    }
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        int recorded = 0;
+        HRESULT hr = S_OK;
+        bool stopped = session->StopRecording(&recorded, &hr);
+        if (frameCount)
+        {
+            *frameCount = recorded;
+        }
+        if (!stopped)
+        {
+            SetLastError(session->GetLastError());
+            return hr == S_OK ? BAKETA_CAPTURE_ERROR_NOT_FOUND : BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("StopRecording failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("StopRecording failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 呼び出し側が用意したバッファへフレームをキャプチャ
+/// </summary>
+int BaketaCapture_CaptureFrameInto(int sessionId, BaketaCaptureFrame* frame, unsigned char* buffer, int bufferSize, int* requiredSize, int targetWidth, int targetHeight, int timeoutMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!frame || !buffer || bufferSize <= 0)
+    {
+        SetLastError("Invalid frame or buffer parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    // フレーム構造体を初期化
+    frame->bgraData = nullptr;
+    frame->width = 0;
+    frame->height = 0;
+    frame->stride = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->originalWidth = 0;
+    frame->originalHeight = 0;
+    if (requiredSize)
+    {
+        *requiredSize = 0;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureOutputBuffer outputBuffer;
+        outputBuffer.data = buffer;
+        outputBuffer.capacity = static_cast<size_t>(bufferSize);
+
+        if (!session->CaptureFrameResized(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence, &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, timeoutMs, &outputBuffer))
+        {
+            frame->bgraData = nullptr;
+            if (outputBuffer.requiredSize > outputBuffer.capacity)
+            {
+                if (requiredSize)
+                {
+                    *requiredSize = static_cast<int>(outputBuffer.requiredSize);
+                }
+                SetLastError("Output buffer too small");
+                return BAKETA_CAPTURE_ERROR_BUFFER_TOO_SMALL;
+            }
+
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("Frame capture into buffer failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("Frame capture into buffer failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// ストリーミングモードを開始
+/// </summary>
+int BaketaCapture_StartStreaming(int sessionId, int maxFps, int poolDepth)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->IsValid())
+        {
+            SetLastError("Session is invalid or closing");
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        if (!session->StartStreaming(maxFps, poolDepth))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        SetLastError(std::string("StartStreaming failed: ") + e.what());
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+    catch (...)
+    {
+        SetLastError("StartStreaming failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// ストリーミングモードを停止
+/// </summary>
+int BaketaCapture_StopStreaming(int sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        session->StopStreaming();
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (...)
+    {
+        SetLastError("StopStreaming failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// 最小フレーム間隔を設定（フレームペーシング）
+/// </summary>
+int BaketaCapture_SetMinFrameInterval(int sessionId, int intervalMs)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    session->SetMinFrameInterval(intervalMs);
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+/// <summary>
+/// フレーム到着通知用の自動リセットイベントを取得
+/// </summary>
+int BaketaCapture_GetFrameEvent(int sessionId, void** eventHandle)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    if (!eventHandle)
+    {
+        SetLastError("Invalid event handle parameter");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+    *eventHandle = nullptr;
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        HANDLE duplicated = nullptr;
+        if (!session->DuplicateFrameEvent(&duplicated))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        *eventHandle = duplicated;
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (...)
+    {
+        SetLastError("GetFrameEvent failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// フレーム到着コールバックを設定
+/// </summary>
+int BaketaCapture_SetFrameCallback(int sessionId, BaketaCaptureFrameCallback callback, void* userData)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    try
+    {
+        if (!session->SetFrameCallback(callback, userData))
+        {
+            SetLastError(session->GetLastError());
+            return BAKETA_CAPTURE_ERROR_DEVICE;
+        }
+
+        CaptureLastError::Clear();
+        return BAKETA_CAPTURE_SUCCESS;
+    }
+    catch (...)
+    {
+        SetLastError("SetFrameCallback failed: Unknown error");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+}
+
+/// <summary>
+/// フレームデータを解放 - 🚀 P2最適化: アライメント済みメモリ対応
+/// ネイティブで確保したバッファはプールへ返却（CaptureFrameInto の呼び出し側バッファは何もしない）
+/// </summary>
+void BaketaCapture_ReleaseFrame(BaketaCaptureFrame* frame)
+{
+    if (frame && frame->bgraData)
+    {
+        FrameBufferPool::Instance().Release(frame->bgraData);
+        frame->bgraData = nullptr;
+        frame->width = 0;
+        frame->height = 0;
+        frame->stride = 0;
+        frame->timestamp = 0;
+        frame->sequence = 0;
+        frame->originalWidth = 0;    // 🚀 [Issue #193]
+        frame->originalHeight = 0;   // 🚀 [Issue #193]
+    }
+}
+
+/// <summary>
+/// フォーマット指定付きフレームデータを解放
+/// </summary>
+void BaketaCapture_ReleaseFrameEx(BaketaCaptureFrameEx* frame)
+{
+    if (frame && frame->data)
+    {
+        FrameBufferPool::Instance().Release(frame->data);
+        memset(frame, 0, sizeof(*frame));
+    }
+}
+
+/// <summary>
+/// フレームバッファプールの保持上限を設定
+/// </summary>
+void BaketaCapture_SetFramePoolLimits(long long maxPooledBytes, int maxPooledBuffers)
+{
+    FrameBufferPool::Instance().SetLimits(static_cast<size_t>((std::max)(0LL, maxPooledBytes)), maxPooledBuffers);
+}
+
+/// <summary>
+/// フレームバッファプールの未使用バッファをすべて解放
+/// </summary>
+void BaketaCapture_TrimFramePool()
+{
+    FrameBufferPool::Instance().Trim();
+}
+
+/// <summary>
+/// 診断ログレベルを設定
+/// </summary>
+int BaketaCapture_SetDiagnosticsLevel(int level)
+{
+    int clamped = (std::max)(BAKETA_CAPTURE_DIAG_OFF, (std::min)(level, CaptureDiagnostics::kCompiledLevel));
+    CaptureDiagnostics::g_runtimeLevel.store(clamped, std::memory_order_relaxed);
+    return clamped;
+}
+
+/// <summary>
+/// 現在の診断ログレベルを取得
+/// </summary>
+int BaketaCapture_GetDiagnosticsLevel()
+{
+    return CaptureDiagnostics::g_runtimeLevel.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// キャプチャセッションを削除
+/// [Issue #324] HWNDキャッシュもクリーンアップ
+/// </summary>
+void BaketaCapture_ReleaseSession(int sessionId)
+{
+    // [Issue #324] 一覧とHWNDキャッシュから外す（以降の参照は Session not found）
+    auto session = SessionRegistry::Instance().Remove(sessionId);
+    if (!session)
+    {
+        return;
+    }
+
+    // ロック外でクローズし、実行中のキャプチャには IsClosing を通知する
+    // オブジェクト自体は最後の参照が外れた時点で破棄される
+    session->Close();
+}
+
+/// <summary>
+/// Windows Graphics Capture API がサポートされているかチェック
+/// </summary>
 int BaketaCapture_IsSupported()
 {
     try
@@ -380,23 +2235,96 @@ int BaketaCapture_IsSupported()
 }
 
 /// <summary>
-/// 最後のエラーメッセージを取得
+/// 呼び出しスレッドの最後のエラーメッセージを取得
 /// </summary>
 int BaketaCapture_GetLastError(char* buffer, int bufferSize)
 {
+    const CaptureLastError::Record& record = CaptureLastError::Current();
     if (!buffer || bufferSize <= 0)
     {
-        return static_cast<int>(g_lastError.length());
+        return record.length;
     }
 
-    int copyLength = (std::min)(static_cast<int>(g_lastError.length()), bufferSize - 1);
+    int copyLength = (std::min)(record.length, bufferSize - 1);
     if (copyLength > 0)
     {
-        memcpy(buffer, g_lastError.c_str(), copyLength);
+        memcpy(buffer, record.message, copyLength);
     }
     buffer[copyLength] = '\0';
 
-    return static_cast<int>(g_lastError.length());
+    return record.length;
+}
+
+/// <summary>
+/// 呼び出しスレッドの最後のエラーの段階・HRESULT を取得
+/// </summary>
+int BaketaCapture_GetLastErrorInfo(BaketaCaptureErrorInfo* info)
+{
+    if (!info)
+    {
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    const CaptureLastError::Record& record = CaptureLastError::Current();
+    info->stage = record.stage;
+    info->hresult = static_cast<int>(record.hresult);
+    info->sessionId = record.sessionId;
+    info->messageLength = record.length;
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+/// <summary>
+/// セッションの段階別タイミング・フレーム統計を取得
+/// </summary>
+int BaketaCapture_GetSessionStats(int sessionId, BaketaCaptureStats* stats)
+{
+    CaptureLastError::Clear();
+
+    if (!stats)
+    {
+        SetLastError("Invalid stats pointer");
+        return BAKETA_CAPTURE_ERROR_INVALID_WINDOW;
+    }
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    session->GetStats(stats);
+    return BAKETA_CAPTURE_SUCCESS;
+}
+
+/// <summary>
+/// セッションの統計をリセット
+/// </summary>
+int BaketaCapture_ResetSessionStats(int sessionId)
+{
+    CaptureLastError::Clear();
+
+    if (!g_initialized)
+    {
+        SetLastError("Library not initialized");
+        return BAKETA_CAPTURE_ERROR_DEVICE;
+    }
+
+    auto session = SessionRegistry::Instance().Find(sessionId);
+    if (!session)
+    {
+        SetLastError("Session not found");
+        return BAKETA_CAPTURE_ERROR_NOT_FOUND;
+    }
+
+    session->ResetStats();
+    return BAKETA_CAPTURE_SUCCESS;
 }
 
 /// <summary>
@@ -404,6 +2332,8 @@ int BaketaCapture_GetLastError(char* buffer, int bufferSize)
 /// </summary>
 int BaketaCapture_GetWindowDebugInfo(int sessionId, char* windowInfoBuffer, int windowInfoSize, char* screenRectBuffer, int screenRectSize)
 {
+    CaptureLastError::Clear();
+
     if (!windowInfoBuffer || !screenRectBuffer || windowInfoSize <= 0 || screenRectSize <= 0)
     {
         SetLastError("Invalid parameters for debug info retrieval");
@@ -412,9 +2342,8 @@ int BaketaCapture_GetWindowDebugInfo(int sessionId, char* windowInfoBuffer, int
 
     try
     {
-        std::lock_guard<std::mutex> lock(g_sessionMutex);
-        auto it = g_sessions.find(sessionId);
-        if (it == g_sessions.end())
+        auto session = SessionRegistry::Instance().Find(sessionId);
+        if (!session)
         {
             SetLastError("Session not found for debug info");
             strncpy_s(windowInfoBuffer, windowInfoSize, "Session not found", windowInfoSize - 1);
@@ -423,7 +2352,7 @@ int BaketaCapture_GetWindowDebugInfo(int sessionId, char* windowInfoBuffer, int
         }
 
         std::string windowInfo, screenRect;
-        if (!it->second->GetWindowDebugInfo(windowInfo, screenRect))
+        if (!session->GetWindowDebugInfo(windowInfo, screenRect))
         {
             SetLastError("Failed to get debug info from session");
             strncpy_s(windowInfoBuffer, windowInfoSize, "Failed to get info", windowInfoSize - 1);
@@ -469,7 +2398,8 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
     case DLL_THREAD_DETACH:
         break;
     case DLL_PROCESS_DETACH:
-        BaketaCapture_Shutdown();
+        // lpReserved が非 null の場合はプロセス終了（FreeLibrary によるアンロードでは null）
+        ShutdownLibrary(true, lpReserved != nullptr);
         break;
     }
     return TRUE;
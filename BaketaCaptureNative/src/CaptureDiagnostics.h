@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "BaketaCaptureNative.h"  // BAKETA_CAPTURE_DIAG_* レベル定義
+
+/// <summary>
+/// キャプチャ診断ログのレベル制御
+/// BAKETA_CAPTURE_DIAGNOSTICS_LEVEL でビルド時の上限を決め、上限を超えるログはコンパイル時に除去される。
+/// 実行時レベルは BaketaCapture_SetDiagnosticsLevel で変更でき、既定は OFF（毎フレームの文字列整形を行わない）。
+/// </summary>
+#ifndef BAKETA_CAPTURE_DIAGNOSTICS_LEVEL
+#define BAKETA_CAPTURE_DIAGNOSTICS_LEVEL BAKETA_CAPTURE_DIAG_VERBOSE
+#endif
+
+namespace CaptureDiagnostics
+{
+    /// <summary>
+    /// ビルド時に有効な最大レベル
+    /// </summary>
+    constexpr int kCompiledLevel = BAKETA_CAPTURE_DIAGNOSTICS_LEVEL;
+
+    /// <summary>
+    /// 実行時レベル（プロセス共通）
+    /// </summary>
+    inline std::atomic<int> g_runtimeLevel{ BAKETA_CAPTURE_DIAG_OFF };
+
+    /// <summary>
+    /// 指定レベルのログを出力すべきか判定
+    /// ホットパスでは relaxed ロード1回のみ（上限外のレベルは定数畳み込みで分岐ごと消える）
+    /// </summary>
+    inline bool IsEnabled(int level)
+    {
+        return level <= kCompiledLevel && level <= g_runtimeLevel.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>
+    /// 診断メッセージをデバッガ出力へ書き出す（エラーレコードには残さない）
+    /// レベルが無効なら何もしない。長いメッセージは切り詰める
+    /// </summary>
+    inline void Log(int level, int sessionId, const char* message)
+    {
+        if (!IsEnabled(level) || !message)
+        {
+            return;
+        }
+
+        char buffer[1024];
+        _snprintf_s(buffer, sizeof(buffer), _TRUNCATE, "[BaketaCapture] session %d: %s\n", sessionId, message);
+        OutputDebugStringA(buffer);
+    }
+}
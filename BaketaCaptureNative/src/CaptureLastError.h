@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include "BaketaCaptureNative.h"  // BAKETA_CAPTURE_STAGE_* / BaketaCaptureErrorInfo
+
+/// <summary>
+/// スレッドごとの最後のエラー情報
+/// 固定長バッファに書き込むためヒープ確保を行わず、並行キャプチャ間でメッセージが混ざらない。
+/// BaketaCapture_GetLastError / GetLastErrorInfo は呼び出しスレッド自身のレコードを返す。
+/// </summary>
+namespace CaptureLastError
+{
+    /// <summary>
+    /// メッセージバッファのサイズ（終端文字を含む、超過分は切り詰め）
+    /// </summary>
+    constexpr size_t kMaxMessageLength = 512;
+
+    struct Record
+    {
+        char message[kMaxMessageLength];
+        int length;
+        int stage;         // BAKETA_CAPTURE_STAGE_*
+        HRESULT hresult;
+        int sessionId;
+    };
+
+    /// <summary>
+    /// 呼び出しスレッドのレコード（POD のため動的初期化なし）
+    /// </summary>
+    inline Record& Current()
+    {
+        thread_local Record record = {};
+        return record;
+    }
+
+    /// <summary>
+    /// メッセージのみ更新（段階・HRESULT は直前の Set の値を保持）
+    /// </summary>
+    inline void SetMessage(const char* message, size_t length)
+    {
+        Record& record = Current();
+        if (message == record.message)
+        {
+            // 自スレッドのレコードをそのまま伝播する場合（セッションのエラーをエクスポートで再設定）
+            return;
+        }
+        size_t copyLength = (std::min)(length, kMaxMessageLength - 1);
+        memcpy(record.message, message, copyLength);
+        record.message[copyLength] = '\0';
+        record.length = static_cast<int>(copyLength);
+    }
+
+    inline void SetMessage(const char* message)
+    {
+        SetMessage(message ? message : "", message ? strlen(message) : 0);
+    }
+
+    /// <summary>
+    /// 段階・HRESULT・メッセージを設定
+    /// </summary>
+    inline void Set(int stage, HRESULT hresult, int sessionId, const char* message)
+    {
+        Record& record = Current();
+        record.stage = stage;
+        record.hresult = hresult;
+        record.sessionId = sessionId;
+        SetMessage(message);
+    }
+
+    /// <summary>
+    /// レコードを消去（成功時、呼び出しごとの先頭で使用）
+    /// </summary>
+    inline void Clear()
+    {
+        Record& record = Current();
+        record.message[0] = '\0';
+        record.length = 0;
+        record.stage = BAKETA_CAPTURE_STAGE_NONE;
+        record.hresult = S_OK;
+        record.sessionId = 0;
+    }
+}
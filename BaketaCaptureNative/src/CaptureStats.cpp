@@ -0,0 +1,259 @@
+﻿#include "pch.h"
+
+int LatencyHistogram::BucketIndex(unsigned long long microseconds)
+{
+    if (microseconds < kSubBuckets)
+    {
+        return static_cast<int>(microseconds);
+    }
+
+    unsigned long msb = 0;
+    _BitScanReverse64(&msb, microseconds);
+    if (static_cast<int>(msb) > kMaxExponent)
+    {
+        return kBucketCount - 1;
+    }
+
+    int shift = static_cast<int>(msb) - 3;
+    int sub = static_cast<int>((microseconds >> shift) & (kSubBuckets - 1));
+    return kSubBuckets + shift * kSubBuckets + sub;
+}
+
+unsigned long long LatencyHistogram::BucketUpperBound(int index)
+{
+    if (index < kSubBuckets)
+    {
+        return static_cast<unsigned long long>(index);
+    }
+
+    int shift = (index - kSubBuckets) / kSubBuckets;
+    unsigned long long sub = static_cast<unsigned long long>((index - kSubBuckets) % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(unsigned long long microseconds)
+{
+    m_buckets[BucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+
+    unsigned long long currentMax = m_maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > currentMax &&
+        !m_maxMicroseconds.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::Snapshot(BaketaCaptureStageTiming* timing) const
+{
+    // 記録中のサンプルとはわずかにずれ得るが、パーセンタイルはバケット合計を基準に求める
+    std::array<unsigned int, kBucketCount> counts;
+    unsigned long long total = 0;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    unsigned long long maxMicroseconds = m_maxMicroseconds.load(std::memory_order_relaxed);
+    auto percentile = [&](unsigned long long permille) -> int
+    {
+        if (total == 0)
+        {
+            return 0;
+        }
+        unsigned long long rank = (total * permille + 999) / 1000;
+        unsigned long long seen = 0;
+        for (int i = 0; i < kBucketCount; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                return static_cast<int>((std::min)(BucketUpperBound(i), maxMicroseconds));
+            }
+        }
+        return static_cast<int>(maxMicroseconds);
+    };
+
+    timing->count = static_cast<long long>(m_count.load(std::memory_order_relaxed));
+    timing->p50Us = percentile(500);
+    timing->p95Us = percentile(950);
+    timing->p99Us = percentile(990);
+    timing->maxUs = static_cast<int>((std::min)(maxMicroseconds, static_cast<unsigned long long>(INT_MAX)));
+    timing->totalUs = static_cast<long long>(m_totalMicroseconds.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_totalMicroseconds.store(0, std::memory_order_relaxed);
+    m_maxMicroseconds.store(0, std::memory_order_relaxed);
+}
+
+unsigned long long CaptureStats::ToMicroseconds(long long ticks)
+{
+    static const long long frequency = []
+    {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+
+    if (ticks <= 0)
+    {
+        return 0;
+    }
+    return static_cast<unsigned long long>(ticks) * 1000000ULL / static_cast<unsigned long long>(frequency);
+}
+
+void CaptureStats::RecordStage(int stage, unsigned long long microseconds)
+{
+    if (stage < 0 || stage >= BAKETA_CAPTURE_TIMING_STAGE_COUNT)
+    {
+        return;
+    }
+    m_stages[stage].Record(microseconds);
+}
+
+void CaptureStats::Snapshot(BaketaCaptureStats* stats) const
+{
+    for (int i = 0; i < BAKETA_CAPTURE_TIMING_STAGE_COUNT; ++i)
+    {
+        m_stages[i].Snapshot(&stats->stages[i]);
+    }
+    stats->framesArrived = static_cast<long long>(m_framesArrived.load(std::memory_order_relaxed));
+    stats->framesDelivered = static_cast<long long>(m_framesDelivered.load(std::memory_order_relaxed));
+    stats->framesDropped = static_cast<long long>(m_framesDropped.load(std::memory_order_relaxed));
+    stats->cpuFallbackCount = static_cast<long long>(m_cpuFallbackCount.load(std::memory_order_relaxed));
+    stats->captureFailures = static_cast<long long>(m_captureFailures.load(std::memory_order_relaxed));
+    stats->bufferReuseCount = static_cast<long long>(FrameBufferPool::Instance().GetReuseCount());
+    stats->bufferAllocationCount = static_cast<long long>(FrameBufferPool::Instance().GetAllocationCount());
+}
+
+void CaptureStats::Reset()
+{
+    for (auto& stage : m_stages)
+    {
+        stage.Reset();
+    }
+    m_framesArrived.store(0, std::memory_order_relaxed);
+    m_framesDelivered.store(0, std::memory_order_relaxed);
+    m_framesDropped.store(0, std::memory_order_relaxed);
+    m_cpuFallbackCount.store(0, std::memory_order_relaxed);
+    m_captureFailures.store(0, std::memory_order_relaxed);
+}
+
+bool GpuStageTimer::EnsureQueries(ID3D11Device* device)
+{
+    if (m_slots[0].disjoint)
+    {
+        return true;
+    }
+
+    D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+    D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+    for (auto& slot : m_slots)
+    {
+        if (FAILED(device->CreateQuery(&disjointDesc, &slot.disjoint)) ||
+            FAILED(device->CreateQuery(&timestampDesc, &slot.start)) ||
+            FAILED(device->CreateQuery(&timestampDesc, &slot.end)))
+        {
+            Reset();
+            m_unsupported = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+void GpuStageTimer::Collect(ID3D11DeviceContext* context, CaptureStats& stats, int stage)
+{
+    for (auto& slot : m_slots)
+    {
+        if (!slot.pending)
+        {
+            continue;
+        }
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+        if (context->GetData(slot.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            continue;
+        }
+
+        UINT64 start = 0;
+        UINT64 end = 0;
+        if (context->GetData(slot.start.Get(), &start, sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(slot.end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            continue;
+        }
+
+        slot.pending = false;
+
+        // 計測中にクロックが変化した場合（電源状態の遷移等）は値が無効
+        if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= start)
+        {
+            stats.RecordStage(stage, (end - start) * 1000000ULL / disjoint.Frequency);
+        }
+    }
+}
+
+bool GpuStageTimer::Begin(ID3D11Device* device, ID3D11DeviceContext* context, CaptureStats& stats, int stage)
+{
+    m_activeSlot = -1;
+    if (m_unsupported || !device || !context || !EnsureQueries(device))
+    {
+        return false;
+    }
+
+    Collect(context, stats, stage);
+
+    for (int i = 0; i < kSlotCount; ++i)
+    {
+        if (!m_slots[i].pending)
+        {
+            m_activeSlot = i;
+            break;
+        }
+    }
+    if (m_activeSlot < 0)
+    {
+        return false;
+    }
+
+    Slot& slot = m_slots[m_activeSlot];
+    context->Begin(slot.disjoint.Get());
+    context->End(slot.start.Get());
+    return true;
+}
+
+void GpuStageTimer::End(ID3D11DeviceContext* context)
+{
+    if (m_activeSlot < 0 || !context)
+    {
+        return;
+    }
+
+    Slot& slot = m_slots[m_activeSlot];
+    context->End(slot.end.Get());
+    context->End(slot.disjoint.Get());
+    slot.pending = true;
+    m_activeSlot = -1;
+}
+
+void GpuStageTimer::Reset()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.disjoint.Reset();
+        slot.start.Reset();
+        slot.end.Reset();
+        slot.pending = false;
+    }
+    m_activeSlot = -1;
+}
@@ -0,0 +1,188 @@
+﻿#pragma once
+
+#include "BaketaCaptureNative.h"  // BAKETA_CAPTURE_TIMING_* / BaketaCaptureStats
+
+/// <summary>
+/// ロックフリーのレイテンシヒストグラム（マイクロ秒）
+/// 8 未満は 1us 刻み、それ以上は 2 の冪ごとに 8 分割する対数線形バケット（相対誤差 12.5% 以内）。
+/// 記録は relaxed な fetch_add のみで、読み出し側はスナップショットからパーセンタイルを求める。
+/// </summary>
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kMaxExponent = 26;  // 約 67 秒（超過分は最終バケットへ）
+    static constexpr int kBucketCount = kSubBuckets + (kMaxExponent - 2) * kSubBuckets;
+
+    void Record(unsigned long long microseconds);
+    void Snapshot(BaketaCaptureStageTiming* timing) const;
+    void Reset();
+
+private:
+    static int BucketIndex(unsigned long long microseconds);
+    static unsigned long long BucketUpperBound(int index);
+
+    std::array<std::atomic<unsigned int>, kBucketCount> m_buckets{};
+    std::atomic<unsigned long long> m_count{ 0 };
+    std::atomic<unsigned long long> m_totalMicroseconds{ 0 };
+    std::atomic<unsigned long long> m_maxMicroseconds{ 0 };
+};
+
+/// <summary>
+/// セッションごとのキャプチャ統計（段階別タイミング・フレーム数・フォールバック回数）
+/// どのスレッドからも待機なしで記録でき、BaketaCapture_GetSessionStats でスナップショットを返す。
+/// </summary>
+class CaptureStats
+{
+public:
+    /// <summary>
+    /// 現在の QPC 値
+    /// </summary>
+    static long long Now()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    /// <summary>
+    /// QPC 値の差をマイクロ秒に変換
+    /// </summary>
+    static unsigned long long ToMicroseconds(long long ticks);
+
+    void RecordStage(int stage, unsigned long long microseconds);
+    void RecordStageSince(int stage, long long startTicks) { RecordStage(stage, ToMicroseconds(Now() - startTicks)); }
+
+    void CountArrived() { m_framesArrived.fetch_add(1, std::memory_order_relaxed); }
+    void CountDelivered() { m_framesDelivered.fetch_add(1, std::memory_order_relaxed); }
+    void CountDropped() { m_framesDropped.fetch_add(1, std::memory_order_relaxed); }
+    void CountFallback() { m_cpuFallbackCount.fetch_add(1, std::memory_order_relaxed); }
+    void CountFailure() { m_captureFailures.fetch_add(1, std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 統計のスナップショットを取得（バッファプールの再利用数はプロセス共通値）
+    /// </summary>
+    void Snapshot(BaketaCaptureStats* stats) const;
+
+    void Reset();
+
+private:
+    std::array<LatencyHistogram, BAKETA_CAPTURE_TIMING_STAGE_COUNT> m_stages;
+    std::atomic<unsigned long long> m_framesArrived{ 0 };
+    std::atomic<unsigned long long> m_framesDelivered{ 0 };
+    std::atomic<unsigned long long> m_framesDropped{ 0 };
+    std::atomic<unsigned long long> m_cpuFallbackCount{ 0 };
+    std::atomic<unsigned long long> m_captureFailures{ 0 };
+};
+
+/// <summary>
+/// スコープの経過時間を段階タイミングとして記録する
+/// </summary>
+class StageTimer
+{
+public:
+    StageTimer(CaptureStats& stats, int stage) : m_stats(stats), m_stage(stage), m_start(CaptureStats::Now()) {}
+    ~StageTimer() { m_stats.RecordStageSince(m_stage, m_start); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    CaptureStats& m_stats;
+    int m_stage;
+    long long m_start;
+};
+
+/// <summary>
+/// D3D11 タイムスタンプクエリによる GPU 実行時間の計測
+/// 結果は次回以降の Begin() で待機なしに回収する（GPU を止めない）。全スロットが未完了の場合はその回の計測を省略する。
+/// </summary>
+class GpuStageTimer
+{
+public:
+    static constexpr int kSlotCount = 4;
+
+    /// <summary>
+    /// 計測区間を開始（完了済みの過去の計測を stats へ記録してからクエリを発行）
+    /// </summary>
+    /// <returns>計測を開始した場合は true（End() を呼ぶこと）</returns>
+    bool Begin(ID3D11Device* device, ID3D11DeviceContext* context, CaptureStats& stats, int stage);
+
+    /// <summary>
+    /// 計測区間を終了
+    /// </summary>
+    void End(ID3D11DeviceContext* context);
+
+    void Reset();
+
+private:
+    struct Slot
+    {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> start;
+        ComPtr<ID3D11Query> end;
+        bool pending = false;
+    };
+
+    bool EnsureQueries(ID3D11Device* device);
+    void Collect(ID3D11DeviceContext* context, CaptureStats& stats, int stage);
+
+    std::array<Slot, kSlotCount> m_slots;
+    int m_activeSlot = -1;
+    bool m_unsupported = false;
+};
+
+/// <summary>
+/// Capture* 呼び出し1回分の所要時間（TOTAL）と成否を記録する
+/// Capture* が内部で別の Capture* を呼ぶ場合は最も外側の呼び出しのみを記録する。
+/// </summary>
+class CaptureCallScope
+{
+public:
+    explicit CaptureCallScope(CaptureStats& stats)
+        : m_stats(stats), m_outermost(Depth()++ == 0), m_start(CaptureStats::Now()) {}
+
+    ~CaptureCallScope()
+    {
+        --Depth();
+        if (!m_outermost)
+        {
+            return;
+        }
+
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_TOTAL, m_start);
+        if (m_succeeded)
+        {
+            m_stats.CountDelivered();
+        }
+        else
+        {
+            m_stats.CountFailure();
+        }
+    }
+
+    CaptureCallScope(const CaptureCallScope&) = delete;
+    CaptureCallScope& operator=(const CaptureCallScope&) = delete;
+
+    /// <summary>
+    /// 成功として記録し true を返す（return callScope.Succeed(); で使用）
+    /// </summary>
+    bool Succeed() { m_succeeded = true; return true; }
+
+    /// <summary>
+    /// 結果を記録してそのまま返す
+    /// </summary>
+    bool Complete(bool succeeded) { m_succeeded = succeeded; return succeeded; }
+
+private:
+    static int& Depth()
+    {
+        static thread_local int depth = 0;
+        return depth;
+    }
+
+    CaptureStats& m_stats;
+    bool m_outermost;
+    bool m_succeeded = false;
+    long long m_start;
+};
@@ -0,0 +1,218 @@
+﻿#include "pch.h"
+
+// 出力アトラスの最大サイズ（D3D11 のテクスチャ上限）
+static constexpr UINT kMaxScaledAtlasSize = 16384;
+
+// リサイズコンピュートシェーダー（ScaleShader.hlsl をビルド時にコンパイルしたバイトコード）
+#include "shaders/ScaleCS.h"
+
+struct ScaleParams
+{
+    UINT sourceWidth;
+    UINT sourceHeight;
+    UINT outputCount;
+    UINT filterMode;
+    UINT outputRects[ComputeResizer::kMaxOutputs][4];
+};
+
+bool ComputeResizer::InitializeShader(ID3D11Device* device, HRESULT* hr)
+{
+    if (m_shaderInitialized)
+    {
+        return true;
+    }
+
+    // cs_5_0 と型付き UAV ストアはフィーチャーレベル 11_0 以上が必要
+    if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+    {
+        if (hr) *hr = DXGI_ERROR_UNSUPPORTED;
+        return false;
+    }
+
+    HRESULT result = device->CreateComputeShader(g_ScaleCS, sizeof(g_ScaleCS), nullptr, &m_computeShader);
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(ScaleParams);
+        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        result = device->CreateBuffer(&cbDesc, nullptr, &m_constantBuffer);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        result = device->CreateSamplerState(&samplerDesc, &m_linearSampler);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_computeShader.Reset();
+        m_constantBuffer.Reset();
+        m_linearSampler.Reset();
+        return false;
+    }
+
+    m_shaderInitialized = true;
+    return true;
+}
+
+bool ComputeResizer::EnsureAtlas(ID3D11Device* device, UINT width, UINT height, HRESULT* hr)
+{
+    if (m_atlas && width <= m_atlasWidth && height <= m_atlasHeight)
+    {
+        return true;
+    }
+
+    m_atlasUav.Reset();
+    m_atlas.Reset();
+
+    D3D11_TEXTURE2D_DESC atlasDesc = {};
+    atlasDesc.Width = (std::max)(width, m_atlasWidth);
+    atlasDesc.Height = (std::max)(height, m_atlasHeight);
+    atlasDesc.MipLevels = 1;
+    atlasDesc.ArraySize = 1;
+    atlasDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;  // B8G8R8A8 の型付き UAV ストアはオプション機能のため
+    atlasDesc.SampleDesc.Count = 1;
+    atlasDesc.Usage = D3D11_USAGE_DEFAULT;
+    atlasDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+
+    HRESULT result = device->CreateTexture2D(&atlasDesc, nullptr, &m_atlas);
+    if (SUCCEEDED(result))
+    {
+        result = device->CreateUnorderedAccessView(m_atlas.Get(), nullptr, &m_atlasUav);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_atlas.Reset();
+        m_atlasUav.Reset();
+        m_atlasWidth = 0;
+        m_atlasHeight = 0;
+        return false;
+    }
+
+    m_atlasWidth = atlasDesc.Width;
+    m_atlasHeight = atlasDesc.Height;
+    return true;
+}
+
+bool ComputeResizer::Resize(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* source,
+    UINT sourceWidth, UINT sourceHeight, int filter, const SIZE* sizes, int count, POINT* positions, HRESULT* hr)
+{
+    if (!device || !context || !source || !sizes || !positions || count <= 0 || count > kMaxOutputs ||
+        sourceWidth == 0 || sourceHeight == 0 ||
+        filter < BAKETA_CAPTURE_FILTER_BILINEAR || filter > BAKETA_CAPTURE_FILTER_LANCZOS2)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!InitializeShader(device, hr))
+    {
+        return false;
+    }
+
+    // 共有コンテキスト上でシェーダー・ビューの設定からディスパッチまでを他セッションと混在させない
+    D3DContextLock contextLock(context);
+
+    // 出力 0 を左上に置き、残りをその右側へ縦に積む
+    UINT columnWidth = 0;
+    UINT columnHeight = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (sizes[i].cx <= 0 || sizes[i].cy <= 0)
+        {
+            if (hr) *hr = E_INVALIDARG;
+            return false;
+        }
+
+        if (i == 0)
+        {
+            positions[0] = { 0, 0 };
+            continue;
+        }
+
+        positions[i] = { sizes[0].cx, static_cast<LONG>(columnHeight) };
+        columnWidth = (std::max)(columnWidth, static_cast<UINT>(sizes[i].cx));
+        columnHeight += static_cast<UINT>(sizes[i].cy);
+    }
+
+    UINT usedWidth = static_cast<UINT>(sizes[0].cx) + columnWidth;
+    UINT usedHeight = (std::max)(static_cast<UINT>(sizes[0].cy), columnHeight);
+    if (usedWidth > kMaxScaledAtlasSize || usedHeight > kMaxScaledAtlasSize)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!EnsureAtlas(device, usedWidth, usedHeight, hr))
+    {
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedCb;
+    HRESULT result = context->Map(m_constantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedCb);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    auto* params = static_cast<ScaleParams*>(mappedCb.pData);
+    *params = {};
+    params->sourceWidth = sourceWidth;
+    params->sourceHeight = sourceHeight;
+    params->outputCount = static_cast<UINT>(count);
+    params->filterMode = static_cast<UINT>(filter);
+    for (int i = 0; i < count; ++i)
+    {
+        params->outputRects[i][0] = static_cast<UINT>(positions[i].x);
+        params->outputRects[i][1] = static_cast<UINT>(positions[i].y);
+        params->outputRects[i][2] = static_cast<UINT>(sizes[i].cx);
+        params->outputRects[i][3] = static_cast<UINT>(sizes[i].cy);
+    }
+    context->Unmap(m_constantBuffer.Get(), 0);
+
+    ID3D11ShaderResourceView* srvs[1] = { source };
+    ID3D11UnorderedAccessView* uavs[1] = { m_atlasUav.Get() };
+    ID3D11Buffer* cbs[1] = { m_constantBuffer.Get() };
+    ID3D11SamplerState* samplers[1] = { m_linearSampler.Get() };
+    context->CSSetShader(m_computeShader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 1, srvs);
+    context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+    context->CSSetConstantBuffers(0, 1, cbs);
+    context->CSSetSamplers(0, 1, samplers);
+    context->Dispatch((usedWidth + 7) / 8, (usedHeight + 7) / 8, 1);
+
+    // 後続のパスと競合しないようバインドを解除
+    ID3D11ShaderResourceView* nullSrvs[1] = { nullptr };
+    ID3D11UnorderedAccessView* nullUavs[1] = { nullptr };
+    context->CSSetShaderResources(0, 1, nullSrvs);
+    context->CSSetUnorderedAccessViews(0, 1, nullUavs, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    m_usedWidth = usedWidth;
+    m_usedHeight = usedHeight;
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+void ComputeResizer::Reset()
+{
+    m_atlasUav.Reset();
+    m_atlas.Reset();
+    m_atlasWidth = 0;
+    m_atlasHeight = 0;
+    m_usedWidth = 0;
+    m_usedHeight = 0;
+}
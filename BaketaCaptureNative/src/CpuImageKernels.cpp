@@ -0,0 +1,551 @@
+﻿#include "pch.h"
+
+namespace CpuImageKernels
+{
+namespace
+{
+    // 1 バンドの最小バイト数（これ未満に分割するとスレッド起床のコストが上回る）
+    constexpr size_t kMinBandBytes = 256 * 1024;
+
+    // 固定小数点の補間係数（7bit）
+    constexpr int kFracBits = 7;
+    constexpr int kFracOne = 1 << kFracBits;
+
+    SimdLevel DetectSimdLevel()
+    {
+        int info[4] = {};
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        if (maxLeaf < 1)
+        {
+            return SimdLevel::Scalar;
+        }
+
+        __cpuid(info, 1);
+        bool ssse3 = (info[2] & (1 << 9)) != 0;
+        bool sse41 = (info[2] & (1 << 19)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!ssse3 || !sse41)
+        {
+            return SimdLevel::Scalar;
+        }
+
+        // AVX2 は OS が YMM レジスタを保存する場合のみ使用
+        if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            if ((info[1] & (1 << 5)) != 0)
+            {
+                return SimdLevel::Avx2;
+            }
+        }
+        return SimdLevel::Sse41;
+    }
+
+    int MinRowsPerBand(size_t rowBytes)
+    {
+        return static_cast<int>((std::max)<size_t>(1, kMinBandBytes / (std::max)<size_t>(1, rowBytes)));
+    }
+
+    // ===== 行コピー =====
+
+    void CopyRowSse41(const unsigned char* src, unsigned char* dst, size_t bytes)
+    {
+        size_t i = 0;
+        for (; i + 64 <= bytes; i += 64)
+        {
+            auto* s = reinterpret_cast<__m128i*>(const_cast<unsigned char*>(src + i));
+            __m128i a = _mm_stream_load_si128(s);
+            __m128i b = _mm_stream_load_si128(s + 1);
+            __m128i c = _mm_stream_load_si128(s + 2);
+            __m128i d = _mm_stream_load_si128(s + 3);
+            auto* o = reinterpret_cast<__m128i*>(dst + i);
+            _mm_storeu_si128(o, a);
+            _mm_storeu_si128(o + 1, b);
+            _mm_storeu_si128(o + 2, c);
+            _mm_storeu_si128(o + 3, d);
+        }
+        if (i < bytes)
+        {
+            memcpy(dst + i, src + i, bytes - i);
+        }
+    }
+
+    void CopyRowAvx2(const unsigned char* src, unsigned char* dst, size_t bytes)
+    {
+        size_t i = 0;
+        for (; i + 128 <= bytes; i += 128)
+        {
+            auto* s = reinterpret_cast<__m256i*>(const_cast<unsigned char*>(src + i));
+            __m256i a = _mm256_stream_load_si256(s);
+            __m256i b = _mm256_stream_load_si256(s + 1);
+            __m256i c = _mm256_stream_load_si256(s + 2);
+            __m256i d = _mm256_stream_load_si256(s + 3);
+            auto* o = reinterpret_cast<__m256i*>(dst + i);
+            _mm256_storeu_si256(o, a);
+            _mm256_storeu_si256(o + 1, b);
+            _mm256_storeu_si256(o + 2, c);
+            _mm256_storeu_si256(o + 3, d);
+        }
+        if (i < bytes)
+        {
+            CopyRowSse41(src + i, dst + i, bytes - i);
+        }
+    }
+
+    void CopyRow(SimdLevel level, const unsigned char* src, unsigned char* dst, size_t bytes)
+    {
+        uintptr_t address = reinterpret_cast<uintptr_t>(src);
+        if (level == SimdLevel::Avx2 && (address & 31) == 0)
+        {
+            CopyRowAvx2(src, dst, bytes);
+        }
+        else if (level != SimdLevel::Scalar && (address & 15) == 0)
+        {
+            CopyRowSse41(src, dst, bytes);
+        }
+        else
+        {
+            memcpy(dst, src, bytes);
+        }
+    }
+
+    // ===== バイリニア =====
+
+    // 出力ピクセル中心をソース座標へ写像し、整数位置と 7bit 係数 (0〜128) を求める
+    void BuildBilinearAxis(int srcSize, int dstSize, std::vector<int>& index, std::vector<int>& frac)
+    {
+        index.resize(static_cast<size_t>(dstSize));
+        frac.resize(static_cast<size_t>(dstSize));
+        for (int i = 0; i < dstSize; ++i)
+        {
+            long long pos = ((2LL * i + 1) * srcSize * 65536) / (2LL * dstSize) - 32768;
+            pos = (std::max)(0LL, pos);
+            int idx = static_cast<int>(pos >> 16);
+            int f = static_cast<int>(((pos & 0xFFFF) * kFracOne + 32768) >> 16);
+            if (f >= kFracOne)
+            {
+                ++idx;
+                f = 0;
+            }
+            if (idx >= srcSize - 1)
+            {
+                idx = (std::max)(0, srcSize - 1);
+                f = 0;
+            }
+            index[i] = idx;
+            frac[i] = f;
+        }
+    }
+
+    // 水平補間: out = p0 * 128 + (p1 - p0) * f（0〜32640、uint16 に収まる）
+    void HorizontalRowScalar(const unsigned char* row, int srcWidth, const int* xIndex, const int* xFrac, int begin, int end, unsigned short* out)
+    {
+        for (int x = begin; x < end; ++x)
+        {
+            const unsigned char* p0 = row + static_cast<size_t>(xIndex[x]) * 4;
+            const unsigned char* p1 = row + static_cast<size_t>((std::min)(xIndex[x] + 1, srcWidth - 1)) * 4;
+            int f = xFrac[x];
+            for (int c = 0; c < 4; ++c)
+            {
+                out[x * 4 + c] = static_cast<unsigned short>(p0[c] * kFracOne + (p1[c] - p0[c]) * f);
+            }
+        }
+    }
+
+    // 2 出力ピクセルずつ処理（隣接 2 ソースピクセルを 8 バイトで読み込む。xIndex <= srcWidth - 2 が前提）
+    void HorizontalRowSse41(const unsigned char* row, const int* xIndex, const int* xFrac, int count, unsigned short* out)
+    {
+        int x = 0;
+        for (; x + 2 <= count; x += 2)
+        {
+            __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + static_cast<size_t>(xIndex[x]) * 4));
+            __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + static_cast<size_t>(xIndex[x + 1]) * 4));
+            // [A0 A1 B0 B1] → [A0 B0 A1 B1]
+            __m128i ab = _mm_shuffle_epi32(_mm_unpacklo_epi64(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i p0 = _mm_cvtepu8_epi16(ab);
+            __m128i p1 = _mm_cvtepu8_epi16(_mm_srli_si128(ab, 8));
+            __m128i w = _mm_set_epi16(
+                static_cast<short>(xFrac[x + 1]), static_cast<short>(xFrac[x + 1]), static_cast<short>(xFrac[x + 1]), static_cast<short>(xFrac[x + 1]),
+                static_cast<short>(xFrac[x]), static_cast<short>(xFrac[x]), static_cast<short>(xFrac[x]), static_cast<short>(xFrac[x]));
+            __m128i h = _mm_add_epi16(_mm_slli_epi16(p0, kFracBits), _mm_mullo_epi16(_mm_sub_epi16(p1, p0), w));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), h);
+        }
+        for (; x < count; ++x)
+        {
+            const unsigned char* p0 = row + static_cast<size_t>(xIndex[x]) * 4;
+            for (int c = 0; c < 4; ++c)
+            {
+                out[x * 4 + c] = static_cast<unsigned short>(p0[c] * kFracOne + (p0[c + 4] - p0[c]) * xFrac[x]);
+            }
+        }
+    }
+
+    // 垂直補間: v = t0 + (t1 - t0) * fy / 128、out = (v + 64) >> 7
+    // SIMD 版の _mm_mulhrs_epi16 と同じ丸め（係数は fy << 8、fy は 0〜127）
+    void VerticalRowScalar(const unsigned short* t0, const unsigned short* t1, int fy, int count, unsigned char* out, int begin)
+    {
+        int weight = fy << 8;
+        for (int i = begin; i < count; ++i)
+        {
+            int d = static_cast<int>(t1[i]) - static_cast<int>(t0[i]);
+            int v = t0[i] + ((d * weight + 0x4000) >> 15);
+            out[i] = static_cast<unsigned char>((std::min)(255, (v + 64) >> kFracBits));
+        }
+    }
+
+    void VerticalRowSse41(const unsigned short* t0, const unsigned short* t1, int fy, int count, unsigned char* out)
+    {
+        const __m128i weight = _mm_set1_epi16(static_cast<short>(fy << 8));
+        const __m128i round = _mm_set1_epi16(1 << (kFracBits - 1));
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t0 + i));
+            __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t0 + i + 8));
+            __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t1 + i));
+            __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t1 + i + 8));
+            __m128i v0 = _mm_add_epi16(a0, _mm_mulhrs_epi16(_mm_sub_epi16(b0, a0), weight));
+            __m128i v1 = _mm_add_epi16(a1, _mm_mulhrs_epi16(_mm_sub_epi16(b1, a1), weight));
+            v0 = _mm_srli_epi16(_mm_add_epi16(v0, round), kFracBits);
+            v1 = _mm_srli_epi16(_mm_add_epi16(v1, round), kFracBits);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v0, v1));
+        }
+        VerticalRowScalar(t0, t1, fy, count, out, i);
+    }
+
+    void VerticalRowAvx2(const unsigned short* t0, const unsigned short* t1, int fy, int count, unsigned char* out)
+    {
+        const __m256i weight = _mm256_set1_epi16(static_cast<short>(fy << 8));
+        const __m256i round = _mm256_set1_epi16(1 << (kFracBits - 1));
+        int i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t0 + i));
+            __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t0 + i + 16));
+            __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t1 + i));
+            __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t1 + i + 16));
+            __m256i v0 = _mm256_add_epi16(a0, _mm256_mulhrs_epi16(_mm256_sub_epi16(b0, a0), weight));
+            __m256i v1 = _mm256_add_epi16(a1, _mm256_mulhrs_epi16(_mm256_sub_epi16(b1, a1), weight));
+            v0 = _mm256_srli_epi16(_mm256_add_epi16(v0, round), kFracBits);
+            v1 = _mm256_srli_epi16(_mm256_add_epi16(v1, round), kFracBits);
+            // packus はレーン単位のため 64bit 単位で並べ直す
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+        }
+        if (i < count)
+        {
+            VerticalRowSse41(t0 + i, t1 + i, fy, count - i, out + i);
+        }
+    }
+
+    void ResizeBilinearBand(SimdLevel level, const ConstImage& src, const Image& dst,
+        const std::vector<int>& xIndex, const std::vector<int>& xFrac,
+        const std::vector<int>& yIndex, const std::vector<int>& yFrac, int rowBegin, int rowEnd)
+    {
+        const int valueCount = dst.width * 4;
+        std::vector<unsigned short> buffers(static_cast<size_t>(valueCount) * 2);
+        unsigned short* bufferA = buffers.data();
+        unsigned short* bufferB = bufferA + valueCount;
+        int rowA = -1;
+        int rowB = -1;
+
+        // SIMD 水平補間は xIndex + 1 を同時に読むため、境界の出力ピクセルは xIndex <= srcWidth - 2 の範囲で開始位置を調整する
+        const bool simdHorizontal = level != SimdLevel::Scalar && src.width >= 2;
+        int simdCount = dst.width;
+        while (simdHorizontal && simdCount > 0 && xIndex[simdCount - 1] > src.width - 2)
+        {
+            --simdCount;
+        }
+
+        auto interpolateRow = [&](int sourceRow, unsigned short* out)
+        {
+            const unsigned char* row = src.data + static_cast<size_t>(sourceRow) * src.stride;
+            if (simdHorizontal)
+            {
+                HorizontalRowSse41(row, xIndex.data(), xFrac.data(), simdCount, out);
+                HorizontalRowScalar(row, src.width, xIndex.data(), xFrac.data(), simdCount, dst.width, out);
+            }
+            else
+            {
+                HorizontalRowScalar(row, src.width, xIndex.data(), xFrac.data(), 0, dst.width, out);
+            }
+        };
+
+        // 水平補間済みの 2 行を保持し、出力行が同じソース行を使う間は再計算しない
+        auto fetchRow = [&](int sourceRow, int keepRow) -> const unsigned short*
+        {
+            if (rowA == sourceRow) return bufferA;
+            if (rowB == sourceRow) return bufferB;
+            if (rowA != keepRow)
+            {
+                interpolateRow(sourceRow, bufferA);
+                rowA = sourceRow;
+                return bufferA;
+            }
+            interpolateRow(sourceRow, bufferB);
+            rowB = sourceRow;
+            return bufferB;
+        };
+
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            int sy0 = yIndex[y];
+            int sy1 = (std::min)(sy0 + 1, src.height - 1);
+            const unsigned short* t0 = fetchRow(sy0, sy1);
+            const unsigned short* t1 = fetchRow(sy1, sy0);
+            unsigned char* out = dst.data + static_cast<size_t>(y) * dst.stride;
+
+            switch (level)
+            {
+            case SimdLevel::Avx2:
+                VerticalRowAvx2(t0, t1, yFrac[y], valueCount, out);
+                break;
+            case SimdLevel::Sse41:
+                VerticalRowSse41(t0, t1, yFrac[y], valueCount, out);
+                break;
+            default:
+                VerticalRowScalar(t0, t1, yFrac[y], valueCount, out, 0);
+                break;
+            }
+        }
+    }
+
+    // ===== 面積平均 =====
+
+    void BuildAreaAxis(int srcSize, int dstSize, std::vector<int>& first, std::vector<int>& last)
+    {
+        first.resize(static_cast<size_t>(dstSize));
+        last.resize(static_cast<size_t>(dstSize));
+        for (int i = 0; i < dstSize; ++i)
+        {
+            int begin = static_cast<int>(static_cast<long long>(i) * srcSize / dstSize);
+            int end = static_cast<int>(static_cast<long long>(i + 1) * srcSize / dstSize);
+            first[i] = begin;
+            last[i] = (std::max)(begin + 1, end);
+        }
+    }
+
+    void ResizeAreaBand(SimdLevel level, const ConstImage& src, const Image& dst,
+        const std::vector<int>& xFirst, const std::vector<int>& xLast,
+        const std::vector<int>& yFirst, const std::vector<int>& yLast, int rowBegin, int rowEnd)
+    {
+        std::vector<unsigned int> sums(static_cast<size_t>(dst.width) * 4);
+
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            std::fill(sums.begin(), sums.end(), 0u);
+
+            // ソース行を順に読み、出力ピクセルごとに加算（行方向に連続アクセス）
+            for (int sy = yFirst[y]; sy < yLast[y]; ++sy)
+            {
+                const unsigned char* row = src.data + static_cast<size_t>(sy) * src.stride;
+                for (int x = 0; x < dst.width; ++x)
+                {
+                    unsigned int* sum = sums.data() + static_cast<size_t>(x) * 4;
+                    if (level != SimdLevel::Scalar)
+                    {
+                        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum));
+                        for (int sx = xFirst[x]; sx < xLast[x]; ++sx)
+                        {
+                            int pixel;
+                            memcpy(&pixel, row + static_cast<size_t>(sx) * 4, sizeof(pixel));
+                            acc = _mm_add_epi32(acc, _mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel)));
+                        }
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(sum), acc);
+                    }
+                    else
+                    {
+                        for (int sx = xFirst[x]; sx < xLast[x]; ++sx)
+                        {
+                            const unsigned char* p = row + static_cast<size_t>(sx) * 4;
+                            sum[0] += p[0];
+                            sum[1] += p[1];
+                            sum[2] += p[2];
+                            sum[3] += p[3];
+                        }
+                    }
+                }
+            }
+
+            unsigned char* out = dst.data + static_cast<size_t>(y) * dst.stride;
+            int rowsInBox = yLast[y] - yFirst[y];
+            for (int x = 0; x < dst.width; ++x)
+            {
+                const unsigned int* sum = sums.data() + static_cast<size_t>(x) * 4;
+                unsigned int count = static_cast<unsigned int>(rowsInBox * (xLast[x] - xFirst[x]));
+                if (level != SimdLevel::Scalar)
+                {
+                    __m128 scaled = _mm_add_ps(
+                        _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sum))), _mm_set1_ps(1.0f / count)),
+                        _mm_set1_ps(0.5f));
+                    __m128i value = _mm_cvttps_epi32(scaled);
+                    value = _mm_packus_epi16(_mm_packus_epi32(value, value), value);
+                    int pixel = _mm_cvtsi128_si32(value);
+                    memcpy(out + static_cast<size_t>(x) * 4, &pixel, sizeof(pixel));
+                }
+                else
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        out[x * 4 + c] = static_cast<unsigned char>((sum[c] + count / 2) / count);
+                    }
+                }
+            }
+        }
+    }
+
+    // ===== グレースケール =====
+
+    // BT.601 係数を 128 倍（B 15, G 75, R 38、合計 128）
+    constexpr int kGrayWeightB = 15;
+    constexpr int kGrayWeightG = 75;
+    constexpr int kGrayWeightR = 38;
+
+    void GrayRowScalar(const unsigned char* src, unsigned char* dst, int begin, int width)
+    {
+        for (int x = begin; x < width; ++x)
+        {
+            const unsigned char* p = src + static_cast<size_t>(x) * 4;
+            dst[x] = static_cast<unsigned char>((p[0] * kGrayWeightB + p[1] * kGrayWeightG + p[2] * kGrayWeightR + 64) >> 7);
+        }
+    }
+
+    void GrayRowSse41(const unsigned char* src, unsigned char* dst, int width)
+    {
+        const __m128i weights = _mm_setr_epi8(
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0,
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0);
+        const __m128i round = _mm_set1_epi16(64);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            const auto* s = reinterpret_cast<const __m128i*>(src + static_cast<size_t>(x) * 4);
+            __m128i m0 = _mm_maddubs_epi16(_mm_loadu_si128(s), weights);
+            __m128i m1 = _mm_maddubs_epi16(_mm_loadu_si128(s + 1), weights);
+            __m128i m2 = _mm_maddubs_epi16(_mm_loadu_si128(s + 2), weights);
+            __m128i m3 = _mm_maddubs_epi16(_mm_loadu_si128(s + 3), weights);
+            __m128i g0 = _mm_srli_epi16(_mm_add_epi16(_mm_hadd_epi16(m0, m1), round), 7);
+            __m128i g1 = _mm_srli_epi16(_mm_add_epi16(_mm_hadd_epi16(m2, m3), round), 7);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(g0, g1));
+        }
+        GrayRowScalar(src, dst, x, width);
+    }
+
+    void GrayRowAvx2(const unsigned char* src, unsigned char* dst, int width)
+    {
+        const __m256i weights = _mm256_setr_epi8(
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0,
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0,
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0,
+            kGrayWeightB, kGrayWeightG, kGrayWeightR, 0, kGrayWeightB, kGrayWeightG, kGrayWeightR, 0);
+        const __m256i round = _mm256_set1_epi16(64);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        int x = 0;
+        for (; x + 32 <= width; x += 32)
+        {
+            const auto* s = reinterpret_cast<const __m256i*>(src + static_cast<size_t>(x) * 4);
+            __m256i m0 = _mm256_maddubs_epi16(_mm256_loadu_si256(s), weights);
+            __m256i m1 = _mm256_maddubs_epi16(_mm256_loadu_si256(s + 1), weights);
+            __m256i m2 = _mm256_maddubs_epi16(_mm256_loadu_si256(s + 2), weights);
+            __m256i m3 = _mm256_maddubs_epi16(_mm256_loadu_si256(s + 3), weights);
+            __m256i g0 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(m0, m1), round), 7);
+            __m256i g1 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(m2, m3), round), 7);
+            // hadd / packus はレーン単位のため 4 ピクセル単位で並べ直す
+            __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(g0, g1), order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), packed);
+        }
+        if (x < width)
+        {
+            GrayRowSse41(src + static_cast<size_t>(x) * 4, dst + x, width - x);
+        }
+    }
+}
+
+SimdLevel GetSimdLevel()
+{
+    static const SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+void CopyPlane(const unsigned char* src, size_t srcPitch, unsigned char* dst, size_t dstStride, size_t rowBytes, int rows)
+{
+    if (!src || !dst || rowBytes == 0 || rows <= 0)
+    {
+        return;
+    }
+
+    SimdLevel level = GetSimdLevel();
+    CpuWorkerPool::Instance().ParallelFor(rows, MinRowsPerBand(rowBytes), [&](int begin, int end)
+    {
+        for (int y = begin; y < end; ++y)
+        {
+            CopyRow(level, src + static_cast<size_t>(y) * srcPitch, dst + static_cast<size_t>(y) * dstStride, rowBytes);
+        }
+    });
+}
+
+void ResizeBgra(const ConstImage& src, const Image& dst)
+{
+    if (!src.data || !dst.data || src.width <= 0 || src.height <= 0 || dst.width <= 0 || dst.height <= 0)
+    {
+        return;
+    }
+
+    SimdLevel level = GetSimdLevel();
+    int minRows = MinRowsPerBand(static_cast<size_t>(src.width) * 4);
+
+    if (src.width >= dst.width * 2 && src.height >= dst.height * 2)
+    {
+        std::vector<int> xFirst, xLast, yFirst, yLast;
+        BuildAreaAxis(src.width, dst.width, xFirst, xLast);
+        BuildAreaAxis(src.height, dst.height, yFirst, yLast);
+        // 出力 1 行あたり縮小率分のソース行を読むため、その分だけバンドを細かくできる
+        int rowsPerOutput = (std::max)(1, src.height / dst.height);
+        CpuWorkerPool::Instance().ParallelFor(dst.height, (std::max)(1, minRows / rowsPerOutput), [&](int begin, int end)
+        {
+            ResizeAreaBand(level, src, dst, xFirst, xLast, yFirst, yLast, begin, end);
+        });
+        return;
+    }
+
+    std::vector<int> xIndex, xFrac, yIndex, yFrac;
+    BuildBilinearAxis(src.width, dst.width, xIndex, xFrac);
+    BuildBilinearAxis(src.height, dst.height, yIndex, yFrac);
+    CpuWorkerPool::Instance().ParallelFor(dst.height, minRows, [&](int begin, int end)
+    {
+        ResizeBilinearBand(level, src, dst, xIndex, xFrac, yIndex, yFrac, begin, end);
+    });
+}
+
+void BgraToGray(const ConstImage& src, const Image& dst)
+{
+    if (!src.data || !dst.data || src.width != dst.width || src.height != dst.height || src.width <= 0 || src.height <= 0)
+    {
+        return;
+    }
+
+    SimdLevel level = GetSimdLevel();
+    CpuWorkerPool::Instance().ParallelFor(src.height, MinRowsPerBand(static_cast<size_t>(src.width) * 4), [&](int begin, int end)
+    {
+        for (int y = begin; y < end; ++y)
+        {
+            const unsigned char* in = src.data + static_cast<size_t>(y) * src.stride;
+            unsigned char* out = dst.data + static_cast<size_t>(y) * dst.stride;
+            switch (level)
+            {
+            case SimdLevel::Avx2:
+                GrayRowAvx2(in, out, src.width);
+                break;
+            case SimdLevel::Sse41:
+                GrayRowSse41(in, out, src.width);
+                break;
+            default:
+                GrayRowScalar(in, out, 0, src.width);
+                break;
+            }
+        }
+    });
+}
+}
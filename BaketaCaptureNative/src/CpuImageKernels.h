@@ -0,0 +1,66 @@
+﻿#pragma once
+
+/// <summary>
+/// CPU 画像処理カーネル（GPU リサイズ・変換が使えない環境のフォールバック用）
+/// SSE4.1 / AVX2 の実装を CPUID で実行時に選択し、CpuWorkerPool で行バンドに分割して並列処理する。
+/// マップしたステージングメモリは書き込み結合（非キャッシュ）の場合があるため、
+/// CopyPlane でストリーミングロード（MOVNTDQA）を使ってキャッシュ可能なバッファへ一度だけ読み出してから処理すること。
+/// </summary>
+namespace CpuImageKernels
+{
+    enum class SimdLevel
+    {
+        Scalar = 0,
+        Sse41 = 1,  // SSE4.1 + SSSE3
+        Avx2 = 2,
+    };
+
+    /// <summary>
+    /// 読み取り専用の画像（BGRA は 4 バイト/ピクセル）
+    /// </summary>
+    struct ConstImage
+    {
+        const unsigned char* data;
+        int width;
+        int height;
+        size_t stride;
+    };
+
+    /// <summary>
+    /// 書き込み先の画像
+    /// </summary>
+    struct Image
+    {
+        unsigned char* data;
+        int width;
+        int height;
+        size_t stride;
+    };
+
+    /// <summary>
+    /// 実行中の CPU で使える SIMD レベル（初回呼び出し時に CPUID / XGETBV で判定）
+    /// </summary>
+    SimdLevel GetSimdLevel();
+
+    /// <summary>
+    /// 行ごとにコピー（16 バイト境界のソースはストリーミングロード、行バンドを並列処理）
+    /// </summary>
+    /// <param name="src">コピー元（マップしたステージングメモリ等）</param>
+    /// <param name="srcPitch">コピー元の行バイト数</param>
+    /// <param name="dst">コピー先</param>
+    /// <param name="dstStride">コピー先の行バイト数</param>
+    /// <param name="rowBytes">1 行のコピーバイト数</param>
+    /// <param name="rows">行数</param>
+    void CopyPlane(const unsigned char* src, size_t srcPitch, unsigned char* dst, size_t dstStride, size_t rowBytes, int rows);
+
+    /// <summary>
+    /// BGRA 画像を dst のサイズへリサイズ
+    /// 縦横とも 2 倍以上の縮小は面積平均（ボックス）、それ以外は固定小数点バイリニア
+    /// </summary>
+    void ResizeBgra(const ConstImage& src, const Image& dst);
+
+    /// <summary>
+    /// BGRA 画像を 8bit グレースケールへ変換（BT.601 係数、src と dst は同じサイズ）
+    /// </summary>
+    void BgraToGray(const ConstImage& src, const Image& dst);
+}
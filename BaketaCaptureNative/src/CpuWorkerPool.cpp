@@ -0,0 +1,155 @@
+﻿#include "pch.h"
+
+CpuWorkerPool& CpuWorkerPool::Instance()
+{
+    static CpuWorkerPool instance;
+    return instance;
+}
+
+CpuWorkerPool::~CpuWorkerPool()
+{
+    // プロセス終了時はローダーロック中の可能性があるため join せず切り離す
+    Abandon();
+}
+
+void CpuWorkerPool::EnsureStartedLocked()
+{
+    if (!m_workers.empty())
+    {
+        return;
+    }
+
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    int workerCount = (std::min)(kMaxWorkers, static_cast<int>(hardwareThreads > 1 ? hardwareThreads - 1 : 0));
+    m_stopping = false;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        // 起動時点の世代を渡す（スレッド開始前に公開されたジョブを取りこぼさない）
+        m_workers.emplace_back([this, generation = m_generation]() { WorkerLoop(generation); });
+    }
+}
+
+void CpuWorkerPool::WorkerLoop(unsigned long long seenGeneration)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping)
+            {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        RunBands();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_finishedWorkers;
+        }
+        m_done.notify_all();
+    }
+}
+
+void CpuWorkerPool::RunBands()
+{
+    for (;;)
+    {
+        int band = m_nextBand.fetch_add(1, std::memory_order_relaxed);
+        if (band >= m_bandCount)
+        {
+            return;
+        }
+
+        int begin = band * m_bandSize;
+        int end = (std::min)(m_count, begin + m_bandSize);
+        (*m_body)(begin, end);
+    }
+}
+
+void CpuWorkerPool::ParallelFor(int count, int minItemsPerBand, const std::function<void(int, int)>& body)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> jobLock(m_jobMutex);
+
+    int workerCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EnsureStartedLocked();
+        workerCount = static_cast<int>(m_workers.size());
+    }
+
+    int maxBands = (count + (std::max)(1, minItemsPerBand) - 1) / (std::max)(1, minItemsPerBand);
+    int bandCount = (std::min)(maxBands, workerCount + 1);
+    if (bandCount <= 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_count = count;
+        m_bandSize = (count + bandCount - 1) / bandCount;
+        m_bandCount = (count + m_bandSize - 1) / m_bandSize;
+        m_nextBand.store(0, std::memory_order_relaxed);
+        m_finishedWorkers = 0;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    RunBands();
+
+    // 全ワーカーがこのジョブを終えるまで待つ（body の寿命と次のジョブの公開を保証）
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&]() { return m_finishedWorkers == workerCount; });
+    m_body = nullptr;
+}
+
+void CpuWorkerPool::Shutdown()
+{
+    std::lock_guard<std::mutex> jobLock(m_jobMutex);
+
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        workers.swap(m_workers);
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+void CpuWorkerPool::Abandon()
+{
+    // ParallelFor の実行中でもジョブロックは取らない（ローダーロック中に呼び出し側を待たない）
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        workers.swap(m_workers);
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.detach();
+        }
+    }
+}
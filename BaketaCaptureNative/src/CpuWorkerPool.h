@@ -0,0 +1,65 @@
+﻿#pragma once
+
+/// <summary>
+/// CPU 画像処理用の小さなワーカープール（プロセス共通）
+/// 行範囲をバンドに分割し、呼び出しスレッドを含む最大 kMaxWorkers + 1 スレッドで並列処理する。
+/// 停止は BaketaCapture_Shutdown から行い、DLL アンロード時（ローダーロック中）は join せずに切り離す。
+/// </summary>
+class CpuWorkerPool
+{
+public:
+    /// <summary>
+    /// 呼び出しスレッド以外のワーカー数上限
+    /// </summary>
+    static constexpr int kMaxWorkers = 3;
+
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static CpuWorkerPool& Instance();
+
+    /// <summary>
+    /// [0, count) をバンドに分割して並列実行（全バンド完了まで戻らない）
+    /// </summary>
+    /// <param name="count">項目数（行数）</param>
+    /// <param name="minItemsPerBand">1 バンドの最小項目数（これ未満なら呼び出しスレッドのみで実行）</param>
+    /// <param name="body">バンド処理 (begin, end)</param>
+    void ParallelFor(int count, int minItemsPerBand, const std::function<void(int, int)>& body);
+
+    /// <summary>
+    /// ワーカースレッドを停止（次回の ParallelFor で再起動される）
+    /// </summary>
+    void Shutdown();
+
+    /// <summary>
+    /// ワーカースレッドへ停止を指示して join せずに切り離す（DllMain の DLL_PROCESS_DETACH 用）
+    /// ローダーロック中はスレッドの終了を待てないため、終了は各スレッドに任せる
+    /// </summary>
+    void Abandon();
+
+private:
+    CpuWorkerPool() = default;
+    ~CpuWorkerPool();
+    CpuWorkerPool(const CpuWorkerPool&) = delete;
+    CpuWorkerPool& operator=(const CpuWorkerPool&) = delete;
+
+    void EnsureStartedLocked();
+    void WorkerLoop(unsigned long long seenGeneration);
+    void RunBands();
+
+    std::mutex m_jobMutex;  // ParallelFor の呼び出し側を直列化（複数セッション）
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_workers;
+    bool m_stopping = false;
+
+    // 実行中ジョブ（m_mutex で公開、ワーカーは全員が完了報告するまで次のジョブを受け取らない）
+    const std::function<void(int, int)>* m_body = nullptr;
+    int m_count = 0;
+    int m_bandSize = 0;
+    int m_bandCount = 0;
+    std::atomic<int> m_nextBand{ 0 };
+    unsigned long long m_generation = 0;
+    int m_finishedWorkers = 0;
+};
@@ -0,0 +1,229 @@
+﻿#include "pch.h"
+
+D3DDeviceManager& D3DDeviceManager::Instance()
+{
+    static D3DDeviceManager instance;
+    return instance;
+}
+
+std::shared_ptr<SharedD3DDevice> D3DDeviceManager::AcquireForWindow(HWND hwnd, HRESULT* hr)
+{
+    return AcquireForMonitor(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), hr);
+}
+
+std::shared_ptr<SharedD3DDevice> D3DDeviceManager::AcquireForMonitor(HMONITOR monitor, HRESULT* hr)
+{
+    ComPtr<IDXGIAdapter1> adapter = FindAdapterForMonitor(monitor);
+
+    LUID luid = {};
+    if (adapter)
+    {
+        DXGI_ADAPTER_DESC1 desc = {};
+        if (FAILED(adapter->GetDesc1(&desc)))
+        {
+            adapter.Reset();
+        }
+        else
+        {
+            luid = desc.AdapterLuid;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!adapter && m_defaultDevice)
+        {
+            if (hr) *hr = S_OK;
+            return m_defaultDevice;
+        }
+
+        auto it = adapter ? m_devices.find(LuidKey(luid)) : m_devices.end();
+        if (it != m_devices.end())
+        {
+            if (hr) *hr = S_OK;
+            return it->second;
+        }
+    }
+
+    // デバイス作成はロック外で行い、同時に作成された場合は先に登録された方を使う
+    std::shared_ptr<SharedD3DDevice> created = CreateDevice(adapter.Get(), hr);
+    if (!created)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& cached = adapter ? m_devices[LuidKey(luid)] : m_defaultDevice;
+    if (!cached)
+    {
+        cached = created;
+    }
+    return cached;
+}
+
+bool D3DDeviceManager::CheckDeviceRemoved(const std::shared_ptr<SharedD3DDevice>& device, HRESULT* reason)
+{
+    if (!device || !device->device)
+    {
+        return false;
+    }
+
+    HRESULT removedReason = device->device->GetDeviceRemovedReason();
+    if (SUCCEEDED(removedReason))
+    {
+        return false;
+    }
+
+    if (reason) *reason = removedReason;
+
+    // 以後のセッション作成では新しいデバイスを作成させる
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_defaultDevice == device)
+    {
+        m_defaultDevice.reset();
+    }
+    auto it = m_devices.find(LuidKey(device->adapterLuid));
+    if (it != m_devices.end() && it->second == device)
+    {
+        m_devices.erase(it);
+    }
+    return true;
+}
+
+void D3DDeviceManager::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_devices.clear();
+    m_defaultDevice.reset();
+}
+
+ComPtr<IDXGIAdapter1> D3DDeviceManager::FindAdapterForMonitor(HMONITOR monitor)
+{
+    if (!monitor)
+    {
+        return nullptr;
+    }
+
+    ComPtr<IDXGIFactory1> factory;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))))
+    {
+        return nullptr;
+    }
+
+    // DXGI 1.6 では高性能 GPU 優先の順で列挙（同じモニターを複数アダプターが報告する場合に dGPU を選ぶ）
+    ComPtr<IDXGIFactory6> factory6;
+    factory.As(&factory6);
+
+    for (UINT i = 0; ; ++i)
+    {
+        ComPtr<IDXGIAdapter1> adapter;
+        HRESULT hr = factory6
+            ? factory6->EnumAdapterByGpuPreference(i, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter))
+            : factory->EnumAdapters1(i, &adapter);
+        if (hr == DXGI_ERROR_NOT_FOUND)
+        {
+            break;
+        }
+        if (FAILED(hr))
+        {
+            continue;
+        }
+
+        DXGI_ADAPTER_DESC1 desc = {};
+        if (FAILED(adapter->GetDesc1(&desc)) || (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE))
+        {
+            continue;
+        }
+
+        // アダプターの出力のうちウィンドウのモニターと一致するものを探す
+        ComPtr<IDXGIOutput> output;
+        for (UINT j = 0; adapter->EnumOutputs(j, &output) != DXGI_ERROR_NOT_FOUND; ++j)
+        {
+            DXGI_OUTPUT_DESC outputDesc = {};
+            bool matched = SUCCEEDED(output->GetDesc(&outputDesc)) && outputDesc.Monitor == monitor;
+            output.Reset();
+            if (matched)
+            {
+                return adapter;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<SharedD3DDevice> D3DDeviceManager::CreateDevice(IDXGIAdapter1* adapter, HRESULT* hr)
+{
+    D3D_FEATURE_LEVEL featureLevels[] = {
+        D3D_FEATURE_LEVEL_11_1,
+        D3D_FEATURE_LEVEL_11_0,
+        D3D_FEATURE_LEVEL_10_1,
+        D3D_FEATURE_LEVEL_10_0
+    };
+
+    // ビデオプロセッサー・ハードウェアエンコーダー（HardwareVideoEncoder）のため VIDEO_SUPPORT を要求し、
+    // 対応しないドライバーでは外して作り直す
+    UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_VIDEO_SUPPORT;
+#ifdef _DEBUG
+    // creationFlags |= D3D11_CREATE_DEVICE_DEBUG; // Graphics Tools未対応環境対策で一時的に無効化
+#endif
+
+    auto shared = std::make_shared<SharedD3DDevice>();
+    auto createDevice = [&](UINT flags)
+    {
+        return D3D11CreateDevice(
+            adapter,
+            adapter ? D3D_DRIVER_TYPE_UNKNOWN : D3D_DRIVER_TYPE_HARDWARE,  // アダプター指定時は UNKNOWN
+            nullptr,
+            flags,
+            featureLevels,
+            ARRAYSIZE(featureLevels),
+            D3D11_SDK_VERSION,
+            &shared->device,
+            nullptr,
+            &shared->context
+        );
+    };
+    HRESULT result = createDevice(creationFlags);
+    shared->videoSupported = SUCCEEDED(result);
+    if (FAILED(result))
+    {
+        result = createDevice(creationFlags & ~D3D11_CREATE_DEVICE_VIDEO_SUPPORT);
+    }
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return nullptr;
+    }
+
+    // 複数セッションのスレッドから同じイミディエイトコンテキストを使うため保護を有効化
+    ComPtr<ID3D11Multithread> multithread;
+    if (SUCCEEDED(shared->context.As(&multithread)))
+    {
+        multithread->SetMultithreadProtected(TRUE);
+    }
+
+    ComPtr<IDXGIDevice> dxgiDevice;
+    result = shared->device.As(&dxgiDevice);
+    if (SUCCEEDED(result))
+    {
+        result = CreateDirect3D11DeviceFromDXGIDevice(dxgiDevice.Get(), reinterpret_cast<IInspectable**>(winrt::put_abi(shared->winrtDevice)));
+    }
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return nullptr;
+    }
+
+    // 実際に使われたアダプターの LUID を記録（削除時のキャッシュ除去に使用）
+    ComPtr<IDXGIAdapter> usedAdapter;
+    DXGI_ADAPTER_DESC adapterDesc = {};
+    if (SUCCEEDED(dxgiDevice->GetAdapter(&usedAdapter)) && SUCCEEDED(usedAdapter->GetDesc(&adapterDesc)))
+    {
+        shared->adapterLuid = adapterDesc.AdapterLuid;
+    }
+    shared->adapterMatched = adapter != nullptr;
+
+    if (hr) *hr = S_OK;
+    return shared;
+}
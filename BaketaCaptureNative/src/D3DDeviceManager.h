@@ -0,0 +1,108 @@
+﻿#pragma once
+
+/// <summary>
+/// アダプターごとにプロセス内で共有される D3D11 デバイス
+/// イミディエイトコンテキストはマルチスレッド保護を有効にして作成し、
+/// 複数の呼び出しにまたがるパス（シェーダー・ビューの設定からディスパッチまで）は D3DContextLock で囲む。
+/// </summary>
+struct SharedD3DDevice
+{
+    ComPtr<ID3D11Device> device;
+    ComPtr<ID3D11DeviceContext> context;
+    winrt::IDirect3DDevice winrtDevice{ nullptr };
+    LUID adapterLuid = {};
+    bool adapterMatched = false;                          // ウィンドウのモニターを出力するアダプターで作成したか
+    bool videoSupported = false;                          // D3D11_CREATE_DEVICE_VIDEO_SUPPORT 付きで作成できたか
+
+    // リサイズ用の IA/VS/PS ステージを最後にバインドしたセッション（コンテキストロック下で参照）
+    const void* resizePipelineOwner = nullptr;
+};
+
+/// <summary>
+/// 共有イミディエイトコンテキストの排他区間（ID3D11Multithread::Enter/Leave、再入可）
+/// </summary>
+class D3DContextLock
+{
+public:
+    explicit D3DContextLock(ID3D11DeviceContext* context)
+    {
+        if (context && SUCCEEDED(context->QueryInterface(IID_PPV_ARGS(&m_multithread))))
+        {
+            m_multithread->Enter();
+        }
+    }
+
+    ~D3DContextLock()
+    {
+        if (m_multithread)
+        {
+            m_multithread->Leave();
+        }
+    }
+
+    D3DContextLock(const D3DContextLock&) = delete;
+    D3DContextLock& operator=(const D3DContextLock&) = delete;
+
+private:
+    ComPtr<ID3D11Multithread> m_multithread;
+};
+
+/// <summary>
+/// セッション間で D3D11 デバイスを共有するプロセス共通マネージャー
+/// 対象ウィンドウのモニターを出力しているアダプターを選択し（ハイブリッド GPU 環境でのアダプター間コピーを回避）、
+/// アダプターごとに 1 つのデバイスを再利用する。デバイス削除を検出したデバイスはキャッシュから外し、次回作り直す。
+/// </summary>
+class D3DDeviceManager
+{
+public:
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static D3DDeviceManager& Instance();
+
+    /// <summary>
+    /// ウィンドウを表示しているモニターのアダプターに対応する共有デバイスを取得（無ければ作成）
+    /// </summary>
+    /// <param name="hwnd">キャプチャ対象ウィンドウ</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>共有デバイス、失敗時は nullptr</returns>
+    std::shared_ptr<SharedD3DDevice> AcquireForWindow(HWND hwnd, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// モニターを出力しているアダプターに対応する共有デバイスを取得（無ければ作成）
+    /// </summary>
+    /// <param name="monitor">キャプチャ対象モニター</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>共有デバイス、失敗時は nullptr</returns>
+    std::shared_ptr<SharedD3DDevice> AcquireForMonitor(HMONITOR monitor, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// デバイス削除を確認し、削除されていればキャッシュから外す
+    /// </summary>
+    /// <param name="device">確認する共有デバイス</param>
+    /// <param name="reason">削除理由（出力・省略可）</param>
+    /// <returns>デバイスが削除・リセットされている場合は true</returns>
+    bool CheckDeviceRemoved(const std::shared_ptr<SharedD3DDevice>& device, HRESULT* reason = nullptr);
+
+    /// <summary>
+    /// キャッシュしている全デバイスを手放す（使用中のセッションは参照を保持し続ける）
+    /// </summary>
+    void Reset();
+
+private:
+    D3DDeviceManager() = default;
+    D3DDeviceManager(const D3DDeviceManager&) = delete;
+    D3DDeviceManager& operator=(const D3DDeviceManager&) = delete;
+
+    static unsigned long long LuidKey(const LUID& luid)
+    {
+        return (static_cast<unsigned long long>(static_cast<unsigned int>(luid.HighPart)) << 32) | luid.LowPart;
+    }
+
+    static ComPtr<IDXGIAdapter1> FindAdapterForMonitor(HMONITOR monitor);
+    static std::shared_ptr<SharedD3DDevice> CreateDevice(IDXGIAdapter1* adapter, HRESULT* hr);
+
+    std::mutex m_mutex;
+    std::unordered_map<unsigned long long, std::shared_ptr<SharedD3DDevice>> m_devices;  // アダプター LUID → デバイス
+    std::shared_ptr<SharedD3DDevice> m_defaultDevice;                                     // アダプターを特定できない場合
+};
@@ -0,0 +1,42 @@
+﻿#include "pch.h"
+
+void DirtyRegionTracker::Record(unsigned long long sequence, const RECT* rects, int rectCount, bool fullFrame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[sequence % kHistorySize];
+    entry.sequence = sequence;
+    entry.fullFrame = fullFrame || rectCount > kMaxRectsPerFrame || (rectCount > 0 && !rects);
+    entry.rectCount = entry.fullFrame ? 0 : rectCount;
+    for (int i = 0; i < entry.rectCount; ++i)
+    {
+        entry.rects[i] = rects[i];
+    }
+}
+
+bool DirtyRegionTracker::Collect(unsigned long long after, unsigned long long upTo, std::vector<RECT>& rects) const
+{
+    if (upTo < after || upTo - after > static_cast<unsigned long long>(kHistorySize))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (unsigned long long sequence = after + 1; sequence <= upTo; ++sequence)
+    {
+        const Entry& entry = m_entries[sequence % kHistorySize];
+        if (entry.sequence != sequence || entry.fullFrame)
+        {
+            return false;
+        }
+        rects.insert(rects.end(), entry.rects.begin(), entry.rects.begin() + entry.rectCount);
+    }
+    return true;
+}
+
+void DirtyRegionTracker::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries = {};
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+/// <summary>
+/// WGC フレームの変化矩形（DirtyRegions）履歴
+/// OnFrameArrived がフレーム通し番号ごとに矩形を記録し、読み出し側は前回読み出した番号から
+/// 今回の番号までの矩形をまとめて取得する（ストリーミングで読み飛ばしたフレームの矩形も失わない）。
+/// 履歴が欠けている・矩形情報がないフレームを含む場合は全体読み出しが必要と判定する。
+/// </summary>
+class DirtyRegionTracker
+{
+public:
+    static constexpr int kHistorySize = 32;
+    static constexpr int kMaxRectsPerFrame = 16;
+
+    /// <summary>
+    /// フレームの変化矩形を記録（OnFrameArrived スレッドから呼ぶ）
+    /// </summary>
+    /// <param name="sequence">フレーム通し番号</param>
+    /// <param name="rects">変化矩形</param>
+    /// <param name="rectCount">矩形数（kMaxRectsPerFrame を超える場合は全体変化として記録）</param>
+    /// <param name="fullFrame">矩形情報がない場合は true</param>
+    void Record(unsigned long long sequence, const RECT* rects, int rectCount, bool fullFrame);
+
+    /// <summary>
+    /// (after, upTo] の範囲のフレームの変化矩形を取得
+    /// </summary>
+    /// <param name="after">前回読み出したフレーム番号</param>
+    /// <param name="upTo">今回読み出すフレーム番号</param>
+    /// <param name="rects">変化矩形（出力・追記）</param>
+    /// <returns>範囲内の全フレームの矩形が揃っている場合は true（false の場合は全体読み出し）</returns>
+    bool Collect(unsigned long long after, unsigned long long upTo, std::vector<RECT>& rects) const;
+
+    /// <summary>
+    /// 履歴を破棄
+    /// </summary>
+    void Reset();
+
+private:
+    struct Entry
+    {
+        unsigned long long sequence = 0;
+        bool fullFrame = true;
+        int rectCount = 0;
+        std::array<RECT, kMaxRectsPerFrame> rects{};
+    };
+
+    mutable std::mutex m_mutex;
+    std::array<Entry, kHistorySize> m_entries;
+};
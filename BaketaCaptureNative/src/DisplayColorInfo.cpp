@@ -0,0 +1,91 @@
+﻿#include "pch.h"
+
+namespace
+{
+    // GDI デバイス名（\\.\DISPLAYn）に対応する表示パスの SDR 白レベル（nits）
+    float QuerySdrWhiteLevelNits(const wchar_t* gdiDeviceName)
+    {
+        UINT32 pathCount = 0;
+        UINT32 modeCount = 0;
+        if (GetDisplayConfigBufferSizes(QDC_ONLY_ACTIVE_PATHS, &pathCount, &modeCount) != ERROR_SUCCESS)
+        {
+            return DisplayColorInfo::kScRgbWhiteNits;
+        }
+
+        std::vector<DISPLAYCONFIG_PATH_INFO> paths(pathCount);
+        std::vector<DISPLAYCONFIG_MODE_INFO> modes(modeCount);
+        if (QueryDisplayConfig(QDC_ONLY_ACTIVE_PATHS, &pathCount, paths.data(), &modeCount, modes.data(), nullptr) != ERROR_SUCCESS)
+        {
+            return DisplayColorInfo::kScRgbWhiteNits;
+        }
+
+        for (UINT32 i = 0; i < pathCount; ++i)
+        {
+            DISPLAYCONFIG_SOURCE_DEVICE_NAME sourceName = {};
+            sourceName.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+            sourceName.header.size = sizeof(sourceName);
+            sourceName.header.adapterId = paths[i].sourceInfo.adapterId;
+            sourceName.header.id = paths[i].sourceInfo.id;
+            if (DisplayConfigGetDeviceInfo(&sourceName.header) != ERROR_SUCCESS
+                || wcscmp(sourceName.viewGdiDeviceName, gdiDeviceName) != 0)
+            {
+                continue;
+            }
+
+            // SDRWhiteLevel は 1000 が 80 nits（scRGB の 1.0）
+            DISPLAYCONFIG_SDR_WHITE_LEVEL whiteLevel = {};
+            whiteLevel.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SDR_WHITE_LEVEL;
+            whiteLevel.header.size = sizeof(whiteLevel);
+            whiteLevel.header.adapterId = paths[i].targetInfo.adapterId;
+            whiteLevel.header.id = paths[i].targetInfo.id;
+            if (DisplayConfigGetDeviceInfo(&whiteLevel.header) == ERROR_SUCCESS && whiteLevel.SDRWhiteLevel > 0)
+            {
+                return static_cast<float>(whiteLevel.SDRWhiteLevel) / 1000.0f * DisplayColorInfo::kScRgbWhiteNits;
+            }
+            break;
+        }
+
+        return DisplayColorInfo::kScRgbWhiteNits;
+    }
+}
+
+DisplayColorInfo DisplayColorInfo::Query(HMONITOR monitor)
+{
+    DisplayColorInfo info;
+    if (!monitor)
+    {
+        return info;
+    }
+
+    ComPtr<IDXGIFactory1> factory;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))))
+    {
+        return info;
+    }
+
+    // モニターを出力しているアダプタの出力を探す（色空間・輝度は IDXGIOutput6 のみが報告する）
+    ComPtr<IDXGIAdapter1> adapter;
+    for (UINT adapterIndex = 0; factory->EnumAdapters1(adapterIndex, &adapter) != DXGI_ERROR_NOT_FOUND; ++adapterIndex)
+    {
+        ComPtr<IDXGIOutput> output;
+        for (UINT outputIndex = 0; adapter->EnumOutputs(outputIndex, &output) != DXGI_ERROR_NOT_FOUND; ++outputIndex)
+        {
+            ComPtr<IDXGIOutput6> output6;
+            DXGI_OUTPUT_DESC1 desc = {};
+            if (FAILED(output.As(&output6)) || FAILED(output6->GetDesc1(&desc)) || desc.Monitor != monitor)
+            {
+                continue;
+            }
+
+            info.advancedColor = desc.ColorSpace == DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020;
+            if (info.advancedColor)
+            {
+                info.sdrWhiteNits = QuerySdrWhiteLevelNits(desc.DeviceName);
+                info.maxLuminanceNits = desc.MaxLuminance > 0.0f ? desc.MaxLuminance : info.sdrWhiteNits;
+            }
+            return info;
+        }
+    }
+
+    return info;
+}
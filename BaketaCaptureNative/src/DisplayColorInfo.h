@@ -0,0 +1,24 @@
+﻿#pragma once
+
+/// <summary>
+/// モニターの Advanced Color（HDR）状態
+/// DWM が scRGB で合成している場合、WGC の BGRA8 出力は OS 側の変換で白飛び・低コントラストになるため、
+/// キャプチャは FP16 で受け取り、リサイズシェーダーで SDR へトーンマップする。
+/// </summary>
+struct DisplayColorInfo
+{
+    /// <summary>
+    /// SDR の基準白（scRGB の 1.0）の輝度
+    /// </summary>
+    static constexpr float kScRgbWhiteNits = 80.0f;
+
+    bool advancedColor = false;                 // HDR（PQ / BT.2020 出力）が有効
+    float sdrWhiteNits = kScRgbWhiteNits;       // SDR コンテンツの白レベル（Windows の「SDR コンテンツの明るさ」）
+    float maxLuminanceNits = kScRgbWhiteNits;   // ディスプレイのピーク輝度
+
+    /// <summary>
+    /// 指定モニターの状態を取得（取得できない場合は SDR として返す）
+    /// </summary>
+    /// <param name="monitor">対象モニター</param>
+    static DisplayColorInfo Query(HMONITOR monitor);
+};
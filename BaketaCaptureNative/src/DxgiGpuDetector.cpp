@@ -237,6 +237,33 @@ DXGI_GPU_API int GetAllGpuInfos(DxgiGpuInfo* outInfos, int maxCount) {
     return count;
 }
 
+DXGI_GPU_API bool GetGpuInfoByLuid(uint32_t luidLowPart, int32_t luidHighPart, DxgiGpuInfo* outInfo) {
+    if (!outInfo) return false;
+
+    // 初期化
+    memset(outInfo, 0, sizeof(DxgiGpuInfo));
+
+    ComPtr<IDXGIFactory1> factory;
+    if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), &factory))) {
+        return false;
+    }
+
+    ComPtr<IDXGIAdapter1> adapter;
+    for (UINT i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i, adapter.Reset())
+    {
+        DXGI_ADAPTER_DESC1 desc = {};
+        if (FAILED(adapter->GetDesc1(&desc))) {
+            continue;
+        }
+
+        if (desc.AdapterLuid.LowPart == luidLowPart && desc.AdapterLuid.HighPart == luidHighPart) {
+            return PopulateGpuInfo(adapter.Get(), outInfo);
+        }
+    }
+
+    return false;
+}
+
 DXGI_GPU_API uint32_t GetDirectXFeatureLevelDxgi() {
     ComPtr<IDXGIFactory1> factory;
     if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), &factory))) {
@@ -38,6 +38,11 @@ extern "C" {
     // 戻り値: 実際に取得したGPU数
     DXGI_GPU_API int GetAllGpuInfos(DxgiGpuInfo* outInfos, int maxCount);
 
+    // アダプタLUIDを指定してGPU情報を取得（キャプチャデバイスが実際に使用しているGPUの判定用）
+    // luidLowPart / luidHighPart: DXGI_ADAPTER_DESC1::AdapterLuid
+    // 戻り値: 該当するアダプタが見つかった場合は true
+    DXGI_GPU_API bool GetGpuInfoByLuid(uint32_t luidLowPart, int32_t luidHighPart, DxgiGpuInfo* outInfo);
+
     // DirectX Feature Levelを取得（D3D12優先、D3D11フォールバック）
     // 戻り値: Feature Level値（例: 0xc100 = D3D_FEATURE_LEVEL_12_1）
     DXGI_GPU_API uint32_t GetDirectXFeatureLevelDxgi();
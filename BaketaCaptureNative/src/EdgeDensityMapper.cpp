@@ -0,0 +1,196 @@
+﻿#include "pch.h"
+
+// エッジ密度コンピュートシェーダー（EdgeDensityShader.hlsl をビルド時にコンパイルしたバイトコード）
+#include "shaders/EdgeDensityCS.h"
+
+// 密度の係数: セル平均の Sobel 勾配 0.5・輝度の標準偏差 0.25 でそれぞれ飽和させる（一般的な UI 文字が 200 前後になる目安）
+static constexpr float kEdgeGain = 2.0f;
+static constexpr float kContrastGain = 4.0f;
+
+struct EdgeDensityParams
+{
+    UINT sourceWidth;
+    UINT sourceHeight;
+    UINT cellColumns;
+    float edgeGain;
+    float contrastGain;
+    float padding[3];
+};
+
+bool EdgeDensityMapper::InitializeShader(ID3D11Device* device, HRESULT* hr)
+{
+    if (m_shaderInitialized)
+    {
+        return true;
+    }
+
+    // cs_5_0 はフィーチャーレベル 11_0 以上が必要
+    if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+    {
+        if (hr) *hr = DXGI_ERROR_UNSUPPORTED;
+        return false;
+    }
+
+    HRESULT result = device->CreateComputeShader(g_EdgeDensityCS, sizeof(g_EdgeDensityCS), nullptr, &m_computeShader);
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(EdgeDensityParams);
+        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        result = device->CreateBuffer(&cbDesc, nullptr, &m_constantBuffer);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_computeShader.Reset();
+        m_constantBuffer.Reset();
+        return false;
+    }
+
+    m_shaderInitialized = true;
+    return true;
+}
+
+bool EdgeDensityMapper::EnsureResultBuffer(ID3D11Device* device, UINT wordCount, HRESULT* hr)
+{
+    if (m_resultBuffer && wordCount <= m_resultWords)
+    {
+        return true;
+    }
+
+    m_resultBuffer.Reset();
+    m_resultUav.Reset();
+    m_resultStaging.Reset();
+    m_resultWords = 0;
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.ByteWidth = wordCount * sizeof(UINT);
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufferDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufferDesc.StructureByteStride = sizeof(UINT);
+    HRESULT result = device->CreateBuffer(&bufferDesc, nullptr, &m_resultBuffer);
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.NumElements = wordCount;
+        result = device->CreateUnorderedAccessView(m_resultBuffer.Get(), &uavDesc, &m_resultUav);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC stagingDesc = {};
+        stagingDesc.ByteWidth = wordCount * sizeof(UINT);
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        stagingDesc.StructureByteStride = sizeof(UINT);
+        result = device->CreateBuffer(&stagingDesc, nullptr, &m_resultStaging);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_resultBuffer.Reset();
+        m_resultUav.Reset();
+        m_resultStaging.Reset();
+        return false;
+    }
+
+    m_resultWords = wordCount;
+    return true;
+}
+
+bool EdgeDensityMapper::Build(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* source,
+    UINT width, UINT height, unsigned char* map, HRESULT* hr)
+{
+    if (!device || !context || !source || !map || width == 0 || height == 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!InitializeShader(device, hr))
+    {
+        return false;
+    }
+
+    UINT columns = static_cast<UINT>(Columns(static_cast<int>(width)));
+    UINT rows = static_cast<UINT>(Rows(static_cast<int>(height)));
+    UINT cellCount = columns * rows;
+    if (!EnsureResultBuffer(device, (cellCount + 3) / 4, hr))
+    {
+        return false;
+    }
+
+    // 共有コンテキスト上でシェーダー・ビューの設定からディスパッチまでを他セッションと混在させない
+    D3DContextLock contextLock(context);
+
+    D3D11_MAPPED_SUBRESOURCE mappedCb;
+    HRESULT result = context->Map(m_constantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedCb);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    auto* params = static_cast<EdgeDensityParams*>(mappedCb.pData);
+    params->sourceWidth = width;
+    params->sourceHeight = height;
+    params->cellColumns = columns;
+    params->edgeGain = kEdgeGain;
+    params->contrastGain = kContrastGain;
+    context->Unmap(m_constantBuffer.Get(), 0);
+
+    // シェーダーは InterlockedOr で 4 セルを1ワードへ詰めるため先にクリア
+    const UINT clearValues[4] = { 0, 0, 0, 0 };
+    context->ClearUnorderedAccessViewUint(m_resultUav.Get(), clearValues);
+
+    ID3D11ShaderResourceView* srvs[1] = { source };
+    ID3D11UnorderedAccessView* uavs[1] = { m_resultUav.Get() };
+    ID3D11Buffer* cbs[1] = { m_constantBuffer.Get() };
+    context->CSSetShader(m_computeShader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 1, srvs);
+    context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+    context->CSSetConstantBuffers(0, 1, cbs);
+    context->Dispatch(columns, rows, 1);
+
+    // 後続のパスと競合しないようバインドを解除
+    ID3D11ShaderResourceView* nullSrvs[1] = { nullptr };
+    ID3D11UnorderedAccessView* nullUavs[1] = { nullptr };
+    context->CSSetShaderResources(0, 1, nullSrvs);
+    context->CSSetUnorderedAccessViews(0, 1, nullUavs, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    // 使用範囲（セル数バイト）のみ読み戻す
+    D3D11_BOX box = { 0, 0, 0, ((cellCount + 3) / 4) * static_cast<UINT>(sizeof(UINT)), 1, 1 };
+    context->CopySubresourceRegion(m_resultStaging.Get(), 0, 0, 0, 0, m_resultBuffer.Get(), 0, &box);
+    D3D11_MAPPED_SUBRESOURCE mappedResult;
+    result = context->Map(m_resultStaging.Get(), 0, D3D11_MAP_READ, 0, &mappedResult);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+
+    // ワード内はセル番号順に下位バイトから並ぶため、リトルエンディアンのバイト列としてそのまま使える
+    memcpy(map, mappedResult.pData, cellCount);
+    context->Unmap(m_resultStaging.Get(), 0);
+
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+void EdgeDensityMapper::Reset()
+{
+    m_resultBuffer.Reset();
+    m_resultUav.Reset();
+    m_resultStaging.Reset();
+    m_resultWords = 0;
+}
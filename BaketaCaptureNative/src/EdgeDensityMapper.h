@@ -0,0 +1,59 @@
+﻿#pragma once
+
+/// <summary>
+/// GPU 上での文字領域候補のエッジ密度マップ作成（16x16 セル単位）
+/// フレームの輝度 Sobel 勾配の平均と輝度の標準偏差をセルごとに1バイトへまとめ、
+/// マップ（フレームの 1/256 の画素数）のみを読み戻す。テキスト検出を候補セルに絞り込むための事前段階として使う。
+/// </summary>
+class EdgeDensityMapper
+{
+public:
+    /// <summary>
+    /// セル一辺のピクセル数（元のキャプチャ解像度基準）
+    /// </summary>
+    static constexpr int kCellSize = 16;
+
+    EdgeDensityMapper() = default;
+    EdgeDensityMapper(const EdgeDensityMapper&) = delete;
+    EdgeDensityMapper& operator=(const EdgeDensityMapper&) = delete;
+
+    /// <summary>
+    /// width x height のセル数（列・行）を計算
+    /// </summary>
+    static int Columns(int width) { return (width + kCellSize - 1) / kCellSize; }
+    static int Rows(int height) { return (height + kCellSize - 1) / kCellSize; }
+
+    /// <summary>
+    /// ソースの左上 width x height 領域の密度マップを作成して map へ書き出す
+    /// 値は 0（平坦）〜255（文字・細かな輪郭が密集）、セル番号 = 行 * 列数 + 列
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">ソース SRV</param>
+    /// <param name="width">フレームの有効幅</param>
+    /// <param name="height">フレームの有効高さ</param>
+    /// <param name="map">出力先（Columns(width) * Rows(height) バイト以上）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Build(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* source,
+        UINT width, UINT height, unsigned char* map, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// GPU リソースを解放（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    bool InitializeShader(ID3D11Device* device, HRESULT* hr);
+    bool EnsureResultBuffer(ID3D11Device* device, UINT wordCount, HRESULT* hr);
+
+    bool m_shaderInitialized = false;
+    ComPtr<ID3D11ComputeShader> m_computeShader;
+    ComPtr<ID3D11Buffer> m_constantBuffer;
+
+    // 結果バッファ: 1 ワードに 4 セル（拡大のみ、縮小はしない）
+    ComPtr<ID3D11Buffer> m_resultBuffer;
+    ComPtr<ID3D11UnorderedAccessView> m_resultUav;
+    ComPtr<ID3D11Buffer> m_resultStaging;
+    UINT m_resultWords = 0;
+};
@@ -0,0 +1,84 @@
+// EdgeDensityShader.hlsl - 文字領域候補のエッジ密度マップ（EdgeDensityMapper）
+// 1 スレッドグループ = 1 セル (16x16)。各スレッドが 1 ピクセルの輝度 Sobel 勾配を求め、
+// セル内の平均勾配と輝度の標準偏差をグループ共有メモリで集計して 0〜255 の密度に量子化する
+// ビルド時に fxc で cs_5_0 / CSMain をバイトコードヘッダー (g_EdgeDensityCS) へコンパイルする
+
+Texture2D<float4> sourceTexture : register(t0);
+RWStructuredBuffer<uint> densityResult : register(u0);  // 1 ワードに 4 セル（セル番号順、下位バイト先頭）
+
+cbuffer EdgeDensityParams : register(b0)
+{
+    uint sourceWidth;   // フレームの有効幅（テクスチャはこれより大きい場合がある）
+    uint sourceHeight;
+    uint cellColumns;
+    float edgeGain;     // 平均勾配 → 0〜1 の係数
+    float contrastGain; // 標準偏差 → 0〜1 の係数
+    float3 padding;
+};
+
+static const uint kCellSize = 16;
+static const uint kThreadCount = kCellSize * kCellSize;
+
+groupshared float3 cellSums[kThreadCount];  // x = 勾配, y = 輝度, z = 輝度の二乗
+
+float LoadLuma(int2 pixel)
+{
+    pixel = clamp(pixel, int2(0, 0), int2(sourceWidth - 1, sourceHeight - 1));
+    float3 bgr = sourceTexture.Load(int3(pixel, 0)).rgb;
+    return dot(bgr, float3(0.299f, 0.587f, 0.114f));
+}
+
+[numthreads(16, 16, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 localId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    int2 pixel = int2(groupId.xy * kCellSize + localId.xy);
+    float3 sample = float3(0.0f, 0.0f, 0.0f);
+    if (pixel.x < (int)sourceWidth && pixel.y < (int)sourceHeight)
+    {
+        float tl = LoadLuma(pixel + int2(-1, -1));
+        float tc = LoadLuma(pixel + int2(0, -1));
+        float tr = LoadLuma(pixel + int2(1, -1));
+        float ml = LoadLuma(pixel + int2(-1, 0));
+        float mc = LoadLuma(pixel);
+        float mr = LoadLuma(pixel + int2(1, 0));
+        float bl = LoadLuma(pixel + int2(-1, 1));
+        float bc = LoadLuma(pixel + int2(0, 1));
+        float br = LoadLuma(pixel + int2(1, 1));
+
+        float gx = (tr + 2.0f * mr + br) - (tl + 2.0f * ml + bl);
+        float gy = (bl + 2.0f * bc + br) - (tl + 2.0f * tc + tr);
+        sample = float3(sqrt(gx * gx + gy * gy), mc, mc * mc);
+    }
+
+    cellSums[groupIndex] = sample;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint step = kThreadCount / 2; step > 0; step >>= 1)
+    {
+        if (groupIndex < step)
+        {
+            cellSums[groupIndex] += cellSums[groupIndex + step];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (groupIndex == 0)
+    {
+        // フレーム右端・下端のセルは有効ピクセル数で平均する
+        uint2 cellOrigin = groupId.xy * kCellSize;
+        uint2 extent = min(uint2(kCellSize, kCellSize), uint2(sourceWidth, sourceHeight) - cellOrigin);
+        float count = (float)(extent.x * extent.y);
+
+        float3 mean = cellSums[0] / count;
+        float stddev = sqrt(max(0.0f, mean.z - mean.y * mean.y));
+
+        // 文字は強い勾配と高いコントラストを同時に持つため幾何平均をとる（滑らかなグラデーションを抑える）
+        float edge = saturate(mean.x * edgeGain);
+        float contrast = saturate(stddev * contrastGain);
+        uint density = (uint)(sqrt(edge * contrast) * 255.0f + 0.5f);
+
+        uint cellIndex = groupId.y * cellColumns + groupId.x;
+        InterlockedOr(densityResult[cellIndex / 4], density << ((cellIndex % 4) * 8));
+    }
+}
@@ -0,0 +1,260 @@
+﻿#include "pch.h"
+
+// フォーマット変換コンピュートシェーダー（FormatShader.hlsl をカーネルごとにビルド時にコンパイルしたバイトコード）
+#include "shaders/FormatGrayCS.h"
+#include "shaders/FormatBgr24CS.h"
+#include "shaders/FormatNv12CS.h"
+
+struct FormatParams
+{
+    UINT outputWidth;
+    UINT outputHeight;
+    float inverseWidth;
+    float inverseHeight;
+};
+
+namespace
+{
+    struct FormatKernelInfo
+    {
+        const BYTE* bytecode;
+        SIZE_T bytecodeSize;
+        DXGI_FORMAT textureFormat;
+    };
+
+    // フォーマット番号 (BAKETA_CAPTURE_FORMAT_GRAY8 = 1 〜 NV12 = 3) - 1 で引く
+    const FormatKernelInfo kFormatKernels[3] = {
+        { g_FormatGrayCS, sizeof(g_FormatGrayCS), DXGI_FORMAT_R8_UNORM },
+        { g_FormatBgr24CS, sizeof(g_FormatBgr24CS), DXGI_FORMAT_R32_UINT },
+        { g_FormatNv12CS, sizeof(g_FormatNv12CS), DXGI_FORMAT_R8_UNORM },
+    };
+
+    bool IsConvertedFormat(int format)
+    {
+        return format >= BAKETA_CAPTURE_FORMAT_GRAY8 && format <= BAKETA_CAPTURE_FORMAT_NV12;
+    }
+}
+
+void FormatConverter::GetLayout(int format, int width, int height, int* rowBytes, int* rowCount)
+{
+    switch (format)
+    {
+    case BAKETA_CAPTURE_FORMAT_GRAY8:
+        *rowBytes = width;
+        *rowCount = height;
+        break;
+    case BAKETA_CAPTURE_FORMAT_BGR24:
+        *rowBytes = width * 3;
+        *rowCount = height;
+        break;
+    case BAKETA_CAPTURE_FORMAT_NV12:
+        *rowBytes = width;
+        *rowCount = height + height / 2;
+        break;
+    default:
+        *rowBytes = width * 4;
+        *rowCount = height;
+        break;
+    }
+}
+
+bool FormatConverter::InitializeShared(ID3D11Device* device, HRESULT* hr)
+{
+    if (m_sharedInitialized)
+    {
+        return true;
+    }
+
+    // cs_5_0 と型付き UAV ストアはフィーチャーレベル 11_0 以上が必要
+    if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+    {
+        if (hr) *hr = DXGI_ERROR_UNSUPPORTED;
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.ByteWidth = sizeof(FormatParams);
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    HRESULT result = device->CreateBuffer(&cbDesc, nullptr, &m_constantBuffer);
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        result = device->CreateSamplerState(&samplerDesc, &m_linearSampler);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_constantBuffer.Reset();
+        m_linearSampler.Reset();
+        return false;
+    }
+
+    m_sharedInitialized = true;
+    return true;
+}
+
+bool FormatConverter::EnsureKernel(ID3D11Device* device, int format, HRESULT* hr)
+{
+    Kernel& kernel = m_kernels[format - 1];
+    if (kernel.compiled)
+    {
+        return true;
+    }
+
+    const FormatKernelInfo& info = kFormatKernels[format - 1];
+    HRESULT result = device->CreateComputeShader(info.bytecode, info.bytecodeSize, nullptr, &kernel.shader);
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        kernel.shader.Reset();
+        return false;
+    }
+
+    kernel.compiled = true;
+    return true;
+}
+
+bool FormatConverter::EnsureOutput(ID3D11Device* device, UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr)
+{
+    if (m_output && format == m_outputFormat && width <= m_outputTextureWidth && height <= m_outputTextureHeight)
+    {
+        return true;
+    }
+
+    m_outputUav.Reset();
+    m_output.Reset();
+
+    // 同一フォーマットなら拡大のみ（サイズが揺れても作り直さない）
+    bool sameFormat = format == m_outputFormat;
+    D3D11_TEXTURE2D_DESC outputDesc = {};
+    outputDesc.Width = sameFormat ? (std::max)(width, m_outputTextureWidth) : width;
+    outputDesc.Height = sameFormat ? (std::max)(height, m_outputTextureHeight) : height;
+    outputDesc.MipLevels = 1;
+    outputDesc.ArraySize = 1;
+    outputDesc.Format = format;
+    outputDesc.SampleDesc.Count = 1;
+    outputDesc.Usage = D3D11_USAGE_DEFAULT;
+    outputDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+
+    HRESULT result = device->CreateTexture2D(&outputDesc, nullptr, &m_output);
+    if (SUCCEEDED(result))
+    {
+        result = device->CreateUnorderedAccessView(m_output.Get(), nullptr, &m_outputUav);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_output.Reset();
+        m_outputUav.Reset();
+        m_outputFormat = DXGI_FORMAT_UNKNOWN;
+        m_outputTextureWidth = 0;
+        m_outputTextureHeight = 0;
+        return false;
+    }
+
+    m_outputFormat = format;
+    m_outputTextureWidth = outputDesc.Width;
+    m_outputTextureHeight = outputDesc.Height;
+    return true;
+}
+
+bool FormatConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* source,
+    UINT width, UINT height, int format, HRESULT* hr)
+{
+    if (!device || !context || !source || width == 0 || height == 0 || !IsConvertedFormat(format) ||
+        (format == BAKETA_CAPTURE_FORMAT_NV12 && ((width & 1) != 0 || (height & 1) != 0)))
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!InitializeShared(device, hr) || !EnsureKernel(device, format, hr))
+    {
+        return false;
+    }
+
+    // 共有コンテキスト上でシェーダー・ビューの設定からディスパッチまでを他セッションと混在させない
+    D3DContextLock contextLock(context);
+
+    // 出力テクスチャのテクセル数とディスパッチ数（スレッドあたりの担当ピクセル数が異なる）
+    UINT textureWidth = width;
+    UINT textureHeight = height;
+    UINT threadsX = width;
+    UINT threadsY = height;
+    if (format == BAKETA_CAPTURE_FORMAT_BGR24)
+    {
+        threadsX = (width + 3) / 4;
+        textureWidth = threadsX * 3;
+    }
+    else if (format == BAKETA_CAPTURE_FORMAT_NV12)
+    {
+        textureHeight = height + height / 2;
+        threadsX = width / 2;
+        threadsY = height / 2;
+    }
+
+    if (!EnsureOutput(device, textureWidth, textureHeight, kFormatKernels[format - 1].textureFormat, hr))
+    {
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedCb;
+    HRESULT result = context->Map(m_constantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedCb);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    auto* params = static_cast<FormatParams*>(mappedCb.pData);
+    params->outputWidth = width;
+    params->outputHeight = height;
+    params->inverseWidth = 1.0f / static_cast<float>(width);
+    params->inverseHeight = 1.0f / static_cast<float>(height);
+    context->Unmap(m_constantBuffer.Get(), 0);
+
+    ID3D11ShaderResourceView* srvs[1] = { source };
+    ID3D11UnorderedAccessView* uavs[1] = { m_outputUav.Get() };
+    ID3D11Buffer* cbs[1] = { m_constantBuffer.Get() };
+    ID3D11SamplerState* samplers[1] = { m_linearSampler.Get() };
+    context->CSSetShader(m_kernels[format - 1].shader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 1, srvs);
+    context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+    context->CSSetConstantBuffers(0, 1, cbs);
+    context->CSSetSamplers(0, 1, samplers);
+    context->Dispatch((threadsX + 7) / 8, (threadsY + 7) / 8, 1);
+
+    // 後続のパスと競合しないようバインドを解除
+    ID3D11ShaderResourceView* nullSrvs[1] = { nullptr };
+    ID3D11UnorderedAccessView* nullUavs[1] = { nullptr };
+    context->CSSetShaderResources(0, 1, nullSrvs);
+    context->CSSetUnorderedAccessViews(0, 1, nullUavs, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    m_outputWidth = textureWidth;
+    m_outputHeight = textureHeight;
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+void FormatConverter::Reset()
+{
+    m_outputUav.Reset();
+    m_output.Reset();
+    m_outputFormat = DXGI_FORMAT_UNKNOWN;
+    m_outputTextureWidth = 0;
+    m_outputTextureHeight = 0;
+    m_outputWidth = 0;
+    m_outputHeight = 0;
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+/// <summary>
+/// GPU 上でのピクセルフォーマット変換（読み出し前に変換して転送量を削減）
+/// BGRA ソースを出力サイズへバイリニアでサンプリングしつつ、グレースケール (R8)・パック BGR (24bit)・NV12 へ変換する。
+/// 出力テクスチャのメモリレイアウトは CPU 側の最終レイアウトと同じで、行ごとのコピーだけで読み出せる。
+/// </summary>
+class FormatConverter
+{
+public:
+    FormatConverter() = default;
+    FormatConverter(const FormatConverter&) = delete;
+    FormatConverter& operator=(const FormatConverter&) = delete;
+
+    /// <summary>
+    /// ソースを width x height へサンプリングして指定フォーマットへ変換
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">ソース SRV（BGRA）</param>
+    /// <param name="width">出力幅（NV12 は偶数であること）</param>
+    /// <param name="height">出力高さ（NV12 は偶数であること）</param>
+    /// <param name="format">BAKETA_CAPTURE_FORMAT_GRAY8 / BGR24 / NV12</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true（結果は GetOutput で取得）</returns>
+    bool Convert(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* source,
+        UINT width, UINT height, int format, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 直前の Convert の出力テクスチャ
+    /// </summary>
+    ID3D11Texture2D* GetOutput() const { return m_output.Get(); }
+
+    /// <summary>
+    /// 出力テクスチャのフォーマット（ステージングテクスチャの作成用）
+    /// </summary>
+    DXGI_FORMAT GetOutputFormat() const { return m_outputFormat; }
+
+    /// <summary>
+    /// 出力テクスチャの使用領域（テクセル単位）
+    /// </summary>
+    UINT GetOutputWidth() const { return m_outputWidth; }
+    UINT GetOutputHeight() const { return m_outputHeight; }
+
+    /// <summary>
+    /// 出力フォーマットの1行のバイト数と行数（CPU 側レイアウト、NV12 は Y + UV の行数）
+    /// </summary>
+    static void GetLayout(int format, int width, int height, int* rowBytes, int* rowCount);
+
+    /// <summary>
+    /// GPU リソースを解放（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    struct Kernel
+    {
+        ComPtr<ID3D11ComputeShader> shader;
+        bool compiled = false;
+    };
+
+    bool InitializeShared(ID3D11Device* device, HRESULT* hr);
+    bool EnsureKernel(ID3D11Device* device, int format, HRESULT* hr);
+    bool EnsureOutput(ID3D11Device* device, UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr);
+
+    bool m_sharedInitialized = false;
+    ComPtr<ID3D11Buffer> m_constantBuffer;
+    ComPtr<ID3D11SamplerState> m_linearSampler;
+    std::array<Kernel, 3> m_kernels;  // GRAY8 / BGR24 / NV12（初回使用時にコンパイル）
+
+    ComPtr<ID3D11Texture2D> m_output;
+    ComPtr<ID3D11UnorderedAccessView> m_outputUav;
+    DXGI_FORMAT m_outputFormat = DXGI_FORMAT_UNKNOWN;
+    UINT m_outputTextureWidth = 0;
+    UINT m_outputTextureHeight = 0;
+    UINT m_outputWidth = 0;
+    UINT m_outputHeight = 0;
+};
@@ -0,0 +1,102 @@
+// FormatShader.hlsl - ピクセルフォーマット変換（FormatConverter）
+// 出力ピクセル中心の UV でソースをバイリニアサンプリングするため、リサイズと変換を1パスで行う
+// ビルド時に fxc でカーネルごとに KERNEL_* を定義して cs_5_0 のバイトコードヘッダーへコンパイルする
+//   KERNEL_GRAY  / CSGray  -> g_FormatGrayCS
+//   KERNEL_BGR24 / CSBgr24 -> g_FormatBgr24CS
+//   KERNEL_NV12  / CSNv12  -> g_FormatNv12CS
+
+Texture2D<float4> sourceTexture : register(t0);
+SamplerState linearSampler : register(s0);
+
+cbuffer FormatParams : register(b0)
+{
+    uint outputWidth;
+    uint outputHeight;
+    float2 inverseSize;  // 1 / 出力サイズ
+};
+
+float3 SampleRgb(uint2 pixel)
+{
+    return sourceTexture.SampleLevel(linearSampler, (float2(pixel) + 0.5f) * inverseSize, 0).rgb;
+}
+
+uint ToByte(float value)
+{
+    return (uint)(saturate(value) * 255.0f + 0.5f);
+}
+
+// 出力 UAV の型がカーネルごとに異なるため、カーネル名のマクロで1つだけ有効にしてコンパイルする
+#if defined(KERNEL_GRAY)
+// グレースケール: BT.601 輝度（OpenCV の BGR2GRAY と同じ係数）
+RWTexture2D<unorm float> grayOutput : register(u0);
+
+[numthreads(8, 8, 1)]
+void CSGray(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= outputWidth || id.y >= outputHeight)
+        return;
+    grayOutput[id.xy] = dot(SampleRgb(id.xy), float3(0.299f, 0.587f, 0.114f));
+}
+#endif
+
+#if defined(KERNEL_BGR24)
+// パック BGR: 1 スレッドで 4 ピクセル (12 バイト) を 3 ワードへ詰める
+RWTexture2D<uint> packedOutput : register(u0);
+
+[numthreads(8, 8, 1)]
+void CSBgr24(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x * 4 >= outputWidth || id.y >= outputHeight)
+        return;
+
+    uint bytes[12];
+    [unroll]
+    for (uint i = 0; i < 4; ++i)
+    {
+        float3 rgb = SampleRgb(uint2(min(id.x * 4 + i, outputWidth - 1), id.y));
+        bytes[i * 3 + 0] = ToByte(rgb.b);
+        bytes[i * 3 + 1] = ToByte(rgb.g);
+        bytes[i * 3 + 2] = ToByte(rgb.r);
+    }
+
+    [unroll]
+    for (uint w = 0; w < 3; ++w)
+    {
+        packedOutput[uint2(id.x * 3 + w, id.y)] =
+            bytes[w * 4] | (bytes[w * 4 + 1] << 8) | (bytes[w * 4 + 2] << 16) | (bytes[w * 4 + 3] << 24);
+    }
+}
+#endif
+
+#if defined(KERNEL_NV12)
+// NV12: BT.709 リミテッドレンジ。1 スレッドで 2x2 ブロックの Y 4 つと UV 1 組を書く
+// 出力テクスチャは上 outputHeight 行が Y プレーン、続く outputHeight / 2 行が UV インターリーブ
+RWTexture2D<unorm float> nv12Output : register(u0);
+
+[numthreads(8, 8, 1)]
+void CSNv12(uint3 id : SV_DispatchThreadID)
+{
+    uint2 origin = id.xy * 2;
+    if (origin.x >= outputWidth || origin.y >= outputHeight)
+        return;
+
+    float3 sum = 0.0f;
+    [unroll]
+    for (uint y = 0; y < 2; ++y)
+    {
+        [unroll]
+        for (uint x = 0; x < 2; ++x)
+        {
+            float3 rgb = SampleRgb(origin + uint2(x, y));
+            nv12Output[origin + uint2(x, y)] = (16.0f + 219.0f * dot(rgb, float3(0.2126f, 0.7152f, 0.0722f))) / 255.0f;
+            sum += rgb;
+        }
+    }
+
+    float3 rgb = sum * 0.25f;
+    float u = 128.0f + 224.0f * dot(rgb, float3(-0.1146f, -0.3854f, 0.5f));
+    float v = 128.0f + 224.0f * dot(rgb, float3(0.5f, -0.4542f, -0.0458f));
+    nv12Output[uint2(origin.x, outputHeight + id.y)] = u / 255.0f;
+    nv12Output[uint2(origin.x + 1, outputHeight + id.y)] = v / 255.0f;
+}
+#endif
@@ -0,0 +1,124 @@
+﻿#include "pch.h"
+
+// SIMD・ストリーミングコピーに適したキャッシュライン境界
+static constexpr size_t kFrameBufferAlignment = 64;
+
+FrameBufferPool& FrameBufferPool::Instance()
+{
+    static FrameBufferPool instance;
+    return instance;
+}
+
+FrameBufferPool::~FrameBufferPool()
+{
+    // 未使用バッファのみ解放（貸出中のものは呼び出し側が ReleaseFrame するまで有効）
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TrimLocked(0, 0);
+}
+
+unsigned char* FrameBufferPool::Acquire(int width, int height, int stride)
+{
+    if (width <= 0 || height <= 0 || stride <= 0)
+    {
+        return nullptr;
+    }
+
+    BufferKey key{ width, height, stride };
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // 新しいものから同一キーのバッファを探す（キャッシュに残っている可能性が高い）
+        for (auto it = m_free.rbegin(); it != m_free.rend(); ++it)
+        {
+            if (it->key == key)
+            {
+                unsigned char* data = it->data;
+                m_freeBytes -= key.Bytes();
+                m_free.erase(std::next(it).base());
+                m_outstanding.emplace(data, key);
+                m_reuseCount.fetch_add(1, std::memory_order_relaxed);
+                return data;
+            }
+        }
+    }
+
+    // プールに無い場合は新規確保（ロック外で確保）
+    auto* data = static_cast<unsigned char*>(_aligned_malloc(key.Bytes(), kFrameBufferAlignment));
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    m_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outstanding.emplace(data, key);
+    return data;
+}
+
+bool FrameBufferPool::Release(unsigned char* buffer)
+{
+    if (!buffer)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_outstanding.find(buffer);
+    if (it == m_outstanding.end())
+    {
+        // プールが貸し出していないバッファ（CaptureFrameInto の呼び出し側バッファ等）
+        return false;
+    }
+
+    BufferKey key = it->second;
+    m_outstanding.erase(it);
+
+    // 単体で上限を超えるバッファは保持しない
+    if (key.Bytes() > m_maxPooledBytes || m_maxPooledBuffers <= 0)
+    {
+        _aligned_free(buffer);
+        return true;
+    }
+
+    m_free.push_back({ key, buffer });
+    m_freeBytes += key.Bytes();
+
+    // ハイウォーターマークを超えた分は古い順に解放
+    TrimLocked(m_maxPooledBytes, m_maxPooledBuffers);
+    return true;
+}
+
+void FrameBufferPool::SetLimits(size_t maxPooledBytes, int maxPooledBuffers)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxPooledBytes = maxPooledBytes;
+    m_maxPooledBuffers = (std::max)(0, maxPooledBuffers);
+    TrimLocked(m_maxPooledBytes, m_maxPooledBuffers);
+}
+
+void FrameBufferPool::Trim(size_t targetBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TrimLocked(targetBytes, targetBytes == 0 ? 0 : m_maxPooledBuffers);
+}
+
+void FrameBufferPool::TrimLocked(size_t targetBytes, int targetCount)
+{
+    size_t releaseCount = 0;
+    while (releaseCount < m_free.size() &&
+        (m_freeBytes > targetBytes || static_cast<int>(m_free.size() - releaseCount) > targetCount))
+    {
+        FreeBuffer& oldest = m_free[releaseCount];
+        m_freeBytes -= oldest.key.Bytes();
+        _aligned_free(oldest.data);
+        ++releaseCount;
+    }
+
+    if (releaseCount > 0)
+    {
+        m_free.erase(m_free.begin(), m_free.begin() + static_cast<std::ptrdiff_t>(releaseCount));
+    }
+}
@@ -0,0 +1,99 @@
+﻿#pragma once
+
+/// <summary>
+/// キャプチャフレーム出力バッファのプロセス共通プール
+/// (width, height, stride) をキーに 64 バイトアライメントのバッファを再利用し、
+/// 毎フレームの _aligned_malloc / _aligned_free による CRT ヒープの断片化を防ぐ。
+/// BaketaCapture_ReleaseFrame で返却されたバッファは解放せずプールへ戻す。
+/// </summary>
+class FrameBufferPool
+{
+public:
+    /// <summary>
+    /// デフォルトの保持上限（ハイウォーターマーク）: 128MB / 8 バッファ
+    /// </summary>
+    static constexpr size_t kDefaultMaxPooledBytes = 128ull * 1024 * 1024;
+    static constexpr int kDefaultMaxPooledBuffers = 8;
+
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static FrameBufferPool& Instance();
+
+    /// <summary>
+    /// height * stride バイトのバッファを取得（プールに同一キーがあれば再利用）
+    /// </summary>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ（行数）</param>
+    /// <param name="stride">行バイト数</param>
+    /// <returns>バッファ、確保失敗時は nullptr</returns>
+    unsigned char* Acquire(int width, int height, int stride);
+
+    /// <summary>
+    /// バッファをプールへ返却
+    /// </summary>
+    /// <param name="buffer">Acquire() で取得したバッファ</param>
+    /// <returns>プール管理下のバッファだった場合は true（呼び出し側所有のバッファは false）</returns>
+    bool Release(unsigned char* buffer);
+
+    /// <summary>
+    /// 保持上限を設定（超過分は古い順に解放）
+    /// </summary>
+    /// <param name="maxPooledBytes">保持する未使用バッファの合計バイト数上限</param>
+    /// <param name="maxPooledBuffers">保持する未使用バッファ数上限</param>
+    void SetLimits(size_t maxPooledBytes, int maxPooledBuffers);
+
+    /// <summary>
+    /// 未使用バッファを targetBytes 以下になるまで古い順に解放
+    /// </summary>
+    /// <param name="targetBytes">残す合計バイト数（0 で全解放）</param>
+    void Trim(size_t targetBytes = 0);
+
+    /// <summary>
+    /// 再利用ヒット数を取得
+    /// </summary>
+    unsigned long long GetReuseCount() const { return m_reuseCount.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 新規確保数を取得
+    /// </summary>
+    unsigned long long GetAllocationCount() const { return m_allocationCount.load(std::memory_order_relaxed); }
+
+private:
+    FrameBufferPool() = default;
+    ~FrameBufferPool();
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    struct BufferKey
+    {
+        int width;
+        int height;
+        int stride;
+
+        bool operator==(const BufferKey& other) const
+        {
+            return width == other.width && height == other.height && stride == other.stride;
+        }
+
+        size_t Bytes() const { return static_cast<size_t>(height) * static_cast<size_t>(stride); }
+    };
+
+    struct FreeBuffer
+    {
+        BufferKey key;
+        unsigned char* data;
+    };
+
+    void TrimLocked(size_t targetBytes, int targetCount);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<unsigned char*, BufferKey> m_outstanding;  // 貸出中バッファ
+    std::vector<FreeBuffer> m_free;                               // 未使用バッファ（末尾ほど新しい）
+    size_t m_freeBytes = 0;
+    size_t m_maxPooledBytes = kDefaultMaxPooledBytes;
+    int m_maxPooledBuffers = kDefaultMaxPooledBuffers;
+
+    std::atomic<unsigned long long> m_reuseCount{ 0 };
+    std::atomic<unsigned long long> m_allocationCount{ 0 };
+};
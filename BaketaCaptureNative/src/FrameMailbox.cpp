@@ -0,0 +1,64 @@
+﻿#include "pch.h"
+
+bool FrameMailbox::Publish()
+{
+    // 公開スロットと交換し、新しいフレームがあることを示すビットを立てる
+    unsigned int previous = m_shared.exchange(m_back | kFreshBit, std::memory_order_acq_rel);
+    m_back = previous & kIndexMask;
+    m_publishedCount.fetch_add(1);
+
+    // 戻ってきたスロットは読み出されなかった古いフレーム（またはリリース済みの front）
+    // 保持し続けるとフレームプールのバッファが枯渇するため即座に返却する
+    ReleaseSlot(m_slots[m_back]);
+    return (previous & kFreshBit) != 0;
+}
+
+const MailboxFrame* FrameMailbox::AcquireLatest(bool* isNew)
+{
+    bool fresh = (m_shared.load(std::memory_order_relaxed) & kFreshBit) != 0;
+    if (fresh)
+    {
+        unsigned int previous = m_shared.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+    }
+
+    if (isNew)
+    {
+        *isNew = fresh;
+    }
+
+    const MailboxFrame& front = m_slots[m_front];
+    return front.texture ? &front : nullptr;
+}
+
+void FrameMailbox::Reset()
+{
+    for (auto& slot : m_slots)
+    {
+        ReleaseSlot(slot);
+    }
+    m_shared.store(1);
+    m_back = 0;
+    m_front = 2;
+
+    // 再開後の最初のキャプチャが新しいフレームの到着を待つよう公開数も戻す
+    m_publishedCount.store(0);
+}
+
+void FrameMailbox::ReleaseSlot(MailboxFrame& slot)
+{
+    slot.texture.Reset();
+    if (slot.frame)
+    {
+        try
+        {
+            slot.frame.Close();
+        }
+        catch (...) { /* 例外を無視 */ }
+        slot.frame = nullptr;
+    }
+    slot.width = 0;
+    slot.height = 0;
+    slot.timestamp = 0;
+    slot.sequence = 0;
+}
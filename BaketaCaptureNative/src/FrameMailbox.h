@@ -0,0 +1,71 @@
+﻿#pragma once
+
+/// <summary>
+/// ストリーミングモードで公開されるフレーム
+/// WGC フレームの参照を保持し、読み出し中にフレームプールのバッファが再利用されないようにする
+/// </summary>
+struct MailboxFrame
+{
+    winrt::Direct3D11CaptureFrame frame{ nullptr };
+    ComPtr<ID3D11Texture2D> texture;
+    int width = 0;
+    int height = 0;
+    long long timestamp = 0;
+    unsigned long long sequence = 0;  // フレーム到着順の通し番号（1 始まり）
+};
+
+/// <summary>
+/// 最新フレーム受け渡し用のロックフリー・トリプルバッファ
+/// 書き込み側（OnFrameArrived）は back スロットに書いて shared と交換し、
+/// 読み出し側は新しいフレームがあれば front と shared を交換する。
+/// 書き込み側・読み出し側はそれぞれ単一スレッド（読み出し側は呼び出し元で直列化）を前提とする。
+/// </summary>
+class FrameMailbox
+{
+public:
+    FrameMailbox() = default;
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    /// <summary>
+    /// 書き込み側: 次に書き込むスロットを取得（Publish() まで読み出し側からは見えない）
+    /// </summary>
+    MailboxFrame& BeginWrite() { return m_slots[m_back]; }
+
+    /// <summary>
+    /// 書き込み側: BeginWrite() のスロットを最新フレームとして公開
+    /// 読み出されずに置き換えられた古いフレームはここで WGC へ返却される
+    /// </summary>
+    /// <returns>読み出されていないフレームを置き換えた場合は true</returns>
+    bool Publish();
+
+    /// <summary>
+    /// 読み出し側: 最新フレームを取得（待機しない）
+    /// 返されたスロットは次の AcquireLatest() / Reset() まで有効
+    /// </summary>
+    /// <param name="isNew">前回の取得以降に公開されたフレームなら true（出力・省略可）</param>
+    /// <returns>最新フレーム、まだ一度も公開されていない場合は nullptr</returns>
+    const MailboxFrame* AcquireLatest(bool* isNew = nullptr);
+
+    /// <summary>
+    /// 公開済みフレーム数を取得（Reset() で 0 に戻る）
+    /// </summary>
+    unsigned long long GetPublishedCount() const { return m_publishedCount.load(); }
+
+    /// <summary>
+    /// 全スロットを解放（書き込み側・読み出し側が停止している状態で呼ぶこと）
+    /// </summary>
+    void Reset();
+
+private:
+    static constexpr unsigned int kIndexMask = 0x3;
+    static constexpr unsigned int kFreshBit = 0x4;
+
+    static void ReleaseSlot(MailboxFrame& slot);
+
+    std::array<MailboxFrame, 3> m_slots;
+    std::atomic<unsigned int> m_shared{ 1 };  // 公開中スロット番号 | kFreshBit
+    unsigned int m_back = 0;                  // 書き込み側専有
+    unsigned int m_front = 2;                 // 読み出し側専有
+    std::atomic<unsigned long long> m_publishedCount{ 0 };
+};
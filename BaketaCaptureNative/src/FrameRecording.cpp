@@ -0,0 +1,578 @@
+﻿#include "pch.h"
+
+#pragma comment(lib, "cabinet.lib")
+
+namespace
+{
+    // XPRESS（LZ77 系）: Windows 標準の圧縮アルゴリズムの中で展開が最も速い
+    // RAW モードは展開後のサイズを呼び出し側が保持する（フレームヘッダーの rawBytes）
+    constexpr DWORD kCompressAlgorithm = COMPRESS_ALGORITHM_XPRESS | COMPRESS_RAW;
+
+    // フレームヘッダーをメモリマップ上で直接参照できるよう、各フレームを 8 バイト境界に揃える
+    constexpr unsigned long long kFrameAlignment = 8;
+
+    constexpr unsigned long long AlignUp(unsigned long long value, unsigned long long alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    HRESULT LastErrorHResult()
+    {
+        DWORD error = ::GetLastError();
+        return error != ERROR_SUCCESS ? HRESULT_FROM_WIN32(error) : E_FAIL;
+    }
+}
+
+static_assert(sizeof(FrameRecording::FileHeader) == 16, "File header layout must not change");
+static_assert(sizeof(FrameRecording::FrameHeader) == 40, "Frame header layout must not change");
+static_assert(sizeof(FrameRecording::FileFooter) == 16, "File footer layout must not change");
+
+std::unique_ptr<FrameRecorder> FrameRecorder::Create(const wchar_t* path, HRESULT* hr)
+{
+    if (!path || !path[0])
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return nullptr;
+    }
+
+    std::unique_ptr<FrameRecorder> recorder(new FrameRecorder());
+    if (!CreateCompressor(kCompressAlgorithm, nullptr, &recorder->m_compressor))
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    recorder->m_file = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (recorder->m_file == INVALID_HANDLE_VALUE)
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    FrameRecording::FileHeader header = {};
+    header.magic = FrameRecording::kFileMagic;
+    header.version = FrameRecording::kVersion;
+    header.frameHeaderSize = sizeof(FrameRecording::FrameHeader);
+    if (!recorder->Write(&header, sizeof(header), hr))
+    {
+        return nullptr;
+    }
+
+    if (hr) *hr = S_OK;
+    return recorder;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    // Finish されなかったファイルもフレーム単位で完結しているため、リーダーは走査して読める
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    if (m_compressor)
+    {
+        CloseCompressor(m_compressor);
+        m_compressor = nullptr;
+    }
+}
+
+bool FrameRecorder::Write(const void* data, size_t bytes, HRESULT* hr)
+{
+    const auto* cursor = static_cast<const unsigned char*>(data);
+    while (bytes > 0)
+    {
+        DWORD chunk = static_cast<DWORD>((std::min)(bytes, static_cast<size_t>(1u << 30)));
+        DWORD written = 0;
+        if (!WriteFile(m_file, cursor, chunk, &written, nullptr) || written != chunk)
+        {
+            if (hr) *hr = LastErrorHResult();
+            return false;
+        }
+        cursor += written;
+        bytes -= written;
+        m_offset += written;
+    }
+    return true;
+}
+
+bool FrameRecorder::Append(const unsigned char* bgra, int width, int height, int stride, long long timestamp, unsigned long long sequence,
+    const RECT* dirtyRects, int rectCount, bool fullFrame, HRESULT* hr)
+{
+    if (m_file == INVALID_HANDLE_VALUE || !bgra || width <= 0 || height <= 0 || stride < width * 4 || rectCount < 0 ||
+        (!fullFrame && rectCount > 0 && !dirtyRects))
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    const size_t packedStride = static_cast<size_t>(width) * 4;
+    const size_t rawBytes = packedStride * static_cast<size_t>(height);
+    if (rawBytes > UINT_MAX)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    // 行間のパディングを除いてから圧縮する（リプレイ側は stride = width * 4 として扱う）
+    const unsigned char* raw = bgra;
+    if (static_cast<size_t>(stride) != packedStride)
+    {
+        m_packed.resize(rawBytes);
+        for (int y = 0; y < height; ++y)
+        {
+            memcpy(m_packed.data() + packedStride * y, bgra + static_cast<size_t>(stride) * y, packedStride);
+        }
+        raw = m_packed.data();
+    }
+
+    // 出力先を展開後と同じサイズにし、収まらない（圧縮が効かない）場合はそのまま格納する
+    m_compressed.resize(rawBytes);
+    SIZE_T compressedBytes = 0;
+    bool compressed = Compress(m_compressor, raw, rawBytes, m_compressed.data(), m_compressed.size(), &compressedBytes) != FALSE;
+    if (!compressed && ::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+    {
+        if (hr) *hr = LastErrorHResult();
+        return false;
+    }
+
+    FrameRecording::FrameHeader header = {};
+    header.timestamp = timestamp;
+    header.sequence = sequence;
+    header.width = width;
+    header.height = height;
+    header.rawBytes = static_cast<unsigned int>(rawBytes);
+    header.payloadBytes = static_cast<unsigned int>(compressed ? compressedBytes : rawBytes);
+    header.flags = compressed ? 0 : FrameRecording::kFrameUncompressed;
+
+    std::vector<BaketaCaptureRect>& rects = m_rects;
+    rects.clear();
+    if (!fullFrame)
+    {
+        for (int i = 0; i < rectCount; ++i)
+        {
+            const RECT& rect = dirtyRects[i];
+            rects.push_back({ static_cast<int>(rect.left), static_cast<int>(rect.top),
+                static_cast<int>(rect.right - rect.left), static_cast<int>(rect.bottom - rect.top) });
+        }
+    }
+    else
+    {
+        header.flags |= FrameRecording::kFrameFullFrame;
+    }
+    header.rectCount = static_cast<int>(rects.size());
+
+    unsigned long long frameOffset = m_offset;
+    if (!Write(&header, sizeof(header), hr) ||
+        (!rects.empty() && !Write(rects.data(), rects.size() * sizeof(BaketaCaptureRect), hr)) ||
+        !Write(compressed ? m_compressed.data() : raw, header.payloadBytes, hr))
+    {
+        return false;
+    }
+
+    static const unsigned char kPadding[kFrameAlignment] = {};
+    size_t padding = static_cast<size_t>(AlignUp(m_offset, kFrameAlignment) - m_offset);
+    if (padding > 0 && !Write(kPadding, padding, hr))
+    {
+        return false;
+    }
+
+    m_frameOffsets.push_back(frameOffset);
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+bool FrameRecorder::Finish(HRESULT* hr)
+{
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        if (hr) *hr = S_OK;
+        return true;
+    }
+
+    FrameRecording::FileFooter footer = {};
+    footer.indexOffset = m_offset;
+    footer.frameCount = static_cast<unsigned int>(m_frameOffsets.size());
+    footer.magic = FrameRecording::kIndexMagic;
+
+    bool written = (m_frameOffsets.empty() || Write(m_frameOffsets.data(), m_frameOffsets.size() * sizeof(unsigned long long), hr)) &&
+        Write(&footer, sizeof(footer), hr);
+
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+    if (written && hr) *hr = S_OK;
+    return written;
+}
+
+std::unique_ptr<FrameRecordingWriter> FrameRecordingWriter::Create(const wchar_t* path, HRESULT* hr)
+{
+    auto recorder = FrameRecorder::Create(path, hr);
+    if (!recorder)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<FrameRecordingWriter> writer(new FrameRecordingWriter());
+    writer->m_recorder = std::move(recorder);
+    writer->m_thread = std::thread([raw = writer.get()]() { raw->WriterLoop(); });
+    return writer;
+}
+
+FrameRecordingWriter::~FrameRecordingWriter()
+{
+    Finish();
+}
+
+bool FrameRecordingWriter::Enqueue(const unsigned char* bgra, int width, int height, int stride, long long timestamp, unsigned long long sequence,
+    const RECT* dirtyRects, int rectCount, bool fullFrame)
+{
+    if (!bgra || width <= 0 || height <= 0 || stride < width * 4 || rectCount < 0 || (!fullFrame && rectCount > 0 && !dirtyRects))
+    {
+        return false;
+    }
+
+    QueuedFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || FAILED(m_result.load()) || m_queue.size() >= kMaxQueuedFrames)
+        {
+            return false;
+        }
+        if (!m_freeBuffers.empty())
+        {
+            frame.pixels = std::move(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+    }
+
+    // ロック外でコピー（書き込みスレッドはキューの先頭のみ取り出すため、呼び出し側が 1 スレッドなら満杯にはならない）
+    const size_t packedStride = static_cast<size_t>(width) * 4;
+    frame.pixels.resize(packedStride * static_cast<size_t>(height));
+    CpuImageKernels::CopyPlane(bgra, static_cast<size_t>(stride), frame.pixels.data(), packedStride, packedStride, height);
+    if (!fullFrame && rectCount > 0)
+    {
+        frame.rects.assign(dirtyRects, dirtyRects + rectCount);
+    }
+    frame.width = width;
+    frame.height = height;
+    frame.timestamp = timestamp;
+    frame.sequence = sequence;
+    frame.fullFrame = fullFrame;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(frame));
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void FrameRecordingWriter::WriterLoop()
+{
+    for (;;)
+    {
+        QueuedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty())
+            {
+                // 通知はロック中に行い、以降は this に触れない（Finish はスレッドを join せずに戻る）
+                m_writerExited = true;
+                m_drained.notify_all();
+                return;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        // 失敗後のフレームは変化矩形が繋がらないため捨てる
+        HRESULT hr = S_OK;
+        if (SUCCEEDED(m_result.load()) &&
+            !m_recorder->Append(frame.pixels.data(), frame.width, frame.height, frame.width * 4, frame.timestamp, frame.sequence,
+                frame.rects.data(), static_cast<int>(frame.rects.size()), frame.fullFrame, &hr))
+        {
+            m_result.store(hr);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeBuffers.size() < kMaxQueuedFrames)
+        {
+            m_freeBuffers.push_back(std::move(frame.pixels));
+        }
+    }
+}
+
+bool FrameRecordingWriter::Finish(int* frameCount, HRESULT* hr)
+{
+    if (m_finished)
+    {
+        if (frameCount) *frameCount = m_recorder ? m_recorder->FrameCount() : 0;
+        if (hr) *hr = S_OK;
+        return true;
+    }
+    m_finished = true;
+
+    bool writerExited = false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_wake.notify_all();
+
+        // join はローダーロック中（DllMain からのセッション終了）にデッドロックするため、終了通知を待つ
+        // プロセス終了時に強制終了されたスレッドは通知しないため、スレッドハンドルも確認する
+        while (!(writerExited = m_writerExited) && m_thread.joinable())
+        {
+            if (m_drained.wait_for(lock, std::chrono::milliseconds(50), [this]() { return m_writerExited; }))
+            {
+                continue;
+            }
+            if (WaitForSingleObject(m_thread.native_handle(), 0) == WAIT_OBJECT_0)
+            {
+                break;
+            }
+        }
+    }
+    if (m_thread.joinable())
+    {
+        m_thread.detach();
+    }
+
+    if (frameCount) *frameCount = m_recorder->FrameCount();
+    if (!writerExited)
+    {
+        // 書き込み途中で止まった可能性があるためインデックスは書かない（リーダーは先頭から走査する）
+        if (hr) *hr = E_ABORT;
+        return false;
+    }
+    return m_recorder->Finish(hr);
+}
+
+std::unique_ptr<FrameReplayReader> FrameReplayReader::Open(const wchar_t* path, HRESULT* hr)
+{
+    if (!path || !path[0])
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return nullptr;
+    }
+
+    std::unique_ptr<FrameReplayReader> reader(new FrameReplayReader());
+    if (!CreateDecompressor(kCompressAlgorithm, nullptr, &reader->m_decompressor))
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    reader->m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (reader->m_file == INVALID_HANDLE_VALUE)
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(reader->m_file, &fileSize))
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+    if (static_cast<unsigned long long>(fileSize.QuadPart) < sizeof(FrameRecording::FileHeader))
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+        return nullptr;
+    }
+
+    reader->m_mapping = CreateFileMappingW(reader->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!reader->m_mapping)
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    reader->m_view = static_cast<const unsigned char*>(MapViewOfFile(reader->m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!reader->m_view)
+    {
+        if (hr) *hr = LastErrorHResult();
+        return nullptr;
+    }
+
+    const auto* header = reinterpret_cast<const FrameRecording::FileHeader*>(reader->m_view);
+    if (header->magic != FrameRecording::kFileMagic || header->version != FrameRecording::kVersion ||
+        header->frameHeaderSize != sizeof(FrameRecording::FrameHeader))
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+        return nullptr;
+    }
+
+    // インデックスが無い・壊れている場合（記録中に終了したファイル）は先頭から走査する
+    unsigned long long size = static_cast<unsigned long long>(fileSize.QuadPart);
+    if (!reader->LoadIndex(size) && !reader->ScanFrames(size))
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+        return nullptr;
+    }
+
+    if (hr) *hr = S_OK;
+    return reader;
+}
+
+FrameReplayReader::~FrameReplayReader()
+{
+    if (m_view)
+    {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    if (m_decompressor)
+    {
+        CloseDecompressor(m_decompressor);
+        m_decompressor = nullptr;
+    }
+}
+
+bool FrameReplayReader::AddFrame(unsigned long long offset, unsigned long long fileSize)
+{
+    // offset はインデックスから読んだ値のため、減算で折り返さないよう先に範囲を確認する
+    if (offset < sizeof(FrameRecording::FileHeader) || offset % kFrameAlignment != 0 || offset > fileSize ||
+        fileSize - offset < sizeof(FrameRecording::FrameHeader))
+    {
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const FrameRecording::FrameHeader*>(m_view + offset);
+    unsigned long long rawBytes = static_cast<unsigned long long>(header->width) * 4ULL * static_cast<unsigned long long>(header->height);
+    unsigned long long bodyBytes = static_cast<unsigned long long>(header->rectCount) * sizeof(BaketaCaptureRect) + header->payloadBytes;
+    if (header->width <= 0 || header->height <= 0 || header->rectCount < 0 || rawBytes != header->rawBytes ||
+        ((header->flags & FrameRecording::kFrameUncompressed) && header->payloadBytes != header->rawBytes) ||
+        fileSize - offset - sizeof(FrameRecording::FrameHeader) < bodyBytes)
+    {
+        return false;
+    }
+
+    Frame frame;
+    frame.header = header;
+    frame.rects = reinterpret_cast<const BaketaCaptureRect*>(header + 1);
+    frame.payload = reinterpret_cast<const unsigned char*>(frame.rects + header->rectCount);
+    m_frames.push_back(frame);
+    return true;
+}
+
+bool FrameReplayReader::LoadIndex(unsigned long long fileSize)
+{
+    if (fileSize < sizeof(FrameRecording::FileHeader) + sizeof(FrameRecording::FileFooter))
+    {
+        return false;
+    }
+
+    // indexOffset は信頼できないため、加算で折り返さないよう残りのサイズと比較する
+    const unsigned long long footerOffset = fileSize - sizeof(FrameRecording::FileFooter);
+    const auto* footer = reinterpret_cast<const FrameRecording::FileFooter*>(m_view + footerOffset);
+    unsigned long long indexBytes = static_cast<unsigned long long>(footer->frameCount) * sizeof(unsigned long long);
+    if (footer->magic != FrameRecording::kIndexMagic || footer->indexOffset < sizeof(FrameRecording::FileHeader) ||
+        footer->indexOffset > footerOffset || footer->indexOffset % kFrameAlignment != 0 ||
+        footerOffset - footer->indexOffset != indexBytes)
+    {
+        return false;
+    }
+
+    const auto* offsets = reinterpret_cast<const unsigned long long*>(m_view + footer->indexOffset);
+    m_frames.reserve(footer->frameCount);
+    for (unsigned int i = 0; i < footer->frameCount; ++i)
+    {
+        // フレームはインデックスより前に収まっていること
+        if (!AddFrame(offsets[i], footer->indexOffset))
+        {
+            m_frames.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameReplayReader::ScanFrames(unsigned long long fileSize)
+{
+    m_frames.clear();
+    unsigned long long offset = sizeof(FrameRecording::FileHeader);
+    while (offset < fileSize && AddFrame(offset, fileSize))
+    {
+        const FrameRecording::FrameHeader* header = m_frames.back().header;
+        offset = AlignUp(offset + sizeof(FrameRecording::FrameHeader) +
+            static_cast<unsigned long long>(header->rectCount) * sizeof(BaketaCaptureRect) + header->payloadBytes, kFrameAlignment);
+    }
+    return !m_frames.empty();
+}
+
+bool FrameReplayReader::Decode(int index, unsigned char* destination, int destinationStride, HRESULT* hr)
+{
+    if (index < 0 || index >= FrameCount() || !destination)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    const Frame& frame = m_frames[static_cast<size_t>(index)];
+    const FrameRecording::FrameHeader* header = frame.header;
+    const size_t packedStride = static_cast<size_t>(header->width) * 4;
+    if (destinationStride < static_cast<int>(packedStride))
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    // 詰めた出力先へは直接展開し、それ以外は作業バッファを経由して行ごとにコピーする
+    const unsigned char* pixels = frame.payload;
+    bool packed = static_cast<size_t>(destinationStride) == packedStride;
+    if (!(header->flags & FrameRecording::kFrameUncompressed))
+    {
+        unsigned char* output = destination;
+        if (!packed)
+        {
+            m_scratch.resize(header->rawBytes);
+            output = m_scratch.data();
+        }
+
+        SIZE_T decompressedBytes = 0;
+        if (!Decompress(m_decompressor, frame.payload, header->payloadBytes, output, header->rawBytes, &decompressedBytes))
+        {
+            if (hr) *hr = LastErrorHResult();
+            return false;
+        }
+        if (decompressedBytes != header->rawBytes)
+        {
+            if (hr) *hr = HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+            return false;
+        }
+        if (packed)
+        {
+            if (hr) *hr = S_OK;
+            return true;
+        }
+        pixels = output;
+    }
+
+    if (packed)
+    {
+        memcpy(destination, pixels, header->rawBytes);
+    }
+    else
+    {
+        for (int y = 0; y < header->height; ++y)
+        {
+            memcpy(destination + static_cast<size_t>(destinationStride) * y, pixels + packedStride * y, packedStride);
+        }
+    }
+
+    if (hr) *hr = S_OK;
+    return true;
+}
@@ -0,0 +1,249 @@
+﻿#pragma once
+
+/// <summary>
+/// キャプチャフレームの記録ファイル（ベンチマーク用の決定的なリプレイ）
+/// フレームごとに提示時刻・通し番号・変化矩形と、XPRESS（Windows Compression API）で圧縮した BGRA を追記し、
+/// クローズ時に末尾へフレーム位置のインデックスを書く。リプレイ側はファイル全体をメモリマップし、
+/// インデックスからフレームを直接参照して展開する（インデックスが無い中断されたファイルは先頭から走査する）。
+/// </summary>
+namespace FrameRecording
+{
+    constexpr unsigned int kFileMagic = 0x43524B42;    // 'BKRC'
+    constexpr unsigned int kIndexMagic = 0x49524B42;   // 'BKRI'
+    constexpr unsigned int kVersion = 1;
+
+    constexpr unsigned int kFrameFullFrame = 0x1;      // 変化矩形の情報がない（全体が変化したものとして扱う）
+    constexpr unsigned int kFrameUncompressed = 0x2;   // 圧縮で小さくならなかったためそのまま格納
+
+    struct FileHeader
+    {
+        unsigned int magic;
+        unsigned int version;
+        unsigned int frameHeaderSize;
+        unsigned int reserved;
+    };
+
+    struct FrameHeader
+    {
+        long long timestamp;           // 提示時刻（100ns単位）
+        unsigned long long sequence;   // 記録元セッションのフレーム通し番号
+        int width;
+        int height;                    // 行数（stride = width * 4 で詰めて格納）
+        unsigned int payloadBytes;     // 格納バイト数
+        unsigned int rawBytes;         // 展開後のバイト数
+        int rectCount;                 // 直前に記録したフレームからの変化矩形数（BaketaCaptureRect が続く）
+        unsigned int flags;            // kFrame*
+    };
+
+    struct FileFooter
+    {
+        unsigned long long indexOffset;  // フレーム先頭オフセット（unsigned long long * frameCount）の位置
+        unsigned int frameCount;
+        unsigned int magic;              // kIndexMagic
+    };
+}
+
+/// <summary>
+/// 記録ファイルの書き込み側（呼び出し側で直列化すること）
+/// </summary>
+class FrameRecorder
+{
+public:
+    /// <summary>
+    /// 記録ファイルを作成する（既存のファイルは上書きする）
+    /// </summary>
+    /// <param name="path">ファイルパス</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>レコーダー、失敗時は nullptr</returns>
+    static std::unique_ptr<FrameRecorder> Create(const wchar_t* path, HRESULT* hr = nullptr);
+
+    ~FrameRecorder();
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /// <summary>
+    /// フレームを圧縮して追記する
+    /// </summary>
+    /// <param name="bgra">BGRA ピクセル</param>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ</param>
+    /// <param name="stride">行バイト数</param>
+    /// <param name="timestamp">提示時刻（100ns単位）</param>
+    /// <param name="sequence">フレーム通し番号</param>
+    /// <param name="dirtyRects">直前に記録したフレームからの変化矩形</param>
+    /// <param name="rectCount">矩形数（0 は変化なし）</param>
+    /// <param name="fullFrame">変化矩形の情報がない場合は true（dirtyRects は参照しない）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Append(const unsigned char* bgra, int width, int height, int stride, long long timestamp, unsigned long long sequence,
+        const RECT* dirtyRects, int rectCount, bool fullFrame, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// インデックスを書き込んでファイルを閉じる
+    /// </summary>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Finish(HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 記録済みフレーム数
+    /// </summary>
+    int FrameCount() const { return static_cast<int>(m_frameOffsets.size()); }
+
+private:
+    FrameRecorder() = default;
+
+    bool Write(const void* data, size_t bytes, HRESULT* hr);
+
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    COMPRESSOR_HANDLE m_compressor = nullptr;
+    unsigned long long m_offset = 0;
+    std::vector<unsigned long long> m_frameOffsets;
+    std::vector<unsigned char> m_packed;      // stride を詰めた BGRA
+    std::vector<unsigned char> m_compressed;  // 圧縮結果
+    std::vector<BaketaCaptureRect> m_rects;   // 書き込む変化矩形
+};
+
+/// <summary>
+/// 記録ファイルの非同期書き込み
+/// 呼び出し側は詰めた BGRA を上限付きキューへ渡すだけで戻り、圧縮と WriteFile は専用の書き込みスレッドで行う。
+/// キューが満杯の間に渡されたフレームは記録しない（呼び出し側は次のフレームの変化矩形を最後に受け付けたフレームから求める）。
+/// </summary>
+class FrameRecordingWriter
+{
+public:
+    /// <summary>
+    /// 書き込み待ちにできるフレーム数の上限
+    /// </summary>
+    static constexpr size_t kMaxQueuedFrames = 4;
+
+    /// <summary>
+    /// 記録ファイルを作成して書き込みスレッドを開始する
+    /// </summary>
+    /// <param name="path">ファイルパス</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>ライター、失敗時は nullptr</returns>
+    static std::unique_ptr<FrameRecordingWriter> Create(const wchar_t* path, HRESULT* hr = nullptr);
+
+    ~FrameRecordingWriter();
+    FrameRecordingWriter(const FrameRecordingWriter&) = delete;
+    FrameRecordingWriter& operator=(const FrameRecordingWriter&) = delete;
+
+    /// <summary>
+    /// フレームを書き込みキューへ追加する（ピクセルはここでコピーするため、戻った後は bgra を解放してよい）
+    /// </summary>
+    /// <param name="bgra">BGRA ピクセル</param>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ</param>
+    /// <param name="stride">行バイト数</param>
+    /// <param name="timestamp">提示時刻（100ns単位）</param>
+    /// <param name="sequence">フレーム通し番号</param>
+    /// <param name="dirtyRects">直前に受け付けたフレームからの変化矩形</param>
+    /// <param name="rectCount">矩形数（0 は変化なし）</param>
+    /// <param name="fullFrame">変化矩形の情報がない場合は true</param>
+    /// <returns>キューへ追加した場合は true（満杯・書き込み失敗後は false）。呼び出しは 1 スレッドずつ行うこと</returns>
+    bool Enqueue(const unsigned char* bgra, int width, int height, int stride, long long timestamp, unsigned long long sequence,
+        const RECT* dirtyRects, int rectCount, bool fullFrame);
+
+    /// <summary>
+    /// 書き込みスレッドで最初に失敗した HRESULT（失敗していなければ S_OK）
+    /// </summary>
+    HRESULT GetResult() const { return m_result.load(); }
+
+    /// <summary>
+    /// キューの残りを書き込んでからインデックスを書いてファイルを閉じる
+    /// </summary>
+    /// <param name="frameCount">記録したフレーム数（出力・省略可）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Finish(int* frameCount = nullptr, HRESULT* hr = nullptr);
+
+private:
+    struct QueuedFrame
+    {
+        std::vector<unsigned char> pixels;  // stride = width * 4 で詰めた BGRA
+        std::vector<RECT> rects;
+        int width = 0;
+        int height = 0;
+        long long timestamp = 0;
+        unsigned long long sequence = 0;
+        bool fullFrame = false;
+    };
+
+    FrameRecordingWriter() = default;
+
+    void WriterLoop();
+
+    std::unique_ptr<FrameRecorder> m_recorder;  // 書き込みスレッド専有（Finish で停止後に呼び出し側へ戻る）
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    std::deque<QueuedFrame> m_queue;
+    std::vector<std::vector<unsigned char>> m_freeBuffers;  // 書き込み済みフレームのバッファ（再利用）
+    bool m_stopping = false;
+    bool m_writerExited = false;
+    bool m_finished = false;
+    std::atomic<HRESULT> m_result{ S_OK };
+};
+
+/// <summary>
+/// 記録ファイルの読み出し側（メモリマップ）
+/// 展開は1スレッドずつ行うこと（展開ハンドルを共有するため）。
+/// </summary>
+class FrameReplayReader
+{
+public:
+    struct Frame
+    {
+        const FrameRecording::FrameHeader* header = nullptr;
+        const BaketaCaptureRect* rects = nullptr;
+        const unsigned char* payload = nullptr;
+    };
+
+    /// <summary>
+    /// 記録ファイルを開いてフレーム位置を読み込む
+    /// </summary>
+    /// <param name="path">ファイルパス</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可、形式が不正な場合は HRESULT_FROM_WIN32(ERROR_BAD_FORMAT)）</param>
+    /// <returns>リーダー、失敗時は nullptr</returns>
+    static std::unique_ptr<FrameReplayReader> Open(const wchar_t* path, HRESULT* hr = nullptr);
+
+    ~FrameReplayReader();
+    FrameReplayReader(const FrameReplayReader&) = delete;
+    FrameReplayReader& operator=(const FrameReplayReader&) = delete;
+
+    /// <summary>
+    /// フレーム数
+    /// </summary>
+    int FrameCount() const { return static_cast<int>(m_frames.size()); }
+
+    /// <summary>
+    /// フレームのヘッダー・変化矩形を取得（マッピング上を直接指す）
+    /// </summary>
+    const Frame& GetFrame(int index) const { return m_frames[static_cast<size_t>(index)]; }
+
+    /// <summary>
+    /// フレームを展開する
+    /// </summary>
+    /// <param name="index">フレーム番号</param>
+    /// <param name="destination">出力先（height * destinationStride バイト以上）</param>
+    /// <param name="destinationStride">出力先の行バイト数（width * 4 以上）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Decode(int index, unsigned char* destination, int destinationStride, HRESULT* hr = nullptr);
+
+private:
+    FrameReplayReader() = default;
+
+    bool LoadIndex(unsigned long long fileSize);
+    bool ScanFrames(unsigned long long fileSize);
+    bool AddFrame(unsigned long long offset, unsigned long long fileSize);
+
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    const unsigned char* m_view = nullptr;
+    DECOMPRESSOR_HANDLE m_decompressor = nullptr;
+    std::vector<Frame> m_frames;
+    std::vector<unsigned char> m_scratch;  // stride が異なる出力先への展開用
+};
@@ -0,0 +1,715 @@
+﻿#include "pch.h"
+
+#pragma comment(lib, "mfplat.lib")
+#pragma comment(lib, "mfuuid.lib")
+
+namespace
+{
+    // エンコーダーイベントのポーリング間隔
+    constexpr auto kEventPollInterval = std::chrono::microseconds(500);
+
+    const GUID& CodecSubtype(int codec)
+    {
+        return codec == BAKETA_CAPTURE_CODEC_HEVC ? MFVideoFormat_HEVC : MFVideoFormat_H264;
+    }
+
+    HRESULT EnumerateEncoders(int codec, IMFActivate*** activates, UINT32* count)
+    {
+        MFT_REGISTER_TYPE_INFO inputInfo = { MFMediaType_Video, MFVideoFormat_NV12 };
+        MFT_REGISTER_TYPE_INFO outputInfo = { MFMediaType_Video, CodecSubtype(codec) };
+        return MFTEnumEx(MFT_CATEGORY_VIDEO_ENCODER, MFT_ENUM_FLAG_HARDWARE | MFT_ENUM_FLAG_SORTANDFILTER,
+            &inputInfo, &outputInfo, activates, count);
+    }
+
+    void ReleaseActivates(IMFActivate** activates, UINT32 count)
+    {
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            activates[i]->Release();
+        }
+        CoTaskMemFree(activates);
+    }
+
+    // 対応しないエンコーダーもあるため設定の失敗は無視する
+    void SetCodecValue(ICodecAPI* codecApi, const GUID& property, ULONG value)
+    {
+        if (!codecApi)
+        {
+            return;
+        }
+
+        VARIANT var;
+        VariantInit(&var);
+        var.vt = VT_UI4;
+        var.ulVal = value;
+        codecApi->SetValue(&property, &var);
+    }
+
+    void SetCodecFlag(ICodecAPI* codecApi, const GUID& property, bool value)
+    {
+        if (!codecApi)
+        {
+            return;
+        }
+
+        VARIANT var;
+        VariantInit(&var);
+        var.vt = VT_BOOL;
+        var.boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
+        codecApi->SetValue(&property, &var);
+    }
+}
+
+HardwareVideoEncoder::~HardwareVideoEncoder()
+{
+    Reset();
+}
+
+bool HardwareVideoEncoder::IsCodecAvailable(int codec)
+{
+    if (FAILED(MFStartup(MF_VERSION, MFSTARTUP_LITE)))
+    {
+        return false;
+    }
+
+    IMFActivate** activates = nullptr;
+    UINT32 count = 0;
+    HRESULT hr = EnumerateEncoders(codec, &activates, &count);
+    ReleaseActivates(activates, count);
+    MFShutdown();
+    return SUCCEEDED(hr) && count > 0;
+}
+
+bool HardwareVideoEncoder::Open(ID3D11Device* device, ID3D11DeviceContext* context, LUID adapterLuid, const Config& config, HRESULT* hr)
+{
+    Reset();
+
+    if (!device || !context || config.width == 0 || config.height == 0 || config.frameRate <= 0 || config.bitrateKbps <= 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    HRESULT result = MFStartup(MF_VERSION, MFSTARTUP_LITE);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    m_mfStarted = true;
+    m_config = config;
+
+    // ビデオプロセッサーは VIDEO_SUPPORT 付きのデバイスでのみ取得できる
+    result = device->QueryInterface(IID_PPV_ARGS(&m_videoDevice));
+    if (SUCCEEDED(result))
+    {
+        result = context->QueryInterface(IID_PPV_ARGS(&m_videoContext));
+    }
+    if (SUCCEEDED(result))
+    {
+        result = CreateTransform(device, adapterLuid);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = ConfigureTypes();
+    }
+    if (SUCCEEDED(result))
+    {
+        result = CreateSurfaces(device);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = m_transform->ProcessMessage(MFT_MESSAGE_NOTIFY_BEGIN_STREAMING, 0);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = m_transform->ProcessMessage(MFT_MESSAGE_NOTIFY_START_OF_STREAM, 0);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        Reset();
+        return false;
+    }
+
+    m_sampleDuration = 10000000LL / config.frameRate;
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+HRESULT HardwareVideoEncoder::CreateTransform(ID3D11Device* device, LUID adapterLuid)
+{
+    IMFActivate** activates = nullptr;
+    UINT32 count = 0;
+    HRESULT hr = EnumerateEncoders(m_config.codec, &activates, &count);
+    if (SUCCEEDED(hr) && count == 0)
+    {
+        hr = MF_E_TOPO_CODEC_NOT_FOUND;
+    }
+    if (FAILED(hr))
+    {
+        ReleaseActivates(activates, count);
+        return hr;
+    }
+
+    // キャプチャデバイスと同じアダプターのエンコーダーを優先（複数 GPU 環境でのアダプター間転送を避ける）
+    UINT64 luid = (static_cast<UINT64>(static_cast<UINT32>(adapterLuid.HighPart)) << 32) | adapterLuid.LowPart;
+    UINT32 selected = 0;
+    for (UINT32 i = 0; i < count; ++i)
+    {
+        UINT64 encoderLuid = 0;
+        if (SUCCEEDED(activates[i]->GetUINT64(MFT_ENUM_ADAPTER_LUID, &encoderLuid)) && encoderLuid == luid)
+        {
+            selected = i;
+            break;
+        }
+    }
+
+    hr = activates[selected]->ActivateObject(IID_PPV_ARGS(&m_transform));
+    ReleaseActivates(activates, count);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // ハードウェア MFT は非同期 MFT（METransformNeedInput / METransformHaveOutput で駆動する）
+    ComPtr<IMFAttributes> attributes;
+    hr = m_transform->GetAttributes(&attributes);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+    if (!MFGetAttributeUINT32(attributes.Get(), MF_TRANSFORM_ASYNC, FALSE))
+    {
+        return E_NOTIMPL;
+    }
+    hr = attributes->SetUINT32(MF_TRANSFORM_ASYNC_UNLOCK, TRUE);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+    attributes->SetUINT32(MF_LOW_LATENCY, TRUE);
+
+    hr = m_transform.As(&m_eventGenerator);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+    m_transform.As(&m_codecApi);
+
+    // ストリーム ID が固定の MFT は E_NOTIMPL を返す（その場合は 0）
+    DWORD inputId = 0;
+    DWORD outputId = 0;
+    if (SUCCEEDED(m_transform->GetStreamIDs(1, &inputId, 1, &outputId)))
+    {
+        m_inputStreamId = inputId;
+        m_outputStreamId = outputId;
+    }
+
+    UINT resetToken = 0;
+    hr = MFCreateDXGIDeviceManager(&resetToken, &m_deviceManager);
+    if (SUCCEEDED(hr))
+    {
+        hr = m_deviceManager->ResetDevice(device, resetToken);
+    }
+    if (SUCCEEDED(hr))
+    {
+        hr = m_transform->ProcessMessage(MFT_MESSAGE_SET_D3D_MANAGER, reinterpret_cast<ULONG_PTR>(m_deviceManager.Get()));
+    }
+    return hr;
+}
+
+HRESULT HardwareVideoEncoder::ConfigureTypes()
+{
+    // レート制御・低遅延設定はメディアタイプより先に指定する（後から変更できないエンコーダーがある）
+    // B フレームは使わず、入力と出力を 1 対 1 に保つ
+    const UINT32 bitrate = static_cast<UINT32>(m_config.bitrateKbps) * 1000;
+    SetCodecValue(m_codecApi.Get(), CODECAPI_AVEncCommonRateControlMode, eAVEncCommonRateControlMode_CBR);
+    SetCodecValue(m_codecApi.Get(), CODECAPI_AVEncCommonMeanBitRate, bitrate);
+    SetCodecValue(m_codecApi.Get(), CODECAPI_AVEncMPVDefaultBPictureCount, 0);
+    SetCodecFlag(m_codecApi.Get(), CODECAPI_AVLowLatencyMode, true);
+    if (m_config.keyframeInterval > 0)
+    {
+        SetCodecValue(m_codecApi.Get(), CODECAPI_AVEncMPVGOPSize, static_cast<ULONG>(m_config.keyframeInterval));
+    }
+
+    // 出力タイプを先に設定する（エンコーダー MFT の要件）
+    ComPtr<IMFMediaType> outputType;
+    HRESULT hr = MFCreateMediaType(&outputType);
+    if (SUCCEEDED(hr)) hr = outputType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
+    if (SUCCEEDED(hr)) hr = outputType->SetGUID(MF_MT_SUBTYPE, CodecSubtype(m_config.codec));
+    if (SUCCEEDED(hr)) hr = outputType->SetUINT32(MF_MT_AVG_BITRATE, bitrate);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeSize(outputType.Get(), MF_MT_FRAME_SIZE, m_config.width, m_config.height);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeRatio(outputType.Get(), MF_MT_FRAME_RATE, static_cast<UINT32>(m_config.frameRate), 1);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeRatio(outputType.Get(), MF_MT_PIXEL_ASPECT_RATIO, 1, 1);
+    if (SUCCEEDED(hr)) hr = outputType->SetUINT32(MF_MT_INTERLACE_MODE, MFVideoInterlace_Progressive);
+    if (SUCCEEDED(hr))
+    {
+        hr = outputType->SetUINT32(MF_MT_MPEG2_PROFILE, m_config.codec == BAKETA_CAPTURE_CODEC_HEVC
+            ? static_cast<UINT32>(eAVEncH265VProfile_Main_420_8)
+            : static_cast<UINT32>(eAVEncH264VProfile_Main));
+    }
+    if (SUCCEEDED(hr)) hr = m_transform->SetOutputType(m_outputStreamId, outputType.Get(), 0);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    ComPtr<IMFMediaType> inputType;
+    hr = MFCreateMediaType(&inputType);
+    if (SUCCEEDED(hr)) hr = inputType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
+    if (SUCCEEDED(hr)) hr = inputType->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_NV12);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeSize(inputType.Get(), MF_MT_FRAME_SIZE, m_config.width, m_config.height);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeRatio(inputType.Get(), MF_MT_FRAME_RATE, static_cast<UINT32>(m_config.frameRate), 1);
+    if (SUCCEEDED(hr)) hr = MFSetAttributeRatio(inputType.Get(), MF_MT_PIXEL_ASPECT_RATIO, 1, 1);
+    if (SUCCEEDED(hr)) hr = inputType->SetUINT32(MF_MT_INTERLACE_MODE, MFVideoInterlace_Progressive);
+    if (SUCCEEDED(hr)) hr = m_transform->SetInputType(m_inputStreamId, inputType.Get(), 0);
+    return hr;
+}
+
+HRESULT HardwareVideoEncoder::CreateSurfaces(ID3D11Device* device)
+{
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = m_config.width;
+    desc.Height = m_config.height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_NV12;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+    for (auto& surface : m_surfaces)
+    {
+        HRESULT hr = device->CreateTexture2D(&desc, nullptr, &surface.texture);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+    }
+    m_nextSurface = 0;
+    return S_OK;
+}
+
+HRESULT HardwareVideoEncoder::EnsureVideoProcessor(UINT inputWidth, UINT inputHeight)
+{
+    // 入力テクスチャのサイズが変わらない限り再利用（出力ビューも列挙子に紐づくため作り直す）
+    if (m_processor && inputWidth == m_processorInputWidth && inputHeight == m_processorInputHeight)
+    {
+        return S_OK;
+    }
+
+    m_processor.Reset();
+    m_processorEnumerator.Reset();
+    for (auto& surface : m_surfaces)
+    {
+        surface.outputView.Reset();
+    }
+
+    D3D11_VIDEO_PROCESSOR_CONTENT_DESC contentDesc = {};
+    contentDesc.InputFrameFormat = D3D11_VIDEO_FRAME_FORMAT_PROGRESSIVE;
+    contentDesc.InputFrameRate = { static_cast<UINT>(m_config.frameRate), 1 };
+    contentDesc.InputWidth = inputWidth;
+    contentDesc.InputHeight = inputHeight;
+    contentDesc.OutputFrameRate = { static_cast<UINT>(m_config.frameRate), 1 };
+    contentDesc.OutputWidth = m_config.width;
+    contentDesc.OutputHeight = m_config.height;
+    contentDesc.Usage = D3D11_VIDEO_USAGE_OPTIMAL_SPEED;
+
+    HRESULT hr = m_videoDevice->CreateVideoProcessorEnumerator(&contentDesc, &m_processorEnumerator);
+    if (SUCCEEDED(hr))
+    {
+        hr = m_videoDevice->CreateVideoProcessor(m_processorEnumerator.Get(), 0, &m_processor);
+    }
+
+    D3D11_VIDEO_PROCESSOR_OUTPUT_VIEW_DESC outputDesc = {};
+    outputDesc.ViewDimension = D3D11_VPOV_DIMENSION_TEXTURE2D;
+    for (auto& surface : m_surfaces)
+    {
+        if (SUCCEEDED(hr))
+        {
+            hr = m_videoDevice->CreateVideoProcessorOutputView(surface.texture.Get(), m_processorEnumerator.Get(), &outputDesc, &surface.outputView);
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        m_processor.Reset();
+        m_processorEnumerator.Reset();
+        return hr;
+    }
+
+    // フルレンジ RGB → BT.709 リミテッドレンジ YCbCr（FormatConverter の NV12 と同じ）
+    // ドライバーの自動補正（シャープネス・ノイズ除去等）は文字の輪郭を崩すため無効化する
+    D3D11_VIDEO_PROCESSOR_COLOR_SPACE inputSpace = {};
+    inputSpace.RGB_Range = 0;
+    D3D11_VIDEO_PROCESSOR_COLOR_SPACE outputSpace = {};
+    outputSpace.YCbCr_Matrix = 1;
+    outputSpace.Nominal_Range = D3D11_VIDEO_PROCESSOR_NOMINAL_RANGE_16_235;
+    m_videoContext->VideoProcessorSetStreamColorSpace(m_processor.Get(), 0, &inputSpace);
+    m_videoContext->VideoProcessorSetOutputColorSpace(m_processor.Get(), &outputSpace);
+    m_videoContext->VideoProcessorSetStreamAutoProcessingMode(m_processor.Get(), 0, FALSE);
+    m_videoContext->VideoProcessorSetStreamFrameFormat(m_processor.Get(), 0, D3D11_VIDEO_FRAME_FORMAT_PROGRESSIVE);
+
+    m_processorInputWidth = inputWidth;
+    m_processorInputHeight = inputHeight;
+    return S_OK;
+}
+
+HRESULT HardwareVideoEncoder::ConvertToNv12(ID3D11DeviceContext* context, ID3D11Texture2D* source, UINT sourceWidth, UINT sourceHeight, int surface)
+{
+    D3D11_TEXTURE2D_DESC sourceDesc;
+    source->GetDesc(&sourceDesc);
+
+    // ビデオプロセッサーの設定から Blt までを他セッションの発行と混ぜない
+    D3DContextLock contextLock(context);
+
+    HRESULT hr = EnsureVideoProcessor(sourceDesc.Width, sourceDesc.Height);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    D3D11_VIDEO_PROCESSOR_INPUT_VIEW_DESC inputDesc = {};
+    inputDesc.ViewDimension = D3D11_VPIV_DIMENSION_TEXTURE2D;
+    ComPtr<ID3D11VideoProcessorInputView> inputView;
+    hr = m_videoDevice->CreateVideoProcessorInputView(source, m_processorEnumerator.Get(), &inputDesc, &inputView);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // ソースの有効領域を出力全体へ拡大縮小（アスペクト比は呼び出し側で出力サイズを決める際に維持済み）
+    RECT sourceRect = { 0, 0, static_cast<LONG>(sourceWidth), static_cast<LONG>(sourceHeight) };
+    RECT targetRect = { 0, 0, static_cast<LONG>(m_config.width), static_cast<LONG>(m_config.height) };
+    m_videoContext->VideoProcessorSetStreamSourceRect(m_processor.Get(), 0, TRUE, &sourceRect);
+    m_videoContext->VideoProcessorSetStreamDestRect(m_processor.Get(), 0, TRUE, &targetRect);
+    m_videoContext->VideoProcessorSetOutputTargetRect(m_processor.Get(), TRUE, &targetRect);
+
+    D3D11_VIDEO_PROCESSOR_STREAM stream = {};
+    stream.Enable = TRUE;
+    stream.pInputSurface = inputView.Get();
+    return m_videoContext->VideoProcessorBlt(m_processor.Get(), m_surfaces[surface].outputView.Get(), 0, 1, &stream);
+}
+
+HRESULT HardwareVideoEncoder::SubmitSample(int surface, long long timestamp, unsigned long long sequence, bool forceKeyframe)
+{
+    ComPtr<IMFMediaBuffer> buffer;
+    HRESULT hr = MFCreateDXGISurfaceBuffer(__uuidof(ID3D11Texture2D), m_surfaces[surface].texture.Get(), 0, FALSE, &buffer);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    ComPtr<IMF2DBuffer> buffer2d;
+    DWORD length = 0;
+    if (SUCCEEDED(buffer.As(&buffer2d)) && SUCCEEDED(buffer2d->GetContiguousLength(&length)))
+    {
+        buffer->SetCurrentLength(length);
+    }
+
+    ComPtr<IMFSample> sample;
+    hr = MFCreateSample(&sample);
+    if (SUCCEEDED(hr))
+    {
+        hr = sample->AddBuffer(buffer.Get());
+    }
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // サンプル時刻は最初のフレームを 0 とした提示時刻（同じフレームを再度エンコードした場合も単調増加させる）
+    if (m_firstTimestamp < 0)
+    {
+        m_firstTimestamp = timestamp;
+    }
+    LONGLONG sampleTime = (std::max)(timestamp - m_firstTimestamp, m_lastSampleTime + 1);
+    sample->SetSampleTime(sampleTime);
+    sample->SetSampleDuration(m_sampleDuration);
+
+    if (forceKeyframe || m_keyframePending)
+    {
+        SetCodecValue(m_codecApi.Get(), CODECAPI_AVEncVideoForceKeyFrame, 1);
+        m_keyframePending = false;
+    }
+
+    hr = m_transform->ProcessInput(m_inputStreamId, sample.Get(), 0);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    --m_inputRequests;
+    m_lastSampleTime = sampleTime;
+    m_inFlight.push_back({ sampleTime, timestamp, sequence });
+    return S_OK;
+}
+
+bool HardwareVideoEncoder::CanAcceptInput() const
+{
+    return m_inputRequests > 0 && m_inFlight.size() < static_cast<size_t>(kSurfaceCount);
+}
+
+bool HardwareVideoEncoder::Encode(ID3D11DeviceContext* context, ID3D11Texture2D* source, UINT sourceWidth, UINT sourceHeight,
+    long long timestamp, unsigned long long sequence, bool forceKeyframe, int timeoutMs, HRESULT* hr)
+{
+    if (!m_transform || !context || !source || sourceWidth == 0 || sourceHeight == 0)
+    {
+        if (hr) *hr = m_transform ? E_INVALIDARG : MF_E_NOT_INITIALIZED;
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((std::max)(0, timeoutMs));
+
+    // 入力要求が届き、入力サーフェスに空きができるまで出力を回収しながら待つ
+    HRESULT result = PumpEvents(deadline, [this]() { return CanAcceptInput(); });
+    if (SUCCEEDED(result) && !CanAcceptInput())
+    {
+        result = MF_E_NOTACCEPTING;
+    }
+
+    // 入力中のサーフェスは保持中のものと重ならない（in-flight 数 < サーフェス数、順番に使用）
+    int surface = m_nextSurface;
+    if (SUCCEEDED(result))
+    {
+        result = ConvertToNv12(context, source, sourceWidth, sourceHeight, surface);
+    }
+    if (SUCCEEDED(result))
+    {
+        result = SubmitSample(surface, timestamp, sequence, forceKeyframe);
+    }
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    m_nextSurface = (m_nextSurface + 1) % kSurfaceCount;
+
+    // このフレームの出力を待つ（間に合わなければ次回以降の呼び出しで回収する）
+    unsigned long long producedBefore = m_packetsProduced;
+    result = PumpEvents(deadline, [this, producedBefore]() { return m_packetsProduced > producedBefore || m_inFlight.empty(); });
+    if (hr) *hr = result;
+    return SUCCEEDED(result);
+}
+
+HRESULT HardwareVideoEncoder::PumpEvents(std::chrono::steady_clock::time_point deadline, const std::function<bool()>& done)
+{
+    for (;;)
+    {
+        ComPtr<IMFMediaEvent> event;
+        HRESULT hr = m_eventGenerator->GetEvent(MF_EVENT_FLAG_NO_WAIT, &event);
+        if (hr == MF_E_NO_EVENTS_AVAILABLE)
+        {
+            // 届いているイベントを処理し終えた時点で条件を判定する
+            if (done() || std::chrono::steady_clock::now() >= deadline)
+            {
+                return S_OK;
+            }
+            std::this_thread::sleep_for(kEventPollInterval);
+            continue;
+        }
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        MediaEventType type = MEUnknown;
+        HRESULT status = S_OK;
+        event->GetType(&type);
+        event->GetStatus(&status);
+        if (FAILED(status))
+        {
+            return status;
+        }
+
+        if (type == METransformNeedInput)
+        {
+            ++m_inputRequests;
+        }
+        else if (type == METransformHaveOutput)
+        {
+            hr = DrainOutput();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+    }
+}
+
+HRESULT HardwareVideoEncoder::DrainOutput()
+{
+    MFT_OUTPUT_STREAM_INFO streamInfo = {};
+    HRESULT hr = m_transform->GetOutputStreamInfo(m_outputStreamId, &streamInfo);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // MFT がサンプルを用意しない場合のみ出力バッファを確保する
+    bool providesSamples = (streamInfo.dwFlags & (MFT_OUTPUT_STREAM_PROVIDES_SAMPLES | MFT_OUTPUT_STREAM_CAN_PROVIDE_SAMPLES)) != 0;
+    ComPtr<IMFSample> sample;
+    MFT_OUTPUT_DATA_BUFFER output = {};
+    output.dwStreamID = m_outputStreamId;
+    if (!providesSamples)
+    {
+        ComPtr<IMFMediaBuffer> buffer;
+        hr = MFCreateSample(&sample);
+        if (SUCCEEDED(hr)) hr = MFCreateMemoryBuffer(streamInfo.cbSize, &buffer);
+        if (SUCCEEDED(hr)) hr = sample->AddBuffer(buffer.Get());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        output.pSample = sample.Get();
+    }
+
+    DWORD status = 0;
+    hr = m_transform->ProcessOutput(0, 1, &output, &status);
+    if (output.pEvents)
+    {
+        output.pEvents->Release();
+    }
+    if (providesSamples && output.pSample)
+    {
+        sample.Attach(output.pSample);
+    }
+
+    if (hr == MF_E_TRANSFORM_STREAM_CHANGE)
+    {
+        // エンコーダーが出力タイプを更新した（パラメーターセットの変更等）。提示されたタイプを受け入れて続行する
+        ComPtr<IMFMediaType> outputType;
+        hr = m_transform->GetOutputAvailableType(m_outputStreamId, 0, &outputType);
+        if (SUCCEEDED(hr))
+        {
+            hr = m_transform->SetOutputType(m_outputStreamId, outputType.Get(), 0);
+        }
+        return hr;
+    }
+    if (hr == MF_E_TRANSFORM_NEED_MORE_INPUT)
+    {
+        return S_OK;
+    }
+    if (FAILED(hr) || !sample)
+    {
+        return hr;
+    }
+
+    ComPtr<IMFMediaBuffer> contiguous;
+    hr = sample->ConvertToContiguousBuffer(&contiguous);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    Packet packet;
+    BYTE* data = nullptr;
+    DWORD length = 0;
+    hr = contiguous->Lock(&data, nullptr, &length);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+    packet.data.assign(data, data + length);
+    contiguous->Unlock();
+
+    packet.codec = m_config.codec;
+    packet.width = static_cast<int>(m_config.width);
+    packet.height = static_cast<int>(m_config.height);
+    packet.keyframe = MFGetAttributeUINT32(sample.Get(), MFSampleExtension_CleanPoint, FALSE) != FALSE;
+
+    // 入力時に記録したキャプチャ時刻・通し番号を対応付ける（出力されなかった古いフレームは読み捨てる）
+    LONGLONG sampleTime = 0;
+    sample->GetSampleTime(&sampleTime);
+    while (!m_inFlight.empty())
+    {
+        InFlightFrame frame = m_inFlight.front();
+        m_inFlight.pop_front();
+        if (frame.sampleTime >= sampleTime)
+        {
+            packet.timestamp = frame.timestamp;
+            packet.sequence = frame.sequence;
+            break;
+        }
+    }
+    ++m_packetsProduced;
+
+    // 読み出されないまま溜まった場合は未読分を破棄し、次のキーフレームから再開させる
+    if (m_packets.size() >= kMaxQueuedPackets)
+    {
+        m_packets.clear();
+        m_discontinuity = true;
+        m_keyframePending = true;
+    }
+    if (m_discontinuity)
+    {
+        if (!packet.keyframe)
+        {
+            return S_OK;
+        }
+        packet.discontinuity = true;
+        m_discontinuity = false;
+    }
+
+    m_packets.push_back(std::move(packet));
+    return S_OK;
+}
+
+void HardwareVideoEncoder::PopPacket()
+{
+    if (!m_packets.empty())
+    {
+        m_packets.pop_front();
+    }
+}
+
+void HardwareVideoEncoder::Reset()
+{
+    if (m_transform)
+    {
+        m_transform->ProcessMessage(MFT_MESSAGE_NOTIFY_END_OF_STREAM, 0);
+        m_transform->ProcessMessage(MFT_MESSAGE_NOTIFY_END_STREAMING, 0);
+        m_transform->ProcessMessage(MFT_MESSAGE_SET_D3D_MANAGER, 0);
+
+        // 非同期 MFT はワーカースレッドを止めるため明示的にシャットダウンする
+        ComPtr<IMFShutdown> shutdown;
+        if (SUCCEEDED(m_transform.As(&shutdown)))
+        {
+            shutdown->Shutdown();
+        }
+    }
+
+    m_codecApi.Reset();
+    m_eventGenerator.Reset();
+    m_transform.Reset();
+    m_deviceManager.Reset();
+    m_inputStreamId = 0;
+    m_outputStreamId = 0;
+
+    m_processor.Reset();
+    m_processorEnumerator.Reset();
+    m_processorInputWidth = 0;
+    m_processorInputHeight = 0;
+    for (auto& surface : m_surfaces)
+    {
+        surface.outputView.Reset();
+        surface.texture.Reset();
+    }
+    m_nextSurface = 0;
+    m_videoContext.Reset();
+    m_videoDevice.Reset();
+
+    m_inputRequests = 0;
+    m_inFlight.clear();
+    m_firstTimestamp = -1;
+    m_lastSampleTime = -1;
+    m_keyframePending = false;
+
+    if (m_mfStarted)
+    {
+        MFShutdown();
+        m_mfStarted = false;
+    }
+}
@@ -0,0 +1,165 @@
+﻿#pragma once
+
+/// <summary>
+/// Media Foundation のハードウェアエンコーダー（H.264 / HEVC）
+/// キャプチャした BGRA テクスチャを D3D11 ビデオプロセッサーで出力サイズの NV12 へ変換し、
+/// そのまま非同期ハードウェア MFT へ渡す（CPU への読み出しは行わない）。
+/// 出力パケットはキューに溜め、呼び出し側が読み出すまで保持する。
+/// </summary>
+class HardwareVideoEncoder
+{
+public:
+    /// <summary>
+    /// NV12 入力サーフェス数（エンコーダーが保持中のサーフェスを上書きしないための上限）
+    /// </summary>
+    static constexpr int kSurfaceCount = 4;
+
+    /// <summary>
+    /// 読み出されずに溜まったパケットの上限（超過時は破棄して次の入力をキーフレームにする）
+    /// </summary>
+    static constexpr size_t kMaxQueuedPackets = 32;
+
+    struct Config
+    {
+        int codec = 0;          // BAKETA_CAPTURE_CODEC_*
+        UINT width = 0;         // 出力幅（偶数）
+        UINT height = 0;        // 出力高さ（偶数）
+        int bitrateKbps = 0;
+        int frameRate = 0;
+        int keyframeInterval = 0;  // 0 でエンコーダー既定
+    };
+
+    struct Packet
+    {
+        std::vector<unsigned char> data;
+        int codec = 0;
+        int width = 0;
+        int height = 0;
+        bool keyframe = false;
+        bool discontinuity = false;  // 直前のパケットを破棄した
+        long long timestamp = 0;
+        unsigned long long sequence = 0;
+    };
+
+    HardwareVideoEncoder() = default;
+    ~HardwareVideoEncoder();
+    HardwareVideoEncoder(const HardwareVideoEncoder&) = delete;
+    HardwareVideoEncoder& operator=(const HardwareVideoEncoder&) = delete;
+
+    /// <summary>
+    /// 指定コーデックのハードウェアエンコーダーが存在するか
+    /// </summary>
+    static bool IsCodecAvailable(int codec);
+
+    /// <summary>
+    /// エンコーダーを作成してストリーミングを開始する（既存のエンコーダーは閉じる、キュー内のパケットは保持）
+    /// </summary>
+    /// <param name="device">D3D11 デバイス（D3D11_CREATE_DEVICE_VIDEO_SUPPORT 付きで作成されていること）</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="adapterLuid">デバイスのアダプター LUID（同じアダプターのエンコーダーを優先）</param>
+    /// <param name="config">エンコード設定</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可、エンコーダーが無い場合は MF_E_TOPO_CODEC_NOT_FOUND）</param>
+    /// <returns>成功時は true</returns>
+    bool Open(ID3D11Device* device, ID3D11DeviceContext* context, LUID adapterLuid, const Config& config, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// ソースの左上 sourceWidth x sourceHeight を出力サイズへ変換してエンコーダーへ入力する
+    /// 入力できるまで出力を回収しながら待ち、入力後はこのフレームの出力を timeoutMs まで待つ（間に合わない場合は次回以降に回収）
+    /// </summary>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">ソーステクスチャ（BGRA）</param>
+    /// <param name="sourceWidth">ソースの有効幅</param>
+    /// <param name="sourceHeight">ソースの有効高さ</param>
+    /// <param name="timestamp">キャプチャフレームの提示時刻（100ns単位）</param>
+    /// <param name="sequence">キャプチャフレームの通し番号</param>
+    /// <param name="forceKeyframe">このフレームをキーフレームにする</param>
+    /// <param name="timeoutMs">待機上限</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可、入力を受け付けない場合は MF_E_NOTACCEPTING）</param>
+    /// <returns>入力できた場合は true</returns>
+    bool Encode(ID3D11DeviceContext* context, ID3D11Texture2D* source, UINT sourceWidth, UINT sourceHeight,
+        long long timestamp, unsigned long long sequence, bool forceKeyframe, int timeoutMs, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 最も古い未読パケット（無い場合は nullptr）
+    /// </summary>
+    const Packet* FrontPacket() const { return m_packets.empty() ? nullptr : &m_packets.front(); }
+
+    /// <summary>
+    /// 最も古い未読パケットを取り除く
+    /// </summary>
+    void PopPacket();
+
+    /// <summary>
+    /// 未読パケット数
+    /// </summary>
+    size_t GetQueuedPacketCount() const { return m_packets.size(); }
+
+    /// <summary>
+    /// エンコーダーが作成済みか
+    /// </summary>
+    bool IsOpen() const { return m_transform != nullptr; }
+
+    /// <summary>
+    /// 現在の出力設定
+    /// </summary>
+    const Config& GetConfig() const { return m_config; }
+
+    /// <summary>
+    /// エンコーダーと GPU リソースを解放する（未読パケットは保持）
+    /// </summary>
+    void Reset();
+
+private:
+    struct Surface
+    {
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11VideoProcessorOutputView> outputView;
+    };
+
+    struct InFlightFrame
+    {
+        LONGLONG sampleTime;
+        long long timestamp;
+        unsigned long long sequence;
+    };
+
+    HRESULT CreateTransform(ID3D11Device* device, LUID adapterLuid);
+    HRESULT ConfigureTypes();
+    HRESULT CreateSurfaces(ID3D11Device* device);
+    HRESULT EnsureVideoProcessor(UINT inputWidth, UINT inputHeight);
+    HRESULT ConvertToNv12(ID3D11DeviceContext* context, ID3D11Texture2D* source, UINT sourceWidth, UINT sourceHeight, int surface);
+    HRESULT SubmitSample(int surface, long long timestamp, unsigned long long sequence, bool forceKeyframe);
+    HRESULT PumpEvents(std::chrono::steady_clock::time_point deadline, const std::function<bool()>& done);
+    HRESULT DrainOutput();
+    bool CanAcceptInput() const;
+
+    Config m_config;
+    bool m_mfStarted = false;
+
+    ComPtr<IMFDXGIDeviceManager> m_deviceManager;
+    ComPtr<IMFTransform> m_transform;
+    ComPtr<IMFMediaEventGenerator> m_eventGenerator;
+    ComPtr<ICodecAPI> m_codecApi;
+    DWORD m_inputStreamId = 0;
+    DWORD m_outputStreamId = 0;
+
+    ComPtr<ID3D11VideoDevice> m_videoDevice;
+    ComPtr<ID3D11VideoContext> m_videoContext;
+    ComPtr<ID3D11VideoProcessorEnumerator> m_processorEnumerator;
+    ComPtr<ID3D11VideoProcessor> m_processor;
+    UINT m_processorInputWidth = 0;
+    UINT m_processorInputHeight = 0;
+    std::array<Surface, kSurfaceCount> m_surfaces;
+    int m_nextSurface = 0;
+
+    int m_inputRequests = 0;                 // 未処理の METransformNeedInput 数
+    std::deque<InFlightFrame> m_inFlight;    // 入力済み・未出力のフレーム（入力順）
+    LONGLONG m_firstTimestamp = -1;
+    LONGLONG m_lastSampleTime = -1;
+    LONGLONG m_sampleDuration = 0;
+    unsigned long long m_packetsProduced = 0;
+    bool m_keyframePending = false;
+
+    std::deque<Packet> m_packets;
+    bool m_discontinuity = false;
+};
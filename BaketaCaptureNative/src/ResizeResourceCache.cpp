@@ -0,0 +1,119 @@
+﻿#include "pch.h"
+
+ID3D11ShaderResourceView* ResizeResourceCache::GetSourceView(ID3D11Device* device, ID3D11Texture2D* texture, HRESULT* hr)
+{
+    if (!device || !texture)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return nullptr;
+    }
+
+    for (auto& entry : m_sourceViews)
+    {
+        if (entry.texture == texture)
+        {
+            entry.lastUse = ++m_useCounter;
+            return entry.view.Get();
+        }
+    }
+
+    D3D11_TEXTURE2D_DESC srcDesc;
+    texture->GetDesc(&srcDesc);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = srcDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    ComPtr<ID3D11ShaderResourceView> view;
+    HRESULT result = device->CreateShaderResourceView(texture, &srvDesc, &view);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return nullptr;
+    }
+
+    // 上限に達している場合は最も長く使われていないものを置き換える
+    if (static_cast<int>(m_sourceViews.size()) >= kMaxSourceViews)
+    {
+        auto oldest = std::min_element(m_sourceViews.begin(), m_sourceViews.end(),
+            [](const SourceView& a, const SourceView& b) { return a.lastUse < b.lastUse; });
+        m_sourceViews.erase(oldest);
+    }
+
+    m_sourceViews.push_back({ texture, view, ++m_useCounter });
+    if (hr) *hr = S_OK;
+    return view.Get();
+}
+
+bool ResizeResourceCache::GetRenderTarget(ID3D11Device* device, UINT width, UINT height, ComPtr<ID3D11Texture2D>& texture, ID3D11RenderTargetView** rtv, HRESULT* hr)
+{
+    if (!device || !rtv || width == 0 || height == 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    for (auto& entry : m_renderTargets)
+    {
+        if (entry.width == width && entry.height == height)
+        {
+            entry.lastUse = ++m_useCounter;
+            texture = entry.texture;
+            *rtv = entry.view.Get();
+            return true;
+        }
+    }
+
+    D3D11_TEXTURE2D_DESC rtDesc = {};
+    rtDesc.Width = width;
+    rtDesc.Height = height;
+    rtDesc.MipLevels = 1;
+    rtDesc.ArraySize = 1;
+    rtDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    rtDesc.SampleDesc.Count = 1;
+    rtDesc.SampleDesc.Quality = 0;
+    rtDesc.Usage = D3D11_USAGE_DEFAULT;
+    rtDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    RenderTarget entry = { width, height, nullptr, nullptr, 0 };
+    HRESULT result = device->CreateTexture2D(&rtDesc, nullptr, &entry.texture);
+    if (SUCCEEDED(result))
+    {
+        result = device->CreateRenderTargetView(entry.texture.Get(), nullptr, &entry.view);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+
+    // 上限に達している場合は最も長く使われていないサイズを置き換える
+    if (static_cast<int>(m_renderTargets.size()) >= kMaxRenderTargets)
+    {
+        auto oldest = std::min_element(m_renderTargets.begin(), m_renderTargets.end(),
+            [](const RenderTarget& a, const RenderTarget& b) { return a.lastUse < b.lastUse; });
+        m_renderTargets.erase(oldest);
+    }
+
+    entry.lastUse = ++m_useCounter;
+    texture = entry.texture;
+    *rtv = entry.view.Get();
+    m_renderTargets.push_back(std::move(entry));
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+void ResizeResourceCache::ReleaseSourceViews()
+{
+    m_sourceViews.clear();
+}
+
+void ResizeResourceCache::Reset()
+{
+    m_sourceViews.clear();
+    m_renderTargets.clear();
+    m_useCounter = 0;
+}
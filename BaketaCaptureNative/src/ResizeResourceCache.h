@@ -0,0 +1,78 @@
+﻿#pragma once
+
+/// <summary>
+/// GPU リサイズ用ビュー・レンダーターゲットのキャッシュ
+/// WGC フレームプールは少数のテクスチャを循環させるだけなので、ソース SRV はテクスチャごとに、
+/// リサイズ先テクスチャと RTV は出力サイズごとに再利用し、毎回の Create* 呼び出しを避ける。
+/// ビューはリソースへの参照を保持するため、キャッシュ中のテクスチャのポインタが別テクスチャに再利用されることはない。
+/// </summary>
+class ResizeResourceCache
+{
+public:
+    /// <summary>
+    /// 保持するソース SRV の上限（フレームプールの最大深度 + 予備）
+    /// </summary>
+    static constexpr int kMaxSourceViews = 10;
+
+    /// <summary>
+    /// 保持するレンダーターゲットの上限（出力サイズの種類数）
+    /// </summary>
+    static constexpr int kMaxRenderTargets = 4;
+
+    ResizeResourceCache() = default;
+    ResizeResourceCache(const ResizeResourceCache&) = delete;
+    ResizeResourceCache& operator=(const ResizeResourceCache&) = delete;
+
+    /// <summary>
+    /// ソーステクスチャの SRV を取得（未作成なら作成し、上限超過時は最も古いものを破棄）
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="texture">ソーステクスチャ</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>SRV（キャッシュが所有）、失敗時は nullptr</returns>
+    ID3D11ShaderResourceView* GetSourceView(ID3D11Device* device, ID3D11Texture2D* texture, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 指定サイズのレンダーターゲットを取得（未作成なら作成し、上限超過時は最も古いものを破棄）
+    /// 返したテクスチャは次に同じサイズで呼ばれるまで内容が保持される
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ</param>
+    /// <param name="texture">レンダーターゲットテクスチャ（出力）</param>
+    /// <param name="rtv">RTV（出力、キャッシュが所有）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool GetRenderTarget(ID3D11Device* device, UINT width, UINT height, ComPtr<ID3D11Texture2D>& texture, ID3D11RenderTargetView** rtv, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// ソース SRV のみを解放（フレームプール再作成時、旧テクスチャを早く手放す）
+    /// </summary>
+    void ReleaseSourceViews();
+
+    /// <summary>
+    /// 全キャッシュを解放（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    struct SourceView
+    {
+        ID3D11Texture2D* texture;                    // キー（view が参照を保持）
+        ComPtr<ID3D11ShaderResourceView> view;
+        unsigned long long lastUse;
+    };
+
+    struct RenderTarget
+    {
+        UINT width;
+        UINT height;
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11RenderTargetView> view;
+        unsigned long long lastUse;
+    };
+
+    std::vector<SourceView> m_sourceViews;
+    std::vector<RenderTarget> m_renderTargets;
+    unsigned long long m_useCounter = 0;
+};
@@ -1,11 +1,25 @@
 // ResizeShader.hlsl - GPU Bilinear Resize Shader for Issue #193
 // Vertex Shader + Pixel Shader for texture downscaling
+// ビルド時に fxc で vs_5_0 / VSMain -> g_ResizeVS、ps_5_0 / PSMain -> g_ResizePS のバイトコードヘッダーへコンパイルする
 
-// Texture and Sampler
 Texture2D<float4> sourceTexture : register(t0);
 SamplerState bilinearSampler : register(s0);
 
-// Vertex Shader Input/Output
+// ソース上のサンプリング領域（UV）: 全体リサイズは (0,0)-(1,1)、ROI は部分領域
+// HDR モニターの FP16（scRGB リニア）ソースは同じパスで SDR の sRGB へトーンマップする
+cbuffer ResizeParams : register(b0)
+{
+    float2 uvOffset;
+    float2 uvScale;
+    uint toneMap;          // 1: ソースが scRGB（R16G16B16A16_FLOAT）
+    float sdrWhiteScale;   // scRGB 値を SDR 白 = 1.0 に揃える倍率（80 nits / SDR 白レベル）
+    float peakWhite;       // ディスプレイのピーク輝度（SDR 白 = 1.0 基準）
+    float padding;
+};
+
+// トーンカーブの開始点（これ以下は SDR 表示と同じ明るさのまま残し、文字のコントラストを保つ）
+static const float kKneeStart = 0.75f;
+
 struct VSInput
 {
     float2 Position : POSITION;
@@ -18,17 +32,40 @@ struct PSInput
     float2 TexCoord : TEXCOORD0;
 };
 
-// Vertex Shader - Full-screen quad
 PSInput VSMain(VSInput input)
 {
     PSInput output;
     output.Position = float4(input.Position, 0.0f, 1.0f);
-    output.TexCoord = input.TexCoord;
+    output.TexCoord = uvOffset + input.TexCoord * uvScale;
     return output;
 }
 
-// Pixel Shader - Bilinear sampling (hardware accelerated)
+float3 ToneMapToSdr(float3 scRgb)
+{
+    // 負値は sRGB 色域外（広色域）の成分のため切り捨てる
+    float3 color = max(scRgb * sdrWhiteScale, 0.0f);
+
+    // 膝より上をピーク輝度でちょうど 1.0 になる拡張 Reinhard で圧縮（最大成分の比率で掛けて色相を保つ）
+    float peak = max(max(color.r, color.g), color.b);
+    if (peak > kKneeStart)
+    {
+        float x = (peak - kKneeStart) / (1.0f - kKneeStart);
+        float xMax = max((peakWhite - kKneeStart) / (1.0f - kKneeStart), 1.0f);
+        float y = min(x * (1.0f + x / (xMax * xMax)) / (1.0f + x), 1.0f);
+        color *= (kKneeStart + (1.0f - kKneeStart) * y) / peak;
+    }
+
+    // リニア → sRGB（レンダーターゲットは UNORM のためシェーダーで符号化する）
+    float3 encoded = color <= 0.0031308f ? color * 12.92f : 1.055f * pow(color, 1.0f / 2.4f) - 0.055f;
+    return saturate(encoded);
+}
+
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return sourceTexture.Sample(bilinearSampler, input.TexCoord);
+    float4 color = sourceTexture.Sample(bilinearSampler, input.TexCoord);
+    if (toneMap != 0)
+    {
+        return float4(ToneMapToSdr(color.rgb), saturate(color.a));
+    }
+    return color;
 }
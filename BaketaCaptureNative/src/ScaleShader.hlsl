@@ -0,0 +1,111 @@
+// ScaleShader.hlsl - 高品質リサイズ（ComputeResizer）
+// 1 スレッド = アトラスの 1 ピクセル。どの出力矩形に属するかを判定し、選択されたフィルターでソースから直接サンプリングする
+// ビルド時に fxc で cs_5_0 / CSMain をバイトコードヘッダー (g_ScaleCS) へコンパイルする
+
+Texture2D<float4> sourceTexture : register(t0);
+SamplerState linearSampler : register(s0);
+RWTexture2D<unorm float4> outputAtlas : register(u0);
+
+cbuffer ScaleParams : register(b0)
+{
+    uint sourceWidth;
+    uint sourceHeight;
+    uint outputCount;
+    uint filterMode;       // 0 = バイリニア, 1 = 面積平均, 2 = Lanczos-2
+    uint4 outputRects[4];  // アトラス上の x, y, width, height
+};
+
+static const float PI = 3.14159265f;
+static const int kMaxTaps = 64;  // 1 軸あたりのタップ上限（縮小率 16 倍超の Lanczos・32 倍超の面積平均は打ち切り）
+
+float Lanczos2(float x)
+{
+    x = abs(x);
+    if (x < 1e-5f)
+        return 1.0f;
+    if (x >= 2.0f)
+        return 0.0f;
+    float px = PI * x;
+    return 2.0f * sin(px) * sin(px * 0.5f) / (px * px);
+}
+
+float4 LoadClamped(int2 pixel)
+{
+    pixel = clamp(pixel, int2(0, 0), int2(sourceWidth - 1, sourceHeight - 1));
+    return sourceTexture.Load(int3(pixel, 0));
+}
+
+// 出力ピクセルが覆うソース矩形 [srcMin, srcMax) を被覆面積で重み付け平均
+float4 SampleArea(float2 srcMin, float2 srcMax)
+{
+    int2 first = int2(floor(srcMin));
+    int2 last = min(int2(ceil(srcMax)) - 1, first + kMaxTaps - 1);
+    float4 sum = 0.0f;
+    float weightSum = 0.0f;
+    [loop]
+    for (int y = first.y; y <= last.y; ++y)
+    {
+        float wy = min(srcMax.y, y + 1.0f) - max(srcMin.y, (float)y);
+        [loop]
+        for (int x = first.x; x <= last.x; ++x)
+        {
+            float wx = min(srcMax.x, x + 1.0f) - max(srcMin.x, (float)x);
+            float w = wx * wy;
+            sum += LoadClamped(int2(x, y)) * w;
+            weightSum += w;
+        }
+    }
+    return sum / max(weightSum, 1e-6f);
+}
+
+// 縮小時はカーネル幅を縮小率だけ広げてアンチエイリアスする
+float4 SampleLanczos(float2 center, float2 scale)
+{
+    float2 stretch = max(scale, 1.0f);
+    float2 support = 2.0f * stretch;
+    int2 first = int2(floor(center - support));
+    int2 last = min(int2(ceil(center + support)), first + kMaxTaps - 1);
+    float4 sum = 0.0f;
+    float weightSum = 0.0f;
+    [loop]
+    for (int y = first.y; y <= last.y; ++y)
+    {
+        float wy = Lanczos2((y + 0.5f - center.y) / stretch.y);
+        [loop]
+        for (int x = first.x; x <= last.x; ++x)
+        {
+            float w = Lanczos2((x + 0.5f - center.x) / stretch.x) * wy;
+            sum += LoadClamped(int2(x, y)) * w;
+            weightSum += w;
+        }
+    }
+    return saturate(sum / max(weightSum, 1e-6f));
+}
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 id : SV_DispatchThreadID)
+{
+    [loop]
+    for (uint i = 0; i < outputCount; ++i)
+    {
+        uint4 rect = outputRects[i];
+        if (id.x < rect.x || id.y < rect.y || id.x >= rect.x + rect.z || id.y >= rect.y + rect.w)
+            continue;
+
+        float2 outputSize = float2(rect.zw);
+        float2 local = float2(id.xy - rect.xy) + 0.5f;
+        float2 scale = float2(sourceWidth, sourceHeight) / outputSize;
+
+        float4 color;
+        if (filterMode == 1)
+            color = SampleArea((local - 0.5f) * scale, (local + 0.5f) * scale);
+        else if (filterMode == 2)
+            color = SampleLanczos(local * scale, scale);
+        else
+            color = sourceTexture.SampleLevel(linearSampler, local / outputSize, 0);
+
+        // アトラスは R8G8B8A8 のため、メモリ上のバイト順が BGRA になるよう入れ替えて書く
+        outputAtlas[id.xy] = color.bgra;
+        return;
+    }
+}
@@ -0,0 +1,160 @@
+﻿#include "pch.h"
+
+SessionRegistry& SessionRegistry::Instance()
+{
+    static SessionRegistry instance;
+    return instance;
+}
+
+std::shared_ptr<WindowsCaptureSession> SessionRegistry::Find(int sessionId) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end() || !it->second || it->second->IsClosing())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::shared_ptr<WindowsCaptureSession> SessionRegistry::FindByWindow(HWND hwnd, int* sessionId) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto cacheIt = m_windowToSession.find(hwnd);
+    if (cacheIt == m_windowToSession.end())
+    {
+        return nullptr;
+    }
+
+    auto sessionIt = m_sessions.find(cacheIt->second);
+    if (sessionIt == m_sessions.end() || !sessionIt->second || !sessionIt->second->IsValid())
+    {
+        return nullptr;
+    }
+
+    if (sessionId) *sessionId = cacheIt->second;
+    return sessionIt->second;
+}
+
+int SessionRegistry::Add(const std::shared_ptr<WindowsCaptureSession>& session)
+{
+    HWND hwnd = session->GetWindowHandle();
+    int sessionId = session->GetSessionId();
+
+    std::shared_ptr<WindowsCaptureSession> stale;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+        // 領域セッションは再利用の対象外
+        if (!hwnd)
+        {
+            m_sessions[sessionId] = session;
+            return sessionId;
+        }
+
+        // 初期化中に同じウィンドウのセッションが登録されていれば、有効な方を優先する
+        auto cacheIt = m_windowToSession.find(hwnd);
+        if (cacheIt != m_windowToSession.end())
+        {
+            auto sessionIt = m_sessions.find(cacheIt->second);
+            if (sessionIt != m_sessions.end() && sessionIt->second && sessionIt->second->IsValid())
+            {
+                return cacheIt->second;
+            }
+
+            // 無効なセッション - 一覧から外す（破棄はロック外）
+            if (sessionIt != m_sessions.end())
+            {
+                stale = std::move(sessionIt->second);
+                m_sessions.erase(sessionIt);
+            }
+        }
+
+        m_windowToSession[hwnd] = sessionId;
+        m_sessions[sessionId] = session;
+    }
+
+    if (stale)
+    {
+        stale->Close();
+    }
+    return sessionId;
+}
+
+std::shared_ptr<WindowsCaptureSession> SessionRegistry::Remove(int sessionId)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto sessionIt = m_sessions.find(sessionId);
+    if (sessionIt == m_sessions.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<WindowsCaptureSession> session = std::move(sessionIt->second);
+    m_sessions.erase(sessionIt);
+
+    // [Issue #324] キャッシュが同じセッションを指している場合のみ削除
+    if (session && session->GetWindowHandle())
+    {
+        auto cacheIt = m_windowToSession.find(session->GetWindowHandle());
+        if (cacheIt != m_windowToSession.end() && cacheIt->second == sessionId)
+        {
+            m_windowToSession.erase(cacheIt);
+        }
+    }
+    return session;
+}
+
+std::vector<std::shared_ptr<WindowsCaptureSession>> SessionRegistry::RemoveAll()
+{
+    std::vector<std::shared_ptr<WindowsCaptureSession>> sessions;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    sessions.reserve(m_sessions.size());
+    for (auto& entry : m_sessions)
+    {
+        sessions.push_back(std::move(entry.second));
+    }
+    m_sessions.clear();
+    m_windowToSession.clear();
+    m_monitorSources.clear();
+    return sessions;
+}
+
+void SessionRegistry::Abandon()
+{
+    // 終了済みスレッドがロックを保持したままの可能性があるため、ロックは取らない
+    new std::unordered_map<int, std::shared_ptr<WindowsCaptureSession>>(std::move(m_sessions));
+    m_sessions.clear();
+    m_windowToSession.clear();
+    m_monitorSources.clear();
+}
+
+std::shared_ptr<WindowsCaptureSession> SessionRegistry::FindMonitorSource(HMONITOR monitor) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_monitorSources.find(monitor);
+    if (it == m_monitorSources.end())
+    {
+        return nullptr;
+    }
+
+    auto source = it->second.lock();
+    return (source && source->IsValid()) ? source : nullptr;
+}
+
+std::shared_ptr<WindowsCaptureSession> SessionRegistry::AddMonitorSource(const std::shared_ptr<WindowsCaptureSession>& source)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    // 初期化中に同じモニターのフレームソースが登録されていれば、有効な方を優先する
+    auto& entry = m_monitorSources[source->GetMonitorHandle()];
+    auto existing = entry.lock();
+    if (existing && existing->IsValid())
+    {
+        return existing;
+    }
+
+    entry = source;
+    return source;
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+/// <summary>
+/// キャプチャセッションのプロセス共通テーブル
+/// 参照は共有ロックのみで行い、セッションは shared_ptr で貸し出すため
+/// 異なるウィンドウのキャプチャ同士が直列化されない。
+/// ReleaseSession で一覧から外された後も、実行中のキャプチャが参照を保持している間はセッションは破棄されない。
+/// </summary>
+class SessionRegistry
+{
+public:
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static SessionRegistry& Instance();
+
+    /// <summary>
+    /// 次のセッション ID を払い出す
+    /// </summary>
+    int NextSessionId() { return m_nextSessionId.fetch_add(1); }
+
+    /// <summary>
+    /// セッションを取得（共有ロック）
+    /// </summary>
+    /// <param name="sessionId">セッション ID</param>
+    /// <returns>セッション、見つからない・クローズ中の場合は nullptr</returns>
+    std::shared_ptr<WindowsCaptureSession> Find(int sessionId) const;
+
+    /// <summary>
+    /// [Issue #324] ウィンドウに対応する有効なセッションを取得（共有ロック）
+    /// </summary>
+    /// <param name="hwnd">ウィンドウハンドル</param>
+    /// <param name="sessionId">セッション ID（出力）</param>
+    /// <returns>有効なセッション、無い場合は nullptr</returns>
+    std::shared_ptr<WindowsCaptureSession> FindByWindow(HWND hwnd, int* sessionId) const;
+
+    /// <summary>
+    /// 初期化済みのセッションを登録する
+    /// 同じウィンドウの有効なセッションが他スレッドにより先に登録されていた場合は登録せず、既存の ID を返す
+    /// ウィンドウを持たない領域セッションは常に新しい ID で登録する
+    /// </summary>
+    /// <param name="session">登録するセッション</param>
+    /// <returns>ウィンドウに対応付けられたセッション ID</returns>
+    int Add(const std::shared_ptr<WindowsCaptureSession>& session);
+
+    /// <summary>
+    /// セッションを一覧から外す（クローズは呼び出し側がロック外で行う）
+    /// </summary>
+    /// <param name="sessionId">セッション ID</param>
+    /// <returns>外したセッション、見つからない場合は nullptr</returns>
+    std::shared_ptr<WindowsCaptureSession> Remove(int sessionId);
+
+    /// <summary>
+    /// 全セッションを一覧から外す
+    /// </summary>
+    /// <returns>外したセッション</returns>
+    std::vector<std::shared_ptr<WindowsCaptureSession>> RemoveAll();
+
+    /// <summary>
+    /// 全セッションをクローズせずに手放す（プロセス終了時の DLL_PROCESS_DETACH 用）
+    /// 他のスレッドは終了済みのためロックを取らず、静的デストラクタでクローズされないよう一覧ごとリークさせる
+    /// </summary>
+    void Abandon();
+
+    /// <summary>
+    /// モニターの有効なフレームソースを取得（共有ロック）
+    /// フレームソースは参照している領域セッションが全て破棄された時点で破棄される
+    /// </summary>
+    /// <param name="monitor">モニターハンドル</param>
+    /// <returns>フレームソース、無い場合は nullptr</returns>
+    std::shared_ptr<WindowsCaptureSession> FindMonitorSource(HMONITOR monitor) const;
+
+    /// <summary>
+    /// 初期化済みのフレームソースを登録する
+    /// 同じモニターの有効なフレームソースが他スレッドにより先に登録されていた場合はそちらを返す
+    /// </summary>
+    /// <param name="source">登録するフレームソース</param>
+    /// <returns>モニターに対応付けられたフレームソース</returns>
+    std::shared_ptr<WindowsCaptureSession> AddMonitorSource(const std::shared_ptr<WindowsCaptureSession>& source);
+
+private:
+    SessionRegistry() = default;
+    SessionRegistry(const SessionRegistry&) = delete;
+    SessionRegistry& operator=(const SessionRegistry&) = delete;
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<int, std::shared_ptr<WindowsCaptureSession>> m_sessions;
+    std::unordered_map<HWND, int> m_windowToSession;  // [Issue #324] HWND → SessionID（セッション再利用）
+    std::unordered_map<HMONITOR, std::weak_ptr<WindowsCaptureSession>> m_monitorSources;  // モニター → 共有フレームソース
+    std::atomic<int> m_nextSessionId{ 1 };
+};
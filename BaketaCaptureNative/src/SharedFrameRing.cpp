@@ -0,0 +1,153 @@
+﻿#include "pch.h"
+
+namespace
+{
+    constexpr size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // 共有メモリ上の seqlock カウンタ（8 バイト境界に配置済み）
+    std::atomic_ref<long long> SlotSeq(BaketaCaptureRingSlot* slot)
+    {
+        return std::atomic_ref<long long>(slot->seq);
+    }
+}
+
+static_assert(sizeof(BaketaCaptureRingHeader) <= SharedFrameRing::kAlignment, "Ring header must fit in one cache line");
+static_assert(sizeof(BaketaCaptureRingSlot) <= SharedFrameRing::kAlignment, "Slot header must fit in one cache line");
+
+std::unique_ptr<SharedFrameRing> SharedFrameRing::Create(const wchar_t* name, int slotCount, size_t maxFrameBytes, HRESULT* hr)
+{
+    if (!name || !name[0] || slotCount < 2 || slotCount > kMaxSlotCount || maxFrameBytes == 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return nullptr;
+    }
+
+    size_t slotStride = kAlignment + AlignUp(maxFrameBytes, kAlignment);
+    unsigned long long totalBytes = static_cast<unsigned long long>(kAlignment) + static_cast<unsigned long long>(slotStride) * slotCount;
+    if (slotStride > UINT_MAX)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedFrameRing> ring(new SharedFrameRing());
+    ring->m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(totalBytes >> 32), static_cast<DWORD>(totalBytes & 0xFFFFFFFFull), name);
+    if (!ring->m_mapping)
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(::GetLastError());
+        return nullptr;
+    }
+
+    // 既存のマッピングはサイズ・レイアウトが一致する保証がないため使わない
+    if (::GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS);
+        return nullptr;
+    }
+
+    ring->m_view = MapViewOfFile(ring->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!ring->m_view)
+    {
+        if (hr) *hr = HRESULT_FROM_WIN32(::GetLastError());
+        return nullptr;
+    }
+
+    ring->m_slotCount = slotCount;
+    ring->m_slotStride = slotStride;
+    ring->m_maxFrameBytes = maxFrameBytes;
+
+    // 新規マッピングはゼロ初期化済み（全スロット seq = 0、frameId = 0）
+    BaketaCaptureRingHeader* header = ring->Header();
+    header->version = BAKETA_CAPTURE_RING_VERSION;
+    header->slotCount = static_cast<unsigned int>(slotCount);
+    header->slotStride = static_cast<unsigned int>(slotStride);
+    header->headerSize = static_cast<unsigned int>(kAlignment);
+    header->slotHeaderSize = static_cast<unsigned int>(kAlignment);
+    header->maxFrameBytes = static_cast<unsigned int>((std::min)(maxFrameBytes, static_cast<size_t>(UINT_MAX)));
+
+    // magic は最後に公開（消費側は magic を確認してからレイアウトを読む）
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = BAKETA_CAPTURE_RING_MAGIC;
+
+    if (hr) *hr = S_OK;
+    return ring;
+}
+
+SharedFrameRing::~SharedFrameRing()
+{
+    if (m_view)
+    {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+}
+
+BaketaCaptureRingSlot* SharedFrameRing::Slot(int index) const
+{
+    return reinterpret_cast<BaketaCaptureRingSlot*>(static_cast<unsigned char*>(m_view) + kAlignment + m_slotStride * static_cast<size_t>(index));
+}
+
+unsigned char* SharedFrameRing::BeginWrite(size_t* capacity)
+{
+    // フレームIDからスロットを決める（消費側も frameId % slotCount で同じスロットを引く）
+    m_writingSlot = static_cast<int>(m_nextFrameId % static_cast<unsigned long long>(m_slotCount));
+    BaketaCaptureRingSlot* slot = Slot(m_writingSlot);
+
+    // seqlock: 奇数にしてから書き込む（読み出し側は前後で値が変わった・奇数の場合に破棄する）
+    auto seq = SlotSeq(slot);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    *capacity = m_maxFrameBytes;
+    return reinterpret_cast<unsigned char*>(slot) + kAlignment;
+}
+
+unsigned long long SharedFrameRing::EndWrite(const BaketaCaptureFrame& frame, bool succeeded)
+{
+    if (m_writingSlot < 0)
+    {
+        return 0;
+    }
+
+    BaketaCaptureRingSlot* slot = Slot(m_writingSlot);
+    unsigned long long frameId = 0;
+    if (succeeded)
+    {
+        frameId = m_nextFrameId++;
+        slot->frameId = frameId;
+        slot->sequence = frame.sequence;
+        slot->timestamp = frame.timestamp;
+        slot->width = frame.width;
+        slot->height = frame.height;
+        slot->stride = frame.stride;
+        slot->format = BAKETA_CAPTURE_FORMAT_BGRA32;
+        slot->dataSize = frame.stride * frame.height;
+        slot->originalWidth = frame.originalWidth;
+        slot->originalHeight = frame.originalHeight;
+    }
+    else
+    {
+        // 途中まで書き込まれた可能性があるため、どのフレームIDにも一致させない
+        slot->frameId = 0;
+        slot->dataSize = 0;
+    }
+
+    auto seq = SlotSeq(slot);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    m_writingSlot = -1;
+
+    if (succeeded)
+    {
+        std::atomic_ref<long long>(Header()->latestFrameId).store(static_cast<long long>(frameId), std::memory_order_release);
+    }
+    return frameId;
+}
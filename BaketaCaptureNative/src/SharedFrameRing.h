@@ -0,0 +1,65 @@
+﻿#pragma once
+
+/// <summary>
+/// プロセス外の消費側（grpc_server 等）へフレームを渡す名前付き共有メモリのリング
+/// CreateFileMapping で固定長スロット（BaketaCaptureRingSlot ヘッダー + ピクセルデータ）を確保し、
+/// キャプチャ結果をスロットへ直接書き込む。消費側はマッピングを開いてフレームIDのスロットをそのまま参照し、
+/// gRPC ではフレームIDのみを送る。スロットごとの seqlock（奇数 = 書き込み中）で読み出し中の上書きを検出する。
+/// 書き込み側は1つ（呼び出し側で直列化すること）。
+/// </summary>
+class SharedFrameRing
+{
+public:
+    /// <summary>
+    /// スロット数の上限
+    /// </summary>
+    static constexpr int kMaxSlotCount = 64;
+
+    /// <summary>
+    /// ヘッダー・ピクセルデータのアライメント
+    /// </summary>
+    static constexpr size_t kAlignment = 64;
+
+    /// <summary>
+    /// 名前付き共有メモリを作成してリングを初期化
+    /// </summary>
+    /// <param name="name">マッピング名（例: Local\BaketaFrames）</param>
+    /// <param name="slotCount">スロット数（2〜kMaxSlotCount）</param>
+    /// <param name="maxFrameBytes">1 フレームの最大バイト数</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可、同名のマッピングが既に存在する場合は HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS)）</param>
+    /// <returns>リング、失敗時は nullptr</returns>
+    static std::unique_ptr<SharedFrameRing> Create(const wchar_t* name, int slotCount, size_t maxFrameBytes, HRESULT* hr = nullptr);
+
+    ~SharedFrameRing();
+    SharedFrameRing(const SharedFrameRing&) = delete;
+    SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+    /// <summary>
+    /// 次のスロット（最も古いフレーム）を書き込み中にしてピクセルデータ領域を返す
+    /// </summary>
+    /// <param name="capacity">データ領域のバイト数（出力）</param>
+    /// <returns>データ領域の先頭</returns>
+    unsigned char* BeginWrite(size_t* capacity);
+
+    /// <summary>
+    /// 書き込み中のスロットを確定する（失敗時はスロットを無効化する）
+    /// </summary>
+    /// <param name="frame">書き込んだフレームの情報（成功時のみ参照）</param>
+    /// <param name="succeeded">書き込みに成功した場合は true</param>
+    /// <returns>割り当てたフレームID（失敗時は 0）</returns>
+    unsigned long long EndWrite(const BaketaCaptureFrame& frame, bool succeeded);
+
+private:
+    SharedFrameRing() = default;
+
+    BaketaCaptureRingHeader* Header() const { return static_cast<BaketaCaptureRingHeader*>(m_view); }
+    BaketaCaptureRingSlot* Slot(int index) const;
+
+    HANDLE m_mapping = nullptr;
+    void* m_view = nullptr;
+    int m_slotCount = 0;
+    size_t m_slotStride = 0;
+    size_t m_maxFrameBytes = 0;
+    unsigned long long m_nextFrameId = 1;  // 0 は「フレームなし」
+    int m_writingSlot = -1;
+};
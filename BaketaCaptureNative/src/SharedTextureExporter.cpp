@@ -0,0 +1,166 @@
+﻿#include "pch.h"
+
+int SharedTextureExporter::Publish(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+    UINT width, UINT height, unsigned long long sequence, HRESULT* hr)
+{
+    if (!device || !context || !source || width == 0 || height == 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return -1;
+    }
+
+    if (!EnsureSlots(device, width, height, hr))
+    {
+        return -1;
+    }
+
+    int slotIndex = AcquireSlot(hr);
+    if (slotIndex < 0)
+    {
+        return -1;
+    }
+
+    Slot& slot = m_slots[slotIndex];
+
+    // フレームプールのテクスチャは出力より大きい場合があるため左上領域のみコピー
+    D3D11_TEXTURE2D_DESC srcDesc;
+    source->GetDesc(&srcDesc);
+    if (srcDesc.Width == width && srcDesc.Height == height)
+    {
+        context->CopyResource(slot.texture.Get(), source);
+    }
+    else
+    {
+        D3D11_BOX box = { 0, 0, 0, width, height, 1 };
+        context->CopySubresourceRegion(slot.texture.Get(), 0, 0, 0, 0, source, 0, &box);
+    }
+
+    // 消費側のキーで解放し、別デバイスから見えるようコマンドを送出（完了待ちはキー付きミューテックスが行う）
+    HRESULT result = slot.keyedMutex->ReleaseSync(kConsumerKey);
+    context->Flush();
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return -1;
+    }
+
+    slot.sequence = sequence;
+    if (hr) *hr = S_OK;
+    return slotIndex;
+}
+
+int SharedTextureExporter::AcquireSlot(HRESULT* hr)
+{
+    // 古いフレームのスロットから順に試す（未使用スロットは sequence = 0 で先頭になる）
+    std::array<int, kSlotCount> order;
+    for (int i = 0; i < kSlotCount; ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return m_slots[a].sequence < m_slots[b].sequence; });
+
+    // 1. 消費側が返却済み（キー = kProducerKey）のスロット
+    // 2. 消費側がまだ取得していない（キー = kConsumerKey のまま）スロットを新しいフレームで上書き
+    // WAIT_ABANDONED は消費側デバイスが保持したまま解放された場合で、所有権は取得できている
+    for (UINT64 key : { kProducerKey, kConsumerKey })
+    {
+        for (int slotIndex : order)
+        {
+            HRESULT result = m_slots[slotIndex].keyedMutex->AcquireSync(key, 0);
+            if (result == S_OK || result == static_cast<HRESULT>(WAIT_ABANDONED))
+            {
+                return slotIndex;
+            }
+            if (FAILED(result))
+            {
+                if (hr) *hr = result;
+                return -1;
+            }
+        }
+    }
+
+    // 全スロットを消費側が保持中（WAIT_TIMEOUT）
+    if (hr) *hr = DXGI_ERROR_WAS_STILL_DRAWING;
+    return -1;
+}
+
+bool SharedTextureExporter::EnsureSlots(ID3D11Device* device, UINT width, UINT height, HRESULT* hr)
+{
+    // 消費側は開いたテクスチャを保持するため、サイズが変わった場合のみ作り直す
+    if (m_slots[0].texture && width == m_width && height == m_height)
+    {
+        return true;
+    }
+
+    Reset();
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_NTHANDLE | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+    for (auto& slot : m_slots)
+    {
+        ComPtr<IDXGIResource1> dxgiResource;
+        HRESULT result = device->CreateTexture2D(&desc, nullptr, &slot.texture);
+        if (SUCCEEDED(result))
+        {
+            result = slot.texture.As(&slot.keyedMutex);
+        }
+        if (SUCCEEDED(result))
+        {
+            result = slot.texture.As(&dxgiResource);
+        }
+        if (SUCCEEDED(result))
+        {
+            result = dxgiResource->CreateSharedHandle(nullptr, DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+                nullptr, &slot.sharedHandle);
+        }
+
+        if (FAILED(result))
+        {
+            if (hr) *hr = result;
+            Reset();
+            return false;
+        }
+    }
+
+    m_width = width;
+    m_height = height;
+    ++m_generation;
+    return true;
+}
+
+HANDLE SharedTextureExporter::GetSharedHandle(int slot) const
+{
+    if (slot < 0 || slot >= kSlotCount)
+    {
+        return nullptr;
+    }
+    return m_slots[slot].sharedHandle;
+}
+
+void SharedTextureExporter::Reset()
+{
+    for (auto& slot : m_slots)
+    {
+        if (slot.sharedHandle)
+        {
+            // 消費側が開いたテクスチャはそれぞれの参照で生存し続ける
+            CloseHandle(slot.sharedHandle);
+            slot.sharedHandle = nullptr;
+        }
+        slot.keyedMutex.Reset();
+        slot.texture.Reset();
+        slot.sequence = 0;
+    }
+    m_width = 0;
+    m_height = 0;
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+/// <summary>
+/// GPU 上の消費側（D3D12 / DirectML 推論等）へフレームをコピーなしで渡す共有テクスチャのプール
+/// D3D11_RESOURCE_MISC_SHARED_NTHANDLE | SHARED_KEYEDMUTEX のテクスチャへ最新フレームをコピーし、
+/// NT ハンドルを渡すことで、ステージング経由の CPU 読み出しと消費側での再アップロードを省く。
+/// キー付きミューテックスは kProducerKey（このプールが書き込み可能）と kConsumerKey（消費側が読み出し可能）の2値で受け渡す。
+/// </summary>
+class SharedTextureExporter
+{
+public:
+    /// <summary>
+    /// プールのスロット数（消費側が 1 枚保持している間も 2 枚で書き込みを続けられる）
+    /// </summary>
+    static constexpr int kSlotCount = 3;
+
+    /// <summary>
+    /// キー付きミューテックスのキー: プールが取得してコピーし、kConsumerKey で解放する
+    /// </summary>
+    static constexpr UINT64 kProducerKey = 0;
+
+    /// <summary>
+    /// キー付きミューテックスのキー: 消費側が取得して読み出し、kProducerKey で解放する
+    /// </summary>
+    static constexpr UINT64 kConsumerKey = 1;
+
+    SharedTextureExporter() = default;
+    ~SharedTextureExporter() { Reset(); }
+    SharedTextureExporter(const SharedTextureExporter&) = delete;
+    SharedTextureExporter& operator=(const SharedTextureExporter&) = delete;
+
+    /// <summary>
+    /// ソーステクスチャの左上 width x height 領域を空きスロットへコピーし、消費側へ解放する
+    /// 消費側が返却済みのスロットを優先し、無ければ消費側が取得していない最も古いスロットを上書きする
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">コピー元テクスチャ（B8G8R8A8_UNORM）</param>
+    /// <param name="width">コピー幅</param>
+    /// <param name="height">コピー高さ</param>
+    /// <param name="sequence">フレーム通し番号（スロットに記録）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>コピー先スロット番号、失敗時は -1（全スロットを消費側が保持中の場合は hr = DXGI_ERROR_WAS_STILL_DRAWING）</returns>
+    int Publish(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+        UINT width, UINT height, unsigned long long sequence, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// スロットの NT 共有ハンドル（プール所有、Reset までは同じ値）
+    /// </summary>
+    HANDLE GetSharedHandle(int slot) const;
+
+    /// <summary>
+    /// テクスチャを作り直すたびに増える世代番号（消費側は変化したらハンドルを開き直す）
+    /// </summary>
+    unsigned long long GetGeneration() const { return m_generation; }
+
+    /// <summary>
+    /// 全スロットを解放（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    struct Slot
+    {
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<IDXGIKeyedMutex> keyedMutex;
+        HANDLE sharedHandle = nullptr;       // CreateSharedHandle で作成した NT ハンドル
+        unsigned long long sequence = 0;     // 最後に書き込んだフレームの通し番号（0 は未使用）
+    };
+
+    bool EnsureSlots(ID3D11Device* device, UINT width, UINT height, HRESULT* hr);
+    int AcquireSlot(HRESULT* hr);
+
+    std::array<Slot, kSlotCount> m_slots;
+    UINT m_width = 0;
+    UINT m_height = 0;
+    unsigned long long m_generation = 0;
+};
@@ -0,0 +1,128 @@
+﻿#include "pch.h"
+
+bool StagingTextureCache::EnsureTexture(ID3D11Device* device, UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr)
+{
+    // 既存テクスチャで収まる場合は再利用（大幅に小さくなった場合のみ作り直してメモリを返す）
+    bool fits = m_texture && format == m_format && width <= m_width && height <= m_height;
+    bool tooLarge = fits && (static_cast<unsigned long long>(width) * height * 4ULL
+        < static_cast<unsigned long long>(m_width) * m_height);
+    if (fits && !tooLarge)
+    {
+        return true;
+    }
+
+    Reset();
+
+    D3D11_TEXTURE2D_DESC stagingDesc = {};
+    stagingDesc.Width = width;
+    stagingDesc.Height = height;
+    stagingDesc.MipLevels = 1;
+    stagingDesc.ArraySize = 1;
+    stagingDesc.Format = format;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    stagingDesc.SampleDesc.Count = 1;
+    stagingDesc.SampleDesc.Quality = 0;
+
+    HRESULT result = device->CreateTexture2D(&stagingDesc, nullptr, &m_texture);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        Reset();
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_format = format;
+    return true;
+}
+
+bool StagingTextureCache::Copy(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+    UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr)
+{
+    if (!device || !context || !source || width == 0 || height == 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!EnsureTexture(device, width, height, format, hr))
+    {
+        return false;
+    }
+
+    // 同一サイズならCopyResource、キャッシュの方が大きい場合は左上領域のみコピー
+    D3D11_TEXTURE2D_DESC srcDesc;
+    source->GetDesc(&srcDesc);
+    if (srcDesc.Width == m_width && srcDesc.Height == m_height)
+    {
+        context->CopyResource(m_texture.Get(), source);
+    }
+    else
+    {
+        D3D11_BOX box = { 0, 0, 0, width, height, 1 };
+        context->CopySubresourceRegion(m_texture.Get(), 0, 0, 0, 0, source, 0, &box);
+    }
+
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+bool StagingTextureCache::CopyRegions(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+    UINT width, UINT height, DXGI_FORMAT format, const RECT* rects, int rectCount, HRESULT* hr)
+{
+    if (!device || !context || !source || width == 0 || height == 0 || !rects || rectCount <= 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!EnsureTexture(device, width, height, format, hr))
+    {
+        return false;
+    }
+
+    // 矩形ごとに同じ座標へコピー（変化のない領域は転送しない）
+    for (int i = 0; i < rectCount; ++i)
+    {
+        const RECT& rect = rects[i];
+        D3D11_BOX box = {
+            static_cast<UINT>(rect.left), static_cast<UINT>(rect.top), 0,
+            static_cast<UINT>(rect.right), static_cast<UINT>(rect.bottom), 1
+        };
+        context->CopySubresourceRegion(m_texture.Get(), 0, box.left, box.top, 0, source, 0, &box);
+    }
+
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+HRESULT StagingTextureCache::Map(ID3D11DeviceContext* context, D3D11_MAPPED_SUBRESOURCE* mapped)
+{
+    if (!context || !m_texture || !mapped)
+    {
+        return E_INVALIDARG;
+    }
+
+    // フラグなしの Map はコマンドを送出してコピー完了まで待機する
+    return context->Map(m_texture.Get(), 0, D3D11_MAP_READ, 0, mapped);
+}
+
+void StagingTextureCache::Unmap(ID3D11DeviceContext* context)
+{
+    if (!context || !m_texture)
+    {
+        return;
+    }
+
+    context->Unmap(m_texture.Get(), 0);
+}
+
+void StagingTextureCache::Reset()
+{
+    m_texture.Reset();
+    m_width = 0;
+    m_height = 0;
+    m_format = DXGI_FORMAT_UNKNOWN;
+}
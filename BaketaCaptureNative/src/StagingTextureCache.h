@@ -0,0 +1,64 @@
+﻿#pragma once
+
+/// <summary>
+/// CPU 読み取り用ステージングテクスチャのキャッシュ
+/// 毎フレームの CreateTexture2D を廃止し、サイズ・フォーマットが変わらない限り同じテクスチャを再利用する。
+/// 読み出しはコピー直後にマップする同期処理のため、テクスチャは 1 枚とし Map のブロッキング待機に任せる。
+/// </summary>
+class StagingTextureCache
+{
+public:
+    StagingTextureCache() = default;
+    StagingTextureCache(const StagingTextureCache&) = delete;
+    StagingTextureCache& operator=(const StagingTextureCache&) = delete;
+
+    /// <summary>
+    /// ソーステクスチャの左上 width x height 領域をステージングテクスチャへコピー発行する（待機しない）
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">コピー元テクスチャ</param>
+    /// <param name="width">コピー幅</param>
+    /// <param name="height">コピー高さ</param>
+    /// <param name="format">ステージングテクスチャのフォーマット</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool Copy(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+        UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// ソーステクスチャの指定矩形のみをステージングテクスチャの同じ位置へコピー発行する（待機しない）
+    /// 矩形外の内容は前回コピーしたフレームのまま（テクスチャを作り直した直後は不定）
+    /// </summary>
+    /// <param name="rects">コピーする矩形（width x height 内にクランプ済みであること）</param>
+    /// <param name="rectCount">矩形数</param>
+    /// <returns>成功時は true</returns>
+    bool CopyRegions(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source,
+        UINT width, UINT height, DXGI_FORMAT format, const RECT* rects, int rectCount, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// コピー完了を待ってマップする（ドライバのブロッキング Map で待機し、CPU をスピンさせない）
+    /// </summary>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="mapped">マップ結果（出力）</param>
+    /// <returns>Map の HRESULT</returns>
+    HRESULT Map(ID3D11DeviceContext* context, D3D11_MAPPED_SUBRESOURCE* mapped);
+
+    /// <summary>
+    /// マップを解除する
+    /// </summary>
+    void Unmap(ID3D11DeviceContext* context);
+
+    /// <summary>
+    /// テクスチャを解放する（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    bool EnsureTexture(ID3D11Device* device, UINT width, UINT height, DXGI_FORMAT format, HRESULT* hr);
+
+    ComPtr<ID3D11Texture2D> m_texture;
+    UINT m_width = 0;
+    UINT m_height = 0;
+    DXGI_FORMAT m_format = DXGI_FORMAT_UNKNOWN;
+};
@@ -0,0 +1,175 @@
+﻿#include "pch.h"
+
+bool StagingTextureRing::EnsureSlot(ID3D11Device* device, Slot& slot, UINT width, UINT height, HRESULT* hr)
+{
+    // 既存テクスチャで収まる場合は再利用（大幅に小さくなった場合のみ作り直してメモリを返す）
+    bool fits = slot.texture && width <= slot.textureWidth && height <= slot.textureHeight;
+    bool tooLarge = fits && (static_cast<unsigned long long>(width) * height * 4ULL
+        < static_cast<unsigned long long>(slot.textureWidth) * slot.textureHeight);
+    if (fits && !tooLarge)
+    {
+        return true;
+    }
+
+    slot.texture.Reset();
+    slot.textureWidth = 0;
+    slot.textureHeight = 0;
+
+    D3D11_TEXTURE2D_DESC stagingDesc = {};
+    stagingDesc.Width = width;
+    stagingDesc.Height = height;
+    stagingDesc.MipLevels = 1;
+    stagingDesc.ArraySize = 1;
+    stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    stagingDesc.SampleDesc.Count = 1;
+    stagingDesc.SampleDesc.Quality = 0;
+
+    HRESULT result = device->CreateTexture2D(&stagingDesc, nullptr, &slot.texture);
+    if (SUCCEEDED(result) && !slot.copyDoneQuery)
+    {
+        D3D11_QUERY_DESC queryDesc = {};
+        queryDesc.Query = D3D11_QUERY_EVENT;
+        result = device->CreateQuery(&queryDesc, &slot.copyDoneQuery);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        slot.texture.Reset();
+        return false;
+    }
+
+    slot.textureWidth = width;
+    slot.textureHeight = height;
+    return true;
+}
+
+int StagingTextureRing::Issue(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source, const FrameTag& tag, HRESULT* hr)
+{
+    if (!device || !context || !source || tag.width <= 0 || tag.height <= 0)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return -1;
+    }
+
+    // 最も古いスロットを上書きする（読み出されなかったフレームは破棄される）
+    int slotIndex = m_nextSlot;
+    Slot& slot = m_slots[slotIndex];
+    slot.tag = {};
+    if (!EnsureSlot(device, slot, static_cast<UINT>(tag.width), static_cast<UINT>(tag.height), hr))
+    {
+        return -1;
+    }
+    m_nextSlot = (m_nextSlot + 1) % kSlotCount;
+
+    // 同一サイズならCopyResource、スロットの方が大きい場合は左上領域のみコピー
+    D3D11_TEXTURE2D_DESC srcDesc;
+    source->GetDesc(&srcDesc);
+    if (srcDesc.Width == slot.textureWidth && srcDesc.Height == slot.textureHeight)
+    {
+        context->CopyResource(slot.texture.Get(), source);
+    }
+    else
+    {
+        D3D11_BOX box = { 0, 0, 0, static_cast<UINT>(tag.width), static_cast<UINT>(tag.height), 1 };
+        context->CopySubresourceRegion(slot.texture.Get(), 0, 0, 0, 0, source, 0, &box);
+    }
+
+    // コピー完了をイベントクエリで通知させ、読み出しを待たずにコマンドを GPU へ送出
+    context->End(slot.copyDoneQuery.Get());
+    context->Flush();
+    slot.tag = tag;
+
+    if (hr) *hr = S_OK;
+    return slotIndex;
+}
+
+int StagingTextureRing::Find(unsigned long long sequence, int width, int height) const
+{
+    if (sequence == 0)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < kSlotCount; ++i)
+    {
+        const FrameTag& tag = m_slots[i].tag;
+        if (tag.sequence == sequence && tag.width == width && tag.height == height)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int StagingTextureRing::FindNewestReady(ID3D11DeviceContext* context, unsigned long long afterSequence, unsigned long long beforeSequence, const FrameTag& tag) const
+{
+    int newest = -1;
+    for (int i = 0; i < kSlotCount; ++i)
+    {
+        const FrameTag& slotTag = m_slots[i].tag;
+        if (slotTag.sequence == 0 || slotTag.sequence <= afterSequence || slotTag.sequence >= beforeSequence ||
+            slotTag.sourceWidth != tag.sourceWidth || slotTag.sourceHeight != tag.sourceHeight ||
+            slotTag.width != tag.width || slotTag.height != tag.height)
+        {
+            continue;
+        }
+        if ((newest < 0 || slotTag.sequence > m_slots[newest].tag.sequence) && IsReady(context, i))
+        {
+            newest = i;
+        }
+    }
+    return newest;
+}
+
+bool StagingTextureRing::IsReady(ID3D11DeviceContext* context, int slot) const
+{
+    if (slot < 0 || slot >= kSlotCount || !m_slots[slot].copyDoneQuery || m_slots[slot].tag.sequence == 0)
+    {
+        return false;
+    }
+
+    return context->GetData(m_slots[slot].copyDoneQuery.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+}
+
+HRESULT StagingTextureRing::Map(ID3D11DeviceContext* context, int slot, D3D11_MAPPED_SUBRESOURCE* mapped)
+{
+    if (!context || slot < 0 || slot >= kSlotCount || !m_slots[slot].texture || !mapped)
+    {
+        return E_INVALIDARG;
+    }
+
+    ID3D11Texture2D* texture = m_slots[slot].texture.Get();
+    HRESULT hr = context->Map(texture, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, mapped);
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+    {
+        // コピーが未完了の場合はドライバのブロッキング Map で待つ（CPU をスピンさせない）
+        hr = context->Map(texture, 0, D3D11_MAP_READ, 0, mapped);
+    }
+    return hr;
+}
+
+void StagingTextureRing::Unmap(ID3D11DeviceContext* context, int slot)
+{
+    if (!context || slot < 0 || slot >= kSlotCount || !m_slots[slot].texture)
+    {
+        return;
+    }
+
+    context->Unmap(m_slots[slot].texture.Get(), 0);
+}
+
+void StagingTextureRing::Reset()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.texture.Reset();
+        slot.copyDoneQuery.Reset();
+        slot.textureWidth = 0;
+        slot.textureHeight = 0;
+        slot.tag = {};
+    }
+    m_nextSlot = 0;
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+/// <summary>
+/// パイプライン読み出し用のステージングテクスチャのリング
+/// フレーム到着時にスロット N へコピーを発行しておき（イベントクエリで完了を検知）、読み出し側は
+/// コピー済みのスロットを待たずにマップする。スロットごとにフレームの通し番号とサイズを保持する。
+/// 全メソッドは呼び出し側の読み出しロック下で使用する（マップ中のスロットへは発行されない）
+/// </summary>
+class StagingTextureRing
+{
+public:
+    /// <summary>
+    /// リングのスロット数（到着中・マップ待ち・読み出し中の 3 フレーム）
+    /// </summary>
+    static constexpr int kSlotCount = 3;
+
+    /// <summary>
+    /// スロットにコピーしたフレームの情報
+    /// </summary>
+    struct FrameTag
+    {
+        unsigned long long sequence = 0;  // フレーム通し番号（0 は空きスロット）
+        long long timestamp = 0;          // 提示時刻（100ns単位）
+        int sourceWidth = 0;              // リサイズ前のフレームサイズ
+        int sourceHeight = 0;
+        int width = 0;                    // スロットにコピーしたサイズ
+        int height = 0;
+    };
+
+    StagingTextureRing() = default;
+    StagingTextureRing(const StagingTextureRing&) = delete;
+    StagingTextureRing& operator=(const StagingTextureRing&) = delete;
+
+    /// <summary>
+    /// ソーステクスチャの左上 tag.width x tag.height 領域を最も古いスロットへコピー発行し、GPU へ送出する（待機しない）
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="source">コピー元テクスチャ（BGRA）</param>
+    /// <param name="tag">コピーするフレームの情報</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>コピー先スロット番号、失敗時は -1</returns>
+    int Issue(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* source, const FrameTag& tag, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 指定フレームを同じ出力サイズでコピーしたスロットを探す
+    /// </summary>
+    /// <returns>スロット番号、無い場合は -1</returns>
+    int Find(unsigned long long sequence, int width, int height) const;
+
+    /// <summary>
+    /// afterSequence より新しく beforeSequence より古いフレームのうち、コピー完了済みで最も新しいスロットを探す（待機しない）
+    /// </summary>
+    /// <param name="tag">比較するサイズ（sourceWidth / sourceHeight / width / height）</param>
+    /// <returns>スロット番号、無い場合は -1</returns>
+    int FindNewestReady(ID3D11DeviceContext* context, unsigned long long afterSequence, unsigned long long beforeSequence, const FrameTag& tag) const;
+
+    /// <summary>
+    /// スロットのコピーが GPU 上で完了済みかを待機なしで確認する
+    /// </summary>
+    bool IsReady(ID3D11DeviceContext* context, int slot) const;
+
+    /// <summary>
+    /// スロットをマップする（完了済みは D3D11_MAP_FLAG_DO_NOT_WAIT で即時、未完了はブロッキング Map で待つ）
+    /// </summary>
+    /// <returns>Map の HRESULT</returns>
+    HRESULT Map(ID3D11DeviceContext* context, int slot, D3D11_MAPPED_SUBRESOURCE* mapped);
+
+    /// <summary>
+    /// スロットのマップを解除する
+    /// </summary>
+    void Unmap(ID3D11DeviceContext* context, int slot);
+
+    /// <summary>
+    /// スロットにコピーしたフレームの情報
+    /// </summary>
+    const FrameTag& GetTag(int slot) const { return m_slots[slot].tag; }
+
+    /// <summary>
+    /// 全スロットを解放する（デバイス喪失・セッション終了・パイプライン読み出しの無効化時）
+    /// </summary>
+    void Reset();
+
+private:
+    struct Slot
+    {
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11Query> copyDoneQuery;  // コピー完了検知用イベントクエリ
+        UINT textureWidth = 0;              // 確保済みテクスチャのサイズ（tag のサイズ以上）
+        UINT textureHeight = 0;
+        FrameTag tag;
+    };
+
+    bool EnsureSlot(ID3D11Device* device, Slot& slot, UINT width, UINT height, HRESULT* hr);
+
+    std::array<Slot, kSlotCount> m_slots;
+    int m_nextSlot = 0;
+};
@@ -0,0 +1,271 @@
+﻿#include "pch.h"
+
+// タイル差分検出コンピュートシェーダー（TileDiffShader.hlsl をビルド時にコンパイルしたバイトコード）
+#include "shaders/TileDiffCS.h"
+
+struct TileDiffParams
+{
+    UINT textureWidth;
+    UINT textureHeight;
+    UINT tileColumns;
+    float threshold;
+};
+
+bool TileChangeDetector::InitializeShader(ID3D11Device* device, HRESULT* hr)
+{
+    if (m_shaderInitialized)
+    {
+        return true;
+    }
+
+    // cs_5_0 はフィーチャーレベル 11_0 以上が必要
+    if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+    {
+        m_gpuSupported = false;
+        m_shaderInitialized = true;
+        return true;
+    }
+
+    HRESULT result = device->CreateComputeShader(g_TileDiffCS, sizeof(g_TileDiffCS), nullptr, &m_computeShader);
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(TileDiffParams);
+        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        result = device->CreateBuffer(&cbDesc, nullptr, &m_constantBuffer);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        m_computeShader.Reset();
+        m_constantBuffer.Reset();
+        return false;
+    }
+
+    m_shaderInitialized = true;
+    return true;
+}
+
+bool TileChangeDetector::EnsureResources(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& desc, HRESULT* hr)
+{
+    if (m_previousTexture && desc.Width == m_width && desc.Height == m_height && desc.Format == m_format)
+    {
+        return true;
+    }
+
+    m_previousTexture.Reset();
+    m_previousSrv.Reset();
+    m_resultBuffer.Reset();
+    m_resultUav.Reset();
+    m_resultStaging.Reset();
+    m_hasPrevious = false;
+
+    m_width = desc.Width;
+    m_height = desc.Height;
+    m_format = desc.Format;
+    m_tileColumns = static_cast<int>((desc.Width + kTileSize - 1) / kTileSize);
+    m_tileRows = static_cast<int>((desc.Height + kTileSize - 1) / kTileSize);
+    m_dirtyBitmap.assign((static_cast<size_t>(m_tileColumns) * m_tileRows + 31) / 32, 0);
+
+    if (!m_gpuSupported)
+    {
+        return true;
+    }
+
+    D3D11_TEXTURE2D_DESC prevDesc = {};
+    prevDesc.Width = desc.Width;
+    prevDesc.Height = desc.Height;
+    prevDesc.MipLevels = 1;
+    prevDesc.ArraySize = 1;
+    prevDesc.Format = desc.Format;
+    prevDesc.SampleDesc.Count = 1;
+    prevDesc.Usage = D3D11_USAGE_DEFAULT;
+    prevDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    HRESULT result = device->CreateTexture2D(&prevDesc, nullptr, &m_previousTexture);
+    if (SUCCEEDED(result))
+    {
+        result = device->CreateShaderResourceView(m_previousTexture.Get(), nullptr, &m_previousSrv);
+    }
+
+    UINT elementCount = static_cast<UINT>(1 + m_dirtyBitmap.size());
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.ByteWidth = elementCount * sizeof(UINT);
+        bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+        bufferDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+        bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bufferDesc.StructureByteStride = sizeof(UINT);
+        result = device->CreateBuffer(&bufferDesc, nullptr, &m_resultBuffer);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.NumElements = elementCount;
+        result = device->CreateUnorderedAccessView(m_resultBuffer.Get(), &uavDesc, &m_resultUav);
+    }
+
+    if (SUCCEEDED(result))
+    {
+        D3D11_BUFFER_DESC stagingDesc = {};
+        stagingDesc.ByteWidth = elementCount * sizeof(UINT);
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        stagingDesc.StructureByteStride = sizeof(UINT);
+        result = device->CreateBuffer(&stagingDesc, nullptr, &m_resultStaging);
+    }
+
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        Reset();
+        return false;
+    }
+
+    return true;
+}
+
+void TileChangeDetector::MarkAllDirty()
+{
+    size_t tileCount = static_cast<size_t>(m_tileColumns) * m_tileRows;
+    std::fill(m_dirtyBitmap.begin(), m_dirtyBitmap.end(), 0xFFFFFFFFu);
+    if (tileCount % 32 != 0 && !m_dirtyBitmap.empty())
+    {
+        m_dirtyBitmap.back() = (1u << (tileCount % 32)) - 1;
+    }
+    m_dirtyTileCount = static_cast<int>(tileCount);
+}
+
+bool TileChangeDetector::Detect(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* texture, int threshold, HRESULT* hr)
+{
+    if (!device || !context || !texture)
+    {
+        if (hr) *hr = E_INVALIDARG;
+        return false;
+    }
+
+    if (!InitializeShader(device, hr))
+    {
+        return false;
+    }
+
+    // 共有コンテキスト上でシェーダー・ビューの設定からディスパッチまでを他セッションと混在させない
+    D3DContextLock contextLock(context);
+
+    D3D11_TEXTURE2D_DESC desc;
+    texture->GetDesc(&desc);
+    if (!EnsureResources(device, desc, hr))
+    {
+        return false;
+    }
+
+    // 比較対象がない場合は全タイル変化あり
+    if (!m_gpuSupported || !m_hasPrevious)
+    {
+        MarkAllDirty();
+        return true;
+    }
+
+    ComPtr<ID3D11ShaderResourceView> currentSrv;
+    HRESULT result = device->CreateShaderResourceView(texture, nullptr, &currentSrv);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedCb;
+    result = context->Map(m_constantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedCb);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+    auto* params = static_cast<TileDiffParams*>(mappedCb.pData);
+    params->textureWidth = desc.Width;
+    params->textureHeight = desc.Height;
+    params->tileColumns = static_cast<UINT>(m_tileColumns);
+    params->threshold = static_cast<float>((std::max)(0, (std::min)(threshold, 765)));
+    context->Unmap(m_constantBuffer.Get(), 0);
+
+    const UINT clearValues[4] = { 0, 0, 0, 0 };
+    context->ClearUnorderedAccessViewUint(m_resultUav.Get(), clearValues);
+
+    ID3D11ShaderResourceView* srvs[2] = { currentSrv.Get(), m_previousSrv.Get() };
+    ID3D11UnorderedAccessView* uavs[1] = { m_resultUav.Get() };
+    ID3D11Buffer* cbs[1] = { m_constantBuffer.Get() };
+    context->CSSetShader(m_computeShader.Get(), nullptr, 0);
+    context->CSSetShaderResources(0, 2, srvs);
+    context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+    context->CSSetConstantBuffers(0, 1, cbs);
+    context->Dispatch(static_cast<UINT>(m_tileColumns), static_cast<UINT>(m_tileRows), 1);
+
+    // 後続のパスと競合しないようバインドを解除
+    ID3D11ShaderResourceView* nullSrvs[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* nullUavs[1] = { nullptr };
+    context->CSSetShaderResources(0, 2, nullSrvs);
+    context->CSSetUnorderedAccessViews(0, 1, nullUavs, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    // 結果（数 KB）のみ読み戻す
+    context->CopyResource(m_resultStaging.Get(), m_resultBuffer.Get());
+    D3D11_MAPPED_SUBRESOURCE mappedResult;
+    result = context->Map(m_resultStaging.Get(), 0, D3D11_MAP_READ, 0, &mappedResult);
+    if (FAILED(result))
+    {
+        if (hr) *hr = result;
+        return false;
+    }
+
+    const auto* words = static_cast<const unsigned int*>(mappedResult.pData);
+    m_dirtyTileCount = static_cast<int>(words[0]);
+    std::copy(words + 1, words + 1 + m_dirtyBitmap.size(), m_dirtyBitmap.begin());
+    context->Unmap(m_resultStaging.Get(), 0);
+
+    if (hr) *hr = S_OK;
+    return true;
+}
+
+void TileChangeDetector::Commit(ID3D11DeviceContext* context, ID3D11Texture2D* texture)
+{
+    if (!m_gpuSupported || !m_previousTexture || !context || !texture)
+    {
+        return;
+    }
+
+    D3D11_TEXTURE2D_DESC desc;
+    texture->GetDesc(&desc);
+    if (desc.Width != m_width || desc.Height != m_height || desc.Format != m_format)
+    {
+        return;
+    }
+
+    context->CopyResource(m_previousTexture.Get(), texture);
+    m_hasPrevious = true;
+}
+
+void TileChangeDetector::Reset()
+{
+    m_previousTexture.Reset();
+    m_previousSrv.Reset();
+    m_resultBuffer.Reset();
+    m_resultUav.Reset();
+    m_resultStaging.Reset();
+    m_hasPrevious = false;
+    m_width = 0;
+    m_height = 0;
+    m_format = DXGI_FORMAT_UNKNOWN;
+    m_tileColumns = 0;
+    m_tileRows = 0;
+    m_dirtyTileCount = 0;
+    m_dirtyBitmap.clear();
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+/// <summary>
+/// GPU 上でのフレーム変化検出（32x32 タイル単位）
+/// 新しい WGC テクスチャと前回読み出したフレームをコンピュートシェーダーで比較し、
+/// 変化したタイルのビットマップだけを読み戻す（数 KB）。
+/// 変化がなければフレーム本体のステージングコピー・Map を丸ごと省略できる。
+/// </summary>
+class TileChangeDetector
+{
+public:
+    /// <summary>
+    /// タイル一辺のピクセル数
+    /// </summary>
+    static constexpr int kTileSize = 32;
+
+    TileChangeDetector() = default;
+    TileChangeDetector(const TileChangeDetector&) = delete;
+    TileChangeDetector& operator=(const TileChangeDetector&) = delete;
+
+    /// <summary>
+    /// 前回コミットしたフレームとの差分を検出
+    /// 比較対象がない（初回・サイズ変更後）場合は全タイルを変化ありとする
+    /// </summary>
+    /// <param name="device">D3D11 デバイス</param>
+    /// <param name="context">デバイスコンテキスト</param>
+    /// <param name="texture">現在のフレームテクスチャ</param>
+    /// <param name="threshold">ピクセル変化とみなす B+G+R 差分絶対値の合計（0〜765、0 で任意の変化）</param>
+    /// <param name="hr">失敗時の HRESULT（出力・省略可）</param>
+    /// <returns>成功時は true（結果は GetDirtyTileCount / GetDirtyBitmap で取得）</returns>
+    bool Detect(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Texture2D* texture, int threshold, HRESULT* hr = nullptr);
+
+    /// <summary>
+    /// 現在のフレームを次回の比較対象として保存（フレームを読み出した時のみ呼ぶ）
+    /// </summary>
+    void Commit(ID3D11DeviceContext* context, ID3D11Texture2D* texture);
+
+    /// <summary>
+    /// GPU 比較に対応しているか（フィーチャーレベル 11_0 未満は常に全タイル変化ありを返す）
+    /// </summary>
+    bool IsGpuSupported() const { return m_gpuSupported; }
+
+    int GetTileColumns() const { return m_tileColumns; }
+    int GetTileRows() const { return m_tileRows; }
+    int GetDirtyTileCount() const { return m_dirtyTileCount; }
+
+    /// <summary>
+    /// 変化タイルのビットマップ（タイル番号 = 行 * 列数 + 列、32 タイル / ワード、LSB 先頭）
+    /// </summary>
+    const std::vector<unsigned int>& GetDirtyBitmap() const { return m_dirtyBitmap; }
+
+    /// <summary>
+    /// GPU リソースを解放（デバイス喪失・セッション終了時）
+    /// </summary>
+    void Reset();
+
+private:
+    bool InitializeShader(ID3D11Device* device, HRESULT* hr);
+    bool EnsureResources(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& desc, HRESULT* hr);
+    void MarkAllDirty();
+
+    bool m_shaderInitialized = false;
+    bool m_gpuSupported = true;
+    ComPtr<ID3D11ComputeShader> m_computeShader;
+    ComPtr<ID3D11Buffer> m_constantBuffer;
+
+    // 前回フレーム（GPU 常駐）
+    ComPtr<ID3D11Texture2D> m_previousTexture;
+    ComPtr<ID3D11ShaderResourceView> m_previousSrv;
+    bool m_hasPrevious = false;
+
+    // 結果バッファ: [0] = 変化タイル数, [1..] = ビットマップ
+    ComPtr<ID3D11Buffer> m_resultBuffer;
+    ComPtr<ID3D11UnorderedAccessView> m_resultUav;
+    ComPtr<ID3D11Buffer> m_resultStaging;
+
+    UINT m_width = 0;
+    UINT m_height = 0;
+    DXGI_FORMAT m_format = DXGI_FORMAT_UNKNOWN;
+    int m_tileColumns = 0;
+    int m_tileRows = 0;
+    int m_dirtyTileCount = 0;
+    std::vector<unsigned int> m_dirtyBitmap;
+};
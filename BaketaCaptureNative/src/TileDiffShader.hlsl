@@ -0,0 +1,61 @@
+// TileDiffShader.hlsl - タイル差分検出（TileChangeDetector）
+// 1 スレッドグループ = 1 タイル (32x32)。8x8 スレッドが 8 ピクセル間隔で 4x4 ピクセルずつ比較する
+// ビルド時に fxc で cs_5_0 / CSMain をバイトコードヘッダー (g_TileDiffCS) へコンパイルする
+
+Texture2D<float4> currentFrame : register(t0);
+Texture2D<float4> previousFrame : register(t1);
+RWStructuredBuffer<uint> dirtyResult : register(u0);  // [0] = 変化タイル数, [1..] = ビットマップ
+
+cbuffer TileDiffParams : register(b0)
+{
+    uint textureWidth;
+    uint textureHeight;
+    uint tileColumns;
+    float threshold;  // B+G+R 差分絶対値の合計（0〜765）
+};
+
+groupshared uint tileDirty;
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 localId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        tileDirty = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint2 tileOrigin = groupId.xy * 32;
+    uint changed = 0;
+
+    [unroll]
+    for (uint y = 0; y < 4; ++y)
+    {
+        [unroll]
+        for (uint x = 0; x < 4; ++x)
+        {
+            uint2 pixel = tileOrigin + localId.xy + uint2(x * 8, y * 8);
+            if (pixel.x < textureWidth && pixel.y < textureHeight)
+            {
+                float3 diff = abs(currentFrame.Load(int3(pixel, 0)).rgb - previousFrame.Load(int3(pixel, 0)).rgb);
+                if ((diff.r + diff.g + diff.b) * 255.0f > threshold)
+                {
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    if (changed)
+    {
+        InterlockedOr(tileDirty, 1);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex == 0 && tileDirty != 0)
+    {
+        uint tileIndex = groupId.y * tileColumns + groupId.x;
+        InterlockedOr(dirtyResult[1 + tileIndex / 32], 1u << (tileIndex % 32));
+        InterlockedAdd(dirtyResult[0], 1);
+    }
+}
@@ -0,0 +1,347 @@
+﻿#include "pch.h"
+
+// 監視対象の変更を監視スレッドへ通知するメッセージ（フックの登録・解除は登録したスレッドで行う必要がある）
+static constexpr UINT kRefreshHooksMessage = WM_APP + 1;
+
+namespace
+{
+    // 各プロセスに登録する WinEvent の範囲
+    struct EventRange
+    {
+        DWORD first;
+        DWORD last;
+    };
+
+    constexpr std::array<EventRange, 4> kProcessEventRanges = { {
+        { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND },
+        { EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE },  // DESTROY / SHOW / HIDE
+        { EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE },
+        { EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED },
+    } };
+
+    bool IsCloaked(HWND hwnd)
+    {
+        DWORD cloaked = 0;
+        return SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked != 0;
+    }
+
+    // 画面上に見えている範囲（DWM の影を除く）
+    bool GetVisibleBounds(HWND hwnd, RECT* rect)
+    {
+        if (SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_EXTENDED_FRAME_BOUNDS, rect, sizeof(*rect))))
+        {
+            return true;
+        }
+        return GetWindowRect(hwnd, rect) != FALSE;
+    }
+
+    // 前面ウィンドウが対象を完全に覆っているか
+    bool IsCoveredByForeground(HWND hwnd)
+    {
+        HWND foreground = GetForegroundWindow();
+        if (!foreground || foreground == hwnd)
+        {
+            return false;
+        }
+
+        // 対象の子・所有ウィンドウ（ダイアログ等）は対象の一部として扱う
+        if (GetAncestor(foreground, GA_ROOTOWNER) == GetAncestor(hwnd, GA_ROOTOWNER))
+        {
+            return false;
+        }
+
+        // 最前面指定の対象は通常ウィンドウに覆われない
+        LONG_PTR targetExStyle = GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
+        LONG_PTR foregroundExStyle = GetWindowLongPtrW(foreground, GWL_EXSTYLE);
+        if ((targetExStyle & WS_EX_TOPMOST) && !(foregroundExStyle & WS_EX_TOPMOST))
+        {
+            return false;
+        }
+
+        // 半透明・クリック透過のウィンドウ（オーバーレイ等）越しには対象が見えている
+        if ((foregroundExStyle & (WS_EX_LAYERED | WS_EX_TRANSPARENT)) != 0
+            || IsIconic(foreground) || !IsWindowVisible(foreground) || IsCloaked(foreground))
+        {
+            return false;
+        }
+
+        RECT target;
+        RECT cover;
+        if (!GetVisibleBounds(hwnd, &target) || !GetVisibleBounds(foreground, &cover)
+            || target.right <= target.left || target.bottom <= target.top)
+        {
+            return false;
+        }
+
+        return cover.left <= target.left && cover.top <= target.top
+            && cover.right >= target.right && cover.bottom >= target.bottom;
+    }
+}
+
+WindowStateMonitor& WindowStateMonitor::Instance()
+{
+    // 静的破棄の順序によらずセッションのクローズから Unwatch() できるよう破棄しない
+    // （監視スレッドはプロセス終了時に OS が終了させる。ローダーロック中の join も避けられる）
+    static WindowStateMonitor* instance = new WindowStateMonitor();
+    return *instance;
+}
+
+int WindowStateMonitor::Watch(HWND hwnd, Listener listener, State* initialState)
+{
+    DWORD processId = 0;
+    if (!hwnd || !listener || GetWindowThreadProcessId(hwnd, &processId) == 0)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!EnsureThreadLocked())
+    {
+        return 0;
+    }
+
+    int watchId = m_nextWatchId++;
+    WatchEntry& entry = m_watches[watchId];
+    entry.hwnd = hwnd;
+    entry.processId = processId;
+    entry.listener = std::move(listener);
+    entry.state = Query(hwnd);
+    if (initialState)
+    {
+        *initialState = entry.state;
+    }
+
+    PostThreadMessageW(m_threadId, kRefreshHooksMessage, 0, 0);
+    return watchId;
+}
+
+void WindowStateMonitor::Unwatch(int watchId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_watches.erase(watchId) > 0)
+    {
+        PostThreadMessageW(m_threadId, kRefreshHooksMessage, 0, 0);
+    }
+}
+
+WindowStateMonitor::State WindowStateMonitor::Query(HWND hwnd)
+{
+    State state;
+    if (!IsWindow(hwnd))
+    {
+        state.hidden = true;
+        return state;
+    }
+
+    state.minimized = IsIconic(hwnd) != FALSE;
+    state.hidden = IsWindowVisible(hwnd) == FALSE;
+    state.cloaked = IsCloaked(hwnd);
+    if (!state.IsInactive())
+    {
+        state.occluded = IsCoveredByForeground(hwnd);
+    }
+    return state;
+}
+
+bool WindowStateMonitor::EnsureThreadLocked()
+{
+    if (m_thread.joinable())
+    {
+        return true;
+    }
+
+    // スレッドのメッセージキューが作成されてから PostThreadMessage する
+    std::promise<DWORD> ready;
+    std::future<DWORD> threadId = ready.get_future();
+    try
+    {
+        m_thread = std::thread([this, &ready]() { ThreadMain(&ready); });
+    }
+    catch (const std::system_error&)
+    {
+        return false;
+    }
+
+    m_threadId = threadId.get();
+    return true;
+}
+
+void WindowStateMonitor::ThreadMain(std::promise<DWORD>* ready)
+{
+    // 通知先が WinRT のキャプチャセッションを操作するため MTA に参加する
+    try
+    {
+        winrt::init_apartment(winrt::apartment_type::multi_threaded);
+    }
+    catch (...) { /* 既に初期化済み */ }
+
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    ready->set_value(GetCurrentThreadId());
+
+    // WINEVENT_OUTOFCONTEXT のフックはこのメッセージループ内で呼ばれる
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+        if (msg.message == kRefreshHooksMessage)
+        {
+            RefreshHooks();
+        }
+        else if (msg.message == WM_TIMER && msg.hwnd == nullptr)
+        {
+            EvaluateAll();
+        }
+        else
+        {
+            DispatchMessageW(&msg);
+        }
+    }
+
+    UnhookAll();
+}
+
+void WindowStateMonitor::RefreshHooks()
+{
+    std::vector<DWORD> processIds;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& [watchId, entry] : m_watches)
+        {
+            if (std::find(processIds.begin(), processIds.end(), entry.processId) == processIds.end())
+            {
+                processIds.push_back(entry.processId);
+            }
+        }
+    }
+
+    // 監視が無くなったプロセスのフックを解除
+    for (auto it = m_processHooks.begin(); it != m_processHooks.end();)
+    {
+        if (std::find(processIds.begin(), processIds.end(), it->first) == processIds.end())
+        {
+            for (HWINEVENTHOOK hook : it->second.hooks)
+            {
+                if (hook)
+                {
+                    UnhookWinEvent(hook);
+                }
+            }
+            it = m_processHooks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (DWORD processId : processIds)
+    {
+        if (m_processHooks.find(processId) != m_processHooks.end())
+        {
+            continue;
+        }
+
+        ProcessHooks& processHooks = m_processHooks[processId];
+        for (size_t i = 0; i < kProcessEventRanges.size(); ++i)
+        {
+            processHooks.hooks[i] = SetWinEventHook(kProcessEventRanges[i].first, kProcessEventRanges[i].last,
+                nullptr, &WindowStateMonitor::WinEventProc, processId, 0, WINEVENT_OUTOFCONTEXT);
+        }
+    }
+
+    // 前面ウィンドウの変更と遮蔽のポーリングは監視がある間のみ
+    bool active = !processIds.empty();
+    if (active && !m_foregroundHook)
+    {
+        m_foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+            nullptr, &WindowStateMonitor::WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+        m_pollTimer = SetTimer(nullptr, 0, kPollIntervalMs, nullptr);
+    }
+    else if (!active && m_foregroundHook)
+    {
+        UnhookAll();
+    }
+
+    // フック登録前に変化した状態を取りこぼさないよう再評価
+    EvaluateAll();
+}
+
+void WindowStateMonitor::UnhookAll()
+{
+    for (auto& [processId, processHooks] : m_processHooks)
+    {
+        for (HWINEVENTHOOK hook : processHooks.hooks)
+        {
+            if (hook)
+            {
+                UnhookWinEvent(hook);
+            }
+        }
+    }
+    m_processHooks.clear();
+
+    if (m_foregroundHook)
+    {
+        UnhookWinEvent(m_foregroundHook);
+        m_foregroundHook = nullptr;
+    }
+    if (m_pollTimer)
+    {
+        KillTimer(nullptr, m_pollTimer);
+        m_pollTimer = 0;
+    }
+}
+
+void CALLBACK WindowStateMonitor::WinEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD, DWORD)
+{
+    // 前面ウィンドウの変更は全ての監視対象の遮蔽状態に影響する
+    if (event == EVENT_SYSTEM_FOREGROUND)
+    {
+        Instance().EvaluateAll();
+        return;
+    }
+
+    // キャレット・カーソル・子要素のイベントは無視
+    if (!hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
+    {
+        return;
+    }
+
+    Instance().EvaluateWindow(hwnd);
+}
+
+void WindowStateMonitor::EvaluateWindow(HWND hwnd)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [watchId, entry] : m_watches)
+    {
+        if (entry.hwnd == hwnd)
+        {
+            EvaluateLocked(entry);
+        }
+    }
+}
+
+void WindowStateMonitor::EvaluateAll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [watchId, entry] : m_watches)
+    {
+        EvaluateLocked(entry);
+    }
+}
+
+void WindowStateMonitor::EvaluateLocked(WatchEntry& entry)
+{
+    State state = Query(entry.hwnd);
+    if (state == entry.state)
+    {
+        return;
+    }
+
+    entry.state = state;
+    try
+    {
+        entry.listener(state);
+    }
+    catch (...) { /* 通知先の例外で監視スレッドを止めない */ }
+}
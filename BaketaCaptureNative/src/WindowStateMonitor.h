@@ -0,0 +1,112 @@
+﻿#pragma once
+
+/// <summary>
+/// キャプチャ対象ウィンドウの状態監視（プロセス共通）
+/// 専用スレッドのメッセージループで WinEvent フック（最小化・表示/非表示・移動/サイズ変更・DWM クローク・前面ウィンドウ変更）を受け、
+/// 状態が変わったウィンドウの監視者へ通知する。ウィンドウ単位のフックは対象プロセスごとに登録し、同じプロセスの監視で共有する。
+/// 他プロセスのウィンドウによる遮蔽は対象側のイベントが無いため、前面ウィンドウ変更時と定期ポーリングで判定する。
+/// </summary>
+class WindowStateMonitor
+{
+public:
+    /// <summary>
+    /// 遮蔽判定のポーリング間隔
+    /// </summary>
+    static constexpr UINT kPollIntervalMs = 1000;
+
+    /// <summary>
+    /// ウィンドウ状態
+    /// </summary>
+    struct State
+    {
+        bool minimized = false;  // 最小化
+        bool cloaked = false;    // DWM クローク（別の仮想デスクトップ・中断中のストアアプリ等）
+        bool hidden = false;     // 非表示・破棄済み
+        bool occluded = false;   // 前面ウィンドウに完全に覆われている
+
+        /// <summary>
+        /// WGC が新しいフレームを生成しない状態（キャプチャを停止してよい）
+        /// </summary>
+        bool IsInactive() const { return minimized || cloaked || hidden; }
+
+        bool operator==(const State& other) const
+        {
+            return minimized == other.minimized && cloaked == other.cloaked
+                && hidden == other.hidden && occluded == other.occluded;
+        }
+
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    /// <summary>
+    /// 状態変更の通知先（監視スレッドから呼ばれる）
+    /// </summary>
+    using Listener = std::function<void(const State&)>;
+
+    /// <summary>
+    /// プロセス共通インスタンスを取得
+    /// </summary>
+    static WindowStateMonitor& Instance();
+
+    /// <summary>
+    /// ウィンドウの監視を開始
+    /// 通知は監視のロック下で呼ばれるため、Unwatch() から戻った後に呼ばれることはない（通知内で Unwatch() を呼ばないこと）
+    /// </summary>
+    /// <param name="hwnd">対象ウィンドウ</param>
+    /// <param name="listener">状態変更の通知先</param>
+    /// <param name="initialState">監視開始時点の状態（出力・省略可）</param>
+    /// <returns>監視ID（Unwatch() に渡す）、失敗時は 0</returns>
+    int Watch(HWND hwnd, Listener listener, State* initialState = nullptr);
+
+    /// <summary>
+    /// ウィンドウの監視を終了（最後の監視が外れたプロセスのフックは解除される）
+    /// </summary>
+    /// <param name="watchId">Watch() が返した監視ID</param>
+    void Unwatch(int watchId);
+
+    /// <summary>
+    /// ウィンドウの現在の状態を取得（任意のスレッドから呼び出し可）
+    /// </summary>
+    static State Query(HWND hwnd);
+
+private:
+    WindowStateMonitor() = default;
+    ~WindowStateMonitor() = default;
+    WindowStateMonitor(const WindowStateMonitor&) = delete;
+    WindowStateMonitor& operator=(const WindowStateMonitor&) = delete;
+
+    struct WatchEntry
+    {
+        HWND hwnd = nullptr;
+        DWORD processId = 0;
+        Listener listener;
+        State state;
+    };
+
+    // 対象プロセス 1 つ分の WinEvent フック（監視スレッド専有）
+    struct ProcessHooks
+    {
+        std::array<HWINEVENTHOOK, 4> hooks{};
+    };
+
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+
+    bool EnsureThreadLocked();
+    void ThreadMain(std::promise<DWORD>* ready);
+    void RefreshHooks();
+    void UnhookAll();
+    void EvaluateWindow(HWND hwnd);
+    void EvaluateAll();
+    void EvaluateLocked(WatchEntry& entry);
+
+    std::mutex m_mutex;
+    std::unordered_map<int, WatchEntry> m_watches;
+    int m_nextWatchId = 1;
+    std::thread m_thread;
+    DWORD m_threadId = 0;
+
+    // 以下は監視スレッド専有
+    std::unordered_map<DWORD, ProcessHooks> m_processHooks;
+    HWINEVENTHOOK m_foregroundHook = nullptr;
+    UINT_PTR m_pollTimer = 0;
+};
@@ -11,7 +11,183 @@ extern "C" {
     BOOL GetWindowRect(HWND hWnd, LPRECT lpRect);
     int GetClassNameA(HWND hWnd, LPSTR lpClassName, int nMaxCount);
     int GetWindowTextA(HWND hWnd, LPSTR lpString, int nMaxCount);
-    VOID Sleep(DWORD dwMilliseconds); // リトライ遅延用
+}
+
+// GraphicsCaptureItem 作成のリトライ回数と初回バックオフ（以降は倍々）
+static constexpr int kCreateItemMaxAttempts = 4;
+static constexpr int kCreateItemInitialBackoffMs = 25;
+
+// ストリーミングモードのフレームプール深度
+// メールボックスが front / shared の2フレームを保持するため、WGC が書き込める空きを1つ以上残す
+static constexpr int kDefaultStreamingPoolDepth = 3;
+static constexpr int kMaxStreamingPoolDepth = 8;
+
+// 前面ウィンドウに完全に覆われている間の最小フレーム間隔（1fps、100ns単位）
+static constexpr long long kOccludedFrameIntervalTicks = 10000000LL;
+
+// Close が実行中のフレームコールバックを待つ上限（コールバック内からのクローズ・アンロード時に止まらない）
+static constexpr int kCloseCallbackWaitMs = 1000;
+
+// リプレイの記録が1フレームのみの場合の周回間隔（60fps 相当、100ns単位）
+static constexpr long long kReplaySingleFrameIntervalTicks = 166667LL;
+
+// ROI アトラスの最大サイズ（D3D11 のテクスチャ上限）と棚詰めの目安幅
+static constexpr int kMaxRegionAtlasSize = 16384;
+static constexpr int kRegionAtlasShelfWidth = 4096;
+
+namespace
+{
+    // ROI のアトラス上の配置
+    struct RegionPlacement
+    {
+        int index;       // regions 配列のインデックス
+        RECT source;     // フレーム内にクランプしたソース領域
+        int width;       // 出力サイズ
+        int height;
+        int atlasX;      // アトラス上の位置
+        int atlasY;
+    };
+
+    // 高さ順の棚詰め（Shelf packing）でアトラス上の位置を決める
+    bool PackRegionPlacements(std::vector<RegionPlacement>& placements, int* atlasWidth, int* atlasHeight)
+    {
+        std::vector<RegionPlacement*> order;
+        order.reserve(placements.size());
+        int widest = 0;
+        for (auto& placement : placements)
+        {
+            order.push_back(&placement);
+            widest = (std::max)(widest, placement.width);
+        }
+        std::sort(order.begin(), order.end(), [](const RegionPlacement* a, const RegionPlacement* b) { return a->height > b->height; });
+
+        int shelfWidth = (std::max)(widest, kRegionAtlasShelfWidth);
+        if (shelfWidth > kMaxRegionAtlasSize)
+        {
+            return false;
+        }
+
+        int x = 0;
+        int y = 0;
+        int shelfHeight = 0;
+        int usedWidth = 0;
+        for (auto* placement : order)
+        {
+            if (x + placement->width > shelfWidth)
+            {
+                y += shelfHeight;
+                x = 0;
+                shelfHeight = 0;
+            }
+            if (placement->height > kMaxRegionAtlasSize - y)
+            {
+                return false;
+            }
+            placement->atlasX = x;
+            placement->atlasY = y;
+            x += placement->width;
+            usedWidth = (std::max)(usedWidth, x);
+            shelfHeight = (std::max)(shelfHeight, placement->height);
+        }
+
+        *atlasWidth = usedWidth;
+        *atlasHeight = y + shelfHeight;
+        return *atlasHeight <= kMaxRegionAtlasSize;
+    }
+
+    // 100ns単位の単調増加タイムスタンプ（steady_clock は QPC 基準）
+    long long GetFrameTimestampTicks()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() / 100;
+    }
+
+    // フレームの提示時刻（100ns単位）
+    // SystemRelativeTime は QPC 基準のため、非対応 OS での代替値（到着時刻）とも大小比較できる
+    long long GetPresentationTimestampTicks(winrt::Direct3D11CaptureFrame const& frame)
+    {
+        static const bool supported = []()
+        {
+            try
+            {
+                return winrt::Windows::Foundation::Metadata::ApiInformation::IsPropertyPresent(
+                    L"Windows.Graphics.Capture.Direct3D11CaptureFrame", L"SystemRelativeTime");
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }();
+
+        if (supported)
+        {
+            try
+            {
+                return frame.SystemRelativeTime().count();
+            }
+            catch (...) { /* 到着時刻で代用 */ }
+        }
+        return GetFrameTimestampTicks();
+    }
+
+    // フレームペーシングの許容誤差（提示間隔の揺らぎで同一レートのフレームを落とさないため、100ns単位）
+    constexpr long long kFramePacingToleranceTicks = 10000;
+
+    // ResizeShader.hlsl の ResizeParams（16 バイト境界）
+    struct ResizeShaderParams
+    {
+        float uvOffset[2];
+        float uvScale[2];
+        UINT toneMap;
+        float sdrWhiteScale;
+        float peakWhite;
+        float padding;
+    };
+    static_assert(sizeof(ResizeShaderParams) % 16 == 0, "Constant buffer size must be a multiple of 16 bytes");
+
+    // アスペクト比を維持して目標サイズ内に収まる出力サイズ（1 ピクセル以上）
+    void FitToTarget(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight, int* width, int* height)
+    {
+        float srcAspect = static_cast<float>(sourceWidth) / static_cast<float>(sourceHeight);
+        float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
+        if (srcAspect > targetAspect)
+        {
+            *width = targetWidth;
+            *height = static_cast<int>(targetWidth / srcAspect);
+        }
+        else
+        {
+            *height = targetHeight;
+            *width = static_cast<int>(targetHeight * srcAspect);
+        }
+        *width = (std::max)(1, *width);
+        *height = (std::max)(1, *height);
+    }
+
+    // OnFrameArrived のストリーミング処理中を示すカウンタ（StopStreaming が完了を待つ）
+    struct CallbackInFlightScope
+    {
+        CallbackInFlightScope(std::mutex& mutex, std::condition_variable& idle, int& counter)
+            : m_mutex(mutex), m_idle(idle), m_counter(counter)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_counter;
+        }
+
+        ~CallbackInFlightScope()
+        {
+            // 最後のコールバックが終了を待つ側を起こす
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_counter == 0)
+            {
+                m_idle.notify_all();
+            }
+        }
+
+        std::mutex& m_mutex;
+        std::condition_variable& m_idle;
+        int& m_counter;
+    };
 }
 
 WindowsCaptureSession::WindowsCaptureSession(int sessionId, HWND hwnd)
@@ -25,12 +201,44 @@ WindowsCaptureSession::WindowsCaptureSession(int sessionId, HWND hwnd)
     , m_lastHResult(S_OK)
     , m_gpuResizeInitialized(false)  // 🚀 [Issue #193] GPU Shader Resize
 {
+    // フレーム到着通知用の自動リセットイベント
+    m_frameEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+}
+
+WindowsCaptureSession::WindowsCaptureSession(int sessionId, HMONITOR monitor)
+    : WindowsCaptureSession(sessionId, static_cast<HWND>(nullptr))
+{
+    m_monitor = monitor;
+}
+
+WindowsCaptureSession::WindowsCaptureSession(int sessionId, std::shared_ptr<WindowsCaptureSession> frameSource, const RECT* cropRect)
+    : WindowsCaptureSession(sessionId, static_cast<HWND>(nullptr))
+{
+    m_frameSource = std::move(frameSource);
+    if (cropRect)
+    {
+        m_cropRect = *cropRect;
+        m_hasCropRect = true;
+    }
+}
+
+WindowsCaptureSession::WindowsCaptureSession(int sessionId, const wchar_t* replayPath, int replayFlags)
+    : WindowsCaptureSession(sessionId, static_cast<HWND>(nullptr))
+{
+    m_replayPath = replayPath ? replayPath : L"";
+    m_replayFlags = replayFlags;
 }
 
 WindowsCaptureSession::~WindowsCaptureSession()
 {
     // [Issue #324] 安全なクローズ処理に委譲
     Close();
+
+    if (m_frameEvent)
+    {
+        CloseHandle(m_frameEvent);
+        m_frameEvent = nullptr;
+    }
 }
 
 /// <summary>
@@ -48,6 +256,20 @@ void WindowsCaptureSession::Close()
         return;
     }
 
+    // ウィンドウ状態の監視を解除（戻った時点で以後の状態変更は通知されない）
+    if (m_windowWatchId != 0)
+    {
+        WindowStateMonitor::Instance().Unwatch(m_windowWatchId);
+        m_windowWatchId = 0;
+    }
+
+    // ストリーミングを停止し、最初のフレームを待機中の読み出し側を起こす
+    m_streaming.store(false);
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+    }
+    m_frameCondition.notify_all();
+
     // [Issue #324] 少し待機してコールバックが完了するのを待つ
     // OnFrameArrived が m_isClosing をチェックして早期リターンするため
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
@@ -60,26 +282,111 @@ void WindowsCaptureSession::Close()
     }
 
     // [Issue #324] リソース解放（順序重要）
-    // 1. キャプチャセッションを先に閉じる（新しいフレームの到着を停止）
-    if (m_captureSession)
     {
-        try
+        // サイズ変更による Recreate と並行しないよう直列化
+        std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+
+        // 1. キャプチャセッションを先に閉じる（新しいフレームの到着を停止）
+        if (m_captureSession)
         {
-            m_captureSession.Close();
+            try
+            {
+                m_captureSession.Close();
+            }
+            catch (...) { /* 例外を無視 */ }
+            m_captureSession = nullptr;
+        }
+
+        // 2. フレームプールを閉じる
+        if (m_framePool)
+        {
+            try
+            {
+                m_framePool.Close();
+            }
+            catch (...) { /* 例外を無視 */ }
+            m_framePool = nullptr;
         }
-        catch (...) { /* 例外を無視 */ }
-        m_captureSession = nullptr;
     }
 
-    // 2. フレームプールを閉じる
-    if (m_framePool)
+    // 共有メモリリング・エンコーダーを閉じる（m_readbackMutex より先に取得するロックのため、読み出しロックの外で行う）
+    DisableSharedRing();
+    StopEncoder();
+
+    // 記録中のファイルは書き込み待ちのフレームを書き出してから閉じる（記録は m_readbackMutex の後に取得するロックのため単独で行う）
     {
-        try
+        std::lock_guard<std::mutex> recordLock(m_recordMutex);
+        m_recording.store(false);
+        if (m_recordWriter)
         {
-            m_framePool.Close();
+            m_recordWriter->Finish();
+            m_recordWriter.reset();
         }
-        catch (...) { /* 例外を無視 */ }
-        m_framePool = nullptr;
+        m_recordStaging.Reset();
+    }
+
+    // 3. ステージングテクスチャとメールボックスを解放（進行中の読み出し完了を待つ）
+    // コールバックが上限内に終わらない場合、コールバックが書き込むメールボックスはセッション破棄まで残す
+    bool callbacksIdle = WaitForStreamCallbacks(std::chrono::milliseconds(kCloseCallbackWaitMs));
+    if (!callbacksIdle)
+    {
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, "Frame callback still running at close - keeping the mailbox until destruction");
+    }
+    {
+        std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+        m_staging.Reset();
+        m_readbackRing.Reset();
+        m_changeDetector.Reset();
+        if (callbacksIdle)
+        {
+            m_mailbox.Reset();
+        }
+        m_dirtyTracker.Reset();
+        m_dirtyFrame.clear();
+        m_dirtyFrame.shrink_to_fit();
+        m_dirtyFrameSequence = 0;
+        m_regionStaging.Reset();
+        m_computeResizer.Reset();
+        m_scaledStaging.Reset();
+        m_formatConverter.Reset();
+        m_formatStaging.Reset();
+        m_edgeMapper.Reset();
+        m_sharedExporter.Reset();
+        m_cpuScratch.clear();
+        m_cpuScratch.shrink_to_fit();
+        m_cpuResizeScratch.clear();
+        m_cpuResizeScratch.shrink_to_fit();
+        m_resizeCache.Reset();
+        m_gpuResizeTimer.Reset();
+        m_cropTexture.Reset();
+        m_replayTexture.Reset();
+        m_replayUploadedSequence = 0;
+        m_replayPixels.clear();
+        m_replayPixels.shrink_to_fit();
+        if (m_sharedDevice)
+        {
+            // 同じアドレスに作成される後続セッションがバインド済みと誤認しないよう所有を解除
+            D3DContextLock contextLock(m_d3dContext.Get());
+            if (m_sharedDevice->resizePipelineOwner == this)
+            {
+                m_sharedDevice->resizePipelineOwner = nullptr;
+            }
+        }
+        m_regionAtlasRtv.Reset();
+        m_regionAtlas.Reset();
+        m_regionAtlasWidth = 0;
+        m_regionAtlasHeight = 0;
+    }
+
+    // 4. コールバックを解除し、イベント待機中の呼び出し側を起こす（次のキャプチャで失敗を検出させる）
+    {
+        std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+        m_frameCallback = nullptr;
+        m_frameCallbackUserData = nullptr;
+    }
+    if (m_frameEvent)
+    {
+        SetEvent(m_frameEvent);
     }
 
     m_initialized = false;
@@ -87,90 +394,161 @@ void WindowsCaptureSession::Close()
 
 bool WindowsCaptureSession::Initialize()
 {
+    // 領域セッションはフレームソースのキャプチャを共有する
+    if (m_frameSource)
+    {
+        return InitializeFromSource();
+    }
+
+    // リプレイセッションは WGC を使わず記録ファイルからフレームを出す
+    if (IsReplay())
+    {
+        return InitializeReplay();
+    }
+
     try
     {
-        SetLastError("DEBUG: Initialize() started");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, "Initialize() started");
         
         // Direct3D デバイスを作成
         if (!CreateD3DDevice())
         {
-            SetLastError("DEBUG: CreateD3DDevice() failed - " + m_lastError);
+            SetLastError(std::string("CreateD3DDevice() failed - ") + GetLastError());
             return false;
         }
 
-        SetLastError("DEBUG: CreateD3DDevice() succeeded");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, "CreateD3DDevice() succeeded");
 
-        // GraphicsCaptureItem を作成
-        if (!CreateCaptureItem())
+        // GraphicsCaptureItem を作成（モニターのフレームソースは CreateForMonitor）
+        if (!(m_monitor ? CreateMonitorCaptureItem() : CreateCaptureItem()))
         {
-            SetLastError("DEBUG: CreateCaptureItem() failed - " + m_lastError);
+            SetLastError(std::string("CreateCaptureItem() failed - ") + GetLastError());
             return false;
         }
 
-        SetLastError("DEBUG: CreateCaptureItem() succeeded");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, "CreateCaptureItem() succeeded");
 
         // フレームプールを作成
         if (!CreateFramePool())
         {
-            SetLastError("DEBUG: CreateFramePool() failed - " + m_lastError);
+            SetLastError(std::string("CreateFramePool() failed - ") + GetLastError());
             return false;
         }
 
-        SetLastError("DEBUG: All initialization steps completed successfully");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, "All initialization steps completed successfully");
         m_initialized = true;
+
+        // ウィンドウの最小化・クローク・遮蔽を監視してキャプチャを自動停止する
+        if (m_hwnd)
+        {
+            StartWindowStateWatch();
+        }
         return true;
     }
     catch (const std::exception& e)
     {
-        SetLastError(std::string("DEBUG: Initialize exception caught: ") + e.what());
+        SetLastError(std::string("Initialize exception caught: ") + e.what());
         return false;
     }
     catch (...)
     {
-        SetLastError("DEBUG: Initialize unknown exception caught");
+        SetLastError("Initialize unknown exception caught");
         return false;
     }
 }
 
-bool WindowsCaptureSession::CreateD3DDevice()
+bool WindowsCaptureSession::InitializeFromSource()
 {
-    try
+    if (!m_frameSource->IsValid())
     {
-        // Direct3D11 デバイスを作成
-        D3D_FEATURE_LEVEL featureLevels[] = {
-            D3D_FEATURE_LEVEL_11_1,
-            D3D_FEATURE_LEVEL_11_0,
-            D3D_FEATURE_LEVEL_10_1,
-            D3D_FEATURE_LEVEL_10_0
-        };
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE_ITEM, E_FAIL, "Monitor capture source is not available");
+        return false;
+    }
 
-        UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-#ifdef _DEBUG
-        // creationFlags |= D3D11_CREATE_DEVICE_DEBUG; // Graphics Tools未対応環境対策で一時的に無効化
-#endif
+    // ソースと同じ共有デバイスを使う（ソースのテクスチャを直接コピーするため）
+    m_sharedDevice = m_frameSource->m_sharedDevice;
+    m_d3dDevice = m_frameSource->m_d3dDevice;
+    m_d3dContext = m_frameSource->m_d3dContext;
+    m_winrtDevice = m_frameSource->m_winrtDevice;
+    m_initialized = true;
+    return true;
+}
 
-        HRESULT hr = D3D11CreateDevice(
-            nullptr,                    // アダプター
-            D3D_DRIVER_TYPE_HARDWARE,   // ドライバータイプ
-            nullptr,                    // ソフトウェアラスタライザー
-            creationFlags,              // フラグ
-            featureLevels,              // フィーチャーレベル
-            ARRAYSIZE(featureLevels),   // フィーチャーレベル数
-            D3D11_SDK_VERSION,          // SDK バージョン
-            &m_d3dDevice,               // デバイス
-            nullptr,                    // フィーチャーレベル（出力）
-            &m_d3dContext               // デバイスコンテキスト
-        );
+bool WindowsCaptureSession::InitializeReplay()
+{
+    HRESULT hr = S_OK;
+    m_replay = FrameReplayReader::Open(m_replayPath.c_str(), &hr);
+    if (!m_replay || m_replay->FrameCount() == 0)
+    {
+        m_replay.reset();
+        m_lastHResult = FAILED(hr) ? hr : HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE_ITEM, m_lastHResult, "Failed to open capture recording");
+        return false;
+    }
 
-        if (FAILED(hr))
+    // 記録元のアダプターは分からないため、プライマリモニターを出力しているアダプターで再生する
+    m_sharedDevice = D3DDeviceManager::Instance().AcquireForMonitor(MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY), &hr);
+    if (!m_sharedDevice)
+    {
+        m_replay.reset();
+        m_lastHResult = hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_DEVICE, hr, "Failed to create D3D device for replay");
+        return false;
+    }
+
+    m_d3dDevice = m_sharedDevice->device;
+    m_d3dContext = m_sharedDevice->context;
+    m_winrtDevice = m_sharedDevice->winrtDevice;
+    m_initialized = true;
+    return true;
+}
+
+bool WindowsCaptureSession::IsValid() const
+{
+    if (!m_initialized || m_isClosing.load() || m_deviceLost.load())
+    {
+        return false;
+    }
+
+    if (m_replay)
+    {
+        return true;
+    }
+
+    if (m_frameSource)
+    {
+        return m_frameSource->IsValid();
+    }
+
+    if (m_monitor)
+    {
+        // モニターの切断を検出
+        MONITORINFO info = {};
+        info.cbSize = sizeof(info);
+        return GetMonitorInfoW(m_monitor, &info) != FALSE;
+    }
+
+    return IsWindow(m_hwnd) != FALSE;
+}
+
+bool WindowsCaptureSession::CreateD3DDevice()
+{
+    try
+    {
+        // ウィンドウのモニターを出力しているアダプターの共有デバイスを取得（同じアダプターのセッション間で再利用）
+        HRESULT hr = S_OK;
+        m_sharedDevice = m_monitor
+            ? D3DDeviceManager::Instance().AcquireForMonitor(m_monitor, &hr)
+            : D3DDeviceManager::Instance().AcquireForWindow(m_hwnd, &hr);
+        if (!m_sharedDevice)
         {
             // HRESULTを保存
             m_lastHResult = hr;
-            
+
             // HRESULTの詳細な値を16進数でログ出力
             char errorBuffer[256];
             sprintf_s(errorBuffer, sizeof(errorBuffer), "D3D11CreateDevice failed with HRESULT: 0x%08X", hr);
-            
+
             // 特定のエラーの詳細説明を追加
             if (hr == DXGI_ERROR_SDK_COMPONENT_MISSING) {
                 strcat_s(errorBuffer, sizeof(errorBuffer), " (DXGI_ERROR_SDK_COMPONENT_MISSING - Graphics Tools required for Debug builds)");
@@ -179,36 +557,19 @@ bool WindowsCaptureSession::CreateD3DDevice()
             } else if (hr == DXGI_ERROR_UNSUPPORTED) {
                 strcat_s(errorBuffer, sizeof(errorBuffer), " (DXGI_ERROR_UNSUPPORTED - Feature not supported)");
             }
-            
-            SetLastError(std::string(errorBuffer));
-            return false;
-        }
 
-        // DXGI デバイスを取得
-        ComPtr<IDXGIDevice> dxgiDevice;
-        hr = m_d3dDevice.As(&dxgiDevice);
-        if (FAILED(hr))
-        {
-            m_lastHResult = hr;
-            char errorBuffer[256];
-            sprintf_s(errorBuffer, sizeof(errorBuffer), "Failed to get DXGI device with HRESULT: 0x%08X", hr);
-            SetLastError(std::string(errorBuffer));
+            SetLastError(BAKETA_CAPTURE_STAGE_DEVICE, hr, errorBuffer);
             return false;
         }
 
-        // WinRT Direct3D デバイスを作成
+        m_d3dDevice = m_sharedDevice->device;
+        m_d3dContext = m_sharedDevice->context;
+        m_winrtDevice = m_sharedDevice->winrtDevice;
 
-        // WinRT Direct3D デバイスに変換
-        hr = CreateDirect3D11DeviceFromDXGIDevice(dxgiDevice.Get(), reinterpret_cast<IInspectable**>(winrt::put_abi(m_winrtDevice)));
-        if (FAILED(hr))
+        if (!m_sharedDevice->adapterMatched)
         {
-            m_lastHResult = hr;
-            char errorBuffer[256];
-            sprintf_s(errorBuffer, sizeof(errorBuffer), "Failed to create WinRT Direct3D device with HRESULT: 0x%08X", hr);
-            SetLastError(std::string(errorBuffer));
-            return false;
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, "Adapter for the window's monitor not found, using default adapter");
         }
-
         return true;
     }
     catch (...)
@@ -240,13 +601,14 @@ bool WindowsCaptureSession::CreateCaptureItem()
         }
 
         // 🔍 Phase 0 WGC修復: GraphicsCaptureItem作成前の最終確認
-        SetLastError("DEBUG: About to create GraphicsCaptureItem for validated window");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, "About to create GraphicsCaptureItem for validated window");
 
         // 🔍 Phase 0 WGC修復: リトライメカニズム付きGraphicsCaptureItem作成
+        // 待機は指数バックオフ（25ms → 50ms → 100ms）。一時的な失敗は短い待機で回復することが多く、固定 100ms より早く戻る
         winrt::com_ptr<ABI::Windows::Graphics::Capture::IGraphicsCaptureItem> captureItem;
         HRESULT hr = E_FAIL;
-        const int maxRetries = 3;
-        const int delayMs = 100;
+        const int maxRetries = kCreateItemMaxAttempts;
+        int delayMs = kCreateItemInitialBackoffMs;
 
         for (int attempt = 0; attempt < maxRetries; ++attempt)
         {
@@ -261,7 +623,7 @@ bool WindowsCaptureSession::CreateCaptureItem()
                 char successMsg[256];
                 sprintf_s(successMsg, sizeof(successMsg), 
                     "CreateForWindow succeeded on attempt %d", attempt + 1);
-                SetLastError(std::string(successMsg));
+                LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, successMsg);
                 break;
             }
             else
@@ -270,12 +632,19 @@ bool WindowsCaptureSession::CreateCaptureItem()
                 sprintf_s(retryMsg, sizeof(retryMsg),
                     "CreateForWindow attempt %d failed with HRESULT: 0x%08X - %s", 
                     attempt + 1, hr, (attempt + 1 < maxRetries) ? "retrying" : "giving up");
-                SetLastError(std::string(retryMsg));
+                LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, retryMsg);
 
-                // 最終試行でなければ少し待つ
+                // 最終試行でなければ少し待つ（セッションがクローズされた場合は中断）
                 if (attempt + 1 < maxRetries)
                 {
-                    Sleep(delayMs);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+                    delayMs *= 2;
+                    if (m_isClosing.load())
+                    {
+                        SetLastError("Session closed during CreateForWindow retry - aborting");
+                        return false;
+                    }
+
                     // 次の試行のためにウィンドウ状態を再確認
                     if (!ValidateWindowStateForCapture())
                     {
@@ -309,7 +678,7 @@ bool WindowsCaptureSession::CreateCaptureItem()
     catch (const winrt::hresult_error& ex)
     {
         m_lastHResult = ex.code();
-        SetLastError("CreateCaptureItem winrt error: 0x" + std::to_string(ex.code()));
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE_ITEM, ex.code(), "CreateCaptureItem winrt error: 0x" + std::to_string(ex.code()));
         return false;
     }
     catch (const std::exception& ex)
@@ -324,6 +693,52 @@ bool WindowsCaptureSession::CreateCaptureItem()
     }
 }
 
+bool WindowsCaptureSession::CreateMonitorCaptureItem()
+{
+    try
+    {
+        auto interopFactory = winrt::get_activation_factory<winrt::GraphicsCaptureItem>();
+        auto interop = interopFactory.as<::IGraphicsCaptureItemInterop>();
+        if (!interop)
+        {
+            SetLastError("Failed to get IGraphicsCaptureItemInterop");
+            return false;
+        }
+
+        winrt::com_ptr<ABI::Windows::Graphics::Capture::IGraphicsCaptureItem> captureItem;
+        HRESULT hr = interop->CreateForMonitor(
+            m_monitor,
+            winrt::guid_of<ABI::Windows::Graphics::Capture::IGraphicsCaptureItem>(),
+            captureItem.put_void()
+        );
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE_ITEM, hr, "CreateForMonitor failed");
+            return false;
+        }
+
+        m_captureItem = captureItem.as<winrt::GraphicsCaptureItem>();
+        if (!m_captureItem)
+        {
+            SetLastError("Failed to convert to GraphicsCaptureItem");
+            return false;
+        }
+        return true;
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        m_lastHResult = ex.code();
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE_ITEM, ex.code(), "CreateForMonitor winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CreateMonitorCaptureItem unknown exception");
+        return false;
+    }
+}
+
 bool WindowsCaptureSession::CreateFramePool()
 {
     try
@@ -336,11 +751,14 @@ bool WindowsCaptureSession::CreateFramePool()
 
         // キャプチャアイテムのサイズを取得
         auto itemSize = m_captureItem.Size();
+
+        // HDR モニターでは FP16 で受け取り、リサイズシェーダーで SDR へトーンマップする
+        m_capturePixelFormat = SelectCapturePixelFormat();
         
         // フレームプールを作成
         m_framePool = winrt::Direct3D11CaptureFramePool::CreateFreeThreaded(
             m_winrtDevice,
-            winrt::DirectXPixelFormat::B8G8R8A8UIntNormalized,
+            m_capturePixelFormat,
             1, // フレーム数
             itemSize
         );
@@ -351,6 +769,10 @@ bool WindowsCaptureSession::CreateFramePool()
             return false;
         }
 
+        m_framePoolBuffers = 1;
+        m_framePoolWidth.store(itemSize.Width);
+        m_framePoolHeight.store(itemSize.Height);
+
         // フレーム到着イベントを設定
         m_framePool.FrameArrived({ this, &WindowsCaptureSession::OnFrameArrived });
 
@@ -368,7 +790,7 @@ bool WindowsCaptureSession::CreateFramePool()
     catch (const winrt::hresult_error& ex)
     {
         m_lastHResult = ex.code();
-        SetLastError("CreateFramePool winrt error: 0x" + std::to_string(ex.code()));
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_POOL, ex.code(), "CreateFramePool winrt error: 0x" + std::to_string(ex.code()));
         return false;
     }
     catch (const std::exception& ex)
@@ -385,6 +807,9 @@ bool WindowsCaptureSession::CreateFramePool()
 
 void WindowsCaptureSession::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sender, winrt::IInspectable const& args)
 {
+    // 判定より先に実行中として数える（Close・停止・StopStreaming の WaitForStreamCallbacks がこのコールバックを必ず待つ）
+    CallbackInFlightScope inFlight(m_streamCallbackMutex, m_streamCallbacksIdle, m_streamCallbacksInFlight);
+
     // [Issue #324] クローズ中は即リターン（重い処理をスキップ）
     if (m_isClosing.load())
     {
@@ -399,9 +824,81 @@ void WindowsCaptureSession::OnFrameArrived(winrt::Direct3D11CaptureFramePool con
             return;
         }
 
-        // [Issue #324] フレーム取得後も再度チェック（Close()が呼ばれた可能性）
-        if (m_isClosing.load())
+        // [Issue #324] フレーム取得後も再度チェック（Close()・停止が呼ばれた可能性、停止中のフレームはここで破棄される）
+        if (m_isClosing.load() || m_suspended.load())
+        {
+            return;
+        }
+
+        // フレーム通し番号（DirtyRegions 履歴と読み出し済み判定に使用）
+        unsigned long long sequence = ++m_frameSequenceCounter;
+        m_stats.CountArrived();
+
+        // 提示時刻（SystemRelativeTime）
+        long long timestamp = GetPresentationTimestampTicks(frame);
+
+        // 対象のサイズが変わった場合は旧サイズのフレームを返さず、フレームプールを新しいサイズで作り直す
+        auto contentSize = frame.ContentSize();
+        if (contentSize.Width > 0 && contentSize.Height > 0 &&
+            (contentSize.Width != m_framePoolWidth.load() || contentSize.Height != m_framePoolHeight.load()))
+        {
+            if (m_dirtyRegionsEnabled.load(std::memory_order_relaxed))
+            {
+                m_dirtyTracker.Record(sequence, nullptr, 0, true);
+            }
+            m_stats.CountDropped();
+            frame.Close();
+            OnContentResized(contentSize);
+            return;
+        }
+
+        if (!AcceptFramePacing(timestamp))
+        {
+            // 最小フレーム間隔より早く届いたフレームはテクスチャを参照せずにプールへ返却
+            // DirtyRegions のみ記録し、次に受け取るフレームまで変化矩形を累積させる
+            RecordDirtyRegions(frame, sequence, contentSize.Width, contentSize.Height);
+            m_stats.CountDropped();
+            frame.Close();
+            return;
+        }
+
+        // ストリーミングモード: フレームミューテックスを使わずメールボックスへ公開
+        if (m_streaming.load())
         {
+            auto streamAccess = frame.Surface().as<Windows::Graphics::DirectX::Direct3D11::IDirect3DDxgiInterfaceAccess>();
+            MailboxFrame& slot = m_mailbox.BeginWrite();
+            if (FAILED(streamAccess->GetInterface(IID_PPV_ARGS(slot.texture.ReleaseAndGetAddressOf()))) || !slot.texture)
+            {
+                slot.texture.Reset();
+                return;
+            }
+
+            D3D11_TEXTURE2D_DESC desc;
+            slot.texture->GetDesc(&desc);
+            slot.frame = frame;
+            slot.width = static_cast<int>(desc.Width);
+            slot.height = static_cast<int>(desc.Height);
+            slot.timestamp = timestamp;
+            slot.sequence = sequence;
+            RecordDirtyRegions(frame, sequence, slot.width, slot.height);
+
+            // パイプライン読み出し: 公開前にステージングへのコピーを発行し、読み出し側がマップするまでに完了させる
+            if (m_pipelinedReadback.load(std::memory_order_relaxed))
+            {
+                PrefetchReadback(slot.texture.Get(), sequence, timestamp);
+            }
+            if (m_mailbox.Publish())
+            {
+                m_stats.CountDropped();  // 読み出されずに置き換えられたフレーム
+            }
+            NotifyFrameArrived(timestamp);
+
+            // 最初のフレームを待機中の読み出し側がいる場合のみ通知（通常はロックを取らない）
+            if (m_streamWaiters.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_frameMutex);
+                m_frameCondition.notify_all();
+            }
             return;
         }
 
@@ -414,9 +911,23 @@ void WindowsCaptureSession::OnFrameArrived(winrt::Direct3D11CaptureFramePool con
         
         if (SUCCEEDED(hr) && texture)
         {
-            std::lock_guard<std::mutex> lock(m_frameMutex);
-            
-            // 最新フレームを保存
+            D3D11_TEXTURE2D_DESC frameDesc;
+            texture->GetDesc(&frameDesc);
+            RecordDirtyRegions(frame, sequence, static_cast<int>(frameDesc.Width), static_cast<int>(frameDesc.Height));
+
+            // パイプライン読み出し: 待機中の読み出し側を起こす前にステージングへのコピーを発行する
+            if (m_pipelinedReadback.load(std::memory_order_relaxed))
+            {
+                PrefetchReadback(texture.Get(), sequence, timestamp);
+            }
+
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            
+            // 最新フレームを保存（読み出されていないフレームを置き換える場合は破棄として数える）
+            if (m_frameReady)
+            {
+                m_stats.CountDropped();
+            }
             m_latestFrame = texture;
             
             // フレーム情報を更新
@@ -424,11 +935,16 @@ void WindowsCaptureSession::OnFrameArrived(winrt::Direct3D11CaptureFramePool con
             texture->GetDesc(&desc);
             m_frameWidth = static_cast<int>(desc.Width);
             m_frameHeight = static_cast<int>(desc.Height);
-            m_frameTimestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count() / 100; // 100ns単位
+            m_frameTimestamp = timestamp; // 提示時刻（100ns単位）
+            m_frameSequence = sequence;
             
             m_frameReady = true;
-            m_frameCondition.notify_one();
+            m_frameCondition.notify_all();  // モニターのフレームソースは複数の領域セッションが待機する
+        }
+
+        if (SUCCEEDED(hr) && texture)
+        {
+            NotifyFrameArrived(m_frameTimestamp);
         }
     }
     catch (...)
@@ -437,500 +953,3493 @@ void WindowsCaptureSession::OnFrameArrived(winrt::Direct3D11CaptureFramePool con
     }
 }
 
-bool WindowsCaptureSession::CaptureFrame(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, int timeoutMs)
+void WindowsCaptureSession::NotifyFrameArrived(long long timestamp)
 {
-    if (!m_initialized)
+    if (m_frameEvent)
     {
-        SetLastError("Session not initialized");
-        return false;
+        SetEvent(m_frameEvent);
     }
 
-    if (!m_captureSession)
+    std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+    if (m_frameCallback)
     {
-        SetLastError("Capture session not created");
-        return false;
+        m_frameCallback(m_sessionId, timestamp, m_frameCallbackUserData);
     }
+}
 
-    try
+bool WindowsCaptureSession::AcceptFramePacing(long long timestamp)
+{
+    long long interval = (std::max)(m_minFrameIntervalTicks.load(std::memory_order_relaxed),
+        m_windowStateMinIntervalTicks.load(std::memory_order_relaxed));
+    if (m_streaming.load(std::memory_order_relaxed))
     {
-        // キャプチャを開始
-        m_captureSession.StartCapture();
+        interval = (std::max)(interval, m_streamMinIntervalTicks.load(std::memory_order_relaxed));
+    }
 
-        // フレーム待機
-        std::unique_lock<std::mutex> lock(m_frameMutex);
-        bool frameReceived = m_frameCondition.wait_for(
-            lock, 
-            std::chrono::milliseconds(timeoutMs),
-            [this] { return m_frameReady; }
-        );
+    if (interval <= 0)
+    {
+        m_nextFrameDueTicks = 0;
+        return true;
+    }
 
-        if (!frameReceived)
-        {
-            SetLastError("Frame capture timeout");
-            return false;
-        }
+    if (m_nextFrameDueTicks != 0 && timestamp + kFramePacingToleranceTicks < m_nextFrameDueTicks)
+    {
+        return false;
+    }
 
-        // フレーム情報を設定
-        *width = m_frameWidth;
-        *height = m_frameHeight;
-        *timestamp = m_frameTimestamp;
+    // 予定時刻を間隔ずつ進めて平均レートを保つ（1間隔以上遅れた場合は今回の時刻から数え直す）
+    m_nextFrameDueTicks = (m_nextFrameDueTicks != 0 && timestamp - m_nextFrameDueTicks < interval)
+        ? m_nextFrameDueTicks + interval
+        : timestamp + interval;
+    return true;
+}
 
-        // テクスチャをBGRAデータに変換
-        if (!ConvertTextureToBGRA(m_latestFrame.Get(), bgraData, stride))
-        {
-            SetLastError("Failed to convert texture to BGRA");
-            return false;
-        }
+void WindowsCaptureSession::SetMinFrameInterval(int intervalMs)
+{
+    m_minFrameIntervalTicks.store(intervalMs > 0 ? static_cast<long long>(intervalMs) * 10000LL : 0);
+}
 
-        // フレーム状態をリセット
-        m_frameReady = false;
-        
-        return true;
+bool WindowsCaptureSession::DuplicateFrameEvent(HANDLE* duplicatedHandle)
+{
+    if (!duplicatedHandle)
+    {
+        SetLastError("Invalid event handle parameter");
+        return false;
     }
-    catch (const winrt::hresult_error& ex)
+    *duplicatedHandle = nullptr;
+
+    if (!m_initialized || !m_captureSession || !m_frameEvent)
     {
-        SetLastError("CaptureFrame winrt error: 0x" + std::to_string(ex.code()));
+        SetLastError("Session not initialized");
         return false;
     }
-    catch (const std::exception& ex)
+
+    // セッション解放後も呼び出し側の待機ハンドルが有効であるよう複製して渡す
+    HANDLE process = GetCurrentProcess();
+    if (!DuplicateHandle(process, m_frameEvent, process, duplicatedHandle, SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, 0))
     {
-        SetLastError(std::string("CaptureFrame exception: ") + ex.what());
+        m_lastHResult = HRESULT_FROM_WIN32(::GetLastError());
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE, HRESULT_FROM_WIN32(::GetLastError()), "DuplicateHandle failed for frame event");
         return false;
     }
-    catch (...)
+
+    try
     {
-        SetLastError("CaptureFrame unknown exception");
+        EnsureCaptureStarted();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        CloseHandle(*duplicatedHandle);
+        *duplicatedHandle = nullptr;
+        m_lastHResult = ex.code();
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_POOL, ex.code(), "StartCapture winrt error: 0x" + std::to_string(ex.code()));
         return false;
     }
+
+    return true;
 }
 
-bool WindowsCaptureSession::ConvertTextureToBGRA(ID3D11Texture2D* texture, unsigned char** bgraData, int* stride)
+bool WindowsCaptureSession::SetFrameCallback(BaketaCaptureFrameCallback callback, void* userData)
 {
-    try
+    if (!m_initialized || !m_captureSession)
     {
-        if (!texture || !bgraData || !stride)
-        {
-            SetLastError("Invalid parameters for texture conversion");
-            return false;
-        }
+        SetLastError("Session not initialized");
+        return false;
+    }
 
-        // テクスチャの詳細を取得
-        D3D11_TEXTURE2D_DESC desc;
-        texture->GetDesc(&desc);
+    {
+        // 進行中のコールバックが終わるまでロックで待機してから差し替える
+        std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+        m_frameCallback = callback;
+        m_frameCallbackUserData = userData;
+    }
 
-        // 🔍🔍🔍 デバッグ: テクスチャ詳細情報をログ出力
-        std::string windowInfo, screenRect;
-        GetWindowDebugInfo(windowInfo, screenRect);
-        
-        char debugBuffer[1024];
-        sprintf_s(debugBuffer, sizeof(debugBuffer),
-            "DEBUG: ConvertTextureToBGRA - %s | %s | Texture=%dx%d, Format=0x%08X, Usage=%d",
-            windowInfo.c_str(),
-            screenRect.c_str(),
-            desc.Width,
-            desc.Height,
-            static_cast<UINT>(desc.Format),
-            static_cast<UINT>(desc.Usage)
-        );
-        SetLastError(std::string(debugBuffer));
-
-        // ステージングテクスチャを作成（CPU読み取り可能）
-        D3D11_TEXTURE2D_DESC stagingDesc = {};
-        stagingDesc.Width = desc.Width;
-        stagingDesc.Height = desc.Height;
-        stagingDesc.MipLevels = 1;
-        stagingDesc.ArraySize = 1;
-        stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-        stagingDesc.Usage = D3D11_USAGE_STAGING;
-        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-        stagingDesc.SampleDesc.Count = 1;
-        stagingDesc.SampleDesc.Quality = 0;
-
-        ComPtr<ID3D11Texture2D> stagingTexture;
-        HRESULT hr = m_d3dDevice->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture);
-        if (FAILED(hr))
+    if (callback)
+    {
+        try
         {
-            SetLastError("Failed to create staging texture");
-            return false;
+            EnsureCaptureStarted();
         }
-
-        // GPU テクスチャを CPU アクセス可能なステージングテクスチャにコピー
-        m_d3dContext->CopyResource(stagingTexture.Get(), texture);
-
-        // ステージングテクスチャをマップしてCPUから読み取り
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        hr = m_d3dContext->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
-        if (FAILED(hr))
+        catch (const winrt::hresult_error& ex)
         {
-            SetLastError("Failed to map staging texture");
+            m_lastHResult = ex.code();
+            SetLastError(BAKETA_CAPTURE_STAGE_FRAME_POOL, ex.code(), "StartCapture winrt error: 0x" + std::to_string(ex.code()));
             return false;
         }
+    }
 
-        // 🚀 P2最適化: Row Stride計算とメモリアライメント改善
-        // 安全なRow Strideを計算（16バイトアライメント考慮）
-        UINT pixelRowBytes = desc.Width * 4; // BGRA = 4 bytes per pixel
-        UINT alignedStride = ((pixelRowBytes + 15) / 16) * 16; // 16バイトアライメント
-        
-        // GPU Row Pitchとの整合性チェック
-        UINT actualRowPitch = static_cast<UINT>(mappedResource.RowPitch);
-        UINT safeStride = (actualRowPitch >= alignedStride) ? actualRowPitch : alignedStride;
-        
-        *stride = static_cast<int>(safeStride);
-        size_t dataSize = desc.Height * safeStride;
-        
-        // 🚀 P2最適化: アライメント済みメモリ確保
-        *bgraData = static_cast<unsigned char*>(_aligned_malloc(dataSize, 16));
+    return true;
+}
 
-        if (!(*bgraData))
-        {
-            m_d3dContext->Unmap(stagingTexture.Get(), 0);
-            SetLastError("P2: Failed to allocate aligned BGRA data memory");
-            return false;
-        }
+void WindowsCaptureSession::EnsureCaptureStarted()
+{
+    if (m_captureStarted.load())
+    {
+        return;
+    }
 
-        // 🔍🔍🔍 P2デバッグ: 最適化されたRow Stride情報
-        char strideBuffer[512];
-        sprintf_s(strideBuffer, sizeof(strideBuffer),
-            "P2_DEBUG: GPURowPitch=%d, PixelRowBytes=%d, AlignedStride=%d, SafeStride=%d, TotalSize=%zu, Aligned16=%s",
-            actualRowPitch,
-            pixelRowBytes, 
-            alignedStride,
-            safeStride,
-            dataSize,
-            ((reinterpret_cast<uintptr_t>(*bgraData) % 16) == 0) ? "YES" : "NO"
-        );
-        
-        // ピクセルデータをコピー
-        const unsigned char* srcData = static_cast<const unsigned char*>(mappedResource.pData);
-        unsigned char* dstData = *bgraData;
-        
-        // 🔍🔍🔍 デバッグ: 最初の数ピクセルをサンプリング（コピー前）
-        std::string pixelSamples = "SrcPixels: ";
-        UINT maxPixels = (desc.Width < 5U) ? desc.Width : 5U;
-        for (UINT i = 0; i < maxPixels; ++i)
-        {
-            if (srcData && (i * 4 + 3) < static_cast<UINT>(mappedResource.RowPitch))
-            {
-                char pixelBuffer[32];
-                sprintf_s(pixelBuffer, sizeof(pixelBuffer), "[%02X,%02X,%02X,%02X] ",
-                    srcData[i * 4 + 0], // B
-                    srcData[i * 4 + 1], // G  
-                    srcData[i * 4 + 2], // R
-                    srcData[i * 4 + 3]  // A
-                );
-                pixelSamples += pixelBuffer;
-            }
-        }
+    std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+    StartCaptureLocked();
+}
 
-        // 🚀 P2最適化: 効率的な行ごとコピー（アライメント考慮）
-        for (UINT y = 0; y < desc.Height; ++y)
-        {
-            // 16バイトアライメント済みメモリへの高速コピー
-            unsigned char* dstRowPtr = dstData + y * safeStride;
-            const unsigned char* srcRowPtr = srcData + y * actualRowPitch;
-            
-            // より安全なピクセルデータコピー（最小サイズを使用）
-            UINT bytesToCopy = (pixelRowBytes <= actualRowPitch) ? pixelRowBytes : actualRowPitch;
-            memcpy(dstRowPtr, srcRowPtr, bytesToCopy);
-            
-            // アライメントパディング領域をゼロクリア
-            if (safeStride > bytesToCopy) {
-                memset(dstRowPtr + bytesToCopy, 0, safeStride - bytesToCopy);
-            }
-        }
-        
-        // 🔍🔍🔍 デバッグ: コピー後の最初の数ピクセルを確認
-        std::string copiedPixels = "DstPixels: ";
-        for (UINT i = 0; i < maxPixels; ++i)
-        {
-            if (dstData && (i * 4 + 3) < static_cast<UINT>(*stride))
-            {
-                char pixelBuffer[32];
-                sprintf_s(pixelBuffer, sizeof(pixelBuffer), "[%02X,%02X,%02X,%02X] ",
-                    dstData[i * 4 + 0], // B
-                    dstData[i * 4 + 1], // G
-                    dstData[i * 4 + 2], // R
-                    dstData[i * 4 + 3]  // A
-                );
-                copiedPixels += pixelBuffer;
-            }
-        }
-        
-        // 統合デバッグ情報を設定
-        std::string combinedDebug = std::string(strideBuffer) + " | " + pixelSamples + " | " + copiedPixels;
-        SetLastError(combinedDebug);
+void WindowsCaptureSession::StartCaptureLocked()
+{
+    if (m_captureStarted.load() || !m_captureSession)
+    {
+        return;
+    }
 
-        // テクスチャのマップを解除
-        m_d3dContext->Unmap(stagingTexture.Get(), 0);
+    if (m_suspended.load())
+    {
+        // 停止中は復帰時に開始する
+        m_resumeCapture = true;
+        return;
+    }
+
+    if (m_captureSessionClosed)
+    {
+        // 停止時に閉じたセッションは再開できないため、同じフレームプールから作り直す
+        m_captureSession = m_framePool.CreateCaptureSession(m_captureItem);
+        m_captureSessionClosed = false;
+        ApplyCaptureSessionSettingsLocked();
+    }
+
+    m_captureSession.StartCapture();
+    m_captureStarted.store(true);
+}
+
+bool WindowsCaptureSession::StartStreaming(int maxFps, int poolDepth)
+{
+    if (m_frameSource)
+    {
+        // フレームプールは同じモニターの領域セッションで共有しているため、セッション単位では切り替えない
+        SetLastError("Streaming is not supported for monitor region sessions");
+        return false;
+    }
+
+    if (IsReplay())
+    {
+        SetLastError("Streaming is not supported for replay sessions");
+        return false;
+    }
+
+    if (!m_initialized || !m_framePool || !m_captureSession || !m_captureItem)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    m_streamMinIntervalTicks.store(maxFps > 0 ? 10000000LL / maxFps : 0);
 
+    if (m_streaming.load())
+    {
+        // 既にストリーミング中 - フレームレート上限のみ更新
         return true;
     }
-    catch (const std::exception& ex)
+
+    int depth = poolDepth > 0 ? poolDepth : kDefaultStreamingPoolDepth;
+    depth = (std::max)(kDefaultStreamingPoolDepth, (std::min)(depth, kMaxStreamingPoolDepth));
+
+    try
     {
-        SetLastError(std::string("ConvertTextureToBGRA exception: ") + ex.what());
+        // 通常モードの単一フレームは以後参照しない
+        std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+        RecreateFramePoolLocked(depth, m_captureItem.Size());
+
+        m_nextFrameDueTicks = 0;
+        m_streaming.store(true);
+        StartCaptureLocked();
+        return true;
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        m_streaming.store(false);
+        m_lastHResult = ex.code();
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_POOL, ex.code(), "StartStreaming winrt error: 0x" + std::to_string(ex.code()));
         return false;
     }
     catch (...)
     {
-        SetLastError("ConvertTextureToBGRA unknown exception");
+        m_streaming.store(false);
+        SetLastError("StartStreaming unknown exception");
         return false;
     }
 }
 
-void WindowsCaptureSession::SetLastError(const std::string& message)
+void WindowsCaptureSession::StopStreaming()
 {
-    m_lastError = message;
+    if (!m_streaming.exchange(false))
+    {
+        return;
+    }
+
+    // 最初のフレームを待機中の読み出し側を起こし、進行中のコールバック完了を待つ
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+    }
+    m_frameCondition.notify_all();
+    WaitForStreamCallbacks();
+
+    {
+        std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+        m_mailbox.Reset();
+        m_resizeCache.ReleaseSourceViews();
+    }
+
+    // フレームプールを通常モードの単一バッファに戻す
+    if (m_framePool && m_captureItem && !m_isClosing.load())
+    {
+        try
+        {
+            std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+            RecreateFramePoolLocked(1, m_captureItem.Size());
+        }
+        catch (...) { /* 例外を無視（次回キャプチャで検出される） */ }
+    }
 }
 
-/// <summary>
-/// 🔍 Phase 0 WGC修復: ウィンドウ状態をキャプチャ用に検証
-/// </summary>
-bool WindowsCaptureSession::ValidateWindowStateForCapture()
+bool WindowsCaptureSession::AcquireStreamingFrame(int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
 {
-    if (!m_hwnd)
+    const MailboxFrame* latest = m_mailbox.AcquireLatest();
+    if (!latest)
     {
-        SetLastError("Invalid window handle for validation");
+        // まだ一度もフレームが公開されていない場合のみ待機
+        std::unique_lock<std::mutex> lock(m_frameMutex);
+        m_streamWaiters.fetch_add(1);
+        m_frameCondition.wait_for(
+            lock,
+            std::chrono::milliseconds(timeoutMs),
+            [this] { return m_mailbox.GetPublishedCount() > 0 || !m_streaming.load() || m_isClosing.load() || m_suspended.load(); }
+        );
+        m_streamWaiters.fetch_sub(1);
+        lock.unlock();
+
+        latest = m_streaming.load() ? m_mailbox.AcquireLatest() : nullptr;
+    }
+
+    if (!latest)
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_TIMEOUT), "Frame capture timeout");
         return false;
     }
 
-    try
+    // スロットは次の AcquireLatest() まで読み出し側専有のため、書き込み側に上書きされない
+    texture = latest->texture;
+    *width = latest->width;
+    *height = latest->height;
+    *timestamp = latest->timestamp;
+    if (sequence)
     {
-        // 1. ウィンドウの存在確認
-        if (!IsWindow(m_hwnd))
-        {
-            SetLastError("Window no longer exists");
-            return false;
-        }
+        *sequence = latest->sequence;
+    }
+    return true;
+}
 
-        // 2. ウィンドウの可視性確認
-        if (!IsWindowVisible(m_hwnd))
-        {
-            SetLastError("Window is not visible - may cause white image capture");
-            return false;
-        }
+bool WindowsCaptureSession::AcquireFrameForReadback(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence, bool keepHdrSource)
+{
+    unsigned long long frameSequence = 0;
+    if (!AcquireCapturedFrame(timeoutMs, readbackLock, texture, width, height, timestamp, &frameSequence))
+    {
+        return false;
+    }
+    if (sequence)
+    {
+        *sequence = frameSequence;
+    }
 
-        // 3. ウィンドウの最小化状態確認
-        if (IsIconic(m_hwnd))
-        {
-            SetLastError("Window is minimized - Graphics Capture will return white image");
-            return false;
-        }
+    // 呼び出し側バッファの容量を次回の読み出し前に確認できるよう、フレームサイズを覚えておく
+    m_lastReadbackWidth.store(*width);
+    m_lastReadbackHeight.store(*height);
 
-        // 4. ウィンドウのサイズ確認
-        RECT windowRect;
-        if (!GetWindowRect(m_hwnd, &windowRect))
-        {
-            SetLastError("Failed to get window rectangle");
-            return false;
-        }
+    // FP16 フレームは BGRA 前提の経路（コピー・コンピュートシェーダー・CPU 処理）向けに SDR へ変換しておく
+    if (!keepHdrSource && !ResolveSdrFrame(texture))
+    {
+        return false;
+    }
 
-        int width = windowRect.right - windowRect.left;
-        int height = windowRect.bottom - windowRect.top;
-        if (width <= 0 || height <= 0)
+    // 記録は読み出し経路によらず等倍の SDR フレーム（HDR ソースを保持する経路ではトーンマップした複製を記録する）
+    if (m_recording.load(std::memory_order_relaxed))
+    {
+        ComPtr<ID3D11Texture2D> recordTexture = texture;
+        if (!keepHdrSource || ResolveSdrFrame(recordTexture))
         {
-            SetLastError("Invalid window dimensions - zero or negative size");
-            return false;
+            RecordFrameLocked(recordTexture.Get(), *width, *height, *timestamp, frameSequence);
         }
+    }
+    return true;
+}
 
-        if (width > 7680 || height > 4320) // 8K解像度以上はメモリ不足の可能性
-        {
-            char sizeWarning[256];
-            sprintf_s(sizeWarning, sizeof(sizeWarning), 
-                "Extremely large window detected (%dx%d) - may cause memory issues", width, height);
-            SetLastError(std::string(sizeWarning));
+bool WindowsCaptureSession::ResolveSdrFrame(ComPtr<ID3D11Texture2D>& texture)
+{
+    D3D11_TEXTURE2D_DESC desc;
+    texture->GetDesc(&desc);
+    if (desc.Format != DXGI_FORMAT_R16G16B16A16_FLOAT)
+    {
+        return true;
+    }
+
+    // リサイズシェーダーを等倍で通し、トーンマップ済みの BGRA レンダーターゲットに差し替える
+    ComPtr<ID3D11Texture2D> sdrTexture;
+    long long stageStart = CaptureStats::Now();
+    bool converted = GpuResizeTexture(texture.Get(), static_cast<int>(desc.Width), static_cast<int>(desc.Height), sdrTexture);
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_GPU_RESIZE, stageStart);
+    if (!converted)
+    {
+        return false;
+    }
+
+    texture = sdrTexture;
+    return true;
+}
+
+bool WindowsCaptureSession::AcquireCapturedFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
+{
+    // 共有デバイスが削除された場合はセッションを無効化（次の CreateSession で新しいデバイスに作り直される）
+    HRESULT removedReason = S_OK;
+    if (m_deviceLost.load() || D3DDeviceManager::Instance().CheckDeviceRemoved(m_sharedDevice, &removedReason))
+    {
+        if (!m_deviceLost.exchange(true))
+        {
+            m_lastHResult = removedReason;
+        }
+        SetLastError(BAKETA_CAPTURE_STAGE_DEVICE, m_lastHResult, "D3D device removed - session must be recreated");
+        return false;
+    }
+
+    // 最小化・クローク中は新しいフレームが届かないため待機せずに戻る
+    if (m_suspended.load())
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_NOT_READY), "Capture suspended - window is minimized, cloaked or hidden");
+        return false;
+    }
+
+    StageTimer waitTimer(m_stats, BAKETA_CAPTURE_TIMING_FRAME_WAIT);
+    if (m_frameSource)
+    {
+        return AcquireSourceFrame(timeoutMs, readbackLock, texture, width, height, timestamp, sequence);
+    }
+
+    if (m_replay)
+    {
+        return AcquireReplayFrame(timeoutMs, readbackLock, texture, width, height, timestamp, sequence);
+    }
+
+    if (m_streaming.load())
+    {
+        // ストリーミングモード: 読み出しロック下でメールボックスの front を確保（待機なし）
+        readbackLock.lock();
+        if (m_streaming.load())
+        {
+            return AcquireStreamingFrame(timeoutMs, texture, width, height, timestamp, sequence);
+        }
+        readbackLock.unlock();
+    }
+
+    // 通常モード: フレーム待機（フレームミューテックスは取得後すぐに解放される）
+    if (!WaitForLatestFrame(timeoutMs, texture, width, height, timestamp, sequence))
+    {
+        return false;
+    }
+
+    readbackLock.lock();
+    return true;
+}
+
+bool WindowsCaptureSession::AcquireSourceFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
+{
+    ComPtr<ID3D11Texture2D> sourceTexture;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    unsigned long long sourceSequence = 0;
+    if (!m_frameSource->WaitForFrameAfter(m_lastSourceSequence.load(), timeoutMs, sourceTexture, &sourceWidth, &sourceHeight, timestamp, &sourceSequence))
+    {
+        return false;
+    }
+
+    readbackLock.lock();
+    m_lastSourceSequence.store(sourceSequence);
+    if (sequence)
+    {
+        *sequence = sourceSequence;
+    }
+
+    if (!m_hasCropRect)
+    {
+        texture = sourceTexture;
+        *width = sourceWidth;
+        *height = sourceHeight;
+        return true;
+    }
+
+    // 切り出し矩形をフレーム内にクランプ（モニターの解像度変更に追従）
+    RECT crop = {
+        (std::max)(0L, m_cropRect.left),
+        (std::max)(0L, m_cropRect.top),
+        (std::min)(static_cast<LONG>(sourceWidth), m_cropRect.right),
+        (std::min)(static_cast<LONG>(sourceHeight), m_cropRect.bottom)
+    };
+    if (crop.right <= crop.left || crop.bottom <= crop.top)
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, E_INVALIDARG, "Crop rectangle is outside the captured monitor");
+        return false;
+    }
+
+    UINT cropWidth = static_cast<UINT>(crop.right - crop.left);
+    UINT cropHeight = static_cast<UINT>(crop.bottom - crop.top);
+
+    // 切り出し先テクスチャはサイズが変わらない限り再利用（後段のリサイズ・ROI・変換経路がそのまま使える）
+    D3D11_TEXTURE2D_DESC cropDesc = {};
+    if (m_cropTexture)
+    {
+        m_cropTexture->GetDesc(&cropDesc);
+    }
+    if (!m_cropTexture || cropDesc.Width != cropWidth || cropDesc.Height != cropHeight)
+    {
+        D3D11_TEXTURE2D_DESC sourceDesc;
+        sourceTexture->GetDesc(&sourceDesc);
+
+        cropDesc = {};
+        cropDesc.Width = cropWidth;
+        cropDesc.Height = cropHeight;
+        cropDesc.MipLevels = 1;
+        cropDesc.ArraySize = 1;
+        cropDesc.Format = sourceDesc.Format;
+        cropDesc.SampleDesc.Count = 1;
+        cropDesc.Usage = D3D11_USAGE_DEFAULT;
+        cropDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        m_cropTexture.Reset();
+        HRESULT hr = m_d3dDevice->CreateTexture2D(&cropDesc, nullptr, &m_cropTexture);
+        if (FAILED(hr))
+        {
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create crop texture");
+            return false;
+        }
+    }
+
+    D3D11_BOX box = {
+        static_cast<UINT>(crop.left), static_cast<UINT>(crop.top), 0,
+        static_cast<UINT>(crop.right), static_cast<UINT>(crop.bottom), 1
+    };
+    m_d3dContext->CopySubresourceRegion(m_cropTexture.Get(), 0, 0, 0, 0, sourceTexture.Get(), 0, &box);
+
+    texture = m_cropTexture;
+    *width = static_cast<int>(cropWidth);
+    *height = static_cast<int>(cropHeight);
+    return true;
+}
+
+bool WindowsCaptureSession::AcquireReplayFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
+{
+    // 再生位置とアップロード先は読み出しロック下で進める（単一の再生位置を複数の呼び出し側で取り合わない）
+    readbackLock.lock();
+
+    const int frameCount = m_replay->FrameCount();
+    if (m_replayNextIndex >= frameCount)
+    {
+        if (!(m_replayFlags & BAKETA_CAPTURE_REPLAY_LOOP))
+        {
+            readbackLock.unlock();
+            SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_HANDLE_EOF), "Replay reached the end of the recording");
+            return false;
+        }
+        m_replayNextIndex = 0;
+        ++m_replayLoop;
+        m_replayStartTicks = 0;
+    }
+
+    // 早さの異なる周回をまたいでも単調増加する通し番号（DirtyRegions 履歴・読み出し済み判定に使う）
+    auto sequenceOf = [this, frameCount](int index)
+    {
+        return static_cast<unsigned long long>(m_replayLoop) * static_cast<unsigned long long>(frameCount) + static_cast<unsigned long long>(index) + 1;
+    };
+
+    const long long firstTimestamp = m_replay->GetFrame(0).header->timestamp;
+    int index = m_replayNextIndex;
+    if (!(m_replayFlags & BAKETA_CAPTURE_REPLAY_MAX_SPEED))
+    {
+        // 記録時の提示間隔どおりに出す（読み出しが遅れた分は WGC と同様に最新のフレームまで読み飛ばす）
+        auto dueTicks = [this, firstTimestamp](int frameIndex)
+        {
+            return m_replayStartTicks + (m_replay->GetFrame(frameIndex).header->timestamp - firstTimestamp);
+        };
+
+        long long now = GetFrameTimestampTicks();
+        if (m_replayStartTicks == 0)
+        {
+            m_replayStartTicks = now - (m_replay->GetFrame(index).header->timestamp - firstTimestamp);
+        }
+
+        while (index + 1 < frameCount && dueTicks(index + 1) <= now)
+        {
+            RecordReplayDirtyRegions(index, sequenceOf(index));
+            m_stats.CountArrived();
+            m_stats.CountDropped();
+            ++index;
+        }
+        m_replayNextIndex = index;
+
+        long long waitTicks = dueTicks(index) - now;
+        if (waitTicks > static_cast<long long>((std::max)(0, timeoutMs)) * 10000)
+        {
+            readbackLock.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds((std::max)(0, timeoutMs)));
+            SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_TIMEOUT), "Frame capture timeout");
+            return false;
+        }
+        if (waitTicks > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(waitTicks / 10));
+        }
+    }
+
+    unsigned long long frameSequence = sequenceOf(index);
+    RecordReplayDirtyRegions(index, frameSequence);
+    m_stats.CountArrived();
+    if (!UploadReplayFrame(index, frameSequence))
+    {
+        readbackLock.unlock();
+        return false;
+    }
+    m_replayNextIndex = index + 1;
+
+    // 周回ごとに記録全体の長さ（+ 平均フレーム間隔）だけ提示時刻をずらし、単調増加を保つ
+    const FrameRecording::FrameHeader* header = m_replay->GetFrame(index).header;
+    long long span = m_replay->GetFrame(frameCount - 1).header->timestamp - firstTimestamp;
+    long long loopTicks = frameCount > 1 ? span + span / (frameCount - 1) : kReplaySingleFrameIntervalTicks;
+
+    texture = m_replayTexture;
+    *width = header->width;
+    *height = header->height;
+    *timestamp = header->timestamp + m_replayLoop * loopTicks;
+    if (sequence)
+    {
+        *sequence = frameSequence;
+    }
+    return true;
+}
+
+void WindowsCaptureSession::RecordReplayDirtyRegions(int index, unsigned long long sequence)
+{
+    const FrameReplayReader::Frame& frame = m_replay->GetFrame(index);
+
+    // 周回の先頭フレームは直前の周回の最後のフレームとの差分を持たない
+    bool fullFrame = (frame.header->flags & FrameRecording::kFrameFullFrame) != 0 || index == 0 ||
+        frame.header->rectCount > DirtyRegionTracker::kMaxRectsPerFrame;
+
+    std::array<RECT, DirtyRegionTracker::kMaxRectsPerFrame> rects{};
+    int rectCount = fullFrame ? 0 : frame.header->rectCount;
+    for (int i = 0; i < rectCount; ++i)
+    {
+        const BaketaCaptureRect& rect = frame.rects[i];
+        rects[i] = { rect.x, rect.y, rect.x + rect.width, rect.y + rect.height };
+    }
+    m_dirtyTracker.Record(sequence, rects.data(), rectCount, fullFrame);
+}
+
+bool WindowsCaptureSession::UploadReplayFrame(int index, unsigned long long sequence)
+{
+    const FrameRecording::FrameHeader* header = m_replay->GetFrame(index).header;
+    const UINT frameWidth = static_cast<UINT>(header->width);
+    const UINT frameHeight = static_cast<UINT>(header->height);
+    const int packedStride = header->width * 4;
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    if (m_replayTexture)
+    {
+        m_replayTexture->GetDesc(&desc);
+    }
+    bool recreate = !m_replayTexture || desc.Width != frameWidth || desc.Height != frameHeight;
+
+    // 直前にアップロードしたフレームからの変化矩形が揃っていればその部分だけ転送する（変化なしなら展開も省く）
+    std::vector<RECT> rects;
+    bool partial = !recreate && m_replayUploadedSequence != 0 &&
+        m_dirtyTracker.Collect(m_replayUploadedSequence, sequence, rects);
+    if (partial && rects.empty())
+    {
+        m_replayUploadedSequence = sequence;
+        return true;
+    }
+
+    HRESULT hr = S_OK;
+    m_replayPixels.resize(header->rawBytes);
+    if (!m_replay->Decode(index, m_replayPixels.data(), packedStride, &hr))
+    {
+        m_lastHResult = hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, hr, "Failed to decode replay frame");
+        return false;
+    }
+
+    if (recreate)
+    {
+        desc = {};
+        desc.Width = frameWidth;
+        desc.Height = frameHeight;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        D3D11_SUBRESOURCE_DATA initialData = {};
+        initialData.pSysMem = m_replayPixels.data();
+        initialData.SysMemPitch = static_cast<UINT>(packedStride);
+
+        m_replayTexture.Reset();
+        m_replayUploadedSequence = 0;
+        hr = m_d3dDevice->CreateTexture2D(&desc, &initialData, &m_replayTexture);
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, hr, "Failed to create replay texture");
+            return false;
+        }
+    }
+    else if (partial)
+    {
+        for (const auto& rect : rects)
+        {
+            D3D11_BOX box = {
+                static_cast<UINT>(rect.left), static_cast<UINT>(rect.top), 0,
+                static_cast<UINT>(rect.right), static_cast<UINT>(rect.bottom), 1
+            };
+            const unsigned char* source = m_replayPixels.data() + static_cast<size_t>(rect.top) * packedStride + static_cast<size_t>(rect.left) * 4;
+            m_d3dContext->UpdateSubresource(m_replayTexture.Get(), 0, &box, source, static_cast<UINT>(packedStride), 0);
+        }
+    }
+    else
+    {
+        m_d3dContext->UpdateSubresource(m_replayTexture.Get(), 0, nullptr, m_replayPixels.data(), static_cast<UINT>(packedStride), 0);
+    }
+
+    m_replayUploadedSequence = sequence;
+    return true;
+}
+
+bool WindowsCaptureSession::StartRecording(const wchar_t* path, HRESULT* hr)
+{
+    if (!m_initialized || !m_d3dDevice)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    auto writer = FrameRecordingWriter::Create(path, hr);
+    if (!writer)
+    {
+        m_lastHResult = *hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE, *hr, "Failed to create capture recording");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> recordLock(m_recordMutex);
+    if (m_recordWriter)
+    {
+        m_recordWriter->Finish();
+    }
+    m_recordWriter = std::move(writer);
+    m_recordLastSequence = 0;
+    m_recordResult = S_OK;
+    m_recording.store(true);
+    return true;
+}
+
+bool WindowsCaptureSession::StopRecording(int* frameCount, HRESULT* hr)
+{
+    *frameCount = 0;
+
+    std::lock_guard<std::mutex> recordLock(m_recordMutex);
+    m_recording.store(false);
+    if (!m_recordWriter)
+    {
+        *hr = S_OK;
+        SetLastError("Recording not started");
+        return false;
+    }
+
+    // 書き込み待ちのフレームを書き出してからインデックスを書く
+    bool finished = m_recordWriter->Finish(frameCount, hr);
+    if (SUCCEEDED(m_recordResult))
+    {
+        m_recordResult = m_recordWriter->GetResult();
+    }
+    m_recordWriter.reset();
+    m_recordStaging.Reset();
+
+    if (!finished)
+    {
+        m_lastHResult = *hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_CAPTURE, *hr, "Failed to finalize capture recording");
+        return false;
+    }
+    if (FAILED(m_recordResult))
+    {
+        // 失敗したフレーム以降は記録していない（それまでのフレームはファイルに残る）
+        *hr = m_recordResult;
+        m_lastHResult = m_recordResult;
+        SetLastError(BAKETA_CAPTURE_STAGE_READBACK, m_recordResult, "Recording stopped early - failed to write a frame");
+        return false;
+    }
+    return true;
+}
+
+void WindowsCaptureSession::RecordFrameLocked(ID3D11Texture2D* texture, int width, int height, long long timestamp, unsigned long long sequence)
+{
+    std::lock_guard<std::mutex> recordLock(m_recordMutex);
+
+    // 同じフレームを複数回読み出した場合（領域セッションの再読み出し等）は1回だけ記録する
+    if (!m_recording.load() || !m_recordWriter || sequence == m_recordLastSequence)
+    {
+        return;
+    }
+
+    // 書き込みスレッドが失敗した場合は以降のフレームを記録しない
+    if (FAILED(m_recordWriter->GetResult()))
+    {
+        m_recording.store(false);
+        return;
+    }
+
+    // 前回記録したフレームからの変化矩形（DirtyRegions 無効時・履歴が欠けた場合は全体変化として記録）
+    std::vector<RECT> rects;
+    bool fullFrame = m_recordLastSequence == 0 || !m_dirtyTracker.Collect(m_recordLastSequence, sequence, rects);
+
+    // 読み出し中に行うのはステージングコピーとキューへのコピーのみ（圧縮・書き込みは書き込みスレッドで行う）
+    HRESULT hr = S_OK;
+    bool queued = false;
+    bool staged = m_recordStaging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), texture,
+        static_cast<UINT>(width), static_cast<UINT>(height), DXGI_FORMAT_B8G8R8A8_UNORM, &hr);
+    if (staged)
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        hr = m_recordStaging.Map(m_d3dContext.Get(), &mapped);
+        if (SUCCEEDED(hr))
+        {
+            queued = m_recordWriter->Enqueue(static_cast<const unsigned char*>(mapped.pData), width, height, static_cast<int>(mapped.RowPitch),
+                timestamp, sequence, rects.data(), static_cast<int>(rects.size()), fullFrame);
+            m_recordStaging.Unmap(m_d3dContext.Get());
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        // 途中のフレームが欠けると変化矩形が繋がらないため、以降は記録しない
+        m_recordResult = hr;
+        m_recording.store(false);
+        return;
+    }
+
+    // 書き込みが追いつかずキューが満杯の場合はこのフレームを記録しない
+    // （次のフレームの変化矩形は最後に受け付けたフレームから求めるため、記録済みの列は繋がったまま）
+    if (queued)
+    {
+        m_recordLastSequence = sequence;
+    }
+}
+
+bool WindowsCaptureSession::WaitForFrameAfter(unsigned long long afterSequence, int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
+{
+    if (!m_initialized || !m_captureSession)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    EnsureCaptureStarted();
+
+    std::unique_lock<std::mutex> lock(m_frameMutex);
+    bool frameReceived = m_frameCondition.wait_for(
+        lock,
+        std::chrono::milliseconds(timeoutMs),
+        [this, afterSequence] { return (m_latestFrame && m_frameSequence > afterSequence) || m_isClosing.load(); }
+    );
+
+    if (!frameReceived || !m_latestFrame || m_isClosing.load())
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_TIMEOUT), "Frame capture timeout");
+        return false;
+    }
+
+    // フレームは消費しない（同じモニターの他の領域セッションも同じフレームを読み出す）
+    texture = m_latestFrame;
+    *width = m_frameWidth;
+    *height = m_frameHeight;
+    *timestamp = m_frameTimestamp;
+    *sequence = m_frameSequence;
+    return true;
+}
+
+bool WindowsCaptureSession::WaitForLatestFrame(int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence)
+{
+    // キャプチャを開始（初回のみ）
+    EnsureCaptureStarted();
+
+    // フレーム待機
+    std::unique_lock<std::mutex> lock(m_frameMutex);
+    bool frameReceived = m_frameCondition.wait_for(
+        lock,
+        std::chrono::milliseconds(timeoutMs),
+        [this] { return m_frameReady || m_suspended.load(); }
+    );
+
+    if (m_suspended.load())
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_NOT_READY), "Capture suspended - window is minimized, cloaked or hidden");
+        return false;
+    }
+
+    if (!frameReceived || !m_latestFrame)
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_WAIT, HRESULT_FROM_WIN32(ERROR_TIMEOUT), "Frame capture timeout");
+        return false;
+    }
+
+    // フレーム情報を取得してフレーム状態をリセット
+    // テクスチャの参照を保持したままロックを解放し、読み出し中も次フレームを受け付ける
+    texture = m_latestFrame;
+    *width = m_frameWidth;
+    *height = m_frameHeight;
+    *timestamp = m_frameTimestamp;
+    if (sequence)
+    {
+        *sequence = m_frameSequence;
+    }
+    m_frameReady = false;
+
+    return true;
+}
+
+bool WindowsCaptureSession::CaptureFrame(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int timeoutMs, CaptureOutputBuffer* outputBuffer)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        unsigned long long frameSequence = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, width, height, timestamp, &frameSequence))
+        {
+            return false;
+        }
+
+        // パイプライン読み出し: 次に到着するフレームは等倍でコピー発行しておく
+        PipelinedReadbackFrame pipelined = { frameSequence, *timestamp, *width, *height };
+        if (m_pipelinedReadback.load())
+        {
+            m_prefetchTargetWidth.store(0);
+            m_prefetchTargetHeight.store(0);
+            m_pipelinedFrame = &pipelined;
+        }
+
+        // テクスチャをBGRAデータに変換
+        m_outputBuffer = outputBuffer;
+        bool converted = ConvertTextureToBGRA(frameTexture.Get(), bgraData, stride);
+        m_outputBuffer = nullptr;
+        m_pipelinedFrame = nullptr;
+        if (!converted)
+        {
+            SetLastError(std::string("Failed to convert texture to BGRA: ") + GetLastError());
+            return false;
+        }
+
+        // 1 つ前のフレームを返した場合はそのフレームの提示時刻・通し番号
+        *timestamp = pipelined.timestamp;
+        if (sequence)
+        {
+            *sequence = pipelined.sequence;
+        }
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureFrame winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureFrame exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureFrame unknown exception");
+        return false;
+    }
+}
+
+size_t WindowsCaptureSession::ExpectedOutputBytes(int targetWidth, int targetHeight) const
+{
+    int width = m_lastReadbackWidth.load();
+    int height = m_lastReadbackHeight.load();
+    if (width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+
+    // ResizeAndConvertTextureToBGRA と同じくアスペクト比を維持して縮小のみ
+    if (targetWidth > 0 && targetHeight > 0 && (width > targetWidth || height > targetHeight))
+    {
+        FitToTarget(width, height, targetWidth, targetHeight, &width, &height);
+    }
+
+    return static_cast<size_t>(width) * 4 * static_cast<size_t>(height);
+}
+
+unsigned char* WindowsCaptureSession::AcquireOutputBuffer(int width, int height, int bytesPerPixel, int preferredStride, int* stride)
+{
+    if (m_outputBuffer)
+    {
+        // 呼び出し側バッファ: パディングなしで詰めて書き込む
+        int packedStride = width * bytesPerPixel;
+        size_t required = static_cast<size_t>(packedStride) * static_cast<size_t>(height);
+        *stride = packedStride;
+        if (!m_outputBuffer->data || m_outputBuffer->capacity < required)
+        {
+            m_outputBuffer->requiredSize = required;
+            return nullptr;
+        }
+        return m_outputBuffer->data;
+    }
+
+    *stride = preferredStride;
+    return FrameBufferPool::Instance().Acquire(width, height, preferredStride);
+}
+
+void WindowsCaptureSession::PrefetchReadback(ID3D11Texture2D* texture, unsigned long long sequence, long long timestamp)
+{
+    // 読み出し中はコピーを発行しない（コールバックを待たせず、読み出し側は同期コピーに戻る）
+    std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::try_to_lock);
+    if (!readbackLock.owns_lock() || !m_pipelinedReadback.load() || m_deviceLost.load() || m_isClosing.load())
+    {
+        return;
+    }
+
+    D3D11_TEXTURE2D_DESC desc;
+    texture->GetDesc(&desc);
+    if (desc.Format != DXGI_FORMAT_B8G8R8A8_UNORM)
+    {
+        // FP16 フレームは読み出し時にトーンマップする
+        return;
+    }
+
+    StagingTextureRing::FrameTag tag;
+    tag.sequence = sequence;
+    tag.timestamp = timestamp;
+    tag.sourceWidth = static_cast<int>(desc.Width);
+    tag.sourceHeight = static_cast<int>(desc.Height);
+    tag.width = tag.sourceWidth;
+    tag.height = tag.sourceHeight;
+
+    // 直近の読み出しと同じ目標サイズへ GPU 上で縮小してからコピーする（ResizeAndConvertTextureToBGRA と同じ判定）
+    ComPtr<ID3D11Texture2D> source = texture;
+    int targetWidth = m_prefetchTargetWidth.load();
+    int targetHeight = m_prefetchTargetHeight.load();
+    if (targetWidth > 0 && targetHeight > 0 && (tag.sourceWidth > targetWidth || tag.sourceHeight > targetHeight))
+    {
+        FitToTarget(tag.sourceWidth, tag.sourceHeight, targetWidth, targetHeight, &tag.width, &tag.height);
+        if (!GpuResizeTexture(texture, tag.width, tag.height, source))
+        {
+            return;
+        }
+    }
+
+    m_readbackRing.Issue(m_d3dDevice.Get(), m_d3dContext.Get(), source.Get(), tag);
+}
+
+bool WindowsCaptureSession::HasPrefetchedReadback(int width, int height) const
+{
+    return m_pipelinedFrame && m_readbackRing.Find(m_pipelinedFrame->sequence, width, height) >= 0;
+}
+
+HRESULT WindowsCaptureSession::MapForReadback(ID3D11Texture2D* texture, UINT width, UINT height, D3D11_MAPPED_SUBRESOURCE* mapped, int* slot)
+{
+    *slot = -1;
+    HRESULT hr = S_OK;
+    long long stageStart = CaptureStats::Now();
+
+    if (!m_pipelinedFrame)
+    {
+        // 同期読み出し: コピー発行直後のブロッキング Map で完了を待つ
+        bool staged = m_staging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), texture,
+            width, height, DXGI_FORMAT_B8G8R8A8_UNORM, &hr);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_COPY, stageStart);
+        if (!staged)
+        {
+            return FAILED(hr) ? hr : E_FAIL;
+        }
+
+        stageStart = CaptureStats::Now();
+        hr = m_staging.Map(m_d3dContext.Get(), mapped);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_MAP, stageStart);
+        return hr;
+    }
+
+    PipelinedReadbackFrame& frame = *m_pipelinedFrame;
+    int outputWidth = static_cast<int>(width);
+    int outputHeight = static_cast<int>(height);
+    int ringSlot = m_readbackRing.Find(frame.sequence, outputWidth, outputHeight);
+    if (ringSlot >= 0 && !m_readbackRing.IsReady(m_d3dContext.Get(), ringSlot))
+    {
+        // 最新フレームのコピーが未完了なら、完了済みで未返却の 1 つ前のフレームを待たずに返す
+        StagingTextureRing::FrameTag size;
+        size.sourceWidth = frame.sourceWidth;
+        size.sourceHeight = frame.sourceHeight;
+        size.width = outputWidth;
+        size.height = outputHeight;
+        int previous = m_readbackRing.FindNewestReady(m_d3dContext.Get(), m_lastPipelinedSequence, frame.sequence, size);
+        if (previous >= 0)
+        {
+            ringSlot = previous;
+        }
+    }
+
+    if (ringSlot < 0)
+    {
+        // 到着時に発行できなかったフレーム（読み出し中に到着・目標サイズの変更・FP16）はここで発行して待つ
+        StagingTextureRing::FrameTag tag;
+        tag.sequence = frame.sequence;
+        tag.timestamp = frame.timestamp;
+        tag.sourceWidth = frame.sourceWidth;
+        tag.sourceHeight = frame.sourceHeight;
+        tag.width = outputWidth;
+        tag.height = outputHeight;
+        ringSlot = texture ? m_readbackRing.Issue(m_d3dDevice.Get(), m_d3dContext.Get(), texture, tag, &hr) : -1;
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_COPY, stageStart);
+        if (ringSlot < 0)
+        {
+            return FAILED(hr) ? hr : E_FAIL;
+        }
+    }
+
+    stageStart = CaptureStats::Now();
+    hr = m_readbackRing.Map(m_d3dContext.Get(), ringSlot, mapped);
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_MAP, stageStart);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    const StagingTextureRing::FrameTag& tag = m_readbackRing.GetTag(ringSlot);
+    frame.sequence = tag.sequence;
+    frame.timestamp = tag.timestamp;
+    m_lastPipelinedSequence = (std::max)(m_lastPipelinedSequence, tag.sequence);
+    *slot = ringSlot;
+    return S_OK;
+}
+
+void WindowsCaptureSession::UnmapReadback(int slot)
+{
+    if (slot >= 0)
+    {
+        m_readbackRing.Unmap(m_d3dContext.Get(), slot);
+    }
+    else
+    {
+        m_staging.Unmap(m_d3dContext.Get());
+    }
+}
+
+bool WindowsCaptureSession::ConvertTextureToBGRA(ID3D11Texture2D* texture, unsigned char** bgraData, int* stride)
+{
+    try
+    {
+        if (!texture || !bgraData || !stride)
+        {
+            SetLastError("Invalid parameters for texture conversion");
+            return false;
+        }
+
+        // テクスチャの詳細を取得
+        D3D11_TEXTURE2D_DESC desc;
+        texture->GetDesc(&desc);
+
+        // 🔍🔍🔍 デバッグ: テクスチャ詳細情報をログ出力（詳細診断レベル時のみ）
+        if (CaptureDiagnostics::IsEnabled(BAKETA_CAPTURE_DIAG_VERBOSE))
+        {
+            std::string windowInfo, screenRect;
+            GetWindowDebugInfo(windowInfo, screenRect);
+
+            char debugBuffer[1024];
+            sprintf_s(debugBuffer, sizeof(debugBuffer),
+                "ConvertTextureToBGRA - %s | %s | Texture=%dx%d, Format=0x%08X, Usage=%d",
+                windowInfo.c_str(),
+                screenRect.c_str(),
+                desc.Width,
+                desc.Height,
+                static_cast<UINT>(desc.Format),
+                static_cast<UINT>(desc.Usage)
+            );
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, debugBuffer);
+        }
+
+        // GPU テクスチャをステージングテクスチャへコピーし、完了を待ってマップしてCPUから読み取り
+        // （サイズ不変の間は同じテクスチャを再利用、パイプライン読み出し中は到着時に発行済みのコピーを使う）
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        int stagingSlot = -1;
+        HRESULT hr = MapForReadback(texture, desc.Width, desc.Height, &mappedResource, &stagingSlot);
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to stage or map texture");
+            return false;
+        }
+
+        // 🚀 P2最適化: Row Stride計算とメモリアライメント改善
+        // 安全なRow Strideを計算（16バイトアライメント考慮）
+        UINT pixelRowBytes = desc.Width * 4; // BGRA = 4 bytes per pixel
+        UINT alignedStride = ((pixelRowBytes + 15) / 16) * 16; // 16バイトアライメント
+        
+        // GPU Row Pitchとの整合性チェック
+        UINT actualRowPitch = static_cast<UINT>(mappedResource.RowPitch);
+        UINT safeStride = (actualRowPitch >= alignedStride) ? actualRowPitch : alignedStride;
+        
+        // 🚀 P2最適化: アライメント済みメモリをプール（または呼び出し側バッファ）から取得
+        long long stageStart = CaptureStats::Now();
+        *bgraData = AcquireOutputBuffer(static_cast<int>(desc.Width), static_cast<int>(desc.Height), 4, static_cast<int>(safeStride), stride);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ALLOCATION, stageStart);
+        safeStride = static_cast<UINT>(*stride);
+        size_t dataSize = desc.Height * safeStride;
+
+        if (!(*bgraData))
+        {
+            UnmapReadback(stagingSlot);
+            SetLastError("P2: Failed to allocate aligned BGRA data memory");
+            return false;
+        }
+
+        // ピクセルデータをコピー
+        const unsigned char* srcData = static_cast<const unsigned char*>(mappedResource.pData);
+        unsigned char* dstData = *bgraData;
+
+        // 🚀 P2最適化: 行ごとコピー（ストリーミングロード・行バンド並列）
+        // より安全なピクセルデータコピー（最小サイズを使用）
+        UINT bytesToCopy = (pixelRowBytes <= actualRowPitch) ? pixelRowBytes : actualRowPitch;
+        stageStart = CaptureStats::Now();
+        CpuImageKernels::CopyPlane(srcData, actualRowPitch, dstData, safeStride, bytesToCopy, static_cast<int>(desc.Height));
+
+        // アライメントパディング領域をゼロクリア
+        if (safeStride > bytesToCopy)
+        {
+            for (UINT y = 0; y < desc.Height; ++y)
+            {
+                memset(dstData + y * safeStride + bytesToCopy, 0, safeStride - bytesToCopy);
+            }
+        }
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ROW_COPY, stageStart);
+
+        // 🔍🔍🔍 P2デバッグ: Row Stride情報とコピー前後のピクセルサンプル（詳細診断レベル時のみ）
+        if (CaptureDiagnostics::IsEnabled(BAKETA_CAPTURE_DIAG_VERBOSE))
+        {
+            char strideBuffer[512];
+            sprintf_s(strideBuffer, sizeof(strideBuffer),
+                "P2_DEBUG: GPURowPitch=%d, PixelRowBytes=%d, AlignedStride=%d, SafeStride=%d, TotalSize=%zu, Aligned16=%s",
+                actualRowPitch,
+                pixelRowBytes, 
+                alignedStride,
+                safeStride,
+                dataSize,
+                ((reinterpret_cast<uintptr_t>(*bgraData) % 16) == 0) ? "YES" : "NO"
+            );
+
+            // 最初の数ピクセルをサンプリング（ステージング側はマップ中のため読み取り可能）
+            std::string pixelSamples = "SrcPixels: ";
+            std::string copiedPixels = "DstPixels: ";
+            UINT maxPixels = (desc.Width < 5U) ? desc.Width : 5U;
+            for (UINT i = 0; i < maxPixels; ++i)
+            {
+                char pixelBuffer[32];
+                if (srcData && (i * 4 + 3) < static_cast<UINT>(mappedResource.RowPitch))
+                {
+                    sprintf_s(pixelBuffer, sizeof(pixelBuffer), "[%02X,%02X,%02X,%02X] ",
+                        srcData[i * 4 + 0], // B
+                        srcData[i * 4 + 1], // G
+                        srcData[i * 4 + 2], // R
+                        srcData[i * 4 + 3]  // A
+                    );
+                    pixelSamples += pixelBuffer;
+                }
+                if (dstData && (i * 4 + 3) < static_cast<UINT>(*stride))
+                {
+                    sprintf_s(pixelBuffer, sizeof(pixelBuffer), "[%02X,%02X,%02X,%02X] ",
+                        dstData[i * 4 + 0], // B
+                        dstData[i * 4 + 1], // G
+                        dstData[i * 4 + 2], // R
+                        dstData[i * 4 + 3]  // A
+                    );
+                    copiedPixels += pixelBuffer;
+                }
+            }
+
+            // 統合デバッグ情報を設定
+            std::string combinedDebug = std::string(strideBuffer) + " | " + pixelSamples + " | " + copiedPixels;
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, combinedDebug);
+        }
+
+        // テクスチャのマップを解除
+        UnmapReadback(stagingSlot);
+
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("ConvertTextureToBGRA exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("ConvertTextureToBGRA unknown exception");
+        return false;
+    }
+}
+
+void WindowsCaptureSession::SetLastError(const char* message)
+{
+    // 段階未設定のままセッション内部で失敗した場合は CAPTURE 段階として扱う
+    CaptureLastError::Record& record = CaptureLastError::Current();
+    if (record.stage == BAKETA_CAPTURE_STAGE_NONE)
+    {
+        record.stage = BAKETA_CAPTURE_STAGE_CAPTURE;
+        record.sessionId = m_sessionId;
+    }
+    CaptureLastError::SetMessage(message);
+}
+
+void WindowsCaptureSession::SetLastError(const std::string& message)
+{
+    SetLastError(message.c_str());
+}
+
+void WindowsCaptureSession::SetLastError(int stage, HRESULT hr, const char* message)
+{
+    CaptureLastError::Set(stage, hr, m_sessionId, message);
+}
+
+/// <summary>
+/// 🔍 Phase 0 WGC修復: ウィンドウ状態をキャプチャ用に検証
+/// </summary>
+bool WindowsCaptureSession::ValidateWindowStateForCapture()
+{
+    if (!m_hwnd)
+    {
+        SetLastError("Invalid window handle for validation");
+        return false;
+    }
+
+    try
+    {
+        // 1. ウィンドウの存在確認
+        if (!IsWindow(m_hwnd))
+        {
+            SetLastError("Window no longer exists");
+            return false;
+        }
+
+        // 2. ウィンドウの可視性確認
+        if (!IsWindowVisible(m_hwnd))
+        {
+            SetLastError("Window is not visible - may cause white image capture");
+            return false;
+        }
+
+        // 3. ウィンドウの最小化状態確認
+        if (IsIconic(m_hwnd))
+        {
+            SetLastError("Window is minimized - Graphics Capture will return white image");
+            return false;
+        }
+
+        // 4. ウィンドウのサイズ確認
+        RECT windowRect;
+        if (!GetWindowRect(m_hwnd, &windowRect))
+        {
+            SetLastError("Failed to get window rectangle");
+            return false;
+        }
+
+        int width = windowRect.right - windowRect.left;
+        int height = windowRect.bottom - windowRect.top;
+        if (width <= 0 || height <= 0)
+        {
+            SetLastError("Invalid window dimensions - zero or negative size");
+            return false;
+        }
+
+        if (width > 7680 || height > 4320) // 8K解像度以上はメモリ不足の可能性
+        {
+            char sizeWarning[256];
+            sprintf_s(sizeWarning, sizeof(sizeWarning), 
+                "Extremely large window detected (%dx%d) - may cause memory issues", width, height);
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, sizeWarning);
             // 警告だが継続
         }
 
-        // 5. ウィンドウのフォーカス状態確認 (重要)
-        HWND foregroundWindow = GetForegroundWindow();
-        bool isInForeground = (m_hwnd == foregroundWindow) || IsChild(foregroundWindow, m_hwnd);
-        
-        if (!isInForeground)
+        // 5. ウィンドウのフォーカス状態確認 (重要)
+        HWND foregroundWindow = GetForegroundWindow();
+        bool isInForeground = (m_hwnd == foregroundWindow) || IsChild(foregroundWindow, m_hwnd);
+        
+        if (!isInForeground)
+        {
+            // フォーカスがないと白画像の原因になる場合がある
+            char focusWarning[512];
+            sprintf_s(focusWarning, sizeof(focusWarning), 
+                "Target window (0x%p) is not in foreground (current: 0x%p) - may cause white image", 
+                m_hwnd, foregroundWindow);
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, focusWarning);
+            // 警告だが継続 (フォーカスなしでもキャプチャできる場合がある)
+        }
+
+        // 6. ウィンドウのクラス名・タイトルを診断ログへ (デバッグ用、診断無効時は取得しない)
+        if (CaptureDiagnostics::IsEnabled(BAKETA_CAPTURE_DIAG_BASIC))
+        {
+            char className[256] = {};
+            GetClassNameA(m_hwnd, className, sizeof(className));
+
+            char windowTitle[256] = {};
+            GetWindowTextA(m_hwnd, windowTitle, sizeof(windowTitle));
+
+            // 7. 統合デバッグ情報
+            char validationResult[1024];
+            sprintf_s(validationResult, sizeof(validationResult),
+                "Window validation PASSED: Class='%s', Title='%s', Size=%dx%d, Visible=%s, Focus=%s",
+                className, windowTitle, width, height,
+                IsWindowVisible(m_hwnd) ? "YES" : "NO",
+                isInForeground ? "YES" : "NO"
+            );
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, validationResult);
+        }
+
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("Window validation exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("Window validation unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::GetWindowDebugInfo(std::string& windowInfo, std::string& screenRect) const
+{
+    if (!m_hwnd)
+    {
+        windowInfo = "Invalid HWND";
+        screenRect = "N/A";
+        return false;
+    }
+
+    try
+    {
+        // ウィンドウクラス名取得
+        char className[256] = {};
+        GetClassNameA(m_hwnd, className, sizeof(className));
+
+        // ウィンドウタイトル取得
+        char windowTitle[256] = {};
+        GetWindowTextA(m_hwnd, windowTitle, sizeof(windowTitle));
+
+        // スクリーン座標取得
+        RECT windowRect = {};
+        GetWindowRect(m_hwnd, &windowRect);
+
+        // クライアント領域サイズ取得
+        RECT clientRect = {};
+        GetClientRect(m_hwnd, &clientRect);
+
+        // ウィンドウ情報を構築
+        char infoBuffer[1024];
+        sprintf_s(infoBuffer, sizeof(infoBuffer),
+            "HWND=0x%p, Class='%s', Title='%s', ClientSize=%dx%d",
+            m_hwnd,
+            className,
+            windowTitle,
+            clientRect.right - clientRect.left,
+            clientRect.bottom - clientRect.top
+        );
+        windowInfo = std::string(infoBuffer);
+
+        // スクリーン座標情報を構築
+        char rectBuffer[256];
+        sprintf_s(rectBuffer, sizeof(rectBuffer),
+            "Screen=(%d,%d)-(%d,%d), Size=%dx%d",
+            windowRect.left, windowRect.top,
+            windowRect.right, windowRect.bottom,
+            windowRect.right - windowRect.left,
+            windowRect.bottom - windowRect.top
+        );
+        screenRect = std::string(rectBuffer);
+
+        return true;
+    }
+    catch (...)
+    {
+        windowInfo = "Exception during debug info retrieval";
+        screenRect = "N/A";
+        return false;
+    }
+}
+
+/// <summary>
+/// 🚀 [Issue #193] フレームをキャプチャしてGPU側でリサイズ
+/// </summary>
+bool WindowsCaptureSession::CaptureFrameResized(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int timeoutMs, CaptureOutputBuffer* outputBuffer)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    // ターゲットサイズが0の場合は通常キャプチャにフォールバック（解像度自動調整中は元サイズを上限として縮小する）
+    bool adaptive = m_adaptiveResolution.IsEnabled();
+
+    // 呼び出し側バッファが前回のフレームサイズに足りない場合はフレームを取得せずに戻る（フレームを消費しない）
+    // 解像度自動調整中は出力サイズが読み出すまで決まらないため、取得後に確認する
+    if (outputBuffer && !adaptive)
+    {
+        size_t expected = ExpectedOutputBytes(targetWidth, targetHeight);
+        if (expected > outputBuffer->capacity)
+        {
+            outputBuffer->requiredSize = expected;
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_NOT_SUFFICIENT_BUFFER, "Output buffer too small for the current frame size");
+            return callScope.Complete(false);
+        }
+    }
+    if (!adaptive && (targetWidth <= 0 || targetHeight <= 0))
+    {
+        bool result = CaptureFrame(bgraData, width, height, stride, timestamp, sequence, timeoutMs, outputBuffer);
+        if (result && originalWidth && originalHeight)
+        {
+            // 🚀 [Issue #193] リサイズなしの場合、元のサイズ = キャプチャサイズ
+            *originalWidth = *width;
+            *originalHeight = *height;
+        }
+        return callScope.Complete(result);
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        unsigned long long frameSequence = 0;
+        // FP16 フレームはリサイズのシェーダーパスでそのままトーンマップする
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, timestamp, &frameSequence, true))
+        {
+            return false;
+        }
+
+        // 🚀 [Issue #193] 元のキャプチャサイズを保存（リサイズ前）
+        if (originalWidth && originalHeight)
+        {
+            *originalWidth = frameWidth;
+            *originalHeight = frameHeight;
+        }
+
+        // 解像度自動調整中は現在のスケールで目標サイズを決める
+        if (adaptive)
+        {
+            m_adaptiveResolution.ApplyScale(frameWidth, frameHeight, &targetWidth, &targetHeight);
+        }
+
+        // パイプライン読み出し: 次に到着するフレームは今回の目標サイズでリサイズ・コピー発行しておく
+        PipelinedReadbackFrame pipelined = { frameSequence, *timestamp, frameWidth, frameHeight };
+        if (m_pipelinedReadback.load())
+        {
+            m_prefetchTargetWidth.store(targetWidth);
+            m_prefetchTargetHeight.store(targetHeight);
+            m_pipelinedFrame = &pipelined;
+        }
+
+        // テクスチャをGPU上でリサイズしてBGRAデータに変換
+        long long convertStart = CaptureStats::Now();
+        m_outputBuffer = outputBuffer;
+        bool converted = ResizeAndConvertTextureToBGRA(frameTexture.Get(), bgraData, width, height, stride, targetWidth, targetHeight);
+        m_outputBuffer = nullptr;
+        m_pipelinedFrame = nullptr;
+        if (!converted)
+        {
+            SetLastError(std::string("Failed to resize and convert texture to BGRA: ") + GetLastError());
+            return false;
+        }
+
+        // 1 つ前のフレームを返した場合はそのフレームの提示時刻・通し番号
+        *timestamp = pipelined.timestamp;
+        if (sequence)
+        {
+            *sequence = pipelined.sequence;
+        }
+
+        // フレーム待ちを除いたリサイズ・コピー・マップ・行コピーの時間で次回のスケールを調整
+        if (adaptive)
+        {
+            m_adaptiveResolution.Observe(CaptureStats::ToMicroseconds(CaptureStats::Now() - convertStart));
+        }
+
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureFrameResized winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureFrameResized exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureFrameResized unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::BeginBatchReadback(int targetWidth, int targetHeight, int timeoutMs, BatchReadback* batch)
+{
+    batch->startTicks = CaptureStats::Now();
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return FinishBatchReadback(batch, false);
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return FinishBatchReadback(batch, false);
+    }
+
+    try
+    {
+        // フレーム取得（読み出しロックは EndBatchReadback まで保持）
+        batch->readbackLock = std::unique_lock<std::mutex>(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, batch->readbackLock, batch->frameTexture, &batch->originalWidth, &batch->originalHeight, &batch->timestamp, &batch->sequence))
+        {
+            return FinishBatchReadback(batch, false);
+        }
+
+        // 出力サイズ（ResizeAndConvertTextureToBGRA と同じくアスペクト比を維持して縮小のみ）
+        batch->width = batch->originalWidth;
+        batch->height = batch->originalHeight;
+        if (targetWidth > 0 && targetHeight > 0 && (batch->width > targetWidth || batch->height > targetHeight))
+        {
+            float srcAspect = static_cast<float>(batch->width) / static_cast<float>(batch->height);
+            float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
+            if (srcAspect > targetAspect)
+            {
+                batch->width = targetWidth;
+                batch->height = static_cast<int>(targetWidth / srcAspect);
+            }
+            else
+            {
+                batch->height = targetHeight;
+                batch->width = static_cast<int>(targetHeight * srcAspect);
+            }
+            batch->width = (std::max)(1, batch->width);
+            batch->height = (std::max)(1, batch->height);
+        }
+
+        ID3D11Texture2D* readbackSource = batch->frameTexture.Get();
+        ComPtr<ID3D11Texture2D> resizedTexture;
+        if (batch->width != batch->originalWidth || batch->height != batch->originalHeight)
+        {
+            long long stageStart = CaptureStats::Now();
+            bool resized = GpuResizeTexture(readbackSource, batch->width, batch->height, resizedTexture);
+            m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_GPU_RESIZE, stageStart);
+            if (!resized)
+            {
+                // CPU フォールバックはマップ時に行う（他セッションの GPU 処理の発行を遅らせない）
+                m_stats.CountFallback();
+                batch->cpuFallback = true;
+                return true;
+            }
+            readbackSource = resizedTexture.Get();
+        }
+
+        // ステージングテクスチャへコピー発行（Flush は全セッションの発行後に呼び出し側がまとめて行う）
+        HRESULT hr = S_OK;
+        long long stageStart = CaptureStats::Now();
+        batch->staged = m_staging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), readbackSource,
+            static_cast<UINT>(batch->width), static_cast<UINT>(batch->height), DXGI_FORMAT_B8G8R8A8_UNORM, &hr);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_COPY, stageStart);
+        if (!batch->staged)
+        {
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to create staging texture for batch readback");
+            return FinishBatchReadback(batch, false);
+        }
+
+        return true;
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("BeginBatchReadback winrt error: 0x" + std::to_string(ex.code()));
+        return FinishBatchReadback(batch, false);
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("BeginBatchReadback exception: ") + ex.what());
+        return FinishBatchReadback(batch, false);
+    }
+    catch (...)
+    {
+        SetLastError("BeginBatchReadback unknown exception");
+        return FinishBatchReadback(batch, false);
+    }
+}
+
+bool WindowsCaptureSession::EndBatchReadback(BatchReadback* batch, unsigned char** bgraData, int* stride)
+{
+    try
+    {
+        UINT outputPixelRowBytes = static_cast<UINT>(batch->width) * 4;
+        int preferredStride = static_cast<int>(((outputPixelRowBytes + 15) / 16) * 16);
+        int outputStride = 0;
+
+        if (batch->cpuFallback)
+        {
+            // GPU リサイズ失敗時は ResizeAndConvertTextureToBGRA と同じく CPU で縮小
+            CpuImageKernels::ConstImage source = {};
+            if (!ReadbackToScratch(batch->frameTexture.Get(), batch->originalWidth, batch->originalHeight, &source))
+            {
+                return FinishBatchReadback(batch, false);
+            }
+
+            long long stageStart = CaptureStats::Now();
+            *bgraData = AcquireOutputBuffer(batch->width, batch->height, 4, preferredStride, &outputStride);
+            m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ALLOCATION, stageStart);
+            if (!(*bgraData))
+            {
+                SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate batch output buffer");
+                return FinishBatchReadback(batch, false);
+            }
+
+            CpuImageKernels::ResizeBgra(source, { *bgraData, batch->width, batch->height, static_cast<size_t>(outputStride) });
+            *stride = outputStride;
+            return FinishBatchReadback(batch, true);
+        }
+
+        // コピー完了を待ってマップ（他セッションのコピーも Flush 済みのため GPU 上で重なる）
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        long long stageStart = CaptureStats::Now();
+        HRESULT hr = m_staging.Map(m_d3dContext.Get(), &mappedResource);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_MAP, stageStart);
+        if (FAILED(hr))
+        {
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map staging texture for batch readback");
+            return FinishBatchReadback(batch, false);
+        }
+
+        stageStart = CaptureStats::Now();
+        *bgraData = AcquireOutputBuffer(batch->width, batch->height, 4, preferredStride, &outputStride);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ALLOCATION, stageStart);
+        if (!(*bgraData))
+        {
+            m_staging.Unmap(m_d3dContext.Get());
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate batch output buffer");
+            return FinishBatchReadback(batch, false);
+        }
+
+        stageStart = CaptureStats::Now();
+        CpuImageKernels::CopyPlane(static_cast<const unsigned char*>(mappedResource.pData), static_cast<UINT>(mappedResource.RowPitch),
+            *bgraData, static_cast<UINT>(outputStride), outputPixelRowBytes, batch->height);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ROW_COPY, stageStart);
+
+        m_staging.Unmap(m_d3dContext.Get());
+
+        *stride = outputStride;
+        return FinishBatchReadback(batch, true);
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("EndBatchReadback exception: ") + ex.what());
+        return FinishBatchReadback(batch, false);
+    }
+    catch (...)
+    {
+        SetLastError("EndBatchReadback unknown exception");
+        return FinishBatchReadback(batch, false);
+    }
+}
+
+bool WindowsCaptureSession::FinishBatchReadback(BatchReadback* batch, bool succeeded)
+{
+    // CaptureCallScope と同じく呼び出し全体の所要時間と成否を記録（バッチ内ではセッションごとに記録する）
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_TOTAL, batch->startTicks);
+    if (succeeded)
+    {
+        m_stats.CountDelivered();
+    }
+    else
+    {
+        m_stats.CountFailure();
+    }
+
+    batch->frameTexture.Reset();
+    if (batch->readbackLock.owns_lock())
+    {
+        batch->readbackLock.unlock();
+    }
+    return succeeded;
+}
+
+bool WindowsCaptureSession::CaptureFrameIfChanged(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int threshold, BaketaCaptureTileInfo* tileInfo, unsigned int* dirtyBitmap, int dirtyBitmapWords, int timeoutMs, bool* changed)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *changed = false;
+    *bgraData = nullptr;
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, timestamp, sequence))
+        {
+            return false;
+        }
+
+        if (originalWidth && originalHeight)
+        {
+            *originalWidth = frameWidth;
+            *originalHeight = frameHeight;
+        }
+
+        // GPU でタイル差分を検出（読み戻すのはビットマップのみ）
+        HRESULT hr = S_OK;
+        if (!m_changeDetector.Detect(m_d3dDevice.Get(), m_d3dContext.Get(), frameTexture.Get(), threshold, &hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Tile change detection failed: 0x" + std::to_string(hr));
+            return false;
+        }
+
+        if (tileInfo)
+        {
+            tileInfo->tileSize = TileChangeDetector::kTileSize;
+            tileInfo->tileColumns = m_changeDetector.GetTileColumns();
+            tileInfo->tileRows = m_changeDetector.GetTileRows();
+            tileInfo->dirtyTileCount = m_changeDetector.GetDirtyTileCount();
+        }
+
+        if (dirtyBitmap && dirtyBitmapWords > 0)
+        {
+            const auto& bitmap = m_changeDetector.GetDirtyBitmap();
+            size_t copyWords = (std::min)(bitmap.size(), static_cast<size_t>(dirtyBitmapWords));
+            std::copy(bitmap.begin(), bitmap.begin() + copyWords, dirtyBitmap);
+            std::fill(dirtyBitmap + copyWords, dirtyBitmap + dirtyBitmapWords, 0u);
+        }
+
+        if (m_changeDetector.GetDirtyTileCount() == 0)
+        {
+            // 変化なし - フレーム本体の読み出しを省略
+            *width = 0;
+            *height = 0;
+            *stride = 0;
+            return callScope.Succeed();
+        }
+
+        // 今回読み出すフレームを次回の比較対象にする
+        m_changeDetector.Commit(m_d3dContext.Get(), frameTexture.Get());
+
+        bool converted = false;
+        if (targetWidth > 0 && targetHeight > 0)
+        {
+            converted = ResizeAndConvertTextureToBGRA(frameTexture.Get(), bgraData, width, height, stride, targetWidth, targetHeight);
+        }
+        else
+        {
+            *width = frameWidth;
+            *height = frameHeight;
+            converted = ConvertTextureToBGRA(frameTexture.Get(), bgraData, stride);
+        }
+
+        if (!converted)
+        {
+            SetLastError("Failed to convert changed frame to BGRA");
+            return false;
+        }
+
+        *changed = true;
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureFrameIfChanged winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureFrameIfChanged exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureFrameIfChanged unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::EnsureRegionAtlas(int width, int height)
+{
+    if (m_regionAtlas && width <= m_regionAtlasWidth && height <= m_regionAtlasHeight)
+    {
+        return true;
+    }
+
+    m_regionAtlasRtv.Reset();
+    m_regionAtlas.Reset();
+
+    D3D11_TEXTURE2D_DESC atlasDesc = {};
+    atlasDesc.Width = static_cast<UINT>((std::max)(width, m_regionAtlasWidth));
+    atlasDesc.Height = static_cast<UINT>((std::max)(height, m_regionAtlasHeight));
+    atlasDesc.MipLevels = 1;
+    atlasDesc.ArraySize = 1;
+    atlasDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    atlasDesc.SampleDesc.Count = 1;
+    atlasDesc.Usage = D3D11_USAGE_DEFAULT;
+    atlasDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+    HRESULT hr = m_d3dDevice->CreateTexture2D(&atlasDesc, nullptr, &m_regionAtlas);
+    if (SUCCEEDED(hr))
+    {
+        hr = m_d3dDevice->CreateRenderTargetView(m_regionAtlas.Get(), nullptr, &m_regionAtlasRtv);
+    }
+
+    if (FAILED(hr))
+    {
+        m_lastHResult = hr;
+        m_regionAtlas.Reset();
+        m_regionAtlasRtv.Reset();
+        m_regionAtlasWidth = 0;
+        m_regionAtlasHeight = 0;
+        SetLastError("Failed to create region atlas texture");
+        return false;
+    }
+
+    m_regionAtlasWidth = static_cast<int>(atlasDesc.Width);
+    m_regionAtlasHeight = static_cast<int>(atlasDesc.Height);
+    return true;
+}
+
+bool WindowsCaptureSession::CaptureRegions(BaketaCaptureRegion* regions, int count, unsigned char** data, int* dataSize, int* frameWidth, int* frameHeight, long long* timestamp, unsigned long long* sequence, int timeoutMs)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *data = nullptr;
+    *dataSize = 0;
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    if (!regions || count <= 0)
+    {
+        SetLastError("Invalid region parameters");
+        return false;
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        // FP16 フレームは等倍の ROI もシェーダーで描画してトーンマップする（アトラスへの追加パスなし）
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, frameWidth, frameHeight, timestamp, sequence, true))
+        {
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC frameDesc;
+        frameTexture->GetDesc(&frameDesc);
+        bool hdrSource = frameDesc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+        // ROI をフレーム内にクランプし、出力サイズを決める
+        std::vector<RegionPlacement> placements;
+        placements.reserve(static_cast<size_t>(count));
+        bool needsResize = hdrSource;
+        for (int i = 0; i < count; ++i)
+        {
+            BaketaCaptureRegion& region = regions[i];
+            region.offset = -1;
+            region.width = 0;
+            region.height = 0;
+            region.stride = 0;
+
+            // 右端・下端は int64 で求めてからクランプする（x + width が int を溢れる入力でも範囲外にならない）
+            long long sourceRight = static_cast<long long>(region.source.x) + region.source.width;
+            long long sourceBottom = static_cast<long long>(region.source.y) + region.source.height;
+            RECT source = {
+                (std::max)(0, region.source.x),
+                (std::max)(0, region.source.y),
+                static_cast<LONG>((std::min)(static_cast<long long>(*frameWidth), sourceRight)),
+                static_cast<LONG>((std::min)(static_cast<long long>(*frameHeight), sourceBottom))
+            };
+            if (source.right <= source.left || source.bottom <= source.top)
+            {
+                continue;
+            }
+
+            int sourceWidth = source.right - source.left;
+            int sourceHeight = source.bottom - source.top;
+            int outputWidth = region.targetWidth > 0 ? region.targetWidth : sourceWidth;
+            int outputHeight = region.targetHeight > 0 ? region.targetHeight : sourceHeight;
+            needsResize |= (outputWidth != sourceWidth || outputHeight != sourceHeight);
+
+            placements.push_back({ i, source, outputWidth, outputHeight, 0, 0 });
+        }
+
+        if (placements.empty())
+        {
+            SetLastError("No region intersects the captured frame");
+            return false;
+        }
+
+        int atlasWidth = 0;
+        int atlasHeight = 0;
+        if (!PackRegionPlacements(placements, &atlasWidth, &atlasHeight))
+        {
+            SetLastError("Regions do not fit into the region atlas");
+            return false;
+        }
+
+        if (!EnsureRegionAtlas(atlasWidth, atlasHeight))
+        {
+            return false;
+        }
+
+        if (needsResize && !InitializeGpuResizeResources())
+        {
+            return false;
+        }
+
+        // 等倍の ROI はそのままコピー、リサイズ指定の ROI はシェーダーで描画
+        ID3D11ShaderResourceView* sourceSrv = nullptr;
+        if (needsResize)
+        {
+            HRESULT hr = S_OK;
+            sourceSrv = m_resizeCache.GetSourceView(m_d3dDevice.Get(), frameTexture.Get(), &hr);
+            if (!sourceSrv)
+            {
+                m_lastHResult = hr;
+                SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create source SRV for regions");
+                return false;
+            }
+        }
+
+        bool drawFailed = false;
+        for (const auto& placement : placements)
+        {
+            int sourceWidth = placement.source.right - placement.source.left;
+            int sourceHeight = placement.source.bottom - placement.source.top;
+            if (placement.width == sourceWidth && placement.height == sourceHeight && !hdrSource)
+            {
+                D3D11_BOX box = {
+                    static_cast<UINT>(placement.source.left), static_cast<UINT>(placement.source.top), 0,
+                    static_cast<UINT>(placement.source.right), static_cast<UINT>(placement.source.bottom), 1
+                };
+                m_d3dContext->CopySubresourceRegion(m_regionAtlas.Get(), 0,
+                    static_cast<UINT>(placement.atlasX), static_cast<UINT>(placement.atlasY), 0, frameTexture.Get(), 0, &box);
+                continue;
+            }
+
+            D3D11_VIEWPORT viewport = {};
+            viewport.TopLeftX = static_cast<float>(placement.atlasX);
+            viewport.TopLeftY = static_cast<float>(placement.atlasY);
+            viewport.Width = static_cast<float>(placement.width);
+            viewport.Height = static_cast<float>(placement.height);
+            viewport.MinDepth = 0.0f;
+            viewport.MaxDepth = 1.0f;
+            if (!DrawResizeQuad(sourceSrv, m_regionAtlasRtv.Get(), viewport,
+                static_cast<float>(placement.source.left) / *frameWidth,
+                static_cast<float>(placement.source.top) / *frameHeight,
+                static_cast<float>(sourceWidth) / *frameWidth,
+                static_cast<float>(sourceHeight) / *frameHeight))
+            {
+                drawFailed = true;
+                break;
+            }
+        }
+
+        if (needsResize)
+        {
+            ID3D11ShaderResourceView* nullSRV[] = { nullptr };
+            m_d3dContext->PSSetShaderResources(0, 1, nullSRV);
+        }
+
+        if (drawFailed)
+        {
+            return false;
+        }
+
+        // アトラスの使用領域だけをステージングへコピーして1回だけ Map
+        HRESULT hr = S_OK;
+        bool staged = m_regionStaging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), m_regionAtlas.Get(),
+            static_cast<UINT>(atlasWidth), static_cast<UINT>(atlasHeight), DXGI_FORMAT_B8G8R8A8_UNORM, &hr);
+        if (!staged)
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to create region staging texture");
+            return false;
+        }
+
+        size_t totalBytes = 0;
+        for (const auto& placement : placements)
+        {
+            totalBytes += static_cast<size_t>(placement.width) * placement.height * 4;
+        }
+        if (totalBytes > static_cast<size_t>(INT_MAX))
+        {
+            SetLastError("Region output is too large");
+            return false;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        hr = m_regionStaging.Map(m_d3dContext.Get(), &mapped);
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map region staging texture");
+            return false;
+        }
+
+        unsigned char* output = FrameBufferPool::Instance().Acquire(static_cast<int>(totalBytes), 1, static_cast<int>(totalBytes));
+        if (!output)
+        {
+            m_regionStaging.Unmap(m_d3dContext.Get());
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate region output buffer");
+            return false;
+        }
+
+        // ROI ごとに連続領域へ詰めて出力（入力順にオフセットを割り当てる）
+        std::sort(placements.begin(), placements.end(), [](const RegionPlacement& a, const RegionPlacement& b) { return a.index < b.index; });
+        const auto* atlasData = static_cast<const unsigned char*>(mapped.pData);
+        size_t offset = 0;
+        for (const auto& placement : placements)
+        {
+            size_t rowBytes = static_cast<size_t>(placement.width) * 4;
+            for (int y = 0; y < placement.height; ++y)
+            {
+                memcpy(output + offset + y * rowBytes,
+                    atlasData + static_cast<size_t>(placement.atlasY + y) * mapped.RowPitch + static_cast<size_t>(placement.atlasX) * 4,
+                    rowBytes);
+            }
+
+            BaketaCaptureRegion& region = regions[placement.index];
+            region.offset = static_cast<int>(offset);
+            region.width = placement.width;
+            region.height = placement.height;
+            region.stride = static_cast<int>(rowBytes);
+            offset += rowBytes * placement.height;
+        }
+
+        m_regionStaging.Unmap(m_d3dContext.Get());
+
+        *data = output;
+        *dataSize = static_cast<int>(totalBytes);
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureRegions winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureRegions exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureRegions unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::CaptureEdgeMap(BaketaCaptureFrame* frame, int targetWidth, int targetHeight, unsigned char* densityMap, int densityMapSize, BaketaCaptureEdgeMapInfo* mapInfo, int timeoutMs)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, &mapInfo->timestamp, &mapInfo->sequence))
+        {
+            return false;
+        }
+
+        mapInfo->cellSize = EdgeDensityMapper::kCellSize;
+        mapInfo->columns = EdgeDensityMapper::Columns(frameWidth);
+        mapInfo->rows = EdgeDensityMapper::Rows(frameHeight);
+        mapInfo->dataSize = mapInfo->columns * mapInfo->rows;
+        if (!densityMap || mapInfo->dataSize > densityMapSize)
+        {
+            SetLastError(BAKETA_CAPTURE_STAGE_API, E_NOT_SUFFICIENT_BUFFER, "Density map buffer too small: " + std::to_string(mapInfo->dataSize) + " bytes required");
+            return false;
+        }
+
+        // GPU で密度マップを作成（読み戻すのはセルごとの1バイトのみ）
+        HRESULT hr = S_OK;
+        ID3D11ShaderResourceView* sourceSrv = m_resizeCache.GetSourceView(m_d3dDevice.Get(), frameTexture.Get(), &hr);
+        if (!sourceSrv || !m_edgeMapper.Build(m_d3dDevice.Get(), m_d3dContext.Get(), sourceSrv,
+            static_cast<UINT>(frameWidth), static_cast<UINT>(frameHeight), densityMap, &hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Edge density map failed: 0x" + std::to_string(hr));
+            return false;
+        }
+
+        if (!frame)
+        {
+            return callScope.Succeed();
+        }
+
+        frame->timestamp = mapInfo->timestamp;
+        frame->sequence = mapInfo->sequence;
+        frame->originalWidth = frameWidth;
+        frame->originalHeight = frameHeight;
+
+        bool converted = false;
+        if (targetWidth > 0 && targetHeight > 0)
+        {
+            converted = ResizeAndConvertTextureToBGRA(frameTexture.Get(), &frame->bgraData, &frame->width, &frame->height, &frame->stride, targetWidth, targetHeight);
+        }
+        else
+        {
+            frame->width = frameWidth;
+            frame->height = frameHeight;
+            converted = ConvertTextureToBGRA(frameTexture.Get(), &frame->bgraData, &frame->stride);
+        }
+
+        if (!converted)
+        {
+            SetLastError("Failed to convert edge map frame to BGRA");
+            return false;
+        }
+
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureEdgeMap winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureEdgeMap exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureEdgeMap unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::CaptureFrameConverted(int format, int targetWidth, int targetHeight, unsigned char** data, int* width, int* height, int* stride, int* dataSize, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int timeoutMs)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *data = nullptr;
+    *dataSize = 0;
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    if (format < BAKETA_CAPTURE_FORMAT_GRAY8 || format > BAKETA_CAPTURE_FORMAT_NV12)
+    {
+        SetLastError("Invalid output format");
+        return false;
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, originalWidth, originalHeight, timestamp, sequence))
+        {
+            return false;
+        }
+
+        // 出力サイズ（ResizeAndConvertTextureToBGRA と同じくアスペクト比を維持して縮小のみ）
+        int outputWidth = *originalWidth;
+        int outputHeight = *originalHeight;
+        if (targetWidth > 0 && targetHeight > 0 && (outputWidth > targetWidth || outputHeight > targetHeight))
+        {
+            float srcAspect = static_cast<float>(outputWidth) / static_cast<float>(outputHeight);
+            float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
+            if (srcAspect > targetAspect)
+            {
+                outputWidth = targetWidth;
+                outputHeight = static_cast<int>(targetWidth / srcAspect);
+            }
+            else
+            {
+                outputHeight = targetHeight;
+                outputWidth = static_cast<int>(targetHeight * srcAspect);
+            }
+            outputWidth = (std::max)(1, outputWidth);
+            outputHeight = (std::max)(1, outputHeight);
+        }
+
+        if (format == BAKETA_CAPTURE_FORMAT_NV12)
+        {
+            // 4:2:0 サブサンプリングのため偶数に切り下げ
+            outputWidth = (std::max)(2, outputWidth & ~1);
+            outputHeight = (std::max)(2, outputHeight & ~1);
+        }
+
+        HRESULT hr = S_OK;
+        ID3D11ShaderResourceView* sourceSrv = m_resizeCache.GetSourceView(m_d3dDevice.Get(), frameTexture.Get(), &hr);
+        if (!sourceSrv)
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create source SRV for format conversion");
+            return false;
+        }
+
+        if (!m_formatConverter.Convert(m_d3dDevice.Get(), m_d3dContext.Get(), sourceSrv,
+            static_cast<UINT>(outputWidth), static_cast<UINT>(outputHeight), format, &hr) &&
+            hr == DXGI_ERROR_UNSUPPORTED && format == BAKETA_CAPTURE_FORMAT_GRAY8)
+        {
+            // コンピュートシェーダー非対応デバイス: BGRA で読み出して CPU の SIMD カーネルで変換
+            m_stats.CountFallback();
+            return callScope.Complete(ConvertToGrayOnCpu(frameTexture.Get(), *originalWidth, *originalHeight, outputWidth, outputHeight,
+                data, width, height, stride, dataSize));
+        }
+
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, hr == DXGI_ERROR_UNSUPPORTED
+                ? "GPU format conversion requires feature level 11_0"
+                : "GPU format conversion failed");
+            return false;
+        }
+
+        bool staged = m_formatStaging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), m_formatConverter.GetOutput(),
+            m_formatConverter.GetOutputWidth(), m_formatConverter.GetOutputHeight(), m_formatConverter.GetOutputFormat(), &hr);
+        if (!staged)
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to create format staging texture");
+            return false;
+        }
+
+        int rowBytes = 0;
+        int rowCount = 0;
+        FormatConverter::GetLayout(format, outputWidth, outputHeight, &rowBytes, &rowCount);
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        hr = m_formatStaging.Map(m_d3dContext.Get(), &mapped);
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map format staging texture");
+            return false;
+        }
+
+        unsigned char* output = FrameBufferPool::Instance().Acquire(rowBytes, rowCount, rowBytes);
+        if (!output)
+        {
+            m_formatStaging.Unmap(m_d3dContext.Get());
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate converted output buffer");
+            return false;
+        }
+
+        // 出力テクスチャは CPU 側と同じレイアウトのため行ごとにコピーするだけ
+        const auto* src = static_cast<const unsigned char*>(mapped.pData);
+        CpuImageKernels::CopyPlane(src, mapped.RowPitch, output, rowBytes, rowBytes, rowCount);
+
+        m_formatStaging.Unmap(m_d3dContext.Get());
+
+        *data = output;
+        *width = outputWidth;
+        *height = outputHeight;
+        *stride = rowBytes;
+        *dataSize = rowBytes * rowCount;
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureFrameConverted winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureFrameConverted exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureFrameConverted unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::ConvertToGrayOnCpu(ID3D11Texture2D* texture, int sourceWidth, int sourceHeight, int outputWidth, int outputHeight, unsigned char** data, int* width, int* height, int* stride, int* dataSize)
+{
+    CpuImageKernels::ConstImage source = {};
+    if (!ReadbackToScratch(texture, sourceWidth, sourceHeight, &source))
+    {
+        return false;
+    }
+
+    if (outputWidth != sourceWidth || outputHeight != sourceHeight)
+    {
+        size_t rowBytes = static_cast<size_t>(outputWidth) * 4;
+        m_cpuResizeScratch.resize(rowBytes * outputHeight);
+        CpuImageKernels::ResizeBgra(source, { m_cpuResizeScratch.data(), outputWidth, outputHeight, rowBytes });
+        source = { m_cpuResizeScratch.data(), outputWidth, outputHeight, rowBytes };
+    }
+
+    unsigned char* output = FrameBufferPool::Instance().Acquire(outputWidth, outputHeight, outputWidth);
+    if (!output)
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate converted output buffer");
+        return false;
+    }
+
+    CpuImageKernels::BgraToGray(source, { output, outputWidth, outputHeight, static_cast<size_t>(outputWidth) });
+
+    *data = output;
+    *width = outputWidth;
+    *height = outputHeight;
+    *stride = outputWidth;
+    *dataSize = outputWidth * outputHeight;
+    return true;
+}
+
+bool WindowsCaptureSession::CaptureFrameScaled(int filter, BaketaCaptureScaledOutput* outputs, int count, unsigned char** data, int* dataSize, int* frameWidth, int* frameHeight, long long* timestamp, unsigned long long* sequence, int timeoutMs)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *data = nullptr;
+    *dataSize = 0;
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    if (!outputs || count <= 0 || count > ComputeResizer::kMaxOutputs ||
+        filter < BAKETA_CAPTURE_FILTER_BILINEAR || filter > BAKETA_CAPTURE_FILTER_LANCZOS2)
+    {
+        SetLastError("Invalid scaled output parameters");
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if ((outputs[i].targetWidth <= 0 && outputs[i].targetHeight <= 0) ||
+            outputs[i].targetWidth < 0 || outputs[i].targetHeight < 0)
+        {
+            SetLastError("Invalid scaled output size");
+            return false;
+        }
+    }
+
+    try
+    {
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, frameWidth, frameHeight, timestamp, sequence))
+        {
+            return false;
+        }
+
+        // 片方が 0 の出力はアスペクト比を維持してサイズを決める
+        SIZE sizes[ComputeResizer::kMaxOutputs] = {};
+        POINT positions[ComputeResizer::kMaxOutputs] = {};
+        size_t totalBytes = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            long long width = outputs[i].targetWidth;
+            long long height = outputs[i].targetHeight;
+            if (width == 0)
+            {
+                width = (height * *frameWidth + *frameHeight / 2) / *frameHeight;
+            }
+            else if (height == 0)
+            {
+                height = (width * *frameHeight + *frameWidth / 2) / *frameWidth;
+            }
+            sizes[i].cx = static_cast<LONG>((std::max)(1LL, width));
+            sizes[i].cy = static_cast<LONG>((std::max)(1LL, height));
+            totalBytes += static_cast<size_t>(sizes[i].cx) * sizes[i].cy * 4;
+        }
+
+        if (totalBytes > static_cast<size_t>(INT_MAX))
+        {
+            SetLastError("Scaled output is too large");
+            return false;
+        }
+
+        HRESULT hr = S_OK;
+        ID3D11ShaderResourceView* sourceSrv = m_resizeCache.GetSourceView(m_d3dDevice.Get(), frameTexture.Get(), &hr);
+        if (!sourceSrv)
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create source SRV for scaled capture");
+            return false;
+        }
+
+        if (!m_computeResizer.Resize(m_d3dDevice.Get(), m_d3dContext.Get(), sourceSrv,
+            static_cast<UINT>(*frameWidth), static_cast<UINT>(*frameHeight), filter, sizes, count, positions, &hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, hr == DXGI_ERROR_UNSUPPORTED
+                ? "Compute shader resize requires feature level 11_0"
+                : "Compute shader resize failed");
+            return false;
+        }
+
+        // アトラスの使用領域だけをステージングへコピーして1回だけ Map
+        bool staged = m_scaledStaging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), m_computeResizer.GetAtlas(),
+            m_computeResizer.GetAtlasWidth(), m_computeResizer.GetAtlasHeight(), DXGI_FORMAT_R8G8B8A8_UNORM, &hr);
+        if (!staged)
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to create scaled staging texture");
+            return false;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        hr = m_scaledStaging.Map(m_d3dContext.Get(), &mapped);
+        if (FAILED(hr))
+        {
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map scaled staging texture");
+            return false;
+        }
+
+        unsigned char* output = FrameBufferPool::Instance().Acquire(static_cast<int>(totalBytes), 1, static_cast<int>(totalBytes));
+        if (!output)
+        {
+            m_scaledStaging.Unmap(m_d3dContext.Get());
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate scaled output buffer");
+            return false;
+        }
+
+        // 出力ごとに連続領域へ詰める（アトラスのバイト順は既に BGRA）
+        const auto* atlasData = static_cast<const unsigned char*>(mapped.pData);
+        size_t offset = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            size_t rowBytes = static_cast<size_t>(sizes[i].cx) * 4;
+            for (int y = 0; y < sizes[i].cy; ++y)
+            {
+                memcpy(output + offset + y * rowBytes,
+                    atlasData + static_cast<size_t>(positions[i].y + y) * mapped.RowPitch + static_cast<size_t>(positions[i].x) * 4,
+                    rowBytes);
+            }
+
+            outputs[i].offset = static_cast<int>(offset);
+            outputs[i].width = sizes[i].cx;
+            outputs[i].height = sizes[i].cy;
+            outputs[i].stride = static_cast<int>(rowBytes);
+            offset += rowBytes * sizes[i].cy;
+        }
+
+        m_scaledStaging.Unmap(m_d3dContext.Get());
+
+        *data = output;
+        *dataSize = static_cast<int>(totalBytes);
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("CaptureFrameScaled winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("CaptureFrameScaled exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("CaptureFrameScaled unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::ExportSharedFrame(int targetWidth, int targetHeight, int timeoutMs, BaketaCaptureSharedFrame* frame)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    try
+    {
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, &frame->timestamp, &frame->sequence))
+        {
+            return false;
+        }
+
+        // 出力サイズ（ResizeAndConvertTextureToBGRA と同じくアスペクト比を維持して縮小のみ）
+        int outputWidth = frameWidth;
+        int outputHeight = frameHeight;
+        if (targetWidth > 0 && targetHeight > 0 && (outputWidth > targetWidth || outputHeight > targetHeight))
+        {
+            float srcAspect = static_cast<float>(outputWidth) / static_cast<float>(outputHeight);
+            float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
+            if (srcAspect > targetAspect)
+            {
+                outputWidth = targetWidth;
+                outputHeight = static_cast<int>(targetWidth / srcAspect);
+            }
+            else
+            {
+                outputHeight = targetHeight;
+                outputWidth = static_cast<int>(targetHeight * srcAspect);
+            }
+            outputWidth = (std::max)(1, outputWidth);
+            outputHeight = (std::max)(1, outputHeight);
+        }
+
+        // GPU 上で完結させる経路のため CPU フォールバックは行わない
+        ID3D11Texture2D* exportSource = frameTexture.Get();
+        ComPtr<ID3D11Texture2D> resizedTexture;
+        if (outputWidth != frameWidth || outputHeight != frameHeight)
+        {
+            long long stageStart = CaptureStats::Now();
+            bool resized = GpuResizeTexture(exportSource, outputWidth, outputHeight, resizedTexture);
+            m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_GPU_RESIZE, stageStart);
+            if (!resized)
+            {
+                return false;
+            }
+            exportSource = resizedTexture.Get();
+        }
+
+        HRESULT hr = S_OK;
+        long long stageStart = CaptureStats::Now();
+        int slot = -1;
+        {
+            // コピーからキー付きミューテックスの解放・Flush までを他セッションの発行と混ぜない
+            D3DContextLock contextLock(m_d3dContext.Get());
+            slot = m_sharedExporter.Publish(m_d3dDevice.Get(), m_d3dContext.Get(), exportSource,
+                static_cast<UINT>(outputWidth), static_cast<UINT>(outputHeight), frame->sequence, &hr);
+        }
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_COPY, stageStart);
+        if (slot < 0)
+        {
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, hr == DXGI_ERROR_WAS_STILL_DRAWING
+                ? "All shared textures are held by the consumer"
+                : "Failed to publish shared texture");
+            return false;
+        }
+
+        frame->sharedHandle = m_sharedExporter.GetSharedHandle(slot);
+        frame->slot = slot;
+        frame->width = outputWidth;
+        frame->height = outputHeight;
+        frame->dxgiFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+        frame->acquireKey = SharedTextureExporter::kConsumerKey;
+        frame->releaseKey = SharedTextureExporter::kProducerKey;
+        frame->originalWidth = frameWidth;
+        frame->originalHeight = frameHeight;
+        frame->generation = m_sharedExporter.GetGeneration();
+        frame->adapterLuidLow = m_sharedDevice ? m_sharedDevice->adapterLuid.LowPart : 0;
+        frame->adapterLuidHigh = m_sharedDevice ? m_sharedDevice->adapterLuid.HighPart : 0;
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("ExportSharedFrame winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+    catch (const std::exception& ex)
+    {
+        SetLastError(std::string("ExportSharedFrame exception: ") + ex.what());
+        return false;
+    }
+    catch (...)
+    {
+        SetLastError("ExportSharedFrame unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::EnableSharedRing(const wchar_t* name, int slotCount, int maxFrameBytes, HRESULT* hr)
+{
+    auto ring = SharedFrameRing::Create(name, slotCount, static_cast<size_t>((std::max)(0, maxFrameBytes)), hr);
+    if (!ring)
+    {
+        SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, *hr, "Failed to create shared frame ring: 0x" + std::to_string(*hr));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> ringLock(m_sharedRingMutex);
+    m_sharedRing = std::move(ring);
+    return true;
+}
+
+void WindowsCaptureSession::DisableSharedRing()
+{
+    std::lock_guard<std::mutex> ringLock(m_sharedRingMutex);
+    m_sharedRing.reset();
+}
+
+bool WindowsCaptureSession::HasSharedRing()
+{
+    std::lock_guard<std::mutex> ringLock(m_sharedRingMutex);
+    return m_sharedRing != nullptr;
+}
+
+bool WindowsCaptureSession::CaptureToSharedRing(BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs, unsigned long long* frameId, size_t* requiredSize)
+{
+    *frameId = 0;
+    *requiredSize = 0;
+
+    // スロットの確保からフレームIDの確定までを他の書き込みと混ぜない
+    std::lock_guard<std::mutex> ringLock(m_sharedRingMutex);
+    if (!m_sharedRing)
+    {
+        SetLastError("Shared frame ring not enabled");
+        return false;
+    }
+
+    // 呼び出し側バッファとしてスロットのデータ領域を渡し、読み出し結果を直接書き込ませる
+    CaptureOutputBuffer outputBuffer;
+    outputBuffer.data = m_sharedRing->BeginWrite(&outputBuffer.capacity);
+    bool captured = CaptureFrameResized(&frame->bgraData, &frame->width, &frame->height, &frame->stride, &frame->timestamp, &frame->sequence,
+        &frame->originalWidth, &frame->originalHeight, targetWidth, targetHeight, timeoutMs, &outputBuffer);
+    *frameId = m_sharedRing->EndWrite(*frame, captured);
+    *requiredSize = outputBuffer.requiredSize;
+    return captured;
+}
+
+bool WindowsCaptureSession::StartEncoder(const BaketaCaptureEncoderConfig& config, HRESULT* hr)
+{
+    *hr = S_OK;
+
+    if (!m_initialized || !m_sharedDevice)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    // ビデオプロセッサーによる NV12 変換に VIDEO_SUPPORT 付きのデバイスが必要
+    if (!m_sharedDevice->videoSupported)
+    {
+        *hr = DXGI_ERROR_UNSUPPORTED;
+        SetLastError(BAKETA_CAPTURE_STAGE_ENCODE, *hr, "D3D11 device was created without video support");
+        return false;
+    }
+
+    if (!HardwareVideoEncoder::IsCodecAvailable(config.codec))
+    {
+        *hr = MF_E_TOPO_CODEC_NOT_FOUND;
+        SetLastError(BAKETA_CAPTURE_STAGE_ENCODE, *hr, "No hardware encoder for the requested codec");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> encoderLock(m_encoderMutex);
+    m_encoder = std::make_unique<HardwareVideoEncoder>();
+    m_encoderConfig = config;
+    return true;
+}
+
+void WindowsCaptureSession::StopEncoder()
+{
+    std::lock_guard<std::mutex> encoderLock(m_encoderMutex);
+    m_encoder.reset();
+}
+
+bool WindowsCaptureSession::HasEncoder()
+{
+    std::lock_guard<std::mutex> encoderLock(m_encoderMutex);
+    return m_encoder != nullptr;
+}
+
+bool WindowsCaptureSession::EncodeFrame(bool forceKeyframe, int timeoutMs, int* queuedPackets)
+{
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *queuedPackets = 0;
+
+    // エンコーダーの入れ替え・停止と混ぜない
+    std::lock_guard<std::mutex> encoderLock(m_encoderMutex);
+    if (!m_encoder)
+    {
+        SetLastError("Encoder not started");
+        return false;
+    }
+
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasCaptureSource())
+    {
+        SetLastError("Capture session not created");
+        return false;
+    }
+
+    try
+    {
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        long long timestamp = 0;
+        unsigned long long sequence = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, &timestamp, &sequence))
+        {
+            return false;
+        }
+
+        // 出力サイズ（ResizeAndConvertTextureToBGRA と同じくアスペクト比を維持して縮小のみ、NV12 のため偶数に切り下げ）
+        int targetWidth = m_encoderConfig.targetWidth;
+        int targetHeight = m_encoderConfig.targetHeight;
+        int outputWidth = frameWidth;
+        int outputHeight = frameHeight;
+        if (targetWidth > 0 && targetHeight > 0 && (outputWidth > targetWidth || outputHeight > targetHeight))
         {
-            // フォーカスがないと白画像の原因になる場合がある
-            char focusWarning[512];
-            sprintf_s(focusWarning, sizeof(focusWarning), 
-                "Target window (0x%p) is not in foreground (current: 0x%p) - may cause white image", 
-                m_hwnd, foregroundWindow);
-            SetLastError(std::string(focusWarning));
-            // 警告だが継続 (フォーカスなしでもキャプチャできる場合がある)
+            float srcAspect = static_cast<float>(outputWidth) / static_cast<float>(outputHeight);
+            float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
+            if (srcAspect > targetAspect)
+            {
+                outputWidth = targetWidth;
+                outputHeight = static_cast<int>(targetWidth / srcAspect);
+            }
+            else
+            {
+                outputHeight = targetHeight;
+                outputWidth = static_cast<int>(targetHeight * srcAspect);
+            }
+        }
+        outputWidth = (std::max)(2, outputWidth & ~1);
+        outputHeight = (std::max)(2, outputHeight & ~1);
+
+        // 出力サイズが変わった場合はエンコーダーを作り直す（新しいストリームはキーフレームから始まる）
+        HRESULT hr = S_OK;
+        const HardwareVideoEncoder::Config& current = m_encoder->GetConfig();
+        if (!m_encoder->IsOpen() ||
+            current.width != static_cast<UINT>(outputWidth) || current.height != static_cast<UINT>(outputHeight))
+        {
+            HardwareVideoEncoder::Config config;
+            config.codec = m_encoderConfig.codec;
+            config.width = static_cast<UINT>(outputWidth);
+            config.height = static_cast<UINT>(outputHeight);
+            config.bitrateKbps = m_encoderConfig.bitrateKbps;
+            config.frameRate = m_encoderConfig.frameRate;
+            config.keyframeInterval = m_encoderConfig.keyframeInterval;
+            if (!m_encoder->Open(m_d3dDevice.Get(), m_d3dContext.Get(), m_sharedDevice->adapterLuid, config, &hr))
+            {
+                SetLastError(BAKETA_CAPTURE_STAGE_ENCODE, hr, "Failed to open hardware encoder: 0x" + std::to_string(hr));
+                return false;
+            }
         }
 
-        // 6. ウィンドウのクラス名取得 (デバッグ用)
-        char className[256] = {};
-        GetClassNameA(m_hwnd, className, sizeof(className));
-        
-        char windowTitle[256] = {};
-        GetWindowTextA(m_hwnd, windowTitle, sizeof(windowTitle));
+        bool encoded = m_encoder->Encode(m_d3dContext.Get(), frameTexture.Get(), static_cast<UINT>(frameWidth), static_cast<UINT>(frameHeight),
+            timestamp, sequence, forceKeyframe, timeoutMs, &hr);
+        *queuedPackets = static_cast<int>(m_encoder->GetQueuedPacketCount());
+        if (!encoded)
+        {
+            if (hr == MF_E_NOTACCEPTING)
+            {
+                SetLastError(BAKETA_CAPTURE_STAGE_ENCODE, hr, "Hardware encoder is not accepting input");
+                return false;
+            }
 
-        // 7. 統合デバッグ情報
-        char validationResult[1024];
-        sprintf_s(validationResult, sizeof(validationResult),
-            "Window validation PASSED: Class='%s', Title='%s', Size=%dx%d, Visible=%s, Focus=%s",
-            className, windowTitle, width, height,
-            IsWindowVisible(m_hwnd) ? "YES" : "NO",
-            isInForeground ? "YES" : "NO"
-        );
-        SetLastError(std::string(validationResult));
+            // エンコーダー・デバイスの異常は次回の呼び出しで作り直す
+            m_encoder->Reset();
+            SetLastError(BAKETA_CAPTURE_STAGE_ENCODE, hr, "Hardware encode failed: 0x" + std::to_string(hr));
+            return false;
+        }
 
-        return true;
+        return callScope.Succeed();
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        SetLastError("EncodeFrame winrt error: 0x" + std::to_string(ex.code()));
+        return false;
     }
     catch (const std::exception& ex)
     {
-        SetLastError(std::string("Window validation exception: ") + ex.what());
+        SetLastError(std::string("EncodeFrame exception: ") + ex.what());
         return false;
     }
     catch (...)
     {
-        SetLastError("Window validation unknown exception");
+        SetLastError("EncodeFrame unknown exception");
+        return false;
+    }
+}
+
+bool WindowsCaptureSession::ReadEncodedPacket(unsigned char* buffer, int bufferSize, BaketaCaptureEncodedPacket* packet, bool* available)
+{
+    *available = false;
+
+    std::lock_guard<std::mutex> encoderLock(m_encoderMutex);
+    if (!m_encoder)
+    {
+        SetLastError("Encoder not started");
+        return false;
+    }
+
+    const HardwareVideoEncoder::Packet* front = m_encoder->FrontPacket();
+    if (!front)
+    {
+        return true;
+    }
+
+    *available = true;
+    packet->dataSize = static_cast<int>(front->data.size());
+    packet->codec = front->codec;
+    packet->width = front->width;
+    packet->height = front->height;
+    packet->isKeyframe = front->keyframe ? 1 : 0;
+    packet->discontinuity = front->discontinuity ? 1 : 0;
+    packet->timestamp = front->timestamp;
+    packet->sequence = front->sequence;
+
+    // 容量不足の場合はパケットを残し、必要サイズだけ返す
+    if (!buffer || packet->dataSize > bufferSize)
+    {
+        return true;
+    }
+
+    memcpy(buffer, front->data.data(), front->data.size());
+    m_encoder->PopPacket();
+    return true;
+}
+
+bool WindowsCaptureSession::IsDirtyRegionSupported()
+{
+#if BAKETA_CAPTURE_HAS_DIRTY_REGIONS
+    static const bool supported = []()
+    {
+        try
+        {
+            return winrt::Windows::Foundation::Metadata::ApiInformation::IsPropertyPresent(
+                L"Windows.Graphics.Capture.Direct3D11CaptureFrame", L"DirtyRegions");
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool WindowsCaptureSession::SetDirtyRegionMode(bool enabled)
+{
+    if (!m_initialized || !m_captureSession)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!IsDirtyRegionSupported())
+    {
+        m_dirtyRegionsEnabled.store(false);
+        SetLastError("WGC DirtyRegions is not supported on this system");
+        return false;
+    }
+
+#if BAKETA_CAPTURE_HAS_DIRTY_REGIONS
+    try
+    {
+        // ReportOnly: フレーム全体は常に描画され、変化矩形が併せて報告される
+        // （ReportAndRender だと矩形外が不定になり、通常キャプチャ・タイル差分検出と共存できない）
+        std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+        m_captureSession.DirtyRegionMode(winrt::GraphicsCaptureDirtyRegionMode::ReportOnly);
+    }
+    catch (const winrt::hresult_error& ex)
+    {
+        m_lastHResult = ex.code();
+        SetLastError(BAKETA_CAPTURE_STAGE_FRAME_POOL, ex.code(), "SetDirtyRegionMode winrt error: 0x" + std::to_string(ex.code()));
+        return false;
+    }
+#endif
+
+    m_dirtyRegionsEnabled.store(enabled);
+    return true;
+}
+
+bool WindowsCaptureSession::SetAdaptiveResolution(int latencyBudgetUs, float minScale)
+{
+    if (!m_initialized || !m_sharedDevice)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (latencyBudgetUs <= 0)
+    {
+        m_adaptiveResolution.Disable();
+        return true;
+    }
+
+    if (!(minScale > 0.0f && minScale <= 1.0f))
+    {
+        SetLastError("Minimum scale must be in (0, 1]");
+        return false;
+    }
+
+    // 初期スケールはキャプチャデバイスが実際に使用しているアダプタの種類から決める
+    m_adaptiveResolution.Configure(latencyBudgetUs, minScale, m_sharedDevice->adapterLuid);
+    return true;
+}
+
+bool WindowsCaptureSession::SetAutoSuspend(bool enabled)
+{
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!m_hwnd)
+    {
+        // モニター・領域セッションは対象ウィンドウを持たない
+        SetLastError("Auto suspend is only supported for window sessions");
+        return false;
+    }
+
+    m_autoSuspendEnabled.store(enabled);
+
+    // 次の状態変更を待たずに現在の状態で反映する
+    OnWindowStateChanged(WindowStateMonitor::Query(m_hwnd));
+    return true;
+}
+
+bool WindowsCaptureSession::SetPipelinedReadback(bool enabled)
+{
+    if (!m_initialized)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
+
+    if (!HasOwnFramePool())
+    {
+        // 領域・リプレイセッションはフレーム到着時のコールバックを持たない
+        SetLastError("Pipelined readback is only supported for window and monitor sessions");
         return false;
     }
+
+    m_pipelinedReadback.store(enabled);
+    if (!enabled)
+    {
+        // 発行済みのコピーを破棄してステージングリングを解放する
+        std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+        m_readbackRing.Reset();
+        m_lastPipelinedSequence = 0;
+    }
+    return true;
+}
+
+void WindowsCaptureSession::StartWindowStateWatch()
+{
+    WindowStateMonitor::State initialState;
+    m_windowWatchId = WindowStateMonitor::Instance().Watch(
+        m_hwnd,
+        [this](const WindowStateMonitor::State& state) { OnWindowStateChanged(state); },
+        &initialState
+    );
+
+    // 監視できない場合も従来どおりキャプチャする（自動停止しないだけ）
+    if (m_windowWatchId != 0)
+    {
+        OnWindowStateChanged(initialState);
+    }
+}
+
+void WindowsCaptureSession::OnWindowStateChanged(const WindowStateMonitor::State& state)
+{
+    if (m_isClosing.load())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> controlLock(m_captureControlMutex);
+    bool autoSuspend = m_autoSuspendEnabled.load();
+    m_windowStateMinIntervalTicks.store(autoSuspend && state.occluded ? kOccludedFrameIntervalTicks : 0);
+
+    if (autoSuspend && state.IsInactive())
+    {
+        SuspendCaptureLocked();
+    }
+    else
+    {
+        ResumeCaptureLocked();
+    }
+}
+
+void WindowsCaptureSession::SuspendCaptureLocked()
+{
+    if (m_suspended.exchange(true))
+    {
+        return;
+    }
+
+    // 開始済みの WGC セッションを閉じる（StartCapture 後は停止できないため、復帰時に同じフレームプールから作り直す）
+    if (m_captureStarted.load())
+    {
+        m_resumeCapture = true;
+        m_captureStarted.store(false);
+        m_captureSessionClosed = true;
+        try
+        {
+            m_captureSession.Close();
+        }
+        catch (...) { /* 例外を無視 */ }
+    }
+
+    // 保持中のフレームを手放し、フレーム待機中の読み出し側を起こす（停止中エラーで即時に戻る）
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        m_frameReady = false;
+        m_latestFrame.Reset();
+    }
+    m_frameCondition.notify_all();
+
+    WaitForStreamCallbacks();
+    {
+        std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+        m_mailbox.Reset();
+    }
+}
+
+void WindowsCaptureSession::ResumeCaptureLocked()
+{
+    if (!m_suspended.exchange(false) || !m_resumeCapture)
+    {
+        return;
+    }
+
+    m_resumeCapture = false;
+    m_nextFrameDueTicks = 0;
+    try
+    {
+        StartCaptureLocked();
+    }
+    catch (...) { /* 例外を無視（次回キャプチャの EnsureCaptureStarted で再試行・検出される） */ }
+}
+
+void WindowsCaptureSession::RecreateFramePoolLocked(int bufferCount, winrt::SizeInt32 size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        m_frameReady = false;
+        m_latestFrame.Reset();
+    }
+    {
+        // 旧フレームプールのテクスチャを参照しているメールボックス・SRV を手放す
+        std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+        m_mailbox.Reset();
+        m_resizeCache.ReleaseSourceViews();
+
+        // 別のモニターへの移動・HDR の切り替えに追従してピクセル形式を選び直す
+        m_capturePixelFormat = SelectCapturePixelFormat();
+    }
+
+    m_framePool.Recreate(
+        m_winrtDevice,
+        m_capturePixelFormat,
+        bufferCount,
+        size
+    );
+
+    m_framePoolBuffers = bufferCount;
+    m_framePoolWidth.store(size.Width);
+    m_framePoolHeight.store(size.Height);
+}
+
+void WindowsCaptureSession::OnContentResized(winrt::SizeInt32 size)
+{
+    // StartStreaming・停止処理がロック中の場合は待たずに次のフレームで再試行する
+    std::unique_lock<std::mutex> controlLock(m_captureControlMutex, std::try_to_lock);
+    if (!controlLock.owns_lock() || m_isClosing.load() || !m_framePool)
+    {
+        return;
+    }
+
+    try
+    {
+        RecreateFramePoolLocked(m_framePoolBuffers, size);
+    }
+    catch (...) { /* 例外を無視（次のフレームで再試行される） */ }
+}
+
+void WindowsCaptureSession::WaitForStreamCallbacks()
+{
+    std::unique_lock<std::mutex> lock(m_streamCallbackMutex);
+    m_streamCallbacksIdle.wait(lock, [this] { return m_streamCallbacksInFlight == 0; });
+}
+
+bool WindowsCaptureSession::WaitForStreamCallbacks(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_streamCallbackMutex);
+    return m_streamCallbacksIdle.wait_for(lock, timeout, [this] { return m_streamCallbacksInFlight == 0; });
+}
+
+winrt::DirectXPixelFormat WindowsCaptureSession::SelectCapturePixelFormat()
+{
+    HMONITOR monitor = m_monitor ? m_monitor : MonitorFromWindow(m_hwnd, MONITOR_DEFAULTTONEAREST);
+    DisplayColorInfo colorInfo = DisplayColorInfo::Query(monitor);
+    m_toneMapWhiteScale.store(DisplayColorInfo::kScRgbWhiteNits / colorInfo.sdrWhiteNits);
+    m_toneMapPeakWhite.store((std::max)(1.0f, colorInfo.maxLuminanceNits / colorInfo.sdrWhiteNits));
+
+    // トーンマップはリサイズシェーダーで行うため、シェーダーを用意できない場合は OS の BGRA 変換に任せる
+    if (colorInfo.advancedColor && InitializeGpuResizeResources())
+    {
+        return winrt::DirectXPixelFormat::R16G16B16A16Float;
+    }
+    return winrt::DirectXPixelFormat::B8G8R8A8UIntNormalized;
+}
+
+void WindowsCaptureSession::ApplyCaptureSessionSettingsLocked()
+{
+#if BAKETA_CAPTURE_HAS_DIRTY_REGIONS
+    if (m_dirtyRegionsEnabled.load())
+    {
+        m_captureSession.DirtyRegionMode(winrt::GraphicsCaptureDirtyRegionMode::ReportOnly);
+    }
+#endif
 }
 
-bool WindowsCaptureSession::GetWindowDebugInfo(std::string& windowInfo, std::string& screenRect) const
+void WindowsCaptureSession::RecordDirtyRegions(winrt::Direct3D11CaptureFrame const& frame, unsigned long long sequence, int width, int height)
 {
-    if (!m_hwnd)
+    if (!m_dirtyRegionsEnabled.load(std::memory_order_relaxed))
     {
-        windowInfo = "Invalid HWND";
-        screenRect = "N/A";
-        return false;
+        return;
     }
 
+#if BAKETA_CAPTURE_HAS_DIRTY_REGIONS
     try
     {
-        // ウィンドウクラス名取得
-        char className[256] = {};
-        GetClassNameA(m_hwnd, className, sizeof(className));
-
-        // ウィンドウタイトル取得
-        char windowTitle[256] = {};
-        GetWindowTextA(m_hwnd, windowTitle, sizeof(windowTitle));
-
-        // スクリーン座標取得
-        RECT windowRect = {};
-        GetWindowRect(m_hwnd, &windowRect);
-
-        // クライアント領域サイズ取得
-        RECT clientRect = {};
-        GetClientRect(m_hwnd, &clientRect);
-
-        // ウィンドウ情報を構築
-        char infoBuffer[1024];
-        sprintf_s(infoBuffer, sizeof(infoBuffer),
-            "HWND=0x%p, Class='%s', Title='%s', ClientSize=%dx%d",
-            m_hwnd,
-            className,
-            windowTitle,
-            clientRect.right - clientRect.left,
-            clientRect.bottom - clientRect.top
-        );
-        windowInfo = std::string(infoBuffer);
+        auto regions = frame.DirtyRegions();
+        uint32_t regionCount = regions.Size();
+        if (regionCount > static_cast<uint32_t>(DirtyRegionTracker::kMaxRectsPerFrame))
+        {
+            m_dirtyTracker.Record(sequence, nullptr, 0, true);
+            return;
+        }
 
-        // スクリーン座標情報を構築
-        char rectBuffer[256];
-        sprintf_s(rectBuffer, sizeof(rectBuffer),
-            "Screen=(%d,%d)-(%d,%d), Size=%dx%d",
-            windowRect.left, windowRect.top,
-            windowRect.right, windowRect.bottom,
-            windowRect.right - windowRect.left,
-            windowRect.bottom - windowRect.top
-        );
-        screenRect = std::string(rectBuffer);
+        std::array<RECT, DirtyRegionTracker::kMaxRectsPerFrame> rects{};
+        int rectCount = 0;
+        for (uint32_t i = 0; i < regionCount; ++i)
+        {
+            auto region = regions.GetAt(i);
+            RECT rect = {
+                (std::max)(0, region.X),
+                (std::max)(0, region.Y),
+                (std::min)(width, region.X + region.Width),
+                (std::min)(height, region.Y + region.Height)
+            };
+            if (rect.right > rect.left && rect.bottom > rect.top)
+            {
+                rects[rectCount++] = rect;
+            }
+        }
 
-        return true;
+        m_dirtyTracker.Record(sequence, rects.data(), rectCount, false);
     }
     catch (...)
     {
-        windowInfo = "Exception during debug info retrieval";
-        screenRect = "N/A";
-        return false;
+        m_dirtyTracker.Record(sequence, nullptr, 0, true);
     }
+#else
+    (void)frame;
+    (void)width;
+    (void)height;
+    m_dirtyTracker.Record(sequence, nullptr, 0, true);
+#endif
 }
 
-/// <summary>
-/// 🚀 [Issue #193] フレームをキャプチャしてGPU側でリサイズ
-/// </summary>
-bool WindowsCaptureSession::CaptureFrameResized(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int timeoutMs)
+bool WindowsCaptureSession::CaptureFrameDirty(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, BaketaCaptureRect* dirtyRects, int maxRects, int* rectCount, int timeoutMs)
 {
+    // 呼び出し全体の所要時間と成否を統計へ記録
+    CaptureCallScope callScope(m_stats);
+
+    *bgraData = nullptr;
+    *rectCount = 0;
+
     if (!m_initialized)
     {
         SetLastError("Session not initialized");
         return false;
     }
 
-    if (!m_captureSession)
+    if (!HasCaptureSource())
     {
         SetLastError("Capture session not created");
         return false;
     }
 
-    // ターゲットサイズが0の場合は通常キャプチャにフォールバック
-    if (targetWidth <= 0 || targetHeight <= 0)
+    try
     {
-        bool result = CaptureFrame(bgraData, width, height, stride, timestamp, timeoutMs);
-        if (result && originalWidth && originalHeight)
+        // フレーム取得（通常モードは到着待ち、ストリーミングモードは最新フレームを即時取得）
+        ComPtr<ID3D11Texture2D> frameTexture;
+        int frameWidth = 0;
+        int frameHeight = 0;
+        unsigned long long frameSequence = 0;
+        std::unique_lock<std::mutex> readbackLock(m_readbackMutex, std::defer_lock);
+        if (!AcquireFrameForReadback(timeoutMs, readbackLock, frameTexture, &frameWidth, &frameHeight, timestamp, &frameSequence))
         {
-            // 🚀 [Issue #193] リサイズなしの場合、元のサイズ = キャプチャサイズ
-            *originalWidth = *width;
-            *originalHeight = *height;
+            return false;
+        }
+        if (sequence)
+        {
+            *sequence = frameSequence;
         }
-        return result;
-    }
 
-    try
-    {
-        // キャプチャを開始
-        m_captureSession.StartCapture();
+        const int packedStride = frameWidth * 4;
+        const size_t frameBytes = static_cast<size_t>(packedStride) * frameHeight;
+        bool sizeChanged = m_dirtyFrame.size() != frameBytes || m_dirtyFrameWidth != frameWidth || m_dirtyFrameHeight != frameHeight;
 
-        // フレーム待機
-        std::unique_lock<std::mutex> lock(m_frameMutex);
-        bool frameReceived = m_frameCondition.wait_for(
-            lock,
-            std::chrono::milliseconds(timeoutMs),
-            [this] { return m_frameReady; }
-        );
+        // 前回読み出したフレームから今回のフレームまでの変化矩形を収集
+        std::vector<RECT> rects;
+        bool fullFrame = sizeChanged || m_dirtyFrameSequence == 0 ||
+            (frameSequence != m_dirtyFrameSequence && !m_dirtyTracker.Collect(m_dirtyFrameSequence, frameSequence, rects));
 
-        if (!frameReceived)
+        // 変化面積がフレームの半分を超える場合は全体コピーの方が安い
+        if (!fullFrame && !rects.empty())
         {
-            SetLastError("Frame capture timeout");
-            return false;
+            long long dirtyArea = 0;
+            for (const auto& rect : rects)
+            {
+                dirtyArea += static_cast<long long>(rect.right - rect.left) * (rect.bottom - rect.top);
+            }
+            fullFrame = dirtyArea * 2 > static_cast<long long>(frameWidth) * frameHeight;
         }
 
-        // タイムスタンプを設定
-        *timestamp = m_frameTimestamp;
+        if (fullFrame)
+        {
+            if (sizeChanged)
+            {
+                m_dirtyFrame.assign(frameBytes, 0);
+                m_dirtyFrameWidth = frameWidth;
+                m_dirtyFrameHeight = frameHeight;
+            }
 
-        // 🚀 [Issue #193] 元のキャプチャサイズを保存（リサイズ前）
-        if (originalWidth && originalHeight)
+            // 永続フレームへ直接全体を書き込む（stride = 幅 * 4）
+            CaptureOutputBuffer persistentBuffer;
+            persistentBuffer.data = m_dirtyFrame.data();
+            persistentBuffer.capacity = m_dirtyFrame.size();
+            m_outputBuffer = &persistentBuffer;
+            unsigned char* written = nullptr;
+            int writtenStride = 0;
+            bool converted = ConvertTextureToBGRA(frameTexture.Get(), &written, &writtenStride);
+            m_outputBuffer = nullptr;
+            if (!converted)
+            {
+                m_dirtyFrameSequence = 0;
+                SetLastError("Failed to read full frame for dirty capture");
+                return false;
+            }
+
+            rects.assign(1, RECT{ 0, 0, frameWidth, frameHeight });
+        }
+        else if (!rects.empty())
         {
-            *originalWidth = m_frameWidth;
-            *originalHeight = m_frameHeight;
+            // 変化矩形のみステージングへコピーし、同じ位置の行だけ永続フレームへ転送
+            HRESULT hr = S_OK;
+            bool staged = m_staging.CopyRegions(m_d3dDevice.Get(), m_d3dContext.Get(), frameTexture.Get(),
+                static_cast<UINT>(frameWidth), static_cast<UINT>(frameHeight), DXGI_FORMAT_B8G8R8A8_UNORM,
+                rects.data(), static_cast<int>(rects.size()), &hr);
+            if (!staged)
+            {
+                m_lastHResult = hr;
+                SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to issue dirty region copy");
+                return false;
+            }
+
+            D3D11_MAPPED_SUBRESOURCE mapped;
+            hr = m_staging.Map(m_d3dContext.Get(), &mapped);
+            if (FAILED(hr))
+            {
+                m_lastHResult = hr;
+                SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map dirty region staging texture");
+                return false;
+            }
+
+            const auto* src = static_cast<const unsigned char*>(mapped.pData);
+            for (const auto& rect : rects)
+            {
+                size_t rowBytes = static_cast<size_t>(rect.right - rect.left) * 4;
+                for (LONG y = rect.top; y < rect.bottom; ++y)
+                {
+                    memcpy(m_dirtyFrame.data() + static_cast<size_t>(y) * packedStride + static_cast<size_t>(rect.left) * 4,
+                        src + static_cast<size_t>(y) * mapped.RowPitch + static_cast<size_t>(rect.left) * 4,
+                        rowBytes);
+                }
+            }
+
+            m_staging.Unmap(m_d3dContext.Get());
         }
 
-        // テクスチャをGPU上でリサイズしてBGRAデータに変換
-        if (!ResizeAndConvertTextureToBGRA(m_latestFrame.Get(), bgraData, width, height, stride, targetWidth, targetHeight))
+        m_dirtyFrameSequence = frameSequence;
+
+        // 矩形を出力（容量不足時は外接矩形にまとめる）
+        if (dirtyRects && maxRects > 0 && !rects.empty())
         {
-            SetLastError("Failed to resize and convert texture to BGRA");
-            return false;
-        }
+            if (static_cast<int>(rects.size()) > maxRects)
+            {
+                RECT bounds = rects[0];
+                for (const auto& rect : rects)
+                {
+                    bounds.left = (std::min)(bounds.left, rect.left);
+                    bounds.top = (std::min)(bounds.top, rect.top);
+                    bounds.right = (std::max)(bounds.right, rect.right);
+                    bounds.bottom = (std::max)(bounds.bottom, rect.bottom);
+                }
+                rects.assign(1, bounds);
+            }
 
-        // フレーム状態をリセット
-        m_frameReady = false;
+            for (size_t i = 0; i < rects.size(); ++i)
+            {
+                dirtyRects[i].x = rects[i].left;
+                dirtyRects[i].y = rects[i].top;
+                dirtyRects[i].width = rects[i].right - rects[i].left;
+                dirtyRects[i].height = rects[i].bottom - rects[i].top;
+            }
+            *rectCount = static_cast<int>(rects.size());
+        }
+        else
+        {
+            *rectCount = static_cast<int>(rects.size());
+        }
 
-        return true;
+        *bgraData = m_dirtyFrame.data();
+        *width = frameWidth;
+        *height = frameHeight;
+        *stride = packedStride;
+        return callScope.Succeed();
     }
     catch (const winrt::hresult_error& ex)
     {
-        SetLastError("CaptureFrameResized winrt error: 0x" + std::to_string(ex.code()));
+        SetLastError("CaptureFrameDirty winrt error: 0x" + std::to_string(ex.code()));
         return false;
     }
     catch (const std::exception& ex)
     {
-        SetLastError(std::string("CaptureFrameResized exception: ") + ex.what());
+        SetLastError(std::string("CaptureFrameDirty exception: ") + ex.what());
         return false;
     }
     catch (...)
     {
-        SetLastError("CaptureFrameResized unknown exception");
+        SetLastError("CaptureFrameDirty unknown exception");
         return false;
     }
 }
@@ -939,37 +4448,22 @@ bool WindowsCaptureSession::CaptureFrameResized(unsigned char** bgraData, int* w
 // 🚀 [Issue #193] GPU Shader Resize 実装
 // ========================================
 
-// HLSLシェーダーコード（インライン埋め込み）
-static const char* g_ResizeShaderCode = R"(
-// Vertex Shader + Pixel Shader for GPU Bilinear Resize
-Texture2D<float4> sourceTexture : register(t0);
-SamplerState bilinearSampler : register(s0);
-
-struct VSInput
-{
-    float2 Position : POSITION;
-    float2 TexCoord : TEXCOORD0;
-};
-
-struct PSInput
-{
-    float4 Position : SV_POSITION;
-    float2 TexCoord : TEXCOORD0;
-};
+// ResizeShader.hlsl をビルド時にコンパイルしたバイトコード（実行時の D3DCompile を行わない）
+#include "shaders/ResizeVS.h"
+#include "shaders/ResizePS.h"
 
-PSInput VSMain(VSInput input)
+bool WindowsCaptureSession::PrewarmGpuResources()
 {
-    PSInput output;
-    output.Position = float4(input.Position, 0.0f, 1.0f);
-    output.TexCoord = input.TexCoord;
-    return output;
-}
+    if (!m_initialized || !m_d3dDevice)
+    {
+        SetLastError("Session not initialized");
+        return false;
+    }
 
-float4 PSMain(PSInput input) : SV_TARGET
-{
-    return sourceTexture.Sample(bilinearSampler, input.TexCoord);
+    // キャプチャ経路と同じく読み出しロック下で作成（初回キャプチャと並行しても二重に作成しない）
+    std::lock_guard<std::mutex> readbackLock(m_readbackMutex);
+    return InitializeGpuResizeResources();
 }
-)";
 
 /// <summary>
 /// 🚀 [Issue #193] GPUシェーダーリサイズリソースを初期化
@@ -983,43 +4477,16 @@ bool WindowsCaptureSession::InitializeGpuResizeResources()
     {
         HRESULT hr;
 
-        // 1. Vertex Shaderをコンパイル
-        ComPtr<ID3DBlob> vsBlob;
-        ComPtr<ID3DBlob> errorBlob;
-        hr = D3DCompile(g_ResizeShaderCode, strlen(g_ResizeShaderCode), "ResizeShader",
-            nullptr, nullptr, "VSMain", "vs_5_0", 0, 0, &vsBlob, &errorBlob);
-        if (FAILED(hr))
-        {
-            std::string errorMsg = "VS compile failed";
-            if (errorBlob)
-                errorMsg += ": " + std::string(static_cast<char*>(errorBlob->GetBufferPointer()));
-            SetLastError(errorMsg);
-            return false;
-        }
-
-        hr = m_d3dDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(),
-            nullptr, &m_vertexShader);
+        // 1. Vertex Shaderを作成（ビルド時にコンパイル済みのバイトコード）
+        hr = m_d3dDevice->CreateVertexShader(g_ResizeVS, sizeof(g_ResizeVS), nullptr, &m_vertexShader);
         if (FAILED(hr))
         {
             SetLastError("Failed to create vertex shader");
             return false;
         }
 
-        // 2. Pixel Shaderをコンパイル
-        ComPtr<ID3DBlob> psBlob;
-        hr = D3DCompile(g_ResizeShaderCode, strlen(g_ResizeShaderCode), "ResizeShader",
-            nullptr, nullptr, "PSMain", "ps_5_0", 0, 0, &psBlob, &errorBlob);
-        if (FAILED(hr))
-        {
-            std::string errorMsg = "PS compile failed";
-            if (errorBlob)
-                errorMsg += ": " + std::string(static_cast<char*>(errorBlob->GetBufferPointer()));
-            SetLastError(errorMsg);
-            return false;
-        }
-
-        hr = m_d3dDevice->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(),
-            nullptr, &m_pixelShader);
+        // 2. Pixel Shaderを作成
+        hr = m_d3dDevice->CreatePixelShader(g_ResizePS, sizeof(g_ResizePS), nullptr, &m_pixelShader);
         if (FAILED(hr))
         {
             SetLastError("Failed to create pixel shader");
@@ -1032,8 +4499,7 @@ bool WindowsCaptureSession::InitializeGpuResizeResources()
             { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 }
         };
 
-        hr = m_d3dDevice->CreateInputLayout(inputLayout, 2, vsBlob->GetBufferPointer(),
-            vsBlob->GetBufferSize(), &m_inputLayout);
+        hr = m_d3dDevice->CreateInputLayout(inputLayout, 2, g_ResizeVS, sizeof(g_ResizeVS), &m_inputLayout);
         if (FAILED(hr))
         {
             SetLastError("Failed to create input layout");
@@ -1081,8 +4547,22 @@ bool WindowsCaptureSession::InitializeGpuResizeResources()
             return false;
         }
 
+        // 6. サンプリング領域用の定数バッファを作成
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+        cbDesc.ByteWidth = sizeof(ResizeShaderParams);
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        hr = m_d3dDevice->CreateBuffer(&cbDesc, nullptr, &m_resizeParamsBuffer);
+        if (FAILED(hr))
+        {
+            SetLastError("Failed to create resize constant buffer");
+            return false;
+        }
+
         m_gpuResizeInitialized = true;
-        SetLastError("GPU resize resources initialized successfully");
+        LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, "GPU resize resources initialized successfully");
         return true;
     }
     catch (const std::exception& ex)
@@ -1097,6 +4577,68 @@ bool WindowsCaptureSession::InitializeGpuResizeResources()
     }
 }
 
+/// <summary>
+/// リサイズシェーダーでソースの UV 領域をビューポートへ描画
+/// </summary>
+bool WindowsCaptureSession::DrawResizeQuad(ID3D11ShaderResourceView* sourceSrv, ID3D11RenderTargetView* rtv, const D3D11_VIEWPORT& viewport, float uvOffsetX, float uvOffsetY, float uvScaleX, float uvScaleY)
+{
+    // 定数バッファ更新から描画までを他セッションと混在させない
+    D3DContextLock contextLock(m_d3dContext.Get());
+
+    // FP16（scRGB）ソースは描画と同時に SDR へトーンマップ（領域セッションはフレームソースのモニター設定に従う）
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    sourceSrv->GetDesc(&srvDesc);
+    const WindowsCaptureSession& colorOwner = m_frameSource ? *m_frameSource : *this;
+
+    D3D11_MAPPED_SUBRESOURCE mappedParams;
+    HRESULT hr = m_d3dContext->Map(m_resizeParamsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedParams);
+    if (FAILED(hr))
+    {
+        SetLastError("Failed to map resize constant buffer");
+        return false;
+    }
+    auto* params = static_cast<ResizeShaderParams*>(mappedParams.pData);
+    params->uvOffset[0] = uvOffsetX;
+    params->uvOffset[1] = uvOffsetY;
+    params->uvScale[0] = uvScaleX;
+    params->uvScale[1] = uvScaleY;
+    params->toneMap = srvDesc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 1u : 0u;
+    params->sdrWhiteScale = colorOwner.m_toneMapWhiteScale.load(std::memory_order_relaxed);
+    params->peakWhite = colorOwner.m_toneMapPeakWhite.load(std::memory_order_relaxed);
+    params->padding = 0.0f;
+    m_d3dContext->Unmap(m_resizeParamsBuffer.Get(), 0);
+
+    // 固定のパイプライン状態は、共有コンテキストへ最後にバインドしたのが別セッションの場合のみ設定
+    if (m_sharedDevice->resizePipelineOwner != this)
+    {
+        m_d3dContext->IASetInputLayout(m_inputLayout.Get());
+        m_d3dContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+        UINT stride = sizeof(float) * 4;
+        UINT offset = 0;
+        ID3D11Buffer* vbArray[] = { m_vertexBuffer.Get() };
+        m_d3dContext->IASetVertexBuffers(0, 1, vbArray, &stride, &offset);
+        m_d3dContext->VSSetShader(m_vertexShader.Get(), nullptr, 0);
+        ID3D11Buffer* cbArray[] = { m_resizeParamsBuffer.Get() };
+        m_d3dContext->VSSetConstantBuffers(0, 1, cbArray);
+        m_d3dContext->PSSetShader(m_pixelShader.Get(), nullptr, 0);
+        m_d3dContext->PSSetConstantBuffers(0, 1, cbArray);
+        ID3D11SamplerState* samplerArray[] = { m_bilinearSampler.Get() };
+        m_d3dContext->PSSetSamplers(0, 1, samplerArray);
+        m_sharedDevice->resizePipelineOwner = this;
+    }
+
+    // 描画ごとに変わるのはビューポート・レンダーターゲット・ソースのみ
+    m_d3dContext->RSSetViewports(1, &viewport);
+    ID3D11RenderTargetView* rtvArray[] = { rtv };
+    m_d3dContext->OMSetRenderTargets(1, rtvArray, nullptr);
+    ID3D11ShaderResourceView* srvArray[] = { sourceSrv };
+    m_d3dContext->PSSetShaderResources(0, 1, srvArray);
+
+    // 描画（クワッド）
+    m_d3dContext->Draw(4, 0);
+    return true;
+}
+
 /// <summary>
 /// 🚀 [Issue #193] GPU上でテクスチャをリサイズ（シェーダー使用）
 /// </summary>
@@ -1107,104 +4649,51 @@ bool WindowsCaptureSession::GpuResizeTexture(ID3D11Texture2D* sourceTexture, int
         if (!InitializeGpuResizeResources())
             return false;
 
-        HRESULT hr;
-
-        // 1. ソースSRV（Shader Resource View）を作成
-        D3D11_TEXTURE2D_DESC srcDesc;
-        sourceTexture->GetDesc(&srcDesc);
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = srcDesc.Format;
-        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MostDetailedMip = 0;
-        srvDesc.Texture2D.MipLevels = 1;
+        HRESULT hr = S_OK;
 
-        ComPtr<ID3D11ShaderResourceView> sourceSRV;
-        hr = m_d3dDevice->CreateShaderResourceView(sourceTexture, &srvDesc, &sourceSRV);
-        if (FAILED(hr))
+        // 1. ソースSRV（フレームプールのテクスチャごとにキャッシュ）
+        ID3D11ShaderResourceView* sourceSRV = m_resizeCache.GetSourceView(m_d3dDevice.Get(), sourceTexture, &hr);
+        if (!sourceSRV)
         {
-            SetLastError("Failed to create source SRV");
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create source SRV");
             return false;
         }
 
-        // 2. リサイズ先のRender Targetテクスチャを作成
-        D3D11_TEXTURE2D_DESC rtDesc = {};
-        rtDesc.Width = targetWidth;
-        rtDesc.Height = targetHeight;
-        rtDesc.MipLevels = 1;
-        rtDesc.ArraySize = 1;
-        rtDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-        rtDesc.SampleDesc.Count = 1;
-        rtDesc.SampleDesc.Quality = 0;
-        rtDesc.Usage = D3D11_USAGE_DEFAULT;
-        rtDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-
+        // 2. リサイズ先のRender Targetテクスチャ・RTV（出力サイズごとにキャッシュ）
         ComPtr<ID3D11Texture2D> renderTargetTexture;
-        hr = m_d3dDevice->CreateTexture2D(&rtDesc, nullptr, &renderTargetTexture);
-        if (FAILED(hr))
-        {
-            SetLastError("Failed to create render target texture");
-            return false;
-        }
-
-        // 3. Render Target Viewを作成
-        ComPtr<ID3D11RenderTargetView> rtv;
-        hr = m_d3dDevice->CreateRenderTargetView(renderTargetTexture.Get(), nullptr, &rtv);
-        if (FAILED(hr))
+        ID3D11RenderTargetView* rtv = nullptr;
+        if (!m_resizeCache.GetRenderTarget(m_d3dDevice.Get(), static_cast<UINT>(targetWidth), static_cast<UINT>(targetHeight), renderTargetTexture, &rtv, &hr))
         {
-            SetLastError("Failed to create render target view");
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, hr, "Failed to create render target texture");
             return false;
         }
 
-        // 4. レンダリングパイプラインを設定
-        // 現在の状態を保存
-        // Note: このDLLは専用D3Dパイプラインを使用しているため、
-        // IA/VS/PSステージの完全な状態保存は省略しています。
-        // 他のD3Dアプリケーションと共有する場合は、これらの状態も保存・復元が必要です。
-        ComPtr<ID3D11RenderTargetView> oldRTV;
-        ComPtr<ID3D11DepthStencilView> oldDSV;
-        D3D11_VIEWPORT oldViewport;
-        UINT numViewports = 1;
-        m_d3dContext->RSGetViewports(&numViewports, &oldViewport);
-        m_d3dContext->OMGetRenderTargets(1, &oldRTV, &oldDSV);
-
-        // ビューポートを設定
+        // 3. 描画（ソース全体をターゲット全体へ）
         D3D11_VIEWPORT viewport = {};
         viewport.Width = static_cast<float>(targetWidth);
         viewport.Height = static_cast<float>(targetHeight);
         viewport.MinDepth = 0.0f;
         viewport.MaxDepth = 1.0f;
-        m_d3dContext->RSSetViewports(1, &viewport);
-
-        // レンダーターゲットを設定
-        ID3D11RenderTargetView* rtvArray[] = { rtv.Get() };
-        m_d3dContext->OMSetRenderTargets(1, rtvArray, nullptr);
-
-        // シェーダーを設定
-        m_d3dContext->IASetInputLayout(m_inputLayout.Get());
-        m_d3dContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-        UINT stride = sizeof(float) * 4;
-        UINT offset = 0;
-        ID3D11Buffer* vbArray[] = { m_vertexBuffer.Get() };
-        m_d3dContext->IASetVertexBuffers(0, 1, vbArray, &stride, &offset);
-        m_d3dContext->VSSetShader(m_vertexShader.Get(), nullptr, 0);
-        m_d3dContext->PSSetShader(m_pixelShader.Get(), nullptr, 0);
-        ID3D11ShaderResourceView* srvArray[] = { sourceSRV.Get() };
-        m_d3dContext->PSSetShaderResources(0, 1, srvArray);
-        ID3D11SamplerState* samplerArray[] = { m_bilinearSampler.Get() };
-        m_d3dContext->PSSetSamplers(0, 1, samplerArray);
-
-        // 5. 描画（フルスクリーンクワッド）
-        m_d3dContext->Draw(4, 0);
-
-        // 6. 状態を復元
-        m_d3dContext->RSSetViewports(1, &oldViewport);
-        m_d3dContext->OMSetRenderTargets(1, oldRTV.GetAddressOf(), oldDSV.Get());
+        // GPU 実行時間をタイムスタンプで計測（他セッションの描画が区間に混ざらないようコンテキストを保持）
+        D3DContextLock contextLock(m_d3dContext.Get());
+        bool timing = m_gpuResizeTimer.Begin(m_d3dDevice.Get(), m_d3dContext.Get(), m_stats, BAKETA_CAPTURE_TIMING_GPU_RESIZE_GPU);
+        bool drawn = DrawResizeQuad(sourceSRV, rtv, viewport, 0.0f, 0.0f, 1.0f, 1.0f);
+        if (timing)
+        {
+            m_gpuResizeTimer.End(m_d3dContext.Get());
+        }
 
         // SRVをアンバインド
         ID3D11ShaderResourceView* nullSRV[] = { nullptr };
         m_d3dContext->PSSetShaderResources(0, 1, nullSRV);
 
+        if (!drawn)
+        {
+            return false;
+        }
+
         resizedTexture = renderTargetTexture;
         return true;
     }
@@ -1220,6 +4709,46 @@ bool WindowsCaptureSession::GpuResizeTexture(ID3D11Texture2D* sourceTexture, int
     }
 }
 
+/// <summary>
+/// テクスチャ全体を BGRA のままキャッシュ可能な作業バッファへ読み出す（CPU フォールバック用）
+/// </summary>
+bool WindowsCaptureSession::ReadbackToScratch(ID3D11Texture2D* texture, int width, int height, CpuImageKernels::ConstImage* image)
+{
+    HRESULT hr = S_OK;
+    long long stageStart = CaptureStats::Now();
+    bool staged = m_staging.Copy(m_d3dDevice.Get(), m_d3dContext.Get(), texture,
+        static_cast<UINT>(width), static_cast<UINT>(height), DXGI_FORMAT_B8G8R8A8_UNORM, &hr);
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_COPY, stageStart);
+    if (!staged)
+    {
+        m_lastHResult = hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to create staging texture for CPU fallback");
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    stageStart = CaptureStats::Now();
+    hr = m_staging.Map(m_d3dContext.Get(), &mapped);
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_MAP, stageStart);
+    if (FAILED(hr))
+    {
+        m_lastHResult = hr;
+        SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to map staging texture for CPU fallback");
+        return false;
+    }
+
+    // マップしたメモリは非キャッシュの場合があるため、ストリーミングロードで一度だけ読み出して早めに Unmap する
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    m_cpuScratch.resize(rowBytes * height);
+    stageStart = CaptureStats::Now();
+    CpuImageKernels::CopyPlane(static_cast<const unsigned char*>(mapped.pData), mapped.RowPitch, m_cpuScratch.data(), rowBytes, rowBytes, height);
+    m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ROW_COPY, stageStart);
+    m_staging.Unmap(m_d3dContext.Get());
+
+    *image = { m_cpuScratch.data(), width, height, rowBytes };
+    return true;
+}
+
 /// <summary>
 /// 🚀 [Issue #193] テクスチャをGPU上でリサイズしてBGRAデータに変換
 /// GPU Shader Resize（真のGPUリサイズ）実装
@@ -1242,150 +4771,101 @@ bool WindowsCaptureSession::ResizeAndConvertTextureToBGRA(ID3D11Texture2D* textu
         int srcHeight = static_cast<int>(srcDesc.Height);
 
         // アスペクト比を維持してターゲットサイズを計算
-        float srcAspect = static_cast<float>(srcWidth) / static_cast<float>(srcHeight);
-        float targetAspect = static_cast<float>(targetWidth) / static_cast<float>(targetHeight);
-
-        int finalWidth, finalHeight;
-        if (srcAspect > targetAspect)
-        {
-            finalWidth = targetWidth;
-            finalHeight = static_cast<int>(targetWidth / srcAspect);
-        }
-        else
-        {
-            finalHeight = targetHeight;
-            finalWidth = static_cast<int>(targetHeight * srcAspect);
-        }
-
-        finalWidth = (std::max)(1, finalWidth);
-        finalHeight = (std::max)(1, finalHeight);
+        int finalWidth = 0;
+        int finalHeight = 0;
+        FitToTarget(srcWidth, srcHeight, targetWidth, targetHeight, &finalWidth, &finalHeight);
 
-        // リサイズが不要な場合
+        // リサイズが不要な場合（FP16 フレームはトーンマップのみ行う）
         if (srcWidth <= targetWidth && srcHeight <= targetHeight)
         {
+            ComPtr<ID3D11Texture2D> sdrTexture = texture;
+            if (!ResolveSdrFrame(sdrTexture))
+            {
+                return false;
+            }
             *outputWidth = srcWidth;
             *outputHeight = srcHeight;
-            return ConvertTextureToBGRA(texture, bgraData, stride);
+            return ConvertTextureToBGRA(sdrTexture.Get(), bgraData, stride);
         }
 
-        // 🔍 デバッグログ
-        char debugBuffer[512];
-        sprintf_s(debugBuffer, sizeof(debugBuffer),
-            "GPU_SHADER_RESIZE: Source=%dx%d -> Target=%dx%d -> Final=%dx%d (Transfer: %zu KB -> %zu KB)",
-            srcWidth, srcHeight, targetWidth, targetHeight, finalWidth, finalHeight,
-            (srcWidth * srcHeight * 4) / 1024, (finalWidth * finalHeight * 4) / 1024);
-        SetLastError(std::string(debugBuffer));
+        // 🔍 デバッグログ（詳細診断レベル時のみ）
+        if (CaptureDiagnostics::IsEnabled(BAKETA_CAPTURE_DIAG_VERBOSE))
+        {
+            char debugBuffer[512];
+            sprintf_s(debugBuffer, sizeof(debugBuffer),
+                "GPU_SHADER_RESIZE: Source=%dx%d -> Target=%dx%d -> Final=%dx%d (Transfer: %zu KB -> %zu KB)",
+                srcWidth, srcHeight, targetWidth, targetHeight, finalWidth, finalHeight,
+                static_cast<size_t>(srcWidth * srcHeight * 4) / 1024, static_cast<size_t>(finalWidth * finalHeight * 4) / 1024);
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_VERBOSE, debugBuffer);
+        }
 
-        // 🚀 GPU上でリサイズ
+        // 🚀 GPU上でリサイズ（パイプライン読み出しで到着時にリサイズ・コピー発行済みの場合は省く）
         ComPtr<ID3D11Texture2D> resizedTexture;
-        if (!GpuResizeTexture(texture, finalWidth, finalHeight, resizedTexture))
-        {
-            // シェーダーが失敗した場合はCPUフォールバック（フェイルセーフ）
-            SetLastError("GPU shader resize failed, using CPU fallback");
-            // 以下はCPUリサイズのフォールバックコード
-            D3D11_TEXTURE2D_DESC stagingDesc = {};
-            stagingDesc.Width = srcDesc.Width;
-            stagingDesc.Height = srcDesc.Height;
-            stagingDesc.MipLevels = 1;
-            stagingDesc.ArraySize = 1;
-            stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-            stagingDesc.Usage = D3D11_USAGE_STAGING;
-            stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-            stagingDesc.SampleDesc.Count = 1;
-
-            ComPtr<ID3D11Texture2D> stagingTexture;
-            if (FAILED(m_d3dDevice->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture)))
+        long long stageStart = CaptureStats::Now();
+        bool prefetched = HasPrefetchedReadback(finalWidth, finalHeight);
+        bool resized = prefetched || GpuResizeTexture(texture, finalWidth, finalHeight, resizedTexture);
+        if (!prefetched)
+        {
+            m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_GPU_RESIZE, stageStart);
+        }
+        if (!resized)
+        {
+            m_stats.CountFallback();
+
+            // CPU カーネルは BGRA 専用のため、FP16 フレームはフォールバックできない
+            if (srcDesc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+            {
+                SetLastError(BAKETA_CAPTURE_STAGE_GPU_PROCESS, m_lastHResult, "GPU tone mapping failed for HDR frame");
                 return false;
+            }
 
-            m_d3dContext->CopyResource(stagingTexture.Get(), texture);
-            D3D11_MAPPED_SUBRESOURCE mappedResource;
-            if (FAILED(m_d3dContext->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource)))
+            // シェーダーが失敗した場合はCPUフォールバック（フェイルセーフ、GpuResizeTexture のエラーはそのまま残す）
+            LogDiagnostic(BAKETA_CAPTURE_DIAG_BASIC, "GPU shader resize failed, using CPU fallback");
+            // 以下はCPUリサイズのフォールバックコード（キャッシュ可能なバッファへ読み出してから SIMD カーネルで縮小）
+            CpuImageKernels::ConstImage source = {};
+            if (!ReadbackToScratch(texture, srcWidth, srcHeight, &source))
                 return false;
 
             UINT outputPixelRowBytes = finalWidth * 4;
-            UINT outputAlignedStride = ((outputPixelRowBytes + 15) / 16) * 16;
-            *bgraData = static_cast<unsigned char*>(_aligned_malloc(finalHeight * outputAlignedStride, 16));
-            if (!(*bgraData)) {
-                m_d3dContext->Unmap(stagingTexture.Get(), 0);
+            int outputStride = 0;
+            stageStart = CaptureStats::Now();
+            *bgraData = AcquireOutputBuffer(finalWidth, finalHeight, 4, static_cast<int>(((outputPixelRowBytes + 15) / 16) * 16), &outputStride);
+            m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ALLOCATION, stageStart);
+            if (!(*bgraData))
+            {
+                SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate resized output buffer");
                 return false;
             }
 
-            const unsigned char* srcData = static_cast<const unsigned char*>(mappedResource.pData);
-            unsigned char* dstData = *bgraData;
-            UINT srcRowPitch = static_cast<UINT>(mappedResource.RowPitch);
-            float xRatio = static_cast<float>(srcWidth) / finalWidth;
-            float yRatio = static_cast<float>(srcHeight) / finalHeight;
-
-            for (int y = 0; y < finalHeight; ++y) {
-                float srcY = y * yRatio;
-                int y0 = static_cast<int>(srcY);
-                int y1 = (std::min)(y0 + 1, srcHeight - 1);
-                float yFrac = srcY - y0;
-                unsigned char* dstRow = dstData + y * outputAlignedStride;
-                for (int x = 0; x < finalWidth; ++x) {
-                    float srcX = x * xRatio;
-                    int x0 = static_cast<int>(srcX);
-                    int x1 = (std::min)(x0 + 1, srcWidth - 1);
-                    float xFrac = srcX - x0;
-                    const unsigned char* p00 = srcData + y0 * srcRowPitch + x0 * 4;
-                    const unsigned char* p10 = srcData + y0 * srcRowPitch + x1 * 4;
-                    const unsigned char* p01 = srcData + y1 * srcRowPitch + x0 * 4;
-                    const unsigned char* p11 = srcData + y1 * srcRowPitch + x1 * 4;
-                    for (int c = 0; c < 4; ++c) {
-                        float top = p00[c] * (1 - xFrac) + p10[c] * xFrac;
-                        float bottom = p01[c] * (1 - xFrac) + p11[c] * xFrac;
-                        dstRow[x * 4 + c] = static_cast<unsigned char>((std::min)(255.0f, (std::max)(0.0f, top * (1 - yFrac) + bottom * yFrac)));
-                    }
-                }
-            }
-            m_d3dContext->Unmap(stagingTexture.Get(), 0);
+            CpuImageKernels::ResizeBgra(source, { *bgraData, finalWidth, finalHeight, static_cast<size_t>(outputStride) });
             *outputWidth = finalWidth;
             *outputHeight = finalHeight;
-            *stride = static_cast<int>(outputAlignedStride);
+            *stride = outputStride;
             return true;
         }
 
-        // 🚀 リサイズ後のテクスチャをステージングテクスチャにコピーしてCPUに読み取り
-        D3D11_TEXTURE2D_DESC stagingDesc = {};
-        stagingDesc.Width = finalWidth;
-        stagingDesc.Height = finalHeight;
-        stagingDesc.MipLevels = 1;
-        stagingDesc.ArraySize = 1;
-        stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-        stagingDesc.Usage = D3D11_USAGE_STAGING;
-        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-        stagingDesc.SampleDesc.Count = 1;
-
-        ComPtr<ID3D11Texture2D> stagingTexture;
-        HRESULT hr = m_d3dDevice->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture);
-        if (FAILED(hr))
-        {
-            SetLastError("Failed to create staging texture after GPU resize");
-            return false;
-        }
-
-        // リサイズ済みテクスチャをステージングテクスチャにコピー
-        m_d3dContext->CopyResource(stagingTexture.Get(), resizedTexture.Get());
-
-        // ステージングテクスチャをマップしてCPUに読み取り
+        // 🚀 リサイズ後のテクスチャをステージングテクスチャへコピー発行してCPUに読み取り
         D3D11_MAPPED_SUBRESOURCE mappedResource;
-        hr = m_d3dContext->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
+        int stagingSlot = -1;
+        HRESULT hr = MapForReadback(resizedTexture.Get(), static_cast<UINT>(finalWidth), static_cast<UINT>(finalHeight), &mappedResource, &stagingSlot);
         if (FAILED(hr))
         {
-            SetLastError("Failed to map staging texture after GPU resize");
+            m_lastHResult = hr;
+            SetLastError(BAKETA_CAPTURE_STAGE_READBACK, hr, "Failed to stage or map texture after GPU resize");
             return false;
         }
 
-        // 出力バッファを確保
+        // 出力バッファを取得（プールまたは呼び出し側バッファ）
         UINT outputPixelRowBytes = finalWidth * 4;
-        UINT outputAlignedStride = ((outputPixelRowBytes + 15) / 16) * 16;
-        size_t outputDataSize = finalHeight * outputAlignedStride;
-
-        *bgraData = static_cast<unsigned char*>(_aligned_malloc(outputDataSize, 16));
+        int outputStride = 0;
+        stageStart = CaptureStats::Now();
+        *bgraData = AcquireOutputBuffer(finalWidth, finalHeight, 4, static_cast<int>(((outputPixelRowBytes + 15) / 16) * 16), &outputStride);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ALLOCATION, stageStart);
+        UINT outputAlignedStride = static_cast<UINT>(outputStride);
         if (!(*bgraData))
         {
-            m_d3dContext->Unmap(stagingTexture.Get(), 0);
-            SetLastError("Failed to allocate output buffer after GPU resize");
+            UnmapReadback(stagingSlot);
+            SetLastError(BAKETA_CAPTURE_STAGE_ALLOCATION, E_OUTOFMEMORY, "Failed to allocate output buffer after GPU resize");
             return false;
         }
 
@@ -1394,14 +4874,11 @@ bool WindowsCaptureSession::ResizeAndConvertTextureToBGRA(ID3D11Texture2D* textu
         unsigned char* dstData = *bgraData;
         UINT srcRowPitch = static_cast<UINT>(mappedResource.RowPitch);
 
-        for (int y = 0; y < finalHeight; ++y)
-        {
-            unsigned char* dstRow = dstData + y * outputAlignedStride;
-            const unsigned char* srcRow = srcData + y * srcRowPitch;
-            memcpy(dstRow, srcRow, outputPixelRowBytes);
-        }
+        stageStart = CaptureStats::Now();
+        CpuImageKernels::CopyPlane(srcData, srcRowPitch, dstData, outputAlignedStride, outputPixelRowBytes, finalHeight);
+        m_stats.RecordStageSince(BAKETA_CAPTURE_TIMING_ROW_COPY, stageStart);
 
-        m_d3dContext->Unmap(stagingTexture.Get(), 0);
+        UnmapReadback(stagingSlot);
 
         *outputWidth = finalWidth;
         *outputHeight = finalHeight;
@@ -1,5 +1,47 @@
 ﻿#pragma once
 
+/// <summary>
+/// 呼び出し側が用意した出力バッファ（BaketaCapture_CaptureFrameInto 用）
+/// 指定時は FrameBufferPool を使わず、stride = 幅 * 4 で詰めて書き込む
+/// </summary>
+struct CaptureOutputBuffer
+{
+    unsigned char* data = nullptr;  // 出力先バッファ
+    size_t capacity = 0;            // バッファ容量（バイト）
+    size_t requiredSize = 0;        // 必要バイト数（出力：容量不足時に設定）
+};
+
+/// <summary>
+/// バッチキャプチャ（BaketaCapture_CaptureBatch）の 1 セッション分の読み出し状態
+/// BeginBatchReadback でステージングコピーの発行まで行い、EndBatchReadback でマップして出力する
+/// </summary>
+struct BatchReadback
+{
+    std::unique_lock<std::mutex> readbackLock;  // 発行からマップまで保持する読み出しロック
+    ComPtr<ID3D11Texture2D> frameTexture;       // 取得したフレーム（CPU フォールバック時のリサイズ元）
+    bool staged = false;                        // ステージングテクスチャへコピー発行済み
+    bool cpuFallback = false;                   // GPU リサイズに失敗し、マップ時に CPU で縮小する
+    int width = 0;                              // 出力幅（リサイズ後）
+    int height = 0;                             // 出力高さ（リサイズ後）
+    int originalWidth = 0;                      // 元のキャプチャ幅
+    int originalHeight = 0;                     // 元のキャプチャ高さ
+    long long timestamp = 0;                    // フレームの提示時刻
+    unsigned long long sequence = 0;            // フレーム通し番号
+    long long startTicks = 0;                   // 統計用の開始時刻
+};
+
+/// <summary>
+/// パイプライン読み出し中の CaptureFrame / CaptureFrameResized 1 回分のフレーム情報
+/// 取得したフレームのコピーが未完了で 1 つ前のフレームを返した場合、sequence / timestamp はそのフレームの値に置き換わる
+/// </summary>
+struct PipelinedReadbackFrame
+{
+    unsigned long long sequence = 0;  // 取得したフレームの通し番号（出力：返したフレーム）
+    long long timestamp = 0;          // 取得したフレームの提示時刻（出力：返したフレーム）
+    int sourceWidth = 0;              // リサイズ前のフレームサイズ
+    int sourceHeight = 0;
+};
+
 class WindowsCaptureSession
 {
 public:
@@ -9,6 +51,31 @@ public:
     /// <param name="sessionId">セッションID</param>
     /// <param name="hwnd">対象ウィンドウハンドル</param>
     WindowsCaptureSession(int sessionId, HWND hwnd);
+
+    /// <summary>
+    /// モニター全体をキャプチャするフレームソースのコンストラクタ
+    /// 同じモニターの領域セッション間で1つのフレームプールを共有するために使う（レジストリの一覧には載せない）
+    /// </summary>
+    /// <param name="sessionId">セッションID（フレームソースは 0）</param>
+    /// <param name="monitor">対象モニター</param>
+    WindowsCaptureSession(int sessionId, HMONITOR monitor);
+
+    /// <summary>
+    /// モニターのフレームソースを共有し、指定矩形を GPU 上で切り出す領域セッションのコンストラクタ
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="frameSource">同じモニターのフレームソース</param>
+    /// <param name="cropRect">モニター左上基準の切り出し矩形（nullptr でモニター全体）</param>
+    WindowsCaptureSession(int sessionId, std::shared_ptr<WindowsCaptureSession> frameSource, const RECT* cropRect);
+
+    /// <summary>
+    /// 記録ファイル（StartRecording で作成）のフレームを同じキャプチャ API で再生するリプレイセッションのコンストラクタ
+    /// 記録した BGRA を GPU テクスチャへアップロードし、以降のリサイズ・ROI・変換経路はウィンドウセッションと同じ処理を通る
+    /// </summary>
+    /// <param name="sessionId">セッションID</param>
+    /// <param name="replayPath">記録ファイルのパス（Initialize で開く）</param>
+    /// <param name="replayFlags">BAKETA_CAPTURE_REPLAY_*</param>
+    WindowsCaptureSession(int sessionId, const wchar_t* replayPath, int replayFlags);
     
     /// <summary>
     /// デストラクタ
@@ -34,10 +101,12 @@ public:
     /// <param name="width">幅（出力）</param>
     /// <param name="height">高さ（出力）</param>
     /// <param name="stride">行バイト数（出力）</param>
-    /// <param name="timestamp">タイムスタンプ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
     /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="outputBuffer">呼び出し側の出力バッファ（nullptr の場合はプールから確保）</param>
     /// <returns>成功時は true</returns>
-    bool CaptureFrame(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, int timeoutMs);
+    bool CaptureFrame(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int timeoutMs, CaptureOutputBuffer* outputBuffer = nullptr);
 
     /// <summary>
     /// フレームをキャプチャしてGPU側でリサイズ (Issue #193 パフォーマンス最適化)
@@ -46,14 +115,355 @@ public:
     /// <param name="width">幅（出力）- リサイズ後のサイズ</param>
     /// <param name="height">高さ（出力）- リサイズ後のサイズ</param>
     /// <param name="stride">行バイト数（出力）</param>
-    /// <param name="timestamp">タイムスタンプ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
     /// <param name="originalWidth">🚀 [Issue #193] 元のキャプチャ幅（出力）- リサイズ前</param>
     /// <param name="originalHeight">🚀 [Issue #193] 元のキャプチャ高さ（出力）- リサイズ前</param>
     /// <param name="targetWidth">ターゲット幅</param>
     /// <param name="targetHeight">ターゲット高さ</param>
     /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="outputBuffer">呼び出し側の出力バッファ（nullptr の場合はプールから確保）</param>
     /// <returns>成功時は true</returns>
-    bool CaptureFrameResized(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int timeoutMs);
+    bool CaptureFrameResized(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int timeoutMs, CaptureOutputBuffer* outputBuffer = nullptr);
+
+    /// <summary>
+    /// バッチキャプチャの前半: フレームを取得し、GPU リサイズとステージングコピーを発行する（Flush・マップ待ちはしない）
+    /// 成功時は読み出しロックを batch に保持したまま戻り、EndBatchReadback で解放する
+    /// </summary>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">フレーム到着待ちのタイムアウト</param>
+    /// <param name="batch">読み出し状態（出力）</param>
+    /// <returns>成功時は true（失敗時は統計へ記録済み）</returns>
+    bool BeginBatchReadback(int targetWidth, int targetHeight, int timeoutMs, BatchReadback* batch);
+
+    /// <summary>
+    /// バッチキャプチャの後半: コピー完了を待ってマップし、プールの出力バッファへ書き込む
+    /// 成否に関わらず統計へ記録し、読み出しロックを解放する
+    /// </summary>
+    /// <param name="batch">BeginBatchReadback が成功した読み出し状態</param>
+    /// <param name="bgraData">BGRAピクセルデータ（出力）</param>
+    /// <param name="stride">行バイト数（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool EndBatchReadback(BatchReadback* batch, unsigned char** bgraData, int* stride);
+
+    /// <summary>
+    /// 初回のリサイズキャプチャで作成する GPU リソース（リサイズシェーダー・入力レイアウト・頂点バッファ等）を事前に作成する
+    /// </summary>
+    /// <returns>成功時は true</returns>
+    bool PrewarmGpuResources();
+
+    /// <summary>
+    /// セッションが使用するイミディエイトコンテキスト（同じアダプターのセッション間で共有）
+    /// </summary>
+    ID3D11DeviceContext* GetDeviceContext() const { return m_d3dContext.Get(); }
+
+    /// <summary>
+    /// 前回このメソッドで読み出したフレームから変化がある場合のみキャプチャ
+    /// GPU でタイル差分を検出し、変化がなければステージングコピー・Map を行わない
+    /// </summary>
+    /// <param name="bgraData">BGRAピクセルデータ（出力、変化なしの場合は nullptr）</param>
+    /// <param name="width">幅（出力）</param>
+    /// <param name="height">高さ（出力）</param>
+    /// <param name="stride">行バイト数（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <param name="originalWidth">元のキャプチャ幅（出力）</param>
+    /// <param name="originalHeight">元のキャプチャ高さ（出力）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="threshold">ピクセル変化しきい値（B+G+R 差分絶対値の合計）</param>
+    /// <param name="tileInfo">タイル検出結果（出力・省略可）</param>
+    /// <param name="dirtyBitmap">変化タイルのビットマップ（出力・省略可）</param>
+    /// <param name="dirtyBitmapWords">ビットマップのワード数</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="changed">変化があった場合は true（出力）</param>
+    /// <returns>成功時は true（変化なしも成功）</returns>
+    bool CaptureFrameIfChanged(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int targetWidth, int targetHeight, int threshold, BaketaCaptureTileInfo* tileInfo, unsigned int* dirtyBitmap, int dirtyBitmapWords, int timeoutMs, bool* changed);
+
+    /// <summary>
+    /// 変化矩形のみを読み出してセッション内の永続 CPU フレームを更新
+    /// 初回・サイズ変更時・矩形情報が揃わない場合は全体を読み出す
+    /// 返すデータはセッション所有で、次の CaptureFrameDirty 呼び出しまたはセッション解放まで有効
+    /// </summary>
+    /// <param name="bgraData">永続フレームのBGRAデータ（出力）</param>
+    /// <param name="width">幅（出力）</param>
+    /// <param name="height">高さ（出力）</param>
+    /// <param name="stride">行バイト数（出力、幅 * 4）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <param name="dirtyRects">今回更新した矩形（出力）</param>
+    /// <param name="maxRects">dirtyRects の容量（超過時は外接矩形1つにまとめる）</param>
+    /// <param name="rectCount">更新した矩形数（出力、0 は変化なし）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureFrameDirty(unsigned char** bgraData, int* width, int* height, int* stride, long long* timestamp, unsigned long long* sequence, BaketaCaptureRect* dirtyRects, int maxRects, int* rectCount, int timeoutMs);
+
+    /// <summary>
+    /// 複数の ROI を GPU 上で1枚のアトラスへ切り出し（必要に応じてリサイズ）、1回の Map で読み出す
+    /// 出力バッファには ROI ごとに stride = 幅 * 4 で連続して格納される
+    /// </summary>
+    /// <param name="regions">ROI（入力: source / targetWidth / targetHeight、出力: offset / width / height / stride）</param>
+    /// <param name="count">ROI 数</param>
+    /// <param name="data">出力バッファ（FrameBufferPool 所有、ReleaseFrame で返却）</param>
+    /// <param name="dataSize">出力バッファのバイト数（出力）</param>
+    /// <param name="frameWidth">元のキャプチャ幅（出力）</param>
+    /// <param name="frameHeight">元のキャプチャ高さ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureRegions(BaketaCaptureRegion* regions, int count, unsigned char** data, int* dataSize, int* frameWidth, int* frameHeight, long long* timestamp, unsigned long long* sequence, int timeoutMs);
+
+    /// <summary>
+    /// 最新フレームのエッジ密度マップを作成し、frame 指定時は同じフレームを BGRA で読み出す
+    /// マップの容量が不足する場合はフレームを読み出さずに失敗する（mapInfo->dataSize に必要サイズ）
+    /// </summary>
+    /// <param name="frame">フレームデータ（出力・省略可）</param>
+    /// <param name="targetWidth">フレームのターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">フレームのターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="densityMap">マップの出力先</param>
+    /// <param name="densityMapSize">densityMap の容量（バイト）</param>
+    /// <param name="mapInfo">マップの情報（出力）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureEdgeMap(BaketaCaptureFrame* frame, int targetWidth, int targetHeight, unsigned char* densityMap, int densityMapSize, BaketaCaptureEdgeMapInfo* mapInfo, int timeoutMs);
+
+    /// <summary>
+    /// GPU 上で出力フォーマットへ変換してからキャプチャ（GRAY8 / BGR24 / NV12）
+    /// 出力サイズは CaptureFrameResized と同じくアスペクト比を維持した縮小のみ（NV12 は偶数に切り下げ）
+    /// </summary>
+    /// <param name="format">BAKETA_CAPTURE_FORMAT_GRAY8 / BGR24 / NV12</param>
+    /// <param name="targetWidth">ターゲット幅（0 で等倍）</param>
+    /// <param name="targetHeight">ターゲット高さ（0 で等倍）</param>
+    /// <param name="data">出力バッファ（FrameBufferPool 所有、ReleaseFrameEx で返却）</param>
+    /// <param name="width">出力幅（出力）</param>
+    /// <param name="height">出力高さ（出力）</param>
+    /// <param name="stride">行バイト数（出力、NV12 は Y プレーン）</param>
+    /// <param name="dataSize">出力バッファのバイト数（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <param name="originalWidth">元のキャプチャ幅（出力）</param>
+    /// <param name="originalHeight">元のキャプチャ高さ（出力）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureFrameConverted(int format, int targetWidth, int targetHeight, unsigned char** data, int* width, int* height, int* stride, int* dataSize, long long* timestamp, unsigned long long* sequence, int* originalWidth, int* originalHeight, int timeoutMs);
+
+    /// <summary>
+    /// フィルターを指定して複数サイズへ同時にリサイズし、1回の Map で読み出す
+    /// 出力バッファには出力ごとに stride = 幅 * 4 で連続して格納される
+    /// </summary>
+    /// <param name="filter">BAKETA_CAPTURE_FILTER_*</param>
+    /// <param name="outputs">出力（入力: targetWidth / targetHeight、出力: offset / width / height / stride）</param>
+    /// <param name="count">出力数（1〜ComputeResizer::kMaxOutputs）</param>
+    /// <param name="data">出力バッファ（FrameBufferPool 所有、ReleaseFrame で返却）</param>
+    /// <param name="dataSize">出力バッファのバイト数（出力）</param>
+    /// <param name="frameWidth">元のキャプチャ幅（出力）</param>
+    /// <param name="frameHeight">元のキャプチャ高さ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureFrameScaled(int filter, BaketaCaptureScaledOutput* outputs, int count, unsigned char** data, int* dataSize, int* frameWidth, int* frameHeight, long long* timestamp, unsigned long long* sequence, int timeoutMs);
+
+    /// <summary>
+    /// 最新フレームを（必要に応じて GPU 上でリサイズして）共有テクスチャへコピーし、NT ハンドルで渡す
+    /// CPU への読み出しは行わない。出力サイズは CaptureFrameResized と同じくアスペクト比を維持した縮小のみ
+    /// </summary>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="frame">共有フレーム（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool ExportSharedFrame(int targetWidth, int targetHeight, int timeoutMs, BaketaCaptureSharedFrame* frame);
+
+    /// <summary>
+    /// 共有メモリフレームリングを作成する（既存のリングは閉じて置き換える）
+    /// </summary>
+    /// <param name="name">マッピング名</param>
+    /// <param name="slotCount">スロット数</param>
+    /// <param name="maxFrameBytes">1 フレームの最大バイト数</param>
+    /// <param name="hr">失敗時の HRESULT（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool EnableSharedRing(const wchar_t* name, int slotCount, int maxFrameBytes, HRESULT* hr);
+
+    /// <summary>
+    /// 共有メモリフレームリングを閉じる
+    /// </summary>
+    void DisableSharedRing();
+
+    /// <summary>
+    /// 共有メモリフレームリングが作成済みか
+    /// </summary>
+    bool HasSharedRing();
+
+    /// <summary>
+    /// フレームをキャプチャして共有メモリリングの次のスロットへ直接書き込む
+    /// </summary>
+    /// <param name="frame">書き込んだフレームの情報（出力、bgraData はスロットを指す）</param>
+    /// <param name="targetWidth">ターゲット幅（0の場合はリサイズなし）</param>
+    /// <param name="targetHeight">ターゲット高さ（0の場合はリサイズなし）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="frameId">割り当てたフレームID（出力、失敗時は 0）</param>
+    /// <param name="requiredSize">スロット容量不足時の必要バイト数（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool CaptureToSharedRing(BaketaCaptureFrame* frame, int targetWidth, int targetHeight, int timeoutMs, unsigned long long* frameId, size_t* requiredSize);
+
+    /// <summary>
+    /// ハードウェアエンコーダーを開始する（作成は最初の EncodeFrame で出力サイズが決まった時点）
+    /// </summary>
+    /// <param name="config">エンコード設定</param>
+    /// <param name="hr">失敗時の HRESULT（出力、非対応時は DXGI_ERROR_UNSUPPORTED / MF_E_TOPO_CODEC_NOT_FOUND）</param>
+    /// <returns>成功時は true</returns>
+    bool StartEncoder(const BaketaCaptureEncoderConfig& config, HRESULT* hr);
+
+    /// <summary>
+    /// ハードウェアエンコーダーを停止して未読パケットを破棄する
+    /// </summary>
+    void StopEncoder();
+
+    /// <summary>
+    /// ハードウェアエンコーダーが開始済みか
+    /// </summary>
+    bool HasEncoder();
+
+    /// <summary>
+    /// フレームを取得して GPU 上で NV12 へ変換し、ハードウェアエンコーダーへ入力する
+    /// </summary>
+    /// <param name="forceKeyframe">このフレームをキーフレームにする</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="queuedPackets">呼び出し後の未読パケット数（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool EncodeFrame(bool forceKeyframe, int timeoutMs, int* queuedPackets);
+
+    /// <summary>
+    /// 最も古い未読パケットを読み出す（packet->dataSize が bufferSize を超える場合は書き込まずに残す）
+    /// </summary>
+    /// <param name="buffer">パケットの書き込み先</param>
+    /// <param name="bufferSize">buffer のバイト数</param>
+    /// <param name="packet">パケット情報（出力）</param>
+    /// <param name="available">未読パケットがあった場合は true（出力）</param>
+    /// <returns>エンコーダーが開始されていれば true</returns>
+    bool ReadEncodedPacket(unsigned char* buffer, int bufferSize, BaketaCaptureEncodedPacket* packet, bool* available);
+
+    /// <summary>
+    /// WGC の DirtyRegions 収集を有効化・無効化
+    /// </summary>
+    /// <param name="enabled">有効化する場合は true</param>
+    /// <returns>OS が DirtyRegions に対応している場合は true</returns>
+    bool SetDirtyRegionMode(bool enabled);
+
+    /// <summary>
+    /// 計測レイテンシに基づく解像度の自動調整を設定
+    /// 有効時の CaptureFrameResized は目標サイズを上限として扱い、読み出し時間が予算に収まるよう縮小率を調整する
+    /// （選択したスケールは出力サイズと originalWidth / originalHeight の比で分かる）
+    /// </summary>
+    /// <param name="latencyBudgetUs">1 回の読み出し（フレーム待ちを除く）に許容する時間（マイクロ秒、0 以下で無効化）</param>
+    /// <param name="minScale">文字の可読性を保つ最小スケール（0.0 〜 1.0）</param>
+    /// <returns>成功時は true</returns>
+    bool SetAdaptiveResolution(int latencyBudgetUs, float minScale);
+
+    /// <summary>
+    /// ウィンドウ状態によるキャプチャの自動停止を設定（ウィンドウセッションは既定で有効）
+    /// 最小化・クローク・非表示の間は WGC セッションを閉じて保持中のフレームを手放し、
+    /// 前面ウィンドウに完全に覆われている間は受け取るフレームを 1fps に間引く。復帰時は直ちにキャプチャを再開する
+    /// </summary>
+    /// <param name="enabled">有効化する場合は true</param>
+    /// <returns>成功時は true</returns>
+    bool SetAutoSuspend(bool enabled);
+
+    /// <summary>
+    /// ウィンドウ状態によりキャプチャを停止中か
+    /// </summary>
+    bool IsSuspended() const { return m_suspended.load(); }
+
+    /// <summary>
+    /// パイプライン読み出しを設定（既定は無効、CaptureFrame / CaptureFrameResized が対象）
+    /// 有効時はフレーム到着時に直近の読み出しと同じ目標サイズでステージングへのコピーを発行しておき、
+    /// 読み出し時はコピー済みのスロットを待たずにマップする。最新フレームのコピーが未完了の場合は
+    /// 完了済みの 1 つ前のフレームを返す（timestamp / sequence はそのフレームの値）
+    /// </summary>
+    /// <param name="enabled">有効化する場合は true</param>
+    /// <returns>成功時は true、領域・リプレイセッションは false</returns>
+    bool SetPipelinedReadback(bool enabled);
+
+    /// <summary>
+    /// 自前のフレームプールでフレームを受け取るセッションか（ウィンドウ・モニターセッション）
+    /// </summary>
+    bool HasOwnFramePool() const { return m_frameSource == nullptr && m_replay == nullptr; }
+
+    /// <summary>
+    /// 読み出したフレームの記録を開始する（既に記録中の場合は閉じてから新しいファイルへ切り替える）
+    /// 読み出しごとに等倍の SDR フレームと前回記録したフレームからの変化矩形を追記する（同じフレームは1回のみ）
+    /// </summary>
+    /// <param name="path">記録ファイルのパス</param>
+    /// <param name="hr">失敗時の HRESULT（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool StartRecording(const wchar_t* path, HRESULT* hr);
+
+    /// <summary>
+    /// 記録を終了してインデックスを書き込む
+    /// </summary>
+    /// <param name="frameCount">記録したフレーム数（出力）</param>
+    /// <param name="hr">失敗時の HRESULT（出力、記録中に書き込みが失敗した場合はその HRESULT）</param>
+    /// <returns>全てのフレームを記録できた場合は true</returns>
+    bool StopRecording(int* frameCount, HRESULT* hr);
+
+    /// <summary>
+    /// 記録ファイルのリプレイセッションか
+    /// </summary>
+    bool IsReplay() const { return !m_replayPath.empty(); }
+
+    /// <summary>
+    /// OS・SDK が WGC の DirtyRegions に対応しているか
+    /// </summary>
+    static bool IsDirtyRegionSupported();
+
+    /// <summary>
+    /// ストリーミングモードを開始
+    /// WGC キャプチャを一度だけ開始し、OnFrameArrived から最新フレームをメールボックスへ公開し続ける。
+    /// 以降の CaptureFrame / CaptureFrameResized は到着待ちをせず最新フレームを読み出す。
+    /// </summary>
+    /// <param name="maxFps">公開する最大フレームレート（0 以下で無制限）</param>
+    /// <param name="poolDepth">フレームプールのバッファ数（0 以下で既定値）</param>
+    /// <returns>成功時は true</returns>
+    bool StartStreaming(int maxFps, int poolDepth);
+
+    /// <summary>
+    /// ストリーミングモードを停止し、フレームプールを単一バッファに戻す
+    /// </summary>
+    void StopStreaming();
+
+    /// <summary>
+    /// 最小フレーム間隔を設定（通常モード・ストリーミングモード共通）
+    /// 間隔未満で届いたフレームは OnFrameArrived でテクスチャを保持せずに返却する。
+    /// ストリーミングの maxFps と併用した場合は長い方の間隔が適用される
+    /// </summary>
+    /// <param name="intervalMs">最小フレーム間隔（ミリ秒、0 以下で無制限）</param>
+    void SetMinFrameInterval(int intervalMs);
+
+    /// <summary>
+    /// ストリーミングモード中かチェック
+    /// </summary>
+    /// <returns>ストリーミング中の場合は true</returns>
+    bool IsStreaming() const { return m_streaming.load(); }
+
+    /// <summary>
+    /// フレーム到着通知用の自動リセットイベントを呼び出し側プロセス用に複製して取得
+    /// WGC キャプチャが未開始の場合は開始する
+    /// </summary>
+    /// <param name="duplicatedHandle">複製したイベントハンドル（出力、呼び出し側が CloseHandle する）</param>
+    /// <returns>成功時は true</returns>
+    bool DuplicateFrameEvent(HANDLE* duplicatedHandle);
+
+    /// <summary>
+    /// フレーム到着コールバックを設定（nullptr で解除）
+    /// 解除時は進行中のコールバック完了を待つ。WGC キャプチャが未開始の場合は開始する
+    /// </summary>
+    /// <param name="callback">コールバック</param>
+    /// <param name="userData">ユーザーデータ</param>
+    /// <returns>成功時は true</returns>
+    bool SetFrameCallback(BaketaCaptureFrameCallback callback, void* userData);
 
     /// <summary>
     /// セッションIDを取得
@@ -67,6 +477,12 @@ public:
     /// <returns>ウィンドウハンドル</returns>
     HWND GetWindowHandle() const { return m_hwnd; }
 
+    /// <summary>
+    /// モニターハンドルを取得（ウィンドウセッションは nullptr）
+    /// </summary>
+    /// <returns>モニターハンドル</returns>
+    HMONITOR GetMonitorHandle() const { return m_monitor; }
+
     /// <summary>
     /// 初期化済みかチェック
     /// </summary>
@@ -81,9 +497,24 @@ public:
 
     /// <summary>
     /// [Issue #324] セッションが有効かチェック（クローズ中でなく、初期化済み）
+    /// 対象ウィンドウ・モニター（領域セッションはフレームソース）が存在しない場合も無効
     /// </summary>
     /// <returns>有効な場合は true</returns>
-    bool IsValid() const { return m_initialized && !m_isClosing.load() && IsWindow(m_hwnd); }
+    bool IsValid() const;
+
+    /// <summary>
+    /// afterSequence より新しいフレームを待って参照を取得する（フレームソースとして複数の領域セッションから呼ばれる）
+    /// 通常モードの WaitForLatestFrame と異なりフレームを消費しないため、同じフレームを複数の呼び出し側が読み出せる
+    /// </summary>
+    /// <param name="afterSequence">前回読み出したフレーム通し番号（0 で最新フレーム）</param>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="texture">フレームテクスチャ（出力）</param>
+    /// <param name="width">幅（出力）</param>
+    /// <param name="height">高さ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力）</param>
+    /// <param name="sequence">フレーム通し番号（出力）</param>
+    /// <returns>成功時は true</returns>
+    bool WaitForFrameAfter(unsigned long long afterSequence, int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence);
 
     /// <summary>
     /// [Issue #324] セッションを安全にクローズ
@@ -92,10 +523,21 @@ public:
     void Close();
 
     /// <summary>
-    /// 最後のエラーメッセージを取得
+    /// 呼び出しスレッドで最後に記録されたエラーメッセージを取得
     /// </summary>
-    /// <returns>エラーメッセージ</returns>
-    const std::string& GetLastError() const { return m_lastError; }
+    /// <returns>エラーメッセージ（スレッドローカルバッファ、次のエラー記録まで有効）</returns>
+    const char* GetLastError() const { return CaptureLastError::Current().message; }
+
+    /// <summary>
+    /// 段階別タイミング・フレーム数の統計を取得
+    /// </summary>
+    /// <param name="stats">統計（出力）</param>
+    void GetStats(BaketaCaptureStats* stats) const { m_stats.Snapshot(stats); }
+
+    /// <summary>
+    /// 統計をリセット
+    /// </summary>
+    void ResetStats() { m_stats.Reset(); }
 
     /// <summary>
     /// ウィンドウ情報とスクリーン座標を取得（デバッグ用）
@@ -112,6 +554,28 @@ private:
     /// <returns>成功時は true</returns>
     bool CreateD3DDevice();
 
+    /// <summary>
+    /// フレームソースのデバイスを共有して領域セッションを初期化
+    /// </summary>
+    /// <returns>成功時は true</returns>
+    bool InitializeFromSource();
+
+    /// <summary>
+    /// 記録ファイルを開き、再生用にプライマリモニターのアダプターの共有デバイスを取得する
+    /// </summary>
+    bool InitializeReplay();
+
+    /// <summary>
+    /// モニターの GraphicsCaptureItem を作成（CreateForMonitor）
+    /// </summary>
+    /// <returns>成功時は true</returns>
+    bool CreateMonitorCaptureItem();
+
+    /// <summary>
+    /// フレームの取得元があるか（自前のキャプチャセッション、または共有フレームソース）
+    /// </summary>
+    bool HasCaptureSource() const { return m_captureSession != nullptr || m_frameSource != nullptr || m_replay != nullptr; }
+
     /// <summary>
     /// ウィンドウ状態をキャプチャ用に検証 (Phase 0 WGC修復)
     /// </summary>
@@ -130,6 +594,198 @@ private:
     /// <returns>成功時は true</returns>
     bool CreateFramePool();
 
+    /// <summary>
+    /// 最新フレームの到着を待機してテクスチャを取得
+    /// フレームミューテックスは取得後すぐに解放し、読み出し中も OnFrameArrived が次フレームを受け取れるようにする
+    /// </summary>
+    /// <param name="timeoutMs">タイムアウト時間</param>
+    /// <param name="texture">フレームテクスチャ（出力）</param>
+    /// <param name="width">幅（出力）</param>
+    /// <param name="height">高さ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool WaitForLatestFrame(int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence = nullptr);
+
+    /// <summary>
+    /// WGC キャプチャを開始（セッションにつき一度だけ StartCapture を呼ぶ）
+    /// </summary>
+    void EnsureCaptureStarted();
+
+    /// <summary>
+    /// WGC キャプチャを開始（呼び出し側は m_captureControlMutex を保持すること）
+    /// 停止中は開始要求のみ記録して復帰時に開始する。停止時に閉じたセッションは作り直す
+    /// </summary>
+    void StartCaptureLocked();
+
+    /// <summary>
+    /// キャプチャセッションの設定を作り直したセッションへ再適用（呼び出し側は m_captureControlMutex を保持すること）
+    /// </summary>
+    void ApplyCaptureSessionSettingsLocked();
+
+    /// <summary>
+    /// フレームプールを指定のバッファ数・サイズで作り直す（呼び出し側は m_captureControlMutex を保持すること）
+    /// 旧フレームプールのテクスチャを参照している最新フレーム・メールボックス・SRV は先に手放す
+    /// </summary>
+    /// <param name="bufferCount">フレームバッファ数</param>
+    /// <param name="size">フレームサイズ</param>
+    void RecreateFramePoolLocked(int bufferCount, winrt::SizeInt32 size);
+
+    /// <summary>
+    /// ウィンドウ状態の監視を開始（ウィンドウセッションのみ、初期化完了後に呼ぶ）
+    /// </summary>
+    void StartWindowStateWatch();
+
+    /// <summary>
+    /// ウィンドウ状態の変更通知（WindowStateMonitor のスレッドから呼ばれる）
+    /// </summary>
+    /// <param name="state">新しい状態</param>
+    void OnWindowStateChanged(const WindowStateMonitor::State& state);
+
+    /// <summary>
+    /// WGC セッションを閉じ、保持中のフレームを手放す（呼び出し側は m_captureControlMutex を保持すること）
+    /// </summary>
+    void SuspendCaptureLocked();
+
+    /// <summary>
+    /// 停止前に開始済みだったキャプチャを再開（呼び出し側は m_captureControlMutex を保持すること）
+    /// </summary>
+    void ResumeCaptureLocked();
+
+    /// <summary>
+    /// 対象のサイズ変更時にフレームプールを新しいサイズで作り直す（OnFrameArrived スレッドから呼ぶ）
+    /// </summary>
+    /// <param name="size">新しいコンテンツサイズ</param>
+    void OnContentResized(winrt::SizeInt32 size);
+
+    /// <summary>
+    /// 実行中のフレームコールバック（OnFrameArrived）の終了を待つ（コールバック内から呼ばないこと）
+    /// </summary>
+    void WaitForStreamCallbacks();
+
+    /// <summary>
+    /// 上限時間までフレームコールバックの終了を待つ（Close 用）
+    /// </summary>
+    /// <returns>実行中のコールバックが 0 になった場合は true</returns>
+    bool WaitForStreamCallbacks(std::chrono::milliseconds timeout);
+
+    /// <summary>
+    /// ストリーミングモードの最新フレームを取得（呼び出し側は m_readbackMutex を保持すること）
+    /// 最初のフレームが公開されるまでのみ待機する
+    /// </summary>
+    /// <param name="timeoutMs">最初のフレーム待機のタイムアウト時間</param>
+    /// <param name="texture">フレームテクスチャ（出力）</param>
+    /// <param name="width">幅（出力）</param>
+    /// <param name="height">高さ（出力）</param>
+    /// <param name="timestamp">フレームの提示時刻（出力、QPC 基準の 100ns 単位）</param>
+    /// <param name="sequence">フレーム通し番号（出力・省略可）</param>
+    /// <returns>成功時は true</returns>
+    bool AcquireStreamingFrame(int timeoutMs, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence = nullptr);
+
+    /// <summary>
+    /// 最新フレームを取得して読み出しロックを取得
+    /// 通常モードはフレーム到着を待ってからロックし、ストリーミングモードはロック後にメールボックスから取得する
+    /// HDR モニターの FP16 フレームは keepHdrSource を指定しない限り SDR の BGRA へトーンマップして返す
+    /// </summary>
+    /// <param name="keepHdrSource">リサイズシェーダーで描画する呼び出し側が FP16 のまま受け取る場合は true（描画時にトーンマップされる）</param>
+    bool AcquireFrameForReadback(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence = nullptr, bool keepHdrSource = false);
+
+    /// <summary>
+    /// キャプチャしたままの形式で最新フレームを取得して読み出しロックを取得（AcquireFrameForReadback の本体）
+    /// </summary>
+    bool AcquireCapturedFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence);
+
+    /// <summary>
+    /// FP16（scRGB）フレームをリサイズシェーダーの等倍描画で SDR の BGRA へトーンマップする（BGRA はそのまま）
+    /// 呼び出し側は m_readbackMutex を保持すること。差し替え後のテクスチャは同じサイズの次の描画まで有効
+    /// </summary>
+    /// <param name="texture">フレームテクスチャ（入出力）</param>
+    /// <returns>成功時は true</returns>
+    bool ResolveSdrFrame(ComPtr<ID3D11Texture2D>& texture);
+
+    /// <summary>
+    /// 対象モニターの Advanced Color 状態からキャプチャのピクセル形式を選び、トーンマップのパラメーターを更新する
+    /// 初期化中または m_readbackMutex 保持中に呼ぶこと（GPU リサイズリソースを初期化するため）
+    /// </summary>
+    /// <returns>HDR かつトーンマップ可能な場合は R16G16B16A16Float、それ以外は B8G8R8A8UIntNormalized</returns>
+    winrt::DirectXPixelFormat SelectCapturePixelFormat();
+
+    /// <summary>
+    /// 領域セッション: フレームソースから前回より新しいフレームを取得し、切り出し矩形を GPU 上でコピーする
+    /// 成功時は readbackLock を保持した状態で返る
+    /// </summary>
+    bool AcquireSourceFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence);
+
+    /// <summary>
+    /// フレームの DirtyRegions を履歴に記録（OnFrameArrived から呼ぶ）
+    /// </summary>
+    void RecordDirtyRegions(winrt::Direct3D11CaptureFrame const& frame, unsigned long long sequence, int width, int height);
+
+    /// <summary>
+    /// リプレイセッションの次のフレームを出す（記録時刻どおりの場合は提示時刻まで待ち、遅れた分は読み飛ばす）
+    /// 成功時は読み出しロックを保持したまま戻る
+    /// </summary>
+    bool AcquireReplayFrame(int timeoutMs, std::unique_lock<std::mutex>& readbackLock, ComPtr<ID3D11Texture2D>& texture, int* width, int* height, long long* timestamp, unsigned long long* sequence);
+
+    /// <summary>
+    /// 記録したフレームの変化矩形を DirtyRegions 履歴へ登録する（m_readbackMutex 保持中に呼ぶ）
+    /// </summary>
+    void RecordReplayDirtyRegions(int index, unsigned long long sequence);
+
+    /// <summary>
+    /// 記録したフレームを展開してテクスチャへアップロードする（前回アップロードからの変化矩形のみ転送、m_readbackMutex 保持中に呼ぶ）
+    /// </summary>
+    bool UploadReplayFrame(int index, unsigned long long sequence);
+
+    /// <summary>
+    /// 読み出したフレームを記録の書き込みキューへ渡す（m_readbackMutex 保持中に呼ぶ、失敗時は以降の記録を止める）
+    /// </summary>
+    void RecordFrameLocked(ID3D11Texture2D* texture, int width, int height, long long timestamp, unsigned long long sequence);
+
+    /// <summary>
+    /// 前回読み出したフレームサイズから呼び出し側バッファに必要なバイト数を求める（stride = 幅 * 4）
+    /// </summary>
+    /// <returns>必要バイト数、まだ読み出していない場合は 0</returns>
+    size_t ExpectedOutputBytes(int targetWidth, int targetHeight) const;
+
+    /// <summary>
+    /// フレーム出力バッファを取得
+    /// 呼び出し側バッファ指定時はそれを使い（stride = 幅 * bytesPerPixel）、それ以外は FrameBufferPool から取得
+    /// </summary>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ（行数）</param>
+    /// <param name="bytesPerPixel">1ピクセルあたりのバイト数</param>
+    /// <param name="preferredStride">プール確保時の行バイト数</param>
+    /// <param name="stride">実際の行バイト数（出力）</param>
+    /// <returns>バッファ、容量不足・確保失敗時は nullptr</returns>
+    unsigned char* AcquireOutputBuffer(int width, int height, int bytesPerPixel, int preferredStride, int* stride);
+
+    /// <summary>
+    /// パイプライン読み出し: 到着したフレームを直近の目標サイズでステージングリングへコピー発行する（OnFrameArrived から呼ぶ）
+    /// 読み出しロックを取得できない場合・FP16 フレームは発行しない（読み出し時に同期コピーする）
+    /// </summary>
+    void PrefetchReadback(ID3D11Texture2D* texture, unsigned long long sequence, long long timestamp);
+
+    /// <summary>
+    /// 呼び出し中のフレームを width x height で到着時にコピー発行済みか（m_readbackMutex 保持中に呼ぶ）
+    /// </summary>
+    bool HasPrefetchedReadback(int width, int height) const;
+
+    /// <summary>
+    /// テクスチャの左上 width x height をステージングへ読み出してマップする（m_readbackMutex 保持中に呼ぶ）
+    /// パイプライン読み出し中は到着時に発行済みのスロットを使い、無い場合はリングへ発行してから待つ
+    /// </summary>
+    /// <param name="texture">コピー元（発行済みの場合は nullptr 可）</param>
+    /// <param name="mapped">マップ結果（出力）</param>
+    /// <param name="slot">マップしたリングのスロット（出力、ステージングキャッシュの場合は -1）</param>
+    /// <returns>コピー発行・Map の HRESULT</returns>
+    HRESULT MapForReadback(ID3D11Texture2D* texture, UINT width, UINT height, D3D11_MAPPED_SUBRESOURCE* mapped, int* slot);
+
+    /// <summary>
+    /// MapForReadback でマップしたテクスチャを解除する
+    /// </summary>
+    void UnmapReadback(int slot);
+
     /// <summary>
     /// テクスチャを BGRA データに変換
     /// </summary>
@@ -152,6 +808,11 @@ private:
     /// <returns>成功時は true</returns>
     bool ResizeAndConvertTextureToBGRA(ID3D11Texture2D* texture, unsigned char** bgraData, int* outputWidth, int* outputHeight, int* stride, int targetWidth, int targetHeight);
 
+    /// <summary>
+    /// バッチ読み出しの結果を統計へ記録し、読み出しロックを解放する
+    /// </summary>
+    bool FinishBatchReadback(BatchReadback* batch, bool succeeded);
+
     /// <summary>
     /// 🚀 [Issue #193] GPUシェーダーリサイズリソースを初期化
     /// </summary>
@@ -168,12 +829,73 @@ private:
     /// <returns>成功時は true</returns>
     bool GpuResizeTexture(ID3D11Texture2D* sourceTexture, int targetWidth, int targetHeight, ComPtr<ID3D11Texture2D>& resizedTexture);
 
+    /// <summary>
+    /// リサイズシェーダーでソースの UV 領域をビューポートへ描画
+    /// コンテキストはこのセッション専用のため、IA/VS/PS/サンプラーは初回のみバインドし、以前の状態は復元しない
+    /// FP16（scRGB）ソースの SRV は同じ描画で SDR の sRGB へトーンマップする
+    /// </summary>
+    /// <param name="sourceSrv">ソースSRV</param>
+    /// <param name="rtv">描画先RTV</param>
+    /// <param name="viewport">描画先ビューポート</param>
+    /// <param name="uvOffsetX">サンプリング領域の左上 U</param>
+    /// <param name="uvOffsetY">サンプリング領域の左上 V</param>
+    /// <param name="uvScaleX">サンプリング領域の幅（UV）</param>
+    /// <param name="uvScaleY">サンプリング領域の高さ（UV）</param>
+    /// <returns>成功時は true</returns>
+    bool DrawResizeQuad(ID3D11ShaderResourceView* sourceSrv, ID3D11RenderTargetView* rtv, const D3D11_VIEWPORT& viewport, float uvOffsetX, float uvOffsetY, float uvScaleX, float uvScaleY);
+
+    /// <summary>
+    /// テクスチャ全体を BGRA のままキャッシュ可能な作業バッファへ読み出す（CPU フォールバック用）
+    /// </summary>
+    /// <param name="texture">ソーステクスチャ</param>
+    /// <param name="width">幅</param>
+    /// <param name="height">高さ</param>
+    /// <param name="image">作業バッファ上の画像（出力、次の読み出しまで有効）</param>
+    /// <returns>成功時は true</returns>
+    bool ReadbackToScratch(ID3D11Texture2D* texture, int width, int height, CpuImageKernels::ConstImage* image);
+
+    /// <summary>
+    /// GPU 変換が使えない場合のグレースケール変換（CPU の SIMD カーネルで縮小・変換）
+    /// </summary>
+    bool ConvertToGrayOnCpu(ID3D11Texture2D* texture, int sourceWidth, int sourceHeight, int outputWidth, int outputHeight, unsigned char** data, int* width, int* height, int* stride, int* dataSize);
+
+    /// <summary>
+    /// ROI アトラス用のレンダーターゲットを確保（拡大のみ、縮小はしない）
+    /// </summary>
+    bool EnsureRegionAtlas(int width, int height);
+
     /// <summary>
     /// エラーメッセージを設定
     /// </summary>
     /// <param name="message">エラーメッセージ</param>
+    void SetLastError(const char* message);
     void SetLastError(const std::string& message);
 
+    /// <summary>
+    /// 段階・HRESULT 付きでエラーを記録（呼び出しスレッドのレコードへ、ヒープ確保なし）
+    /// </summary>
+    void SetLastError(int stage, HRESULT hr, const char* message);
+    void SetLastError(int stage, HRESULT hr, const std::string& message) { SetLastError(stage, hr, message.c_str()); }
+
+    /// <summary>
+    /// 成功・警告などの情報メッセージを診断ログへ出力（エラーレコードは変更しない）
+    /// </summary>
+    void LogDiagnostic(int level, const char* message) const { CaptureDiagnostics::Log(level, m_sessionId, message); }
+    void LogDiagnostic(int level, const std::string& message) const { LogDiagnostic(level, message.c_str()); }
+
+    /// <summary>
+    /// フレーム到着をイベント・コールバックへ通知
+    /// </summary>
+    /// <param name="timestamp">フレームのタイムスタンプ</param>
+    void NotifyFrameArrived(long long timestamp);
+
+    /// <summary>
+    /// 最小フレーム間隔に基づき、到着したフレームを受け取るか判定する（OnFrameArrived スレッドから呼ぶ）
+    /// </summary>
+    /// <param name="timestamp">フレームの提示時刻（100ns単位）</param>
+    /// <returns>受け取る場合は true、間引く場合は false</returns>
+    bool AcceptFramePacing(long long timestamp);
+
     /// <summary>
     /// フレーム到着イベントハンドラー
     /// </summary>
@@ -184,15 +906,44 @@ private:
 private:
     int m_sessionId;
     HWND m_hwnd;
+    HMONITOR m_monitor = nullptr;  // モニターのフレームソースの場合のみ
     bool m_initialized;
 
+    // 領域セッション（同じモニターのフレームソースを共有し、矩形を GPU 上で切り出す）
+    std::shared_ptr<WindowsCaptureSession> m_frameSource;
+    RECT m_cropRect = {};
+    bool m_hasCropRect = false;
+    ComPtr<ID3D11Texture2D> m_cropTexture;                 // 切り出し先（m_readbackMutex で保護）
+    std::atomic<unsigned long long> m_lastSourceSequence{ 0 };  // 前回読み出したソースフレームの通し番号
+
+    // リプレイセッション（記録ファイルのフレームを再生、再生位置・アップロード先は m_readbackMutex で保護）
+    std::wstring m_replayPath;
+    int m_replayFlags = 0;
+    std::unique_ptr<FrameReplayReader> m_replay;
+    int m_replayNextIndex = 0;                        // 次に出すフレーム
+    long long m_replayLoop = 0;                       // 先頭へ戻った回数
+    long long m_replayStartTicks = 0;                 // 周回の先頭フレームの予定時刻（100ns単位、0 で未開始）
+    ComPtr<ID3D11Texture2D> m_replayTexture;          // アップロード先
+    unsigned long long m_replayUploadedSequence = 0;  // m_replayTexture の内容のフレーム通し番号
+    std::vector<unsigned char> m_replayPixels;        // 展開したフレーム
+
+    // 読み出したフレームの記録（m_recordMutex で保護、m_readbackMutex の後に取得する）
+    std::mutex m_recordMutex;
+    std::unique_ptr<FrameRecordingWriter> m_recordWriter;
+    std::atomic<bool> m_recording{ false };
+    unsigned long long m_recordLastSequence = 0;      // 前回書き込みキューへ渡したフレームの通し番号
+    HRESULT m_recordResult = S_OK;                    // 記録中に最初に失敗した HRESULT
+    StagingTextureCache m_recordStaging;
+
     // [Issue #324] クローズ中フラグ（スレッドセーフ）
     std::atomic<bool> m_isClosing{false};
 
     // Direct3D オブジェクト
+    std::shared_ptr<SharedD3DDevice> m_sharedDevice;  // アダプターごとにセッション間で共有
     ComPtr<ID3D11Device> m_d3dDevice;
     ComPtr<ID3D11DeviceContext> m_d3dContext;
     winrt::IDirect3DDevice m_winrtDevice;
+    std::atomic<bool> m_deviceLost{ false };          // デバイス削除を検出済み（セッションは作り直しが必要）
 
     // WinRT キャプチャオブジェクト
     winrt::GraphicsCaptureItem m_captureItem{ nullptr };
@@ -209,9 +960,10 @@ private:
     int m_frameWidth;
     int m_frameHeight;
     long long m_frameTimestamp;
+    unsigned long long m_frameSequence = 0;         // m_latestFrame の通し番号（m_frameMutex で保護）
+    unsigned long long m_frameSequenceCounter = 0;  // OnFrameArrived スレッド専有
 
     // エラー情報
-    std::string m_lastError;
     HRESULT m_lastHResult;
 
     // 🚀 [Issue #193] GPU Shader Resize リソース
@@ -221,4 +973,114 @@ private:
     ComPtr<ID3D11InputLayout> m_inputLayout;
     ComPtr<ID3D11Buffer> m_vertexBuffer;
     ComPtr<ID3D11SamplerState> m_bilinearSampler;
+    ComPtr<ID3D11Buffer> m_resizeParamsBuffer;  // VS: サンプリング領域（uvOffset, uvScale）、PS: トーンマップのパラメーター
+    ResizeResourceCache m_resizeCache;          // ソース SRV・リサイズ先 RT の再利用（m_readbackMutex で保護）
+    GpuStageTimer m_gpuResizeTimer;             // リサイズ描画の GPU 実行時間（m_readbackMutex で保護）
+
+    // ROI アトラス（ROI を1枚のテクスチャへ詰めて1回の Map で読み出す）
+    ComPtr<ID3D11Texture2D> m_regionAtlas;
+    ComPtr<ID3D11RenderTargetView> m_regionAtlasRtv;
+    int m_regionAtlasWidth = 0;
+    int m_regionAtlasHeight = 0;
+    StagingTextureCache m_regionStaging;  // 全体読み出し用テクスチャとサイズを取り合わないよう分離
+
+    // コンピュートシェーダーリサイズ（面積平均・Lanczos-2、複数スケール同時出力）
+    ComputeResizer m_computeResizer;
+    StagingTextureCache m_scaledStaging;  // R8G8B8A8 アトラス用（フォーマットが異なるため分離）
+
+    // GPU フォーマット変換（GRAY8 / BGR24 / NV12）
+    FormatConverter m_formatConverter;
+    StagingTextureCache m_formatStaging;
+
+    // 文字領域候補のエッジ密度マップ（m_readbackMutex で保護）
+    EdgeDensityMapper m_edgeMapper;
+
+    // GPU 消費側へ渡す共有テクスチャ（m_readbackMutex で保護）
+    SharedTextureExporter m_sharedExporter;
+
+    // プロセス外の消費側へ渡す共有メモリリング（書き込みは m_sharedRingMutex で直列化、m_readbackMutex より先に取得する）
+    std::mutex m_sharedRingMutex;
+    std::unique_ptr<SharedFrameRing> m_sharedRing;
+
+    // 計測レイテンシによる CaptureFrameResized の解像度自動調整（内部でロックするため任意のスレッドから設定可）
+    AdaptiveResolutionController m_adaptiveResolution;
+
+    // ハードウェアエンコーダー（m_encoderMutex で保護、m_readbackMutex より先に取得する）
+    std::mutex m_encoderMutex;
+    std::unique_ptr<HardwareVideoEncoder> m_encoder;
+    BaketaCaptureEncoderConfig m_encoderConfig = {};
+
+    // CPU フォールバック用の作業バッファ（m_readbackMutex で保護）
+    std::vector<unsigned char> m_cpuScratch;
+    std::vector<unsigned char> m_cpuResizeScratch;
+
+    // ステージングテクスチャキャッシュ（毎フレームの CreateTexture2D を廃止）
+    // キャッシュとデバイスコンテキストの利用は m_readbackMutex で直列化する
+    std::mutex m_readbackMutex;
+    StagingTextureCache m_staging;
+    TileChangeDetector m_changeDetector;
+
+    // ストリーミングモード（OnFrameArrived → メールボックス → 読み出し側）
+    std::atomic<bool> m_captureStarted{ false };
+    std::atomic<bool> m_streaming{ false };
+    std::mutex m_streamCallbackMutex;                 // m_streamCallbacksInFlight の保護（最後に取得する）
+    std::condition_variable m_streamCallbacksIdle;    // 実行中のフレームコールバックが 0 になったら通知
+    int m_streamCallbacksInFlight = 0;
+    std::atomic<int> m_streamWaiters{ 0 };
+    std::atomic<long long> m_streamMinIntervalTicks{ 0 };  // 100ns単位、0 で無制限
+    FrameMailbox m_mailbox;
+
+    // キャプチャセッションの開始・差し替えとフレームプールの Recreate を直列化する
+    // （m_frameMutex・m_readbackMutex より先に取得する。OnFrameArrived からは try_lock のみ）
+    std::mutex m_captureControlMutex;
+    bool m_captureSessionClosed = false;            // 停止時に閉じたセッションのまま（m_captureControlMutex で保護）
+    int m_framePoolBuffers = 1;                     // 現在のフレームバッファ数（m_captureControlMutex で保護）
+    std::atomic<int> m_framePoolWidth{ 0 };         // 現在のフレームプールサイズ（サイズ変更の検出用）
+    std::atomic<int> m_framePoolHeight{ 0 };
+
+    // キャプチャのピクセル形式（HDR モニターでは FP16、m_captureControlMutex で保護）とトーンマップのパラメーター
+    winrt::DirectXPixelFormat m_capturePixelFormat = winrt::DirectXPixelFormat::B8G8R8A8UIntNormalized;
+    std::atomic<float> m_toneMapWhiteScale{ 1.0f };  // scRGB → SDR 白 = 1.0 の倍率
+    std::atomic<float> m_toneMapPeakWhite{ 1.0f };   // ピーク輝度（SDR 白 = 1.0 基準）
+
+    // ウィンドウ状態による自動停止（最小化・クローク・非表示で停止、遮蔽中はフレームを間引く）
+    int m_windowWatchId = 0;
+    std::atomic<bool> m_autoSuspendEnabled{ true };
+    std::atomic<bool> m_suspended{ false };
+    bool m_resumeCapture = false;                   // 復帰時にキャプチャを開始する（m_captureControlMutex で保護）
+    std::atomic<long long> m_windowStateMinIntervalTicks{ 0 };  // 遮蔽中のフレーム間隔（100ns単位、0 で無制限）
+
+    // フレームペーシング（最小フレーム間隔未満で届いたフレームは OnFrameArrived で即返却）
+    std::atomic<long long> m_minFrameIntervalTicks{ 0 };   // 100ns単位、0 で無制限
+    long long m_nextFrameDueTicks = 0;                      // 次に受け取る提示時刻（OnFrameArrived スレッド専有）
+
+    // 段階別タイミング・フレーム数の統計（どのスレッドからも記録可）
+    CaptureStats m_stats;
+
+    // プッシュ型フレーム通知（自動リセットイベント・ネイティブコールバック）
+    HANDLE m_frameEvent = nullptr;
+    std::mutex m_callbackMutex;
+    BaketaCaptureFrameCallback m_frameCallback = nullptr;
+    void* m_frameCallbackUserData = nullptr;
+
+    // 変化矩形のみの部分読み出し（永続 CPU フレームは m_readbackMutex で保護）
+    std::atomic<bool> m_dirtyRegionsEnabled{ false };
+    DirtyRegionTracker m_dirtyTracker;
+    std::vector<unsigned char> m_dirtyFrame;
+    int m_dirtyFrameWidth = 0;
+    int m_dirtyFrameHeight = 0;
+    unsigned long long m_dirtyFrameSequence = 0;
+
+    // 呼び出し中の出力バッファ指定（m_readbackMutex 保持中のみ有効）
+    CaptureOutputBuffer* m_outputBuffer = nullptr;
+    std::atomic<int> m_lastReadbackWidth{ 0 };   // 前回読み出したフレームの幅（呼び出し側バッファの事前確認用）
+    std::atomic<int> m_lastReadbackHeight{ 0 };
+
+    // パイプライン読み出し（リング・返却済み通し番号・呼び出し中のフレームは m_readbackMutex で保護）
+    std::atomic<bool> m_pipelinedReadback{ false };
+    std::atomic<int> m_prefetchTargetWidth{ 0 };   // 直近の読み出しの目標サイズ（0 は等倍）
+    std::atomic<int> m_prefetchTargetHeight{ 0 };
+    StagingTextureRing m_readbackRing;
+    unsigned long long m_lastPipelinedSequence = 0;
+    PipelinedReadbackFrame* m_pipelinedFrame = nullptr;
 };
\ No newline at end of file
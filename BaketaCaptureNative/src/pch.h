@@ -5,24 +5,37 @@
 #include <unknwn.h>
 #include <restrictederrorinfo.h>
 #include <hstring.h>
+#include <dwmapi.h>  // DWMWA_CLOAKED
+#include <compressapi.h>  // FrameRecording（XPRESS）
 
 // C++ 標準ライブラリ
 #include <memory>
+#include <array>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <deque>
 #include <atomic>
 #include <chrono>
 #include <thread>  // [Issue #324] std::this_thread::sleep_for
 #include <condition_variable>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <future>
 #include <cstdio>
+#include <climits>
+
+// SIMD 組み込み関数・CPUID
+#include <intrin.h>
+#include <immintrin.h>
 
 // Windows Runtime
 #include <winrt/base.h>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Foundation.Metadata.h>
 #include <winrt/Windows.Graphics.Capture.h>
 #include <winrt/Windows.Graphics.DirectX.h>
 #include <winrt/Windows.Graphics.DirectX.Direct3D11.h>
@@ -33,11 +46,25 @@
 #include <Windows.Graphics.Capture.h>
 #include <Windows.Graphics.DirectX.Direct3D11.interop.h>
 
+// WGC DirtyRegions は UniversalApiContract v19（Windows SDK 10.0.26100）以降
+#if defined(WINDOWS_FOUNDATION_UNIVERSALAPICONTRACT_VERSION) && WINDOWS_FOUNDATION_UNIVERSALAPICONTRACT_VERSION >= 0x130000
+#define BAKETA_CAPTURE_HAS_DIRTY_REGIONS 1
+#else
+#define BAKETA_CAPTURE_HAS_DIRTY_REGIONS 0
+#endif
+
 // Direct3D
 #include <d3d11.h>
 #include <dxgi1_2.h>
+#include <dxgi1_6.h>  // EnumAdapterByGpuPreference
 #include <d3d11_4.h>
-#include <d3dcompiler.h>  // 🚀 [Issue #193] GPU Shader Resize
+
+// Media Foundation（HardwareVideoEncoder）
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mftransform.h>
+#include <mferror.h>
+#include <codecapi.h>
 
 // COM スマートポインタ
 #include <wrl/client.h>
@@ -54,4 +81,29 @@ namespace winrt
 }
 
 // プロジェクト内ヘッダー
-#include "WindowsCaptureSession.h"
\ No newline at end of file
+#include "CaptureDiagnostics.h"
+#include "CaptureLastError.h"
+#include "D3DDeviceManager.h"
+#include "StagingTextureCache.h"
+#include "StagingTextureRing.h"
+#include "FrameBufferPool.h"
+#include "CaptureStats.h"
+#include "CpuWorkerPool.h"
+#include "CpuImageKernels.h"
+#include "FrameMailbox.h"
+#include "TileChangeDetector.h"
+#include "EdgeDensityMapper.h"
+#include "DisplayColorInfo.h"
+#include "ResizeResourceCache.h"
+#include "ComputeResizer.h"
+#include "FormatConverter.h"
+#include "DirtyRegionTracker.h"
+#include "SharedTextureExporter.h"
+#include "SharedFrameRing.h"
+#include "AdaptiveResolutionController.h"
+#include "HardwareVideoEncoder.h"
+#include "WindowStateMonitor.h"
+#include "FrameRecording.h"
+#include "WindowsCaptureSession.h"
+#include "SessionRegistry.h"
+#include "AsyncSessionCreator.h"
@@ -0,0 +1,577 @@
+﻿// FrameRecordingTests - 記録ファイル（FrameRecording）の読み出し側の検証
+//
+// FrameRecorder で作成した正常なファイルを基に、途中で切れたファイル・8 バイト境界からずれたファイル・
+// インデックスやフレームヘッダーを書き換えたファイルを作り、FrameReplayReader が範囲外を参照せずに
+// 拒否する（または検証済みのフレームだけを返す）ことを確認する。失敗したケースがあれば終了コード 1 を返す。
+//
+// 使用例:
+//   FrameRecordingTests
+//   ctest -R FrameRecordingTests --output-on-failure
+
+#include "pch.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+// 条件が偽なら失敗箇所を出力してテストケースを失敗にする
+#define EXPECT(condition)                                                                 \
+do                                                                                    \
+{                                                                                     \
+    if (!(condition))                                                                 \
+    {                                                                                 \
+        std::fprintf(stderr, "  %s(%d): EXPECT(%s) failed\n", __FILE__, __LINE__, #condition); \
+        return false;                                                                 \
+    }                                                                                 \
+} while (0)
+
+namespace
+{
+    constexpr int kWidth = 16;
+    constexpr int kHeight = 8;
+    constexpr int kFrames = 3;
+    constexpr int kPackedStride = kWidth * 4;
+
+    const HRESULT kBadFormat = HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+
+    using Bytes = std::vector<unsigned char>;
+
+    /// <summary>
+    /// 記録するフレーム（stride = width * 4 で詰めた期待値と変化矩形）
+    /// </summary>
+    struct SourceFrame
+    {
+        Bytes pixels;
+        std::vector<RECT> rects;
+        bool fullFrame = false;
+    };
+
+    /// <summary>
+    /// 正常な記録ファイルとフレームの配置（ファイル先頭からのオフセット）
+    /// </summary>
+    struct Recording
+    {
+        Bytes indexed;    // Finish でインデックスを書いたファイル
+        Bytes unindexed;  // Finish せずに閉じたファイル（リーダーは先頭から走査する）
+        unsigned long long frameOffsets[kFrames] = {};
+        unsigned long long frameEnds[kFrames] = {};  // 変化矩形・ペイロードの末尾（パディングを除く）
+    };
+
+    std::vector<SourceFrame> g_frames;
+    Recording g_recording;
+
+    std::wstring TempPath(const wchar_t* name)
+    {
+        wchar_t directory[MAX_PATH] = {};
+        GetTempPathW(MAX_PATH, directory);
+        return std::wstring(directory) + L"BaketaFrameRecordingTests_" + name + L".bkrec";
+    }
+
+    bool WriteBytes(const std::wstring& path, const Bytes& bytes)
+    {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        DWORD written = 0;
+        bool ok = bytes.empty() || (WriteFile(file, bytes.data(), static_cast<DWORD>(bytes.size()), &written, nullptr) && written == bytes.size());
+        CloseHandle(file);
+        return ok;
+    }
+
+    bool ReadBytes(const std::wstring& path, Bytes* bytes)
+    {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size = {};
+        DWORD read = 0;
+        bool ok = GetFileSizeEx(file, &size) != FALSE;
+        if (ok)
+        {
+            bytes->resize(static_cast<size_t>(size.QuadPart));
+            ok = bytes->empty() || (ReadFile(file, bytes->data(), static_cast<DWORD>(bytes->size()), &read, nullptr) && read == bytes->size());
+        }
+        CloseHandle(file);
+        return ok;
+    }
+
+    /// <summary>
+    /// バイト列をファイルへ書いて開く（リーダーはファイル全体をメモリマップするため、ファイル経由で渡す）
+    /// </summary>
+    std::unique_ptr<FrameReplayReader> OpenBytes(const Bytes& bytes, HRESULT* hr)
+    {
+        static const std::wstring path = TempPath(L"case");
+        *hr = E_UNEXPECTED;
+        if (!WriteBytes(path, bytes))
+        {
+            std::fprintf(stderr, "  Failed to write the test file\n");
+            return nullptr;
+        }
+        return FrameReplayReader::Open(path.c_str(), hr);
+    }
+
+    template <typename T>
+    void Patch(Bytes& bytes, unsigned long long offset, T value)
+    {
+        memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    template <typename T>
+    T ReadAt(const Bytes& bytes, unsigned long long offset)
+    {
+        T value;
+        memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    }
+
+    unsigned long long FooterOffset(const Bytes& bytes)
+    {
+        return bytes.size() - sizeof(FrameRecording::FileFooter);
+    }
+
+    unsigned long long IndexEntryOffset(const Bytes& bytes, int frame)
+    {
+        auto indexOffset = ReadAt<unsigned long long>(bytes, FooterOffset(bytes) + offsetof(FrameRecording::FileFooter, indexOffset));
+        return indexOffset + static_cast<unsigned long long>(frame) * sizeof(unsigned long long);
+    }
+
+    unsigned long long FrameField(int frame, size_t fieldOffset)
+    {
+        return g_recording.frameOffsets[frame] + fieldOffset;
+    }
+
+    /// <summary>
+    /// 1 枚目は単色（圧縮される）、2 枚目は乱数（圧縮されず kFrameUncompressed）、3 枚目はグラデーション
+    /// </summary>
+    void BuildSourceFrames()
+    {
+        g_frames.resize(kFrames);
+        unsigned int seed = 12345;
+        for (int i = 0; i < kFrames; ++i)
+        {
+            SourceFrame& frame = g_frames[static_cast<size_t>(i)];
+            frame.pixels.resize(static_cast<size_t>(kPackedStride) * kHeight);
+            for (size_t p = 0; p < frame.pixels.size(); ++p)
+            {
+                seed = seed * 1103515245u + 12345u;
+                frame.pixels[p] = (i == 0) ? 0x40 : (i == 1) ? static_cast<unsigned char>(seed >> 16) : static_cast<unsigned char>(p);
+            }
+        }
+        g_frames[0].fullFrame = true;
+        g_frames[1].rects = { { 1, 2, 5, 6 } };
+        g_frames[2].rects = { { 0, 0, 8, 4 }, { 8, 4, 16, 8 } };
+    }
+
+    bool RecordFrames(const std::wstring& path, bool finish)
+    {
+        HRESULT hr = S_OK;
+        auto recorder = FrameRecorder::Create(path.c_str(), &hr);
+        if (!recorder)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < kFrames; ++i)
+        {
+            // 1 枚目は行間にパディングがある入力（記録時に詰める）
+            const SourceFrame& frame = g_frames[static_cast<size_t>(i)];
+            int stride = (i == 0) ? kPackedStride + 16 : kPackedStride;
+            Bytes input(static_cast<size_t>(stride) * kHeight, 0xCD);
+            for (int y = 0; y < kHeight; ++y)
+            {
+                memcpy(input.data() + static_cast<size_t>(stride) * y, frame.pixels.data() + static_cast<size_t>(kPackedStride) * y, kPackedStride);
+            }
+            if (!recorder->Append(input.data(), kWidth, kHeight, stride, 1000LL * (i + 1), static_cast<unsigned long long>(i + 1),
+                frame.rects.data(), static_cast<int>(frame.rects.size()), frame.fullFrame, &hr))
+            {
+                return false;
+            }
+        }
+        return !finish || recorder->Finish(&hr);
+    }
+
+    /// <summary>
+    /// 開いたファイルのフレームが記録した先頭 expectedFrames 枚と一致するか（ヘッダー・変化矩形・展開結果）
+    /// </summary>
+    bool VerifyFrames(FrameReplayReader* reader, int expectedFrames)
+    {
+        EXPECT(reader != nullptr);
+        EXPECT(reader->FrameCount() == expectedFrames);
+
+        Bytes packed(static_cast<size_t>(kPackedStride) * kHeight);
+        Bytes padded(static_cast<size_t>(kPackedStride + 8) * kHeight);
+        for (int i = 0; i < expectedFrames; ++i)
+        {
+            const SourceFrame& source = g_frames[static_cast<size_t>(i)];
+            const FrameReplayReader::Frame& frame = reader->GetFrame(i);
+            EXPECT(frame.header->width == kWidth && frame.header->height == kHeight);
+            EXPECT(frame.header->sequence == static_cast<unsigned long long>(i + 1));
+            EXPECT(frame.header->timestamp == 1000LL * (i + 1));
+            EXPECT(((frame.header->flags & FrameRecording::kFrameFullFrame) != 0) == source.fullFrame);
+            EXPECT(frame.header->rectCount == static_cast<int>(source.rects.size()));
+            for (size_t r = 0; r < source.rects.size(); ++r)
+            {
+                const RECT& expected = source.rects[r];
+                const BaketaCaptureRect& rect = frame.rects[r];
+                EXPECT(rect.x == expected.left && rect.y == expected.top &&
+                    rect.width == expected.right - expected.left && rect.height == expected.bottom - expected.top);
+            }
+
+            HRESULT hr = E_FAIL;
+            EXPECT(reader->Decode(i, packed.data(), kPackedStride, &hr) && SUCCEEDED(hr));
+            EXPECT(packed == source.pixels);
+
+            EXPECT(reader->Decode(i, padded.data(), kPackedStride + 8, &hr) && SUCCEEDED(hr));
+            for (int y = 0; y < kHeight; ++y)
+            {
+                EXPECT(memcmp(padded.data() + static_cast<size_t>(kPackedStride + 8) * y,
+                    source.pixels.data() + static_cast<size_t>(kPackedStride) * y, kPackedStride) == 0);
+            }
+        }
+        return true;
+    }
+
+    bool ExpectRejected(const Bytes& bytes)
+    {
+        HRESULT hr = S_OK;
+        auto reader = OpenBytes(bytes, &hr);
+        EXPECT(reader == nullptr);
+        EXPECT(hr == kBadFormat);
+        return true;
+    }
+
+    bool ExpectFrames(const Bytes& bytes, int expectedFrames)
+    {
+        HRESULT hr = E_FAIL;
+        auto reader = OpenBytes(bytes, &hr);
+        EXPECT(reader != nullptr && SUCCEEDED(hr));
+        return VerifyFrames(reader.get(), expectedFrames);
+    }
+
+    bool Setup()
+    {
+        BuildSourceFrames();
+
+        const std::wstring indexedPath = TempPath(L"indexed");
+        const std::wstring unindexedPath = TempPath(L"unindexed");
+        EXPECT(RecordFrames(indexedPath, true));
+        EXPECT(RecordFrames(unindexedPath, false));
+        EXPECT(ReadBytes(indexedPath, &g_recording.indexed));
+        EXPECT(ReadBytes(unindexedPath, &g_recording.unindexed));
+        DeleteFileW(indexedPath.c_str());
+        DeleteFileW(unindexedPath.c_str());
+
+        // フレームの配置はインデックスから求める（インデックスの有無でフレーム部分は同じバイト列）
+        const Bytes& indexed = g_recording.indexed;
+        EXPECT(indexed.size() > g_recording.unindexed.size());
+        EXPECT(memcmp(indexed.data(), g_recording.unindexed.data(), g_recording.unindexed.size()) == 0);
+        EXPECT(ReadAt<unsigned int>(indexed, FooterOffset(indexed) + offsetof(FrameRecording::FileFooter, frameCount)) == kFrames);
+        for (int i = 0; i < kFrames; ++i)
+        {
+            unsigned long long offset = ReadAt<unsigned long long>(indexed, IndexEntryOffset(indexed, i));
+            auto header = ReadAt<FrameRecording::FrameHeader>(indexed, offset);
+            g_recording.frameOffsets[i] = offset;
+            g_recording.frameEnds[i] = offset + sizeof(FrameRecording::FrameHeader) +
+                static_cast<unsigned long long>(header.rectCount) * sizeof(BaketaCaptureRect) + header.payloadBytes;
+        }
+
+        // 圧縮されたフレームと圧縮されなかったフレームの両方を含むこと（kFrameUncompressed の検証に使う）
+        auto first = ReadAt<FrameRecording::FrameHeader>(indexed, g_recording.frameOffsets[0]);
+        auto second = ReadAt<FrameRecording::FrameHeader>(indexed, g_recording.frameOffsets[1]);
+        EXPECT(!(first.flags & FrameRecording::kFrameUncompressed) && first.payloadBytes < first.rawBytes);
+        EXPECT((second.flags & FrameRecording::kFrameUncompressed) != 0);
+        return true;
+    }
+
+    bool TestValidFiles()
+    {
+        EXPECT(ExpectFrames(g_recording.indexed, kFrames));
+        EXPECT(ExpectFrames(g_recording.unindexed, kFrames));
+        return true;
+    }
+
+    bool TestEmptyRecording()
+    {
+        // フレームの無いインデックス付きファイルは 0 フレームとして開く（リプレイセッションの作成側で拒否する）
+        const std::wstring path = TempPath(L"empty");
+        HRESULT hr = S_OK;
+        {
+            auto recorder = FrameRecorder::Create(path.c_str(), &hr);
+            EXPECT(recorder != nullptr);
+            EXPECT(recorder->Finish(&hr));
+        }
+        Bytes bytes;
+        EXPECT(ReadBytes(path, &bytes));
+        DeleteFileW(path.c_str());
+        EXPECT(bytes.size() == sizeof(FrameRecording::FileHeader) + sizeof(FrameRecording::FileFooter));
+        EXPECT(ExpectFrames(bytes, 0));
+
+        // ファイルヘッダーのみ・空のファイル
+        bytes.resize(sizeof(FrameRecording::FileHeader));
+        EXPECT(ExpectRejected(bytes));
+        EXPECT(ExpectRejected(Bytes()));
+        return true;
+    }
+
+    bool TestBadFileHeader()
+    {
+        Bytes bytes = g_recording.indexed;
+        Patch(bytes, offsetof(FrameRecording::FileHeader, magic), 0x12345678u);
+        EXPECT(ExpectRejected(bytes));
+
+        bytes = g_recording.indexed;
+        Patch(bytes, offsetof(FrameRecording::FileHeader, version), FrameRecording::kVersion + 1);
+        EXPECT(ExpectRejected(bytes));
+
+        bytes = g_recording.indexed;
+        Patch(bytes, offsetof(FrameRecording::FileHeader, frameHeaderSize), static_cast<unsigned int>(sizeof(FrameRecording::FrameHeader) + 8));
+        EXPECT(ExpectRejected(bytes));
+        return true;
+    }
+
+    /// <summary>
+    /// 全ての長さで切ったファイルは、末尾まで収まっているフレームだけを返す（1 枚も無ければ拒否する）
+    /// </summary>
+    bool TestTruncated()
+    {
+        const Bytes& full = g_recording.indexed;
+        for (size_t length = 0; length < full.size(); ++length)
+        {
+            Bytes bytes(full.begin(), full.begin() + static_cast<std::ptrdiff_t>(length));
+            int complete = 0;
+            while (complete < kFrames && g_recording.frameEnds[complete] <= length)
+            {
+                ++complete;
+            }
+
+            bool ok = complete == 0 ? ExpectRejected(bytes) : ExpectFrames(bytes, complete);
+            if (!ok)
+            {
+                std::fprintf(stderr, "  truncated to %zu of %zu bytes\n", length, full.size());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool TestMisaligned()
+    {
+        for (size_t shift = 1; shift < 8; ++shift)
+        {
+            // ファイルヘッダーの後ろにずれたフレーム列は、インデックスも走査も一致しない
+            Bytes shifted = g_recording.indexed;
+            shifted.insert(shifted.begin() + sizeof(FrameRecording::FileHeader), shift, 0);
+            EXPECT(ExpectRejected(shifted));
+
+            shifted = g_recording.unindexed;
+            shifted.insert(shifted.begin() + sizeof(FrameRecording::FileHeader), shift, 0);
+            EXPECT(ExpectRejected(shifted));
+
+            // 末尾に余分なバイトがあるファイルはフッターを見つけられないため、先頭から走査する
+            Bytes trailing = g_recording.indexed;
+            trailing.insert(trailing.end(), shift, 0);
+            EXPECT(ExpectFrames(trailing, kFrames));
+
+            // 8 バイト境界にないインデックスのエントリ・インデックス位置
+            Bytes entry = g_recording.indexed;
+            Patch(entry, IndexEntryOffset(entry, 1), g_recording.frameOffsets[1] + shift);
+            EXPECT(ExpectFrames(entry, kFrames));
+
+            Bytes footer = g_recording.indexed;
+            unsigned long long indexOffsetField = FooterOffset(footer) + offsetof(FrameRecording::FileFooter, indexOffset);
+            Patch(footer, indexOffsetField, ReadAt<unsigned long long>(footer, indexOffsetField) + shift);
+            EXPECT(ExpectFrames(footer, kFrames));
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 不正なインデックス・フッターは使わずに先頭から走査する（範囲外のフレームは返さない）
+    /// </summary>
+    bool TestCraftedIndex()
+    {
+        const unsigned long long footerOffset = FooterOffset(g_recording.indexed);
+        const unsigned long long indexOffsetField = footerOffset + offsetof(FrameRecording::FileFooter, indexOffset);
+        const unsigned long long frameCountField = footerOffset + offsetof(FrameRecording::FileFooter, frameCount);
+
+        Bytes bytes = g_recording.indexed;
+        Patch(bytes, indexOffsetField, 0xFFFFFFFFFFFFFFF8ULL);
+        EXPECT(ExpectFrames(bytes, kFrames));
+
+        bytes = g_recording.indexed;
+        Patch(bytes, indexOffsetField, 0ULL);
+        EXPECT(ExpectFrames(bytes, kFrames));
+
+        bytes = g_recording.indexed;
+        Patch(bytes, frameCountField, 0xFFFFFFFFu);
+        EXPECT(ExpectFrames(bytes, kFrames));
+
+        // frameCount と indexOffset を揃えてずらし、インデックスがフレームの中を指すようにする
+        bytes = g_recording.indexed;
+        Patch(bytes, indexOffsetField, ReadAt<unsigned long long>(bytes, indexOffsetField) - 8);
+        Patch(bytes, frameCountField, static_cast<unsigned int>(kFrames + 1));
+        EXPECT(ExpectFrames(bytes, kFrames));
+
+        // ファイル末尾・インデックスより後ろ・フレームの途中を指すエントリ
+        const unsigned long long badOffsets[] = {
+            0xFFFFFFFFFFFFFFF8ULL,
+            static_cast<unsigned long long>(g_recording.indexed.size()) + 8,
+            ReadAt<unsigned long long>(g_recording.indexed, indexOffsetField),
+            g_recording.frameOffsets[1] + 8,
+            0,
+        };
+        for (unsigned long long offset : badOffsets)
+        {
+            bytes = g_recording.indexed;
+            Patch(bytes, IndexEntryOffset(bytes, 2), offset);
+            EXPECT(ExpectFrames(bytes, kFrames));
+        }
+
+        // 同じフレームを 2 回指すインデックスは形式上は正しいため、そのまま使う
+        bytes = g_recording.indexed;
+        Patch(bytes, IndexEntryOffset(bytes, 2), g_recording.frameOffsets[1]);
+        {
+            HRESULT hr = E_FAIL;
+            auto reader = OpenBytes(bytes, &hr);
+            EXPECT(reader != nullptr && reader->FrameCount() == kFrames);
+            EXPECT(reader->GetFrame(2).header->sequence == 2);
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 不正なフレームヘッダーの手前までのフレームだけを返す（インデックスがあっても同じ）
+    /// </summary>
+    bool TestCraftedFrameHeader()
+    {
+        struct HeaderPatch
+        {
+            const char* name;
+            size_t fieldOffset;
+            long long value;
+            int size;
+        };
+        const HeaderPatch patches[] = {
+            { "width = 0", offsetof(FrameRecording::FrameHeader, width), 0, 4 },
+            { "width = -1", offsetof(FrameRecording::FrameHeader, width), -1, 4 },
+            { "height = INT_MAX", offsetof(FrameRecording::FrameHeader, height), INT_MAX, 4 },
+            { "width * height != rawBytes", offsetof(FrameRecording::FrameHeader, width), 0x40000000, 4 },
+            { "rawBytes = 0", offsetof(FrameRecording::FrameHeader, rawBytes), 0, 4 },
+            { "payloadBytes = UINT_MAX", offsetof(FrameRecording::FrameHeader, payloadBytes), 0xFFFFFFFFLL, 4 },
+            { "payloadBytes past end", offsetof(FrameRecording::FrameHeader, payloadBytes), 0x10000, 4 },
+            { "rectCount = -1", offsetof(FrameRecording::FrameHeader, rectCount), -1, 4 },
+            { "rectCount = INT_MAX", offsetof(FrameRecording::FrameHeader, rectCount), INT_MAX, 4 },
+            { "uncompressed payload size", offsetof(FrameRecording::FrameHeader, payloadBytes), kPackedStride * kHeight - 4, 4 },
+        };
+
+        for (const HeaderPatch& patch : patches)
+        {
+            for (int frame = 0; frame < kFrames; ++frame)
+            {
+                for (const Bytes* base : { &g_recording.indexed, &g_recording.unindexed })
+                {
+                    Bytes bytes = *base;
+                    unsigned long long field = FrameField(frame, patch.fieldOffset);
+                    Patch(bytes, field, static_cast<int>(patch.value));
+
+                    // 圧縮されなかったフレームの payloadBytes は rawBytes と一致しなければならない
+                    bool uncompressed = (ReadAt<unsigned int>(bytes, FrameField(frame, offsetof(FrameRecording::FrameHeader, flags))) &
+                        FrameRecording::kFrameUncompressed) != 0;
+                    if (std::strcmp(patch.name, "uncompressed payload size") == 0 && !uncompressed)
+                    {
+                        continue;
+                    }
+
+                    bool ok = frame == 0 ? ExpectRejected(bytes) : ExpectFrames(bytes, frame);
+                    if (!ok)
+                    {
+                        std::fprintf(stderr, "  %s on frame %d (%s)\n", patch.name, frame, base == &g_recording.indexed ? "indexed" : "unindexed");
+                        return false;
+                    }
+                }
+            }
+        }
+
+        // 圧縮されたフレームを非圧縮と偽ると payloadBytes と rawBytes が一致しない
+        for (const Bytes* base : { &g_recording.indexed, &g_recording.unindexed })
+        {
+            Bytes bytes = *base;
+            unsigned long long flagsField = FrameField(0, offsetof(FrameRecording::FrameHeader, flags));
+            Patch(bytes, flagsField, ReadAt<unsigned int>(bytes, flagsField) | FrameRecording::kFrameUncompressed);
+            EXPECT(ExpectRejected(bytes));
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 壊れた圧縮データは展開時に失敗を返す（出力先の範囲外へ書かない）
+    /// </summary>
+    bool TestCorruptPayload()
+    {
+        Bytes bytes = g_recording.indexed;
+        auto header = ReadAt<FrameRecording::FrameHeader>(bytes, g_recording.frameOffsets[0]);
+        unsigned long long payload = g_recording.frameEnds[0] - header.payloadBytes;
+        memset(bytes.data() + payload, 0xFF, header.payloadBytes);
+
+        HRESULT hr = S_OK;
+        auto reader = OpenBytes(bytes, &hr);
+        EXPECT(reader != nullptr && reader->FrameCount() == kFrames);
+
+        // 出力先の後ろに番兵を置き、展開が rawBytes を超えて書かないことを確認する
+        const size_t rawBytes = static_cast<size_t>(kPackedStride) * kHeight;
+        Bytes output(rawBytes + 64, 0xA5);
+        bool decoded = reader->Decode(0, output.data(), kPackedStride, &hr);
+        EXPECT(decoded ? SUCCEEDED(hr) : FAILED(hr));
+        for (size_t i = rawBytes; i < output.size(); ++i)
+        {
+            EXPECT(output[i] == 0xA5);
+        }
+
+        // 範囲外のフレーム番号・小さすぎる stride
+        EXPECT(!reader->Decode(kFrames, output.data(), kPackedStride, &hr) && hr == E_INVALIDARG);
+        EXPECT(!reader->Decode(-1, output.data(), kPackedStride, &hr) && hr == E_INVALIDARG);
+        EXPECT(!reader->Decode(1, output.data(), kPackedStride - 4, &hr) && hr == E_INVALIDARG);
+        return true;
+    }
+}
+
+int main()
+{
+    struct TestCase
+    {
+        const char* name;
+        bool (*run)();
+    };
+    const TestCase tests[] = {
+        { "ValidFiles", TestValidFiles },
+        { "EmptyRecording", TestEmptyRecording },
+        { "BadFileHeader", TestBadFileHeader },
+        { "Truncated", TestTruncated },
+        { "Misaligned", TestMisaligned },
+        { "CraftedIndex", TestCraftedIndex },
+        { "CraftedFrameHeader", TestCraftedFrameHeader },
+        { "CorruptPayload", TestCorruptPayload },
+    };
+
+    if (!Setup())
+    {
+        std::fprintf(stderr, "[FAIL] Setup\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (const TestCase& test : tests)
+    {
+        bool passed = test.run();
+        std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.name);
+        failures += passed ? 0 : 1;
+    }
+
+    DeleteFileW(TempPath(L"case").c_str());
+    std::printf("%d / %zu passed\n", static_cast<int>(std::size(tests)) - failures, std::size(tests));
+    return failures == 0 ? 0 : 1;
+}